@@ -0,0 +1,75 @@
+/** This file contains the benchmarks of the classes defined in chunked_cube.h */
+#include "../Imaging/chunked_cube.h"
+
+#include <cstdio>
+
+#include "benchmarks.h"
+
+// Writing and reading a smooth 512 x 512 x 64 cube of 32 MB in chunks of 16 bands, and
+// reading a band and a small region of it, which decompress only the chunks they cover.
+void BenchmarkChunkedCubes(void)
+{
+	using namespace Imaging;
+
+	const std::string path = "bench_chunked_cube.cube";
+	const Size2D<::size_t> sz(512, 512);
+	const ::size_t nBands = 64, nPixels = sz.width * sz.height;
+	ImageFrame<unsigned short> cube(sz.width, sz.height, nBands), img;
+	for (::size_t Y = 0; Y != sz.height; ++Y)
+		for (::size_t X = 0; X != sz.width; ++X)
+			for (::size_t B = 0; B != nBands; ++B)
+				*cube.GetPointer(X, Y, B) = static_cast<unsigned short>(1000 + 3 * X +
+					2 * Y + 40 * B + (X * 7 + Y * 3) % 5);
+	CubeOptions options;
+	options.chunkBands = 16;
+	unsigned long long nStored = 0;
+	auto write = [&](void)
+	{
+		CubeWriter<unsigned short> writer(path, cube.size, nBands, options);
+		writer.Write(cube);
+		writer.Close();
+		nStored = writer.GetStoredBytes();
+	};
+	write();
+	const double nBytes = 2.0 * cube.data.size();
+
+	RunBenchmark(GetBenchmarkName("CubeWriter::Write", "ushort", sz, nBands,
+		std::to_string(100 * nStored / cube.data.size() / 2) + " % stored"), nBytes,
+		static_cast<double>(nPixels), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+			write();
+	});
+
+	CubeReader<unsigned short> reader(path);
+	RunBenchmark(GetBenchmarkName("CubeReader::Read", "ushort", sz, nBands), nBytes,
+		static_cast<double>(nPixels), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			reader.Read(Region<::size_t, ::size_t>(0, 0, sz.width, sz.height), img);
+			DoNotOptimize(img);
+		}
+	});
+
+	RunBenchmark(GetBenchmarkName("CubeReader::ReadBand", "ushort", sz, 1), 2.0 * nPixels,
+		static_cast<double>(nPixels), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			reader.ReadBand(20, img);
+			DoNotOptimize(img);
+		}
+	});
+
+	RunBenchmark(GetBenchmarkName("CubeReader::Read", "ushort", Size2D<::size_t>(16, 16),
+		nBands), 2.0 * 16 * 16 * nBands, 16 * 16, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			reader.Read(Region<::size_t, ::size_t>(100, 100, 16, 16), img);
+			DoNotOptimize(img);
+		}
+	});
+	std::remove(path.c_str());
+}
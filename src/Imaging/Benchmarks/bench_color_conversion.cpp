@@ -0,0 +1,77 @@
+/** This file contains the benchmarks of the functions defined in color_conversion.h */
+#include "../Imaging/color_conversion.h"
+#include "../Utilities/parallel.h"
+
+#include "benchmarks.h"
+
+// Conversions of a 1080p frame into a destination which keeps its memory after the
+// warm-up.
+void BenchmarkColorConversions(void)
+{
+	using namespace Imaging;
+
+	const Size2D<::size_t> sz(1920, 1080);
+	const ::size_t nPixels = sz.width * sz.height;
+	std::vector<unsigned char> samples(3 * nPixels);
+	for (::size_t I = 0; I != samples.size(); ++I)
+		samples[I] = static_cast<unsigned char>(I * 2654435761u >> 13);
+	const ImageFrame<unsigned char> imgRgb(std::move(samples), sz, 3);
+	ImageFrame<unsigned char> imgYuv, imgGray, imgHsv, imgDst;
+	ColorToYuv(imgRgb, imgYuv, YuvStandard::BT709);
+	const bool allocationFree = GetThreadCount() == 1;
+
+	RunBenchmark(GetBenchmarkName("ColorToGray", "uchar", sz, 3), 4.0 * nPixels, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			ColorToGray(imgRgb, imgGray);
+			DoNotOptimize(imgGray);
+		}
+	}, allocationFree);
+
+	RunBenchmark(GetBenchmarkName("ColorToYuv", "uchar", sz, 3), 6.0 * nPixels, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			ColorToYuv(imgRgb, imgDst, YuvStandard::BT709);
+			DoNotOptimize(imgDst);
+		}
+	}, allocationFree);
+
+	RunBenchmark(GetBenchmarkName("YuvToColor", "uchar", sz, 3), 6.0 * nPixels, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			YuvToColor(imgYuv, imgDst, YuvStandard::BT709);
+			DoNotOptimize(imgDst);
+		}
+	}, allocationFree);
+
+	// NV12 of the Y plane and interleaved chroma of the YUV frame.
+	std::vector<unsigned char> nv12(nPixels + nPixels / 2);
+	for (::size_t I = 0; I != nPixels; ++I)
+		nv12[I] = imgYuv.data[3 * I];
+	RunBenchmark(GetBenchmarkName("Nv12ToColor", "uchar", sz, 3), 4.5 * nPixels, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			Nv12ToColor(nv12.data(), sz.width, nv12.data() + nPixels, sz.width, sz.width,
+				sz.height, imgDst, YuvStandard::BT709);
+			DoNotOptimize(imgDst);
+		}
+	}, allocationFree);
+
+	RunBenchmark(GetBenchmarkName("ColorToHsv", "uchar", sz, 3), 6.0 * nPixels, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			ColorToHsv(imgRgb, imgHsv);
+			DoNotOptimize(imgHsv);
+		}
+	}, allocationFree);
+}
@@ -0,0 +1,126 @@
+/** This file contains the benchmarks of the operators defined in coordinates.h */
+#include "../Imaging/coordinates.h"
+
+#include "benchmarks.h"
+
+// Each iteration is an operation; the operands are hidden from the compiler, so it is
+// neither hoisted out of the loop nor folded into a constant.
+
+template <typename T>
+void BenchmarkPoints(const std::string &typeName)
+{
+	using namespace Imaging;
+
+	RunBenchmark("Point2D+Point2D/" + typeName, 0.0, 1.0, [](unsigned long long n)
+	{
+		Point2D<T> a(1, 2), b(3, 4);
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			DoNotOptimize(b);
+			a = a + b;
+			DoNotOptimize(a);
+		}
+	});
+
+	RunBenchmark("Point2D*double/" + typeName, 0.0, 1.0, [](unsigned long long n)
+	{
+		Point2D<T> a(100, 200);
+		Point2D<double> b;
+		double zm = 0.5;
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			DoNotOptimize(a);
+			DoNotOptimize(zm);
+			b = a * zm;
+			DoNotOptimize(b);
+		}
+	});
+
+	RunBenchmark("Point2D==Point2D/" + typeName, 0.0, 1.0, [](unsigned long long n)
+	{
+		Point2D<T> a(1, 2), b(1, 2);
+		bool equal = false;
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			DoNotOptimize(b);
+			equal = a == b;
+			DoNotOptimize(equal);
+		}
+	});
+}
+
+template <typename T, typename U>
+void BenchmarkRegions(const std::string &typeName)
+{
+	using namespace Imaging;
+
+	RunBenchmark("Region+Point2D/" + typeName, 0.0, 1.0, [](unsigned long long n)
+	{
+		Region<T, U> roi(10, 20, 640, 480);
+		Point2D<T> dist(1, 1);
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			DoNotOptimize(dist);
+			roi = roi + dist;
+			DoNotOptimize(roi);
+		}
+	});
+
+	RunBenchmark("Region*double/" + typeName, 0.0, 1.0, [](unsigned long long n)
+	{
+		Region<T, U> roi(10, 20, 640, 480), dst;
+		double zm = 1.5;
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			DoNotOptimize(roi);
+			DoNotOptimize(zm);
+			dst = roi * zm;
+			DoNotOptimize(dst);
+		}
+	});
+
+	RunBenchmark("Region*Point2D/" + typeName, 0.0, 1.0, [](unsigned long long n)
+	{
+		Region<T, U> roi(10, 20, 640, 480), dst;
+		Point2D<double> zm(1.5, 0.5);
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			DoNotOptimize(roi);
+			DoNotOptimize(zm);
+			dst = roi * zm;
+			DoNotOptimize(dst);
+		}
+	});
+
+	RunBenchmark("Region==Region/" + typeName, 0.0, 1.0, [](unsigned long long n)
+	{
+		Region<T, U> a(10, 20, 640, 480), b(10, 20, 640, 480);
+		bool equal = false;
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			DoNotOptimize(b);
+			equal = a == b;
+			DoNotOptimize(equal);
+		}
+	});
+
+	RunBenchmark("Region::GetArea/" + typeName, 0.0, 1.0, [](unsigned long long n)
+	{
+		Region<T, U> roi(10, 20, 640, 480);
+		U area = 0;
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			DoNotOptimize(roi);
+			area = roi.GetArea();
+			DoNotOptimize(area);
+		}
+	});
+}
+
+void BenchmarkCoordinates(void)
+{
+	BenchmarkPoints<int>("int");
+	BenchmarkPoints<double>("double");
+	BenchmarkRegions<int, int>("int,int");
+	BenchmarkRegions<::size_t, ::size_t>("size_t,size_t");
+}
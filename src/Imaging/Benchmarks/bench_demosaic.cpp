@@ -0,0 +1,40 @@
+/** This file contains the benchmarks of the functions defined in demosaic.h */
+#include "../Imaging/demosaic.h"
+
+#include "benchmarks.h"
+
+// Demosaicing of a 12 MP mosaic by each method. The lines of each band are buffered per
+// call, so these are not allocation-free.
+template <typename T>
+void BenchmarkDemosaic(const std::string &typeName, const Imaging::Size2D<::size_t> &sz,
+	unsigned bitDepth)
+{
+	using namespace Imaging;
+
+	const ::size_t nPixels = sz.width * sz.height;
+	std::vector<T> raw(nPixels);
+	for (::size_t I = 0; I != raw.size(); ++I)
+		raw[I] = static_cast<T>((I * 2654435761u >> 11) & ((1u << bitDepth) - 1));
+	ImageFrame<T> imgDst;
+
+	const DemosaicMethod methods[2] = {DemosaicMethod::BILINEAR, DemosaicMethod::EDGE_AWARE};
+	const char *names[2] = {"bilinear", "edge-aware"};
+	for (int M = 0; M != 2; ++M)
+		RunBenchmark(GetBenchmarkName("Demosaic", typeName, sz, 1, names[M]),
+			4.0 * nPixels * sizeof(T), nPixels, [&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				Demosaic(raw.data(), sz.width, sz.height, sz.width * sizeof(T),
+					BayerPattern::RGGB, imgDst, methods[M], bitDepth);
+				DoNotOptimize(imgDst);
+			}
+		});
+}
+
+void BenchmarkDemosaic(void)
+{
+	const Imaging::Size2D<::size_t> sz(4000, 3000);
+	BenchmarkDemosaic<unsigned char>("uchar", sz, 8);
+	BenchmarkDemosaic<unsigned short>("ushort", sz, 12);
+}
@@ -0,0 +1,69 @@
+/** This file contains the benchmarks of the functions defined in detection.h */
+#include "../Imaging/detection.h"
+
+#include <random>
+
+#include "benchmarks.h"
+
+/** Creates random regions clustered around a few centers over 8192 x 8192 pixels, i.e.,
+typical raw output of a detector, with random scores. */
+void MakeDetections(::size_t count, std::vector<Imaging::Region<int, int>> &regions,
+	std::vector<double> &scores)
+{
+	std::mt19937 gen(1);
+	std::uniform_int_distribution<int> center(0, 8192);
+	std::uniform_int_distribution<int> jitter(-4, 4), extent(16, 48);
+	std::uniform_real_distribution<double> score(0.0, 1.0);
+
+	int cx = 0, cy = 0, w = 0, h = 0;
+	for (::size_t I = 0; I != count; ++I)
+	{
+		if (I % 16 == 0)
+		{
+			cx = center(gen);
+			cy = center(gen);
+			w = extent(gen);
+			h = extent(gen);
+		}
+		regions.push_back(Imaging::Region<int, int>(cx + jitter(gen), cy + jitter(gen),
+			w + jitter(gen), h + jitter(gen)));
+		scores.push_back(score(gen));
+	}
+}
+
+// Greedy NMS and Gaussian soft-NMS, where an item is a candidate region. Soft-NMS decays
+// a copy of the scores on every iteration.
+void BenchmarkDetection(void)
+{
+	using namespace Imaging;
+
+	for (::size_t count : {10000, 100000})
+	{
+		std::vector<Region<int, int>> regions;
+		std::vector<double> scores;
+		MakeDetections(count, regions, scores);
+		std::vector<::size_t> kept;
+
+		RunBenchmark("SuppressNonMaxima/greedy/" + std::to_string(count), 0.0,
+			static_cast<double>(count), [&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				SuppressNonMaxima(regions, scores, 0.5, kept);
+				DoNotOptimize(kept);
+			}
+		});
+
+		RunBenchmark("SuppressNonMaxima/Gaussian/" + std::to_string(count), 0.0,
+			static_cast<double>(count), [&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				std::vector<double> decayed = scores;
+				SuppressNonMaxima(regions, decayed, 0.5, 0.001, Suppression::GAUSSIAN, 0.5,
+					kept);
+				DoNotOptimize(kept);
+			}
+		});
+	}
+}
@@ -0,0 +1,47 @@
+/** This file contains the benchmarks of the classes defined in frame_compression.h */
+#include "../Imaging/frame_compression.h"
+
+#include <cstdio>
+#include <random>
+
+#include "benchmarks.h"
+
+// Compressing and decompressing a smooth 16-bit frame of 2 MB with a little noise, whose
+// ratio is given in the name of the compression.
+void BenchmarkFrameCompression(void)
+{
+	using namespace Imaging;
+
+	const Size2D<::size_t> sz(1024, 1024);
+	const ::size_t nPixels = sz.width * sz.height;
+	std::mt19937 gen(5);
+	std::uniform_int_distribution<int> noise(0, 3);
+	ImageFrame<unsigned short> img(sz.width, sz.height, 1), dst;
+	for (::size_t Y = 0; Y != sz.height; ++Y)
+		for (::size_t X = 0; X != sz.width; ++X)
+			*img.GetPointer(X, Y) = static_cast<unsigned short>(1000 + 7 * X + 5 * Y +
+				noise(gen));
+	CompressedFrame<unsigned short> frame(img);
+	char ratio[32];
+	std::snprintf(ratio, sizeof(ratio), "ratio %.2f", frame.GetRatio());
+
+	RunBenchmark(GetBenchmarkName("CompressedFrame::Compress", "ushort", sz, 1, ratio),
+		2.0 * nPixels, static_cast<double>(nPixels), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			frame.Compress(img);
+			DoNotOptimize(frame);
+		}
+	});
+
+	RunBenchmark(GetBenchmarkName("CompressedFrame::Decompress", "ushort", sz, 1),
+		2.0 * nPixels, static_cast<double>(nPixels), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			frame.Decompress(dst);
+			DoNotOptimize(dst);
+		}
+	});
+}
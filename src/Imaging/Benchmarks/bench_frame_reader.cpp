@@ -0,0 +1,52 @@
+/** This file contains the benchmarks of the classes defined in frame_reader.h */
+#include "../Imaging/frame_reader.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "benchmarks.h"
+
+// Reading and computing on each frame of a sequence of 32 frames of 2 MB, without and
+// with frames read ahead. The computation takes about as long as reading a frame, so on
+// more than one core reading ahead hides one behind the other.
+void BenchmarkFrameReaders(void)
+{
+	using namespace Imaging;
+
+	const std::string path = "bench_frame_reader.raw";
+	const Size2D<::size_t> sz(1024, 1024);
+	const ::size_t nFrames = 32, nPixels = sz.width * sz.height;
+	{
+		std::ofstream file(path, std::ios::binary);
+		std::vector<unsigned short> frame(nPixels, 1);
+		for (::size_t N = 0; N != nFrames; ++N)
+			file.write(reinterpret_cast<const char *>(frame.data()), 2 * frame.size());
+	}
+
+	for (::size_t K : {0, 4})
+	{
+		FrameReaderOptions options;
+		options.nPrefetch = K;
+		FrameReader<unsigned short> reader(path, sz, 1, options);
+		RunBenchmark(GetBenchmarkName("FrameReader::Next", "ushort", sz, 1,
+			std::to_string(nFrames) + " frames, " + std::to_string(K) + " read ahead"),
+			2.0 * nFrames * nPixels, static_cast<double>(nFrames * nPixels),
+			[&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				reader.Seek(0);
+				unsigned long long sum = 0;
+				while (reader.HasNext())
+				{
+					FrameReader<unsigned short>::FramePtr frame = reader.Next().get();
+					for (int R = 0; R != 4; ++R)
+						for (auto it = frame->data.cbegin(); it != frame->data.cend(); ++it)
+							sum += *it * (R + 1);
+				}
+				DoNotOptimize(sum);
+			}
+		});
+	}
+	std::remove(path.c_str());
+}
@@ -0,0 +1,89 @@
+/** This file contains the benchmarks of the classes defined in frame_ring.h */
+#include "../Imaging/frame_ring.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "benchmarks.h"
+
+// Handing 2000 VGA frames from a thread to another by a frame ring of 8 slots, and by
+// moving newly allocated frames through a queue of 8 frames guarded by a mutex. Neither
+// copies the samples of a frame, so bytes are 0 and items are frames.
+void BenchmarkFrameRings(void)
+{
+	using namespace Imaging;
+
+	const unsigned long long nFrames = 2000;
+	const Size2D<::size_t> sz(640, 480);
+
+	RunBenchmark(GetBenchmarkName("FrameRing", "uchar", sz, 1, "2000 frames"), 0.0,
+		static_cast<double>(nFrames), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			FrameRing<unsigned char> ring(8, sz, 1);
+			std::thread producer([&]()
+			{
+				for (unsigned long long N = 0; N != nFrames; ++N)
+				{
+					auto slot = ring.Claim();
+					*slot.GetFrame().GetPointer(0, 0) = static_cast<unsigned char>(N);
+					slot.Commit();
+				}
+				ring.Close();
+			});
+			unsigned long long sum = 0;
+			for (auto view = ring.Acquire(); view; )
+			{
+				sum += view.GetFrame().data.front();
+				view.Release();
+				view = ring.Acquire();
+			}
+			producer.join();
+			DoNotOptimize(sum);
+		}
+	});
+
+	RunBenchmark(GetBenchmarkName("std::deque + std::mutex", "uchar", sz, 1, "2000 frames"),
+		0.0, static_cast<double>(nFrames), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			std::mutex lock;
+			std::condition_variable cv;
+			std::deque<ImageFrame<unsigned char>> queue;
+			bool done = false;
+			std::thread producer([&]()
+			{
+				for (unsigned long long N = 0; N != nFrames; ++N)
+				{
+					ImageFrame<unsigned char> frame(sz, 1);
+					*frame.GetPointer(0, 0) = static_cast<unsigned char>(N);
+					std::unique_lock<std::mutex> guard(lock);
+					cv.wait(guard, [&]() { return queue.size() < 8; });
+					queue.push_back(std::move(frame));
+					cv.notify_all();
+				}
+				std::lock_guard<std::mutex> guard(lock);
+				done = true;
+				cv.notify_all();
+			});
+			unsigned long long sum = 0;
+			for (;;)
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				cv.wait(guard, [&]() { return !queue.empty() || done; });
+				if (queue.empty())
+					break;
+				ImageFrame<unsigned char> frame(std::move(queue.front()));
+				queue.pop_front();
+				cv.notify_all();
+				sum += frame.data.front();
+			}
+			producer.join();
+			DoNotOptimize(sum);
+		}
+	});
+}
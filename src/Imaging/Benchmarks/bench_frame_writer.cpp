@@ -0,0 +1,42 @@
+/** This file contains the benchmarks of the classes defined in frame_writer.h */
+#include "../Imaging/frame_writer.h"
+
+#include <cstdio>
+
+#include "benchmarks.h"
+
+// Writing a sequence of 32 frames of 2 MB from opening to closing the file, buffered and by
+// direct I/O. Write() only queues a frame, so the time includes Close() waiting for the
+// queue to drain.
+void BenchmarkFrameWriters(void)
+{
+	using namespace Imaging;
+
+	const std::string path = "bench_frame_writer.raw";
+	const Size2D<::size_t> sz(1024, 1024);
+	const ::size_t nFrames = 32, nPixels = sz.width * sz.height;
+	ImageFrame<unsigned short> img(sz.width, sz.height, 1);
+	for (::size_t I = 0; I != nPixels; ++I)
+		*(img.GetPointer(0, 0) + I) = static_cast<unsigned short>(I * 2654435761u >> 20);
+
+	for (int D = 0; D != 2; ++D)
+	{
+		FrameWriterOptions options;
+		options.format = RawImageFormat::BSQ;
+		options.directIo = D == 1;
+		RunBenchmark(GetBenchmarkName("FrameWriter::Write", "ushort", sz, 1,
+			std::to_string(nFrames) + " frames, " + (D == 1 ? "direct" : "buffered")),
+			2.0 * nFrames * nPixels, static_cast<double>(nFrames * nPixels),
+			[&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				FrameWriter<unsigned short> writer(path, img.size, 1, options);
+				for (::size_t N = 0; N != nFrames; ++N)
+					writer.Write(img);
+				writer.Close();
+			}
+		});
+	}
+	std::remove(path.c_str());
+}
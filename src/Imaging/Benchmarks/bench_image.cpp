@@ -0,0 +1,222 @@
+/** This file contains the benchmarks of the functions and classes defined in image.h */
+#include "../Imaging/image.h"
+
+#include "benchmarks.h"
+
+// Sizes and depths swept for each sample type.
+const Imaging::Size2D<::size_t> benchmarkSizes[] = {Imaging::Size2D<::size_t>(640, 480),
+	Imaging::Size2D<::size_t>(1920, 1080), Imaging::Size2D<::size_t>(3840, 2160)};
+const ::size_t benchmarkDepths[] = {1, 3, 4};
+
+template <typename T>
+void BenchmarkImages(const std::string &typeName, const Imaging::Size2D<::size_t> &sz,
+	::size_t d)
+{
+	using namespace Imaging;
+
+	const ::size_t nSamples = sz.width * sz.height * d, nPixels = sz.width * sz.height;
+	const ::size_t bytesPerLine = sz.width * d * sizeof(T);
+	const double bytes = 2.0 * nSamples * sizeof(T);
+	std::vector<T> src(nSamples), dst;
+	for (::size_t I = 0; I != nSamples; ++I)
+		src[I] = static_cast<T>(I % 251);
+
+	// Every primitive here writes into a destination sized by the warm-up, so it must not
+	// allocate afterwards.
+
+	// Copy() from a raw buffer without padding, which is a copy of whole lines, and with
+	// lines padded to the next multiple of 64 bytes.
+	RunBenchmark(GetBenchmarkName("Copy", typeName, sz, d, "dense"), bytes, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			Copy(src.data(), sz.width, sz.height, d, bytesPerLine, dst);
+			DoNotOptimize(dst);
+		}
+	}, true);
+
+	const ::size_t paddedBytesPerLine = (bytesPerLine / 64 + 1) * 64;
+	std::vector<char> padded(paddedBytesPerLine * sz.height);
+	RunBenchmark(GetBenchmarkName("Copy", typeName, sz, d, "padded"), bytes, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			Copy(padded.data(), sz.width, sz.height, d, paddedBytesPerLine, dst);
+			DoNotOptimize(dst);
+		}
+	}, true);
+
+	// CopyLines() of the central quarter of an image.
+	const ::size_t roiWidth = sz.width / 2, roiHeight = sz.height / 2;
+	const ::size_t nElemPerLine = sz.width * d, nElemWidth = roiWidth * d;
+	std::vector<T> lines(nElemWidth * roiHeight);
+	RunBenchmark(GetBenchmarkName("CopyLines", typeName, sz, d, "quarter"),
+		2.0 * lines.size() * sizeof(T), roiWidth * roiHeight, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			CopyLines<T>(src.cbegin() + (sz.height / 4) * nElemPerLine + (sz.width / 4) * d,
+				nElemPerLine, lines.begin(), nElemWidth, nElemWidth, roiHeight);
+			DoNotOptimize(lines);
+		}
+	}, true);
+
+	// BsqToBip() and BilToBip() only reorder samples of more than 1 band, into a
+	// destination of the same size.
+	if (d > 1)
+	{
+		dst.resize(nSamples);
+		RunBenchmark(GetBenchmarkName("BsqToBip", typeName, sz, d), bytes, nPixels,
+			[&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				BsqToBip(src, d, nPixels, dst);
+				DoNotOptimize(dst);
+			}
+		}, true);
+
+		RunBenchmark(GetBenchmarkName("BilToBip", typeName, sz, d), bytes, nPixels,
+			[&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				BilToBip(src, d, sz.width, sz.height, dst);
+				DoNotOptimize(dst);
+			}
+		}, true);
+	}
+
+	// CopyFrom() and CopyTo() of the central quarter of an image.
+	ImageFrame<T> imgSrc(sz.width, sz.height, d), imgDst(roiWidth, roiHeight, d), imgOut;
+	imgSrc.CopyFrom(src, sz, d);
+	const Region<::size_t, ::size_t> roi(sz.width / 4, sz.height / 4, roiWidth, roiHeight);
+	const double roiBytes = 2.0 * roiWidth * roiHeight * d * sizeof(T);
+	RunBenchmark(GetBenchmarkName("ImageFrame::CopyFrom", typeName, sz, d, "quarter"),
+		roiBytes, roiWidth * roiHeight, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			imgDst.CopyFrom(imgSrc, roi, Point2D<::size_t>(0, 0));
+			DoNotOptimize(imgDst);
+		}
+	}, true);
+
+	RunBenchmark(GetBenchmarkName("ImageFrame::CopyTo", typeName, sz, d, "quarter"),
+		roiBytes, roiWidth * roiHeight, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			imgSrc.CopyTo(roi, imgOut);
+			DoNotOptimize(imgOut);
+		}
+	}, true);
+}
+
+/** A swap fused into Copy() and BsqToBip() against a separate pass of SwapBytes() after
+them, for 12 M samples of 16-bit and 200 bands x 60 K pixels of float. */
+void BenchmarkByteOrder(void)
+{
+	using namespace Imaging;
+
+	const ByteOrder other = GetNativeByteOrder() == ByteOrder::LITTLE ? ByteOrder::BIG :
+		ByteOrder::LITTLE;
+	const Size2D<::size_t> szRaw(4000, 3000);
+	std::vector<unsigned short> raw(szRaw.width * szRaw.height), dst(raw.size());
+	for (::size_t I = 0; I != raw.size(); ++I)
+		raw[I] = static_cast<unsigned short>(I);
+	const double bytesRaw = 2.0 * raw.size() * sizeof(unsigned short);
+	RunBenchmark(GetBenchmarkName("Copy", "ushort", szRaw, 1, "copy + swap"), bytesRaw,
+		raw.size(), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			Copy(raw.data(), szRaw.width, szRaw.height, 1, 2 * szRaw.width, dst);
+			SwapBytes(dst.data(), dst.size());
+			DoNotOptimize(dst);
+		}
+	}, true);
+	RunBenchmark(GetBenchmarkName("Copy", "ushort", szRaw, 1, "fused swap"), bytesRaw,
+		raw.size(), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			Copy(raw.data(), szRaw.width, szRaw.height, 1, 2 * szRaw.width, dst, other);
+			DoNotOptimize(dst);
+		}
+	}, true);
+
+	const Size2D<::size_t> szCube(300, 200);
+	const ::size_t nBands = 200, nPixels = szCube.width * szCube.height;
+	std::vector<float> cube(nBands * nPixels), cubeBip(cube.size());
+	for (::size_t I = 0; I != cube.size(); ++I)
+		cube[I] = static_cast<float>(I);
+	const double bytesCube = 2.0 * cube.size() * sizeof(float);
+	RunBenchmark(GetBenchmarkName("BsqToBip", "float", szCube, nBands, "convert + swap"),
+		bytesCube, nPixels, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			BsqToBip(cube.data(), nBands, nPixels, cubeBip);
+			SwapBytes(cubeBip.data(), cubeBip.size());
+			DoNotOptimize(cubeBip);
+		}
+	}, true);
+	RunBenchmark(GetBenchmarkName("BsqToBip", "float", szCube, nBands, "fused swap"),
+		bytesCube, nPixels, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			BsqToBip(cube.data(), nBands, nPixels, cubeBip, other);
+			DoNotOptimize(cubeBip);
+		}
+	}, true);
+}
+
+/** Unpacking 12 M packed 10-bit and 12-bit samples of each packing into 16 bits. */
+void BenchmarkPacking(void)
+{
+	using namespace Imaging;
+
+	const Size2D<::size_t> sz(4000, 3000);
+	const Packing packings[4] = {Packing::MONO10P, Packing::MONO12P, Packing::MONO10_PACKED,
+		Packing::MONO12_PACKED};
+	const char *names[4] = {"Mono10p", "Mono12p", "Mono10Packed", "Mono12Packed"};
+	std::vector<unsigned short> dst(sz.width * sz.height);
+	for (int P = 0; P != 4; ++P)
+	{
+		const ::size_t bytesPerLine = GetPackedBytesPerLine(sz.width, packings[P]);
+		std::vector<unsigned char> raw(bytesPerLine * sz.height);
+		for (::size_t I = 0; I != raw.size(); ++I)
+			raw[I] = static_cast<unsigned char>(I * 2654435761u >> 13);
+		RunBenchmark(GetBenchmarkName("Copy", "ushort", sz, 1, names[P]),
+			static_cast<double>(raw.size() + 2 * dst.size()), dst.size(),
+			[&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				Copy(raw.data(), sz.width, sz.height, bytesPerLine, packings[P], dst);
+				DoNotOptimize(dst);
+			}
+		}, true);
+	}
+}
+
+template <typename T>
+void BenchmarkImages(const std::string &typeName)
+{
+	for (const auto &sz : benchmarkSizes)
+		for (auto d : benchmarkDepths)
+			BenchmarkImages<T>(typeName, sz, d);
+}
+
+void BenchmarkImages(void)
+{
+	BenchmarkImages<unsigned char>("uchar");
+	BenchmarkImages<unsigned short>("ushort");
+	BenchmarkImages<float>("float");
+	BenchmarkByteOrder();
+	BenchmarkPacking();
+}
@@ -0,0 +1,47 @@
+/** This file contains the benchmarks of the functions defined in image_codec.h */
+#include "../Imaging/image_codec.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "benchmarks.h"
+
+// Decoding Lenna.png of the tests into a frame which keeps its memory after the warm-up,
+// and decoding 16 copies of it by ReadImages(). Skipped if Lenna.png is not in the working
+// directory.
+void BenchmarkImageCodecs(void)
+{
+	using namespace Imaging;
+
+	const std::string path = "Lenna.png";
+	if (!std::ifstream(path))
+	{
+		std::cout << "Image codecs skipped: " << path << " is not found." << std::endl;
+		return;
+	}
+	ImageFrame<unsigned char> img;
+	ReadImage(path, img);
+	const double nPixels = static_cast<double>(img.size.width * img.size.height);
+
+	RunBenchmark(GetBenchmarkName("ReadImage", "uchar", img.size, img.depth, "PNG"),
+		img.depth * nPixels, nPixels, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			ReadImage(path, img);
+			DoNotOptimize(img);
+		}
+	});
+
+	std::vector<std::string> paths(16, path);
+	std::vector<ImageFrame<unsigned char>> images;
+	RunBenchmark(GetBenchmarkName("ReadImages", "uchar", img.size, img.depth,
+		"16 PNG files"), 16 * img.depth * nPixels, 16 * nPixels, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			ReadImages(paths, images);
+			DoNotOptimize(images);
+		}
+	});
+}
@@ -0,0 +1,53 @@
+/** This file contains the benchmarks of the functions defined in image_expression.h */
+#include "../Imaging/image_expression.h"
+#include "../Utilities/parallel.h"
+
+#include "benchmarks.h"
+
+// (a - b) * gain + offset on 12 MP 12-bit frames by an expression evaluated in one pass,
+// and by a loop per operator through temporary frames.
+void BenchmarkImageExpressions(void)
+{
+	using namespace Imaging;
+
+	const Size2D<::size_t> sz(4000, 3000);
+	const ::size_t nPixels = sz.width * sz.height;
+	ImageFrame<unsigned short> a(sz.width, sz.height, 1), b(sz.width, sz.height, 1);
+	for (::size_t I = 0; I != nPixels; ++I)
+	{
+		*(a.GetPointer(0, 0) + I) = static_cast<unsigned short>(I * 2654435761u >> 20);
+		*(b.GetPointer(0, 0) + I) = static_cast<unsigned short>(I * 2246822519u >> 20);
+	}
+	ImageFrame<float> dst(sz.width, sz.height, 1), diff(sz.width, sz.height, 1),
+		scaled(sz.width, sz.height, 1);
+	const float gain = 1.5f, offset = 100.0f;
+
+	RunBenchmark(GetBenchmarkName("(a - b) * gain + offset", "ushort", sz, 1, "expression"),
+		8.0 * nPixels, static_cast<double>(nPixels), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			dst = (a - b) * gain + offset;
+			DoNotOptimize(dst);
+		}
+	}, GetThreadCount() == 1);
+
+	RunBenchmark(GetBenchmarkName("(a - b) * gain + offset", "ushort", sz, 1,
+		"temporary frames"), 24.0 * nPixels, static_cast<double>(nPixels),
+		[&](unsigned long long n)
+	{
+		const unsigned short *pa = a.GetPointer(0, 0), *pb = b.GetPointer(0, 0);
+		float *pDiff = diff.GetPointer(0, 0), *pScaled = scaled.GetPointer(0, 0),
+			*pDst = dst.GetPointer(0, 0);
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			for (::size_t J = 0; J != nPixels; ++J)
+				pDiff[J] = static_cast<float>(pa[J] - pb[J]);
+			for (::size_t J = 0; J != nPixels; ++J)
+				pScaled[J] = pDiff[J] * gain;
+			for (::size_t J = 0; J != nPixels; ++J)
+				pDst[J] = pScaled[J] + offset;
+			DoNotOptimize(dst);
+		}
+	}, true);
+}
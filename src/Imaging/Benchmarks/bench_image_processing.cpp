@@ -0,0 +1,54 @@
+/** This file contains the benchmarks of the functions defined in image_processing.h */
+#include "../Imaging/image_processing.h"
+
+#include "benchmarks.h"
+
+template <typename T>
+void BenchmarkResize(const std::string &typeName)
+{
+	using namespace Imaging;
+
+	const Size2D<::size_t> sizes[] = {Size2D<::size_t>(640, 480),
+		Size2D<::size_t>(1920, 1080)};
+	const ::size_t depths[] = {1, 3};
+	const Interpolation interps[] = {Interpolation::NEAREST, Interpolation::LINEAR,
+		Interpolation::AREA, Interpolation::CUBIC, Interpolation::LANCZO};
+	const char *interpNames[] = {"nearest", "linear", "area", "cubic", "lanczos"};
+	const double zooms[] = {0.5, 2.0};
+
+	for (const auto &sz : sizes)
+		for (auto d : depths)
+		{
+			ImageFrame<T> imgSrc(sz.width, sz.height, d), imgDst;
+			for (::size_t I = 0; I != imgSrc.data.size(); ++I)
+				*(imgSrc.GetPointer(0, 0) + I) = static_cast<T>(I % 251);
+
+			for (::size_t I = 0; I != 5; ++I)
+				for (auto zm : zooms)
+				{
+					// Bytes are those of the source and the destination, and pixels are those
+					// of the destination.
+					Resize(imgSrc, Point2D<double>(zm, zm), imgDst, interps[I]);
+					const double nPixels = static_cast<double>(imgDst.size.width) *
+						imgDst.size.height;
+					const double bytes = (imgSrc.data.size() + imgDst.data.size()) * sizeof(T);
+					RunBenchmark(GetBenchmarkName("Resize", typeName, sz, d,
+						std::string(interpNames[I]) + (zm < 1.0 ? "/x0.5" : "/x2")), bytes,
+						nPixels, [&](unsigned long long n)
+					{
+						for (unsigned long long J = 0; J != n; ++J)
+						{
+							Resize(imgSrc, Point2D<double>(zm, zm), imgDst, interps[I]);
+							DoNotOptimize(imgDst);
+						}
+					});
+				}
+		}
+}
+
+void BenchmarkImageProcessing(void)
+{
+	BenchmarkResize<unsigned char>("uchar");
+	BenchmarkResize<unsigned short>("ushort");
+	BenchmarkResize<float>("float");
+}
@@ -0,0 +1,57 @@
+/** This file contains the benchmarks of the classes and functions defined in
+lookup_table.h */
+#include "../Imaging/lookup_table.h"
+#include "../Utilities/parallel.h"
+
+#include <limits>
+
+#include "benchmarks.h"
+
+// Gamma of a 12 MP frame by a shared table, and a color map of a gray frame into 3
+// channels. The destination keeps its memory after the warm-up.
+template <typename T>
+void BenchmarkLookupTables(const std::string &typeName, const Imaging::Size2D<::size_t> &sz)
+{
+	using namespace Imaging;
+
+	const ::size_t nPixels = sz.width * sz.height;
+	std::vector<T> samples(nPixels);
+	for (::size_t I = 0; I != samples.size(); ++I)
+		samples[I] = static_cast<T>(I * 2654435761u >> 7);
+	const ImageFrame<T> imgSrc(std::move(samples), sz, 1);
+	ImageFrame<T> imgDst;
+	const bool allocationFree = GetThreadCount() == 1;
+
+	LookupTable<T, T> gamma(1);
+	SetGamma(0.45, gamma);
+	RunBenchmark(GetBenchmarkName("Apply", typeName, sz, 1, "gamma"),
+		2.0 * nPixels * sizeof(T), nPixels, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			Apply(imgSrc, gamma, imgDst);
+			DoNotOptimize(imgDst);
+		}
+	}, allocationFree);
+
+	LookupTable<T, T> colorMap(3, [](T v, ::size_t c)
+	{
+		return static_cast<T>(c == 1 ? std::numeric_limits<T>::max() - v : v);
+	});
+	RunBenchmark(GetBenchmarkName("Apply", typeName, sz, 1, "color map"),
+		4.0 * nPixels * sizeof(T), nPixels, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			Apply(imgSrc, colorMap, imgDst);
+			DoNotOptimize(imgDst);
+		}
+	}, allocationFree);
+}
+
+void BenchmarkLookupTables(void)
+{
+	const Imaging::Size2D<::size_t> sz(4000, 3000);
+	BenchmarkLookupTables<unsigned char>("uchar", sz);
+	BenchmarkLookupTables<unsigned short>("ushort", sz);
+}
@@ -0,0 +1,93 @@
+/** This file contains the benchmarks of the functions defined in morphology.h */
+#include "../Imaging/morphology.h"
+
+#include "benchmarks.h"
+
+#include <algorithm>
+#include <limits>
+
+// Masks of a 10 MP inspection camera. A plain loop over the rectangle at every pixel is
+// the reference of the separable filters; its time grows with the area of the rectangle,
+// and that of van Herk and Gil-Werman does not. The filters keep their temporary frame
+// and lines in a buffer across frames.
+template <typename T>
+void BenchmarkMorphologies(const std::string &typeName, const Imaging::Size2D<::size_t> &sz)
+{
+	using namespace Imaging;
+
+	const ::size_t nPixels = sz.width * sz.height;
+	const double bytes = 2.0 * nPixels * sizeof(T);
+	std::vector<T> samples(nPixels);
+	for (::size_t I = 0; I != samples.size(); ++I)
+		samples[I] = static_cast<T>((I * 2654435761u >> 11) % 7 != 0 ? 255 : 0);
+	const ImageFrame<T> imgSrc(std::move(samples), sz, 1);
+	ImageFrame<T> imgDst;
+	MorphologyBuffer<T> buffer;
+	const bool allocationFree = GetThreadCount() == 1;
+
+	for (::size_t k : {3, 15})
+		RunBenchmark(GetBenchmarkName("Erode", typeName, sz, 1,
+			std::to_string(k) + "x" + std::to_string(k) + " plain loop"), bytes, nPixels,
+			[&](unsigned long long n)
+		{
+			imgDst.Reset(sz, 1);
+			const ::size_t a = k / 2;
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				for (::size_t Y = 0; Y != sz.height; ++Y)
+					for (::size_t X = 0; X != sz.width; ++X)
+					{
+						T value = std::numeric_limits<T>::max();
+						const ::size_t yEnd = std::min(sz.height, Y + k - a);
+						const ::size_t xEnd = std::min(sz.width, X + k - a);
+						for (::size_t y = Y < a ? 0 : Y - a; y < yEnd; ++y)
+							for (::size_t x = X < a ? 0 : X - a; x < xEnd; ++x)
+								value = std::min(value, *imgSrc.GetPointer(x, y));
+						*imgDst.GetPointer(X, Y) = value;
+					}
+				DoNotOptimize(imgDst);
+			}
+		});
+
+	for (::size_t k : {3, 15, 51, 101})
+		RunBenchmark(GetBenchmarkName("Erode", typeName, sz, 1,
+			std::to_string(k) + "x" + std::to_string(k)), bytes, nPixels,
+			[&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				Erode(imgSrc, Size2D<::size_t>(k, k), imgDst, buffer);
+				DoNotOptimize(imgDst);
+			}
+		}, allocationFree);
+
+	const ImageFrame<unsigned char> disk(std::vector<unsigned char>{0, 1, 1, 1, 0, 1, 1, 1,
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 0}, Size2D<::size_t>(5, 5), 1);
+	RunBenchmark(GetBenchmarkName("Open", typeName, sz, 1, "15x15"), 2.0 * bytes, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			Open(imgSrc, Size2D<::size_t>(15, 15), imgDst, buffer);
+			DoNotOptimize(imgDst);
+		}
+	}, allocationFree);
+
+	RunBenchmark(GetBenchmarkName("Open", typeName, sz, 1, "5x5 disk"), 2.0 * bytes, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			Open(imgSrc, disk, imgDst, buffer);
+			DoNotOptimize(imgDst);
+		}
+	}, allocationFree);
+}
+
+void BenchmarkMorphologies(void)
+{
+	const Imaging::Size2D<::size_t> sz(3648, 2736);
+	BenchmarkMorphologies<unsigned char>("uchar", sz);
+	BenchmarkMorphologies<unsigned short>("ushort", sz);
+	BenchmarkMorphologies<float>("float", sz);
+}
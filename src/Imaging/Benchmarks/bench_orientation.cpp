@@ -0,0 +1,78 @@
+/** This file contains the benchmarks of the functions defined in orientation.h */
+#include "../Imaging/orientation.h"
+
+#include "benchmarks.h"
+
+// Frames of a sideways-mounted 4K sensor. A plain loop over the destination pixels is the
+// reference of the tiled transposition.
+template <typename T>
+void BenchmarkOrientations(const std::string &typeName, const Imaging::Size2D<::size_t> &sz,
+	::size_t d)
+{
+	using namespace Imaging;
+
+	const ::size_t nPixels = sz.width * sz.height;
+	const double bytes = 2.0 * nPixels * d * sizeof(T);
+	std::vector<T> samples(nPixels * d);
+	for (::size_t I = 0; I != samples.size(); ++I)
+		samples[I] = static_cast<T>(I % 251);
+	const ImageFrame<T> imgSrc(std::move(samples), sz, d);
+	ImageFrame<T> imgDst;
+	const bool allocationFree = GetThreadCount() == 1;
+
+	RunBenchmark(GetBenchmarkName("Rotate90", typeName, sz, d, "plain loop"), bytes, nPixels,
+		[&](unsigned long long n)
+	{
+		imgDst.Reset(sz.height, sz.width, d);
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			T *dst = imgDst.GetPointer(0, 0);
+			for (::size_t Y = 0; Y != sz.width; ++Y)
+				for (::size_t X = 0; X != sz.height; ++X, dst += d)
+				{
+					const T *src = imgSrc.GetPointer(Y, sz.height - 1 - X);
+					for (::size_t C = 0; C != d; ++C)
+						dst[C] = src[C];
+				}
+			DoNotOptimize(imgDst);
+		}
+	});
+
+	const std::pair<void (*)(const ImageFrame<T> &, ImageFrame<T> &), const char *> ops[] = {
+		{Rotate90<T>, "Rotate90"}, {Rotate180<T>, "Rotate180"}, {Rotate270<T>, "Rotate270"},
+		{FlipHorizontal<T>, "FlipHorizontal"}, {FlipVertical<T>, "FlipVertical"},
+		{Transpose<T>, "Transpose"}};
+	for (const auto &op : ops)
+		RunBenchmark(GetBenchmarkName(op.second, typeName, sz, d), bytes, nPixels,
+			[&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				op.first(imgSrc, imgDst);
+				DoNotOptimize(imgDst);
+			}
+		}, allocationFree);
+
+	// In place on a square frame.
+	ImageFrame<T> img(sz.height, sz.height, d);
+	RunBenchmark(GetBenchmarkName("Transpose", typeName, Size2D<::size_t>(sz.height,
+		sz.height), d, "in place"), 2.0 * img.data.size() * sizeof(T),
+		sz.height * sz.height, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			Transpose(img);
+			DoNotOptimize(img);
+		}
+	}, allocationFree);
+}
+
+void BenchmarkOrientations(void)
+{
+	const Imaging::Size2D<::size_t> sz(3840, 2160);
+	for (::size_t d : {1, 3, 4})
+	{
+		BenchmarkOrientations<unsigned char>("uchar", sz, d);
+		BenchmarkOrientations<unsigned short>("ushort", sz, d);
+	}
+}
@@ -0,0 +1,41 @@
+/** This file contains the benchmarks of the classes defined in pipeline.h */
+#include "../Imaging/pipeline.h"
+
+#include <chrono>
+#include <thread>
+
+#include "benchmarks.h"
+
+// A pipeline of 40 VGA frames whose middle stage waits 2 ms per frame, like a stage waiting
+// for a device, with 1 and 4 threads on the stage. Items are frames.
+void BenchmarkPipelines(void)
+{
+	using namespace Imaging;
+
+	const Size2D<::size_t> sz(640, 480);
+	const unsigned long long nFrames = 40;
+	for (unsigned int P = 1; P <= 4; P += 3)
+		RunBenchmark(GetBenchmarkName("Pipeline::Run", "uchar", sz, 3,
+			std::to_string(P) + " threads on a 2 ms stage"), 0.0,
+			static_cast<double>(nFrames), [&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				Pipeline pipeline(4);
+				auto ingest = pipeline.AddSource<unsigned char>("ingest", sz, 3,
+					[&](unsigned long long index, ImageFrame<unsigned char> &frame)
+				{
+					*frame.GetPointer(0, 0) = static_cast<unsigned char>(index);
+					return index < nFrames;
+				});
+				auto process = pipeline.AddInPlaceStage<unsigned char>("process", ingest,
+					[](ImageFrame<unsigned char> &)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				}, P);
+				pipeline.AddSink<unsigned char>("write", process,
+					[](unsigned long long, const ImageFrame<unsigned char> &) {});
+				pipeline.Run();
+			}
+		});
+}
@@ -0,0 +1,115 @@
+/** This file contains the benchmarks of the classes defined in pyramid.h */
+#include "../Imaging/pyramid.h"
+
+#include "benchmarks.h"
+
+// Five levels of a 4K frame. The reference blurs and decimates each level in two passes
+// into new frames, as resizing level by level does. A pyramid allocates nothing after the
+// warm-up when it runs on one thread; more threads are started on every level.
+template <typename T>
+void BenchmarkPyramids(const std::string &typeName, const Imaging::Size2D<::size_t> &sz,
+	::size_t d)
+{
+	using namespace Imaging;
+
+	const ::size_t nLevels = 5, nPixels = sz.width * sz.height;
+	const double bytes = 2.0 * nPixels * d * sizeof(T);
+	std::vector<T> samples(nPixels * d);
+	for (::size_t I = 0; I != samples.size(); ++I)
+		samples[I] = static_cast<T>(I % 251);
+	const ImageFrame<T> imgSrc(std::move(samples), sz, d);
+	const bool allocationFree = GetThreadCount() == 1;
+
+	RunBenchmark(GetBenchmarkName("Pyramid", typeName, sz, d, "two passes"), bytes, nPixels,
+		[&](unsigned long long n)
+	{
+		const int k[] = {1, 4, 6, 4, 1};
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			std::vector<ImageFrame<T>> levels(1, imgSrc);
+			for (::size_t L = 1; L != nLevels; ++L)
+			{
+				const ImageFrame<T> &src = levels.back();
+				const ::size_t w = src.size.width, h = src.size.height;
+				const ::size_t wDst = (w + 1) / 2, hDst = (h + 1) / 2;
+				ImageFrame<float> imgTemp(wDst, h, d);
+				for (::size_t Y = 0; Y != h; ++Y)
+					for (::size_t X = 0; X != wDst; ++X)
+						for (::size_t C = 0; C != d; ++C)
+						{
+							float sum = 0.0f;
+							for (int J = 0; J != 5; ++J)
+							{
+								const ::ptrdiff_t x = std::abs(
+									2 * static_cast<::ptrdiff_t>(X) + J - 2);
+								sum += k[J] * *src.GetPointer(static_cast<::size_t>(x) < w ?
+									x : 2 * (w - 1) - x, Y, C);
+							}
+							*imgTemp.GetPointer(X, Y, C) = sum;
+						}
+				ImageFrame<T> imgDst(wDst, hDst, d);
+				for (::size_t Y = 0; Y != hDst; ++Y)
+					for (::size_t X = 0; X != wDst; ++X)
+						for (::size_t C = 0; C != d; ++C)
+						{
+							float sum = 0.0f;
+							for (int J = 0; J != 5; ++J)
+							{
+								const ::ptrdiff_t y = std::abs(
+									2 * static_cast<::ptrdiff_t>(Y) + J - 2);
+								sum += k[J] * *imgTemp.GetPointer(X,
+									static_cast<::size_t>(y) < h ? y : 2 * (h - 1) - y, C);
+							}
+							*imgDst.GetPointer(X, Y, C) = static_cast<T>(sum / 256.0f +
+								0.5f);
+						}
+				levels.push_back(std::move(imgDst));
+			}
+			DoNotOptimize(levels);
+		}
+	});
+
+	Pyramid<T> pyramid(sz, d, nLevels), laplacian(sz, d, nLevels, true);
+	RunBenchmark(GetBenchmarkName("Pyramid", typeName, sz, d), bytes, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			pyramid.Build(imgSrc);
+			DoNotOptimize(pyramid);
+		}
+	}, allocationFree);
+
+	RunBenchmark(GetBenchmarkName("Pyramid", typeName, sz, d, "Laplacian"), 1.5 * bytes,
+		nPixels, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			laplacian.Build(imgSrc);
+			DoNotOptimize(laplacian);
+		}
+	}, allocationFree);
+
+	// A moving object of 256 x 256 pixels changes between frames.
+	const Region<::size_t, ::size_t> changed(sz.width / 2, sz.height / 2, 256, 256);
+	RunBenchmark(GetBenchmarkName("Pyramid", typeName, sz, d, "Laplacian, update 256x256"),
+		2.0 * changed.GetArea() * d * sizeof(T), changed.GetArea(), [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			laplacian.Update(imgSrc, changed);
+			DoNotOptimize(laplacian);
+		}
+	}, allocationFree);
+}
+
+void BenchmarkPyramids(void)
+{
+	const Imaging::Size2D<::size_t> sz(3840, 2160);
+	for (::size_t d : {1, 3})
+	{
+		BenchmarkPyramids<unsigned char>("uchar", sz, d);
+		BenchmarkPyramids<unsigned short>("ushort", sz, d);
+	}
+	BenchmarkPyramids<float>("float", sz, 1);
+}
@@ -0,0 +1,78 @@
+/** This file contains the benchmarks of the classes defined in statistics.h */
+#include "../Imaging/statistics.h"
+
+#include "benchmarks.h"
+
+// Histograms of a 12 MP frame. A flat frame counts every sample into one bin, which is
+// the worst case of direct bins; noise spreads the samples over all bins. The partial
+// histograms of each range of lines are allocated on every call.
+template <typename T>
+void BenchmarkHistograms(const std::string &typeName, const Imaging::Size2D<::size_t> &sz)
+{
+	using namespace Imaging;
+
+	const ::size_t nPixels = sz.width * sz.height;
+	const double bytes = static_cast<double>(nPixels * sizeof(T));
+	std::vector<T> samples(nPixels);
+	for (::size_t I = 0; I != samples.size(); ++I)
+		samples[I] = static_cast<T>(I * 2654435761u >> 7);
+	const ImageFrame<T> imgFlat(sz, 1), imgNoise(std::move(samples), sz, 1);
+
+	Histogram<T> hist;
+	RunBenchmark(GetBenchmarkName("Histogram", typeName, sz, 1, "flat"), bytes, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			hist.Compute(imgFlat);
+			DoNotOptimize(hist);
+		}
+	});
+
+	RunBenchmark(GetBenchmarkName("Histogram", typeName, sz, 1, "noise"), bytes, nPixels,
+		[&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			hist.Compute(imgNoise);
+			DoNotOptimize(hist);
+		}
+	});
+}
+
+// 256 uniform bins of a noisy 12 MP frame, which also accumulate the min, max, sum and
+// sum of squares.
+template <typename T>
+void BenchmarkUniformHistogram(const std::string &typeName,
+	const Imaging::Size2D<::size_t> &sz, double upper)
+{
+	using namespace Imaging;
+
+	const ::size_t nPixels = sz.width * sz.height;
+	std::vector<T> samples(nPixels);
+	for (::size_t I = 0; I != samples.size(); ++I)
+		samples[I] = static_cast<T>(static_cast<double>(I * 2654435761u >> 7 & 0xFFFF) *
+		upper / 65536.0);
+	const ImageFrame<T> img(std::move(samples), sz, 1);
+
+	Histogram<T> hist(0.0, upper, 256);
+	RunBenchmark(GetBenchmarkName("Histogram", typeName, sz, 1, "uniform"),
+		static_cast<double>(nPixels * sizeof(T)), nPixels, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			hist.Compute(img);
+			DoNotOptimize(hist);
+		}
+	});
+}
+
+void BenchmarkStatistics(void)
+{
+	const Imaging::Size2D<::size_t> sz(4000, 3000);
+	BenchmarkHistograms<unsigned char>("uchar", sz);
+	BenchmarkHistograms<unsigned short>("ushort", sz);
+	BenchmarkUniformHistogram<unsigned char>("uchar", sz, 256.0);
+	BenchmarkUniformHistogram<unsigned short>("ushort", sz, 65536.0);
+	BenchmarkUniformHistogram<float>("float", sz, 1.0);
+}
@@ -0,0 +1,71 @@
+/** This file contains the benchmarks of the functions and classes defined in warp.h */
+#include "../Imaging/warp.h"
+
+#include "benchmarks.h"
+
+#include <cmath>
+
+// A lens undistortion of a 4K camera by a table built once, as a calibrated camera would
+// run every frame, and a rotation, which computes the positions on the fly.
+template <typename T>
+void BenchmarkWarps(const std::string &typeName, const Imaging::Size2D<::size_t> &sz,
+	::size_t d)
+{
+	using namespace Imaging;
+
+	const ::size_t nPixels = sz.width * sz.height;
+	const double bytes = 2.0 * nPixels * d * sizeof(T);
+	std::vector<T> samples(nPixels * d);
+	for (::size_t I = 0; I != samples.size(); ++I)
+		samples[I] = static_cast<T>(I % 251);
+	const ImageFrame<T> imgSrc(std::move(samples), sz, d);
+	ImageFrame<T> imgDst;
+	const bool allocationFree = GetThreadCount() == 1;
+
+	const double cx = 0.5 * sz.width, cy = 0.5 * sz.height;
+	const double k1 = 0.05 / (cx * cx + cy * cy);
+	RemapTable table(sz);
+	table.Fill([=](::size_t x, ::size_t y)
+	{
+		const double dx = x - cx, dy = y - cy, r = 1.0 + k1 * (dx * dx + dy * dy);
+		return Point2D<double>(cx + dx * r, cy + dy * r);
+	});
+
+	const std::pair<Interpolation, const char *> interps[] = {
+		{Interpolation::NEAREST, "nearest"}, {Interpolation::LINEAR, "linear"},
+		{Interpolation::CUBIC, "cubic"}};
+	for (const auto &interp : interps)
+		RunBenchmark(GetBenchmarkName("Remap", typeName, sz, d,
+			std::string("undistort/") + interp.second), bytes, nPixels,
+			[&](unsigned long long n)
+		{
+			for (unsigned long long I = 0; I != n; ++I)
+			{
+				Remap(imgSrc, table, imgDst, interp.first);
+				DoNotOptimize(imgDst);
+			}
+		}, allocationFree);
+
+	// Rotation by 10 degrees about the center.
+	const double c = std::cos(0.1745329), s = std::sin(0.1745329);
+	const std::array<double, 6> m = {{c, -s, cx - c * cx + s * cy,
+		s, c, cy - s * cx - c * cy}};
+	RunBenchmark(GetBenchmarkName("WarpAffine", typeName, sz, d, "rotate/linear"), bytes,
+		nPixels, [&](unsigned long long n)
+	{
+		for (unsigned long long I = 0; I != n; ++I)
+		{
+			WarpAffine(imgSrc, m, sz, imgDst);
+			DoNotOptimize(imgDst);
+		}
+	}, allocationFree);
+}
+
+void BenchmarkWarps(void)
+{
+	const Imaging::Size2D<::size_t> sz(3840, 2160);
+	BenchmarkWarps<unsigned char>("uchar", sz, 1);
+	BenchmarkWarps<unsigned char>("uchar", sz, 3);
+	BenchmarkWarps<unsigned short>("ushort", sz, 1);
+	BenchmarkWarps<float>("float", sz, 1);
+}
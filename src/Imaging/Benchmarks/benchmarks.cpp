@@ -0,0 +1,234 @@
+/** Runs the benchmarks of the primitives of Imaging, and prints the results in a table or
+writes them in the JSON format of Google Benchmark, so they can be compared between
+releases by its tools.
+
+Benchmarks [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]
+	[--benchmark_out=<file.json>] [--kernel_level=baseline|sse4.1|avx2|avx512] */
+
+#include "benchmarks.h"
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../Imaging/kernels.h"
+#include "../Utilities/memory_tracker.h"
+#include "../Utilities/parallel.h"
+
+// Counts the allocations of each benchmark.
+IMAGING_DEFINE_ALLOCATION_HOOKS()
+
+namespace
+{
+	class BenchmarkResult
+	{
+	public:
+		std::string name;
+		unsigned long long iterations;
+		double nsPerIteration, bytesPerSecond, itemsPerSecond, allocationsPerIteration,
+			allocatedBytesPerIteration;
+	};
+
+	std::regex filter(".*");
+	double minSeconds = 0.2;
+	std::vector<BenchmarkResult> results;
+
+	std::string Escape(const std::string &src)
+	{
+		std::string dst;
+		for (auto c : src)
+		{
+			if (c == '"' || c == '\\')
+				dst.push_back('\\');
+			dst.push_back(c);
+		}
+		return dst;
+	}
+
+	void WriteJson(const std::string &path)
+	{
+		std::ofstream out(path);
+		if (!out)
+			throw std::runtime_error("Failed to open " + path + ".");
+
+		std::time_t now = std::time(nullptr);
+		char date[32];
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+		out << "{\n  \"context\": {\n" <<
+			"    \"date\": \"" << date << "\",\n" <<
+			"    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n" <<
+			"    \"num_threads\": " << Imaging::GetThreadCount() << ",\n" <<
+			"    \"cpu_simd_level\": \"" << GetSimdLevelName(Imaging::GetCpuSimdLevel()) <<
+			"\",\n" <<
+			"    \"kernel_level\": \"" << GetSimdLevelName(Imaging::GetKernelLevel()) <<
+			"\",\n" <<
+#if defined(NDEBUG)
+			"    \"library_build_type\": \"release\"\n" <<
+#else
+			"    \"library_build_type\": \"debug\"\n" <<
+#endif
+			"  },\n  \"benchmarks\": [";
+		out << std::setprecision(10);
+		for (::size_t I = 0; I != results.size(); ++I)
+		{
+			const BenchmarkResult &r = results[I];
+			out << (I == 0 ? "\n" : ",\n") << "    {\n" <<
+				"      \"name\": \"" << Escape(r.name) << "\",\n" <<
+				"      \"run_name\": \"" << Escape(r.name) << "\",\n" <<
+				"      \"run_type\": \"iteration\",\n" <<
+				"      \"iterations\": " << r.iterations << ",\n" <<
+				"      \"real_time\": " << r.nsPerIteration << ",\n" <<
+				"      \"cpu_time\": " << r.nsPerIteration << ",\n" <<
+				"      \"time_unit\": \"ns\",\n" <<
+				"      \"bytes_per_second\": " << r.bytesPerSecond << ",\n" <<
+				"      \"items_per_second\": " << r.itemsPerSecond << ",\n" <<
+				"      \"allocations_per_iteration\": " << r.allocationsPerIteration << ",\n" <<
+				"      \"allocated_bytes_per_iteration\": " << r.allocatedBytesPerIteration <<
+				"\n    }";
+		}
+		out << "\n  ]\n}\n";
+	}
+}
+
+std::string GetBenchmarkName(const std::string &primitive, const std::string &typeName,
+	const Imaging::Size2D<::size_t> &sz, ::size_t d, const std::string &variant)
+{
+	std::ostringstream name;
+	name << primitive << "/" << typeName << "/" << sz.width << "x" << sz.height << "x" << d;
+	if (!variant.empty())
+		name << "/" << variant;
+	return name.str();
+}
+
+void RunBenchmark(const std::string &name, double bytes, double items,
+	const std::function<void(unsigned long long)> &func, bool allocationFree)
+{
+	using Imaging::MemoryTracker;
+
+	if (!std::regex_search(name, filter))
+		return;
+
+	// The warm-up sizes the destinations, so later iterations show the steady state.
+	func(1);
+
+	// Grows n by the ratio to the minimum time like Google Benchmark, at most by 10 times.
+	unsigned long long n = 1, allocations = 0, allocatedBytes = 0;
+	double seconds = 0.0;
+	for (;;)
+	{
+		const unsigned long long count0 = MemoryTracker::GetAllocationCount();
+		const unsigned long long bytes0 = MemoryTracker::GetAllocatedBytes();
+		auto t0 = std::chrono::steady_clock::now();
+		func(n);
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		allocations = MemoryTracker::GetAllocationCount() - count0;
+		allocatedBytes = MemoryTracker::GetAllocatedBytes() - bytes0;
+		if (seconds >= minSeconds)
+			break;
+		double multiplier = seconds > 0.0 ? minSeconds * 1.4 / seconds : 10.0;
+		if (multiplier > 10.0)
+			multiplier = 10.0;
+		n = static_cast<unsigned long long>(n * multiplier) + 1;
+	}
+
+	BenchmarkResult r;
+	r.name = name;
+	r.iterations = n;
+	r.nsPerIteration = seconds * 1e9 / n;
+	r.bytesPerSecond = bytes * n / seconds;
+	r.itemsPerSecond = items * n / seconds;
+	r.allocationsPerIteration = static_cast<double>(allocations) / n;
+	r.allocatedBytesPerIteration = static_cast<double>(allocatedBytes) / n;
+	results.push_back(r);
+
+	std::cout << std::left << std::setw(48) << name << std::right << std::fixed <<
+		std::setprecision(1) << std::setw(14) << r.nsPerIteration << std::setw(12) << n <<
+		std::setprecision(3) << std::setw(10) << r.bytesPerSecond / 1e9 <<
+		std::setw(12) << r.itemsPerSecond / 1e6 << std::setprecision(1) << std::setw(12) <<
+		r.allocationsPerIteration << std::endl;
+	if (allocationFree && allocations != 0)
+		throw std::logic_error(name + " allocates in the steady state.");
+}
+
+int main(int argc, char *argv[])
+{
+	try
+	{
+		std::string outPath;
+		for (int I = 1; I < argc; ++I)
+		{
+			const std::string arg(argv[I]);
+			auto Value = [&arg](const std::string &key) -> const char *
+			{
+				return arg.compare(0, key.size(), key) == 0 ? arg.c_str() + key.size() : nullptr;
+			};
+			if (const char *value = Value("--benchmark_filter="))
+				filter = std::regex(value);
+			else if (const char *value = Value("--benchmark_min_time="))
+				minSeconds = std::stod(value);
+			else if (const char *value = Value("--benchmark_out="))
+				outPath = value;
+			else if (const char *value = Value("--kernel_level="))
+			{
+				const Imaging::SimdLevel levels[] = {Imaging::SimdLevel::BASELINE,
+					Imaging::SimdLevel::SSE41, Imaging::SimdLevel::AVX2,
+					Imaging::SimdLevel::AVX512};
+				bool found = false;
+				for (auto level : levels)
+					if (std::string(value) == Imaging::GetSimdLevelName(level))
+					{
+						Imaging::SetKernelLevel(level);
+						found = true;
+					}
+				if (!found)
+					throw std::invalid_argument("Unknown kernel level " + std::string(value) + ".");
+			}
+			else
+				throw std::invalid_argument("Unknown option " + arg + ".");
+		}
+
+		std::cout << "Kernels: " << GetSimdLevelName(Imaging::GetKernelLevel()) << std::endl;
+		std::cout << std::left << std::setw(48) << "Benchmark" << std::right <<
+			std::setw(14) << "ns/iter" << std::setw(12) << "Iterations" << std::setw(10) <<
+			"GB/s" << std::setw(12) << "Mitems/s" << std::setw(12) << "Allocs/iter" <<
+			std::endl;
+		BenchmarkCoordinates();
+		BenchmarkImages();
+		BenchmarkWarps();
+		BenchmarkOrientations();
+		BenchmarkPyramids();
+		BenchmarkMorphologies();
+		BenchmarkStatistics();
+		BenchmarkDetection();
+		BenchmarkFrameReaders();
+		BenchmarkLookupTables();
+		BenchmarkColorConversions();
+		BenchmarkDemosaic();
+		BenchmarkFrameWriters();
+		BenchmarkImageCodecs();
+		BenchmarkChunkedCubes();
+		BenchmarkFrameCompression();
+		BenchmarkFrameRings();
+		BenchmarkPipelines();
+		BenchmarkImageExpressions();
+#if !defined(IMAGING_NO_OPENCV)
+		BenchmarkImageProcessing();
+#endif
+
+		if (!outPath.empty())
+			WriteJson(outPath);
+	}
+	catch (const std::exception &ex)
+	{
+		std::cout << ex.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,63 @@
+#if !defined(BENCHMARKS_H)
+#define BENCHMARKS_H
+
+#include <functional>
+#include <string>
+
+#include "../Imaging/coordinates.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/** Runs a benchmark and records its result, if its name matches the filter.
+
+func(n) runs n iterations of the measured code. After a warm-up iteration, n is increased
+until a run takes the minimum time, and the last run is reported as nanoseconds per
+iteration, bytes per second, items per second and heap allocations per iteration. bytes
+are the bytes read and written by an iteration, and items are the pixels processed by an
+iteration, or the operations for the coordinate operators.
+@param [in] allocationFree	whether iterations after the warm-up must not allocate
+@exception std::logic_error if allocationFree and the last run allocated */
+void RunBenchmark(const std::string &name, double bytes, double items,
+	const std::function<void(unsigned long long)> &func, bool allocationFree = false);
+
+/** Gets the name of a benchmark on an image as "primitive/type/WxHxD/variant". */
+std::string GetBenchmarkName(const std::string &primitive, const std::string &typeName,
+	const Imaging::Size2D<::size_t> &sz, ::size_t d, const std::string &variant = "");
+
+/** Keeps the compiler from optimizing out a value or the computation of it. */
+template <typename T>
+inline void DoNotOptimize(const T &value)
+{
+#if defined(_MSC_VER)
+	static const void *volatile sink;
+	sink = &value;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+
+void BenchmarkCoordinates(void);
+void BenchmarkImages(void);
+void BenchmarkImageProcessing(void);
+void BenchmarkWarps(void);
+void BenchmarkOrientations(void);
+void BenchmarkPyramids(void);
+void BenchmarkMorphologies(void);
+void BenchmarkStatistics(void);
+void BenchmarkDetection(void);
+void BenchmarkFrameReaders(void);
+void BenchmarkLookupTables(void);
+void BenchmarkColorConversions(void);
+void BenchmarkDemosaic(void);
+void BenchmarkFrameWriters(void);
+void BenchmarkImageCodecs(void);
+void BenchmarkChunkedCubes(void);
+void BenchmarkFrameCompression(void);
+void BenchmarkFrameRings(void);
+void BenchmarkPipelines(void);
+void BenchmarkImageExpressions(void);
+
+#endif
@@ -0,0 +1,239 @@
+#if !defined(CHUNKED_CUBE_H)
+#define CHUNKED_CUBE_H
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "image.h"
+#include "../Utilities/raw_file.h"
+
+namespace Imaging
+{
+	/** Presents the compression of the chunks of a cube file. */
+	enum class CubeCompression {NONE, LZ4};
+
+	/** Options of CubeWriter<T>. */
+	class CubeOptions
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Default constructors.
+		CubeOptions(void) : chunkSize(64, 64), chunkBands(0), format(RawImageFormat::BIP),
+			compression(CubeCompression::LZ4), shuffle(true) {}
+
+		//////////////////////////////////////////////////
+		// Data.
+
+		/** Number of columns and rows of a chunk. */
+		Size2D<::size_t> chunkSize;
+
+		/** Number of bands of a chunk; 0 for all bands.
+
+		Chunks of all bands suit reading spectra of a region, and chunks of a single band
+		suit reading band images. */
+		::size_t chunkBands;
+
+		/** Interleave of the samples within a chunk. */
+		RawImageFormat format;
+
+		CubeCompression compression;
+
+		/** Groups the bytes of samples by significance before compression (see
+		ShuffleBytes()). */
+		bool shuffle;
+	};
+
+	/** Header and geometry of a chunked cube file.
+
+	A cube of width x height x bands samples is divided into chunks of chunk width x chunk
+	height x chunk bands; chunks at the right, bottom and last bands are clipped to the
+	cube. Chunks are stored in the order of band, column and row of chunks, each compressed
+	independently, followed by an index of the position and the number of bytes of every
+	chunk. A chunk whose stored bytes equal its raw bytes is not compressed.
+	The file begins with GetSize() bytes of the header as little-endian 64-bit fields after
+	an 8-byte signature. */
+	class CubeHeader
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Default constructors.
+		CubeHeader(void) : size(0, 0), nBands(0), dataType(0), sampleBytes(0),
+			order(ByteOrder::LITTLE), chunkSize(0, 0), chunkBands(0),
+			format(RawImageFormat::BIP), compression(CubeCompression::NONE), shuffle(false),
+			indexPosition(0) {}
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the number of bytes of the header in a file. */
+		static ::size_t GetSize(void);
+
+		/** Gets the number of chunks along columns, rows and bands. */
+		Size2D<::size_t> GetChunkGrid(void) const;
+		::size_t GetBandChunkCount(void) const;
+		::size_t GetChunkCount(void) const;
+
+		/** Gets the index of the chunk at given position in the grid of chunks. */
+		::size_t GetChunkIndex(::size_t cx, ::size_t cy, ::size_t cb) const;
+
+		/** Gets the region and the bands [first, last) covered by a chunk. */
+		void GetChunkExtent(::size_t index, Region<::size_t, ::size_t> &roi,
+			::size_t &firstBand, ::size_t &lastBand) const;
+
+		/** Gets the distances between samples of a chunk of given extent to the next
+		column, row and band, in samples. */
+		void GetChunkStrides(const Size2D<::size_t> &sz, ::size_t nChunkBands, ::size_t &sx,
+			::size_t &sy, ::size_t &sb) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+		std::vector<unsigned char> ToBytes(void) const;
+
+		/** @exception std::runtime_error	if the bytes are not a valid header */
+		void FromBytes(const unsigned char *src);
+
+		//////////////////////////////////////////////////
+		// Data.
+		Size2D<::size_t> size;
+		::size_t nBands;
+		int dataType;
+		::size_t sampleBytes;
+		ByteOrder order;
+		Size2D<::size_t> chunkSize;
+		::size_t chunkBands;
+		RawImageFormat format;
+		CubeCompression compression;
+		bool shuffle;
+		unsigned long long indexPosition;	// 0 until the file is closed
+	};
+
+	/** Writes a cube into a chunked cube file from rows of BIP frames.
+
+	Rows are collected up to the height of a chunk, and the chunks of these rows are
+	compressed in parallel by ParallelFor() and appended to the file in order, so only one
+	row of chunks is held in memory. */
+	template <typename T>
+	class CubeWriter
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Creates a file for a cube of given dimension.
+
+		@exception std::invalid_argument	if any dimension is 0 or the chunk format is
+		unknown
+		@exception std::runtime_error	if the file cannot be created */
+		CubeWriter(const std::string &path, const Size2D<::size_t> &sz, ::size_t nBands,
+			const CubeOptions &options = CubeOptions());
+
+		CubeWriter(const CubeWriter<T> &src) = delete;
+		CubeWriter<T> &operator=(const CubeWriter<T> &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Destructors.
+
+		/** Closes the file if Close() has not been called, ignoring errors. */
+		~CubeWriter(void);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		const CubeHeader &GetHeader(void) const;
+
+		/** Gets the number of rows written so far. */
+		::size_t GetRowCount(void) const;
+
+		/** Gets the number of bytes of the chunks written so far. */
+		unsigned long long GetStoredBytes(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Appends rows of the cube; a whole cube or consecutive bands of rows of any
+		height.
+
+		@exception std::invalid_argument	if the width or the depth is unmatched
+		@exception std::out_of_range	if the rows exceed the height of the cube */
+		void Write(const ImageFrame<T> &rows);
+
+		/** Writes the index and the header, and closes the file.
+
+		@exception std::logic_error	if not all rows have been written */
+		void Close(void);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void FlushRows(void);
+
+		//////////////////////////////////////////////////
+		// Data.
+		RawFile file_;
+		CubeHeader header_;
+		std::vector<T> rows_;		// BIP rows of the current row of chunks
+		::size_t nRows_, nBufferedRows_;
+		unsigned long long position_;
+		std::vector<std::pair<unsigned long long, unsigned long long>> index_;
+		bool closed_;
+	};
+
+	/** Reads regions and bands of a chunked cube file.
+
+	Only the chunks overlapping a request are read and decompressed, in parallel by
+	ParallelFor(), directly into the destination. Reads may be called from multiple threads
+	at the same time. */
+	template <typename T>
+	class CubeReader
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Opens a cube file and reads its index.
+
+		@exception std::runtime_error	if the file is not a complete cube file, or T is not
+		the type of its samples */
+		CubeReader(const std::string &path);
+
+		CubeReader(const CubeReader<T> &src) = delete;
+		CubeReader<T> &operator=(const CubeReader<T> &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		const CubeHeader &GetHeader(void) const;
+		const Size2D<::size_t> &GetSize(void) const;
+		::size_t GetBandCount(void) const;
+
+		/** Gets the number of chunks decompressed by this object so far. */
+		unsigned long long GetDecodedChunkCount(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Reads all bands of a region as a BIP frame. */
+		void Read(const Region<::size_t, ::size_t> &roi, ImageFrame<T> &dst) const;
+
+		/** Reads bands [firstBand, firstBand + nBands) of a region as a BIP frame.
+
+		@exception std::out_of_range	if the region or the bands are out of the cube */
+		void Read(const Region<::size_t, ::size_t> &roi, ::size_t firstBand, ::size_t nBands,
+			ImageFrame<T> &dst) const;
+
+		/** Reads a whole band as a single-channel frame. */
+		void ReadBand(::size_t band, ImageFrame<T> &dst) const;
+
+	protected:
+		//////////////////////////////////////////////////
+		// Data.
+		RawFile file_;
+		CubeHeader header_;
+		std::vector<std::pair<unsigned long long, unsigned long long>> index_;
+		mutable std::atomic<unsigned long long> nDecoded_;
+	};
+}
+
+#include "chunked_cube_inl.h"
+
+#endif
@@ -0,0 +1,481 @@
+#if !defined(CHUNKED_CUBE_INL_H)
+#define CHUNKED_CUBE_INL_H
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "../Utilities/compression.h"
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	inline void PutLittleEndian64(unsigned long long value, unsigned char *dst)
+	{
+		for (int I = 0; I != 8; ++I)
+			dst[I] = static_cast<unsigned char>(value >> (8 * I));
+	}
+
+	inline unsigned long long GetLittleEndian64(const unsigned char *src)
+	{
+		unsigned long long value = 0;
+		for (int I = 0; I != 8; ++I)
+			value |= static_cast<unsigned long long>(src[I]) << (8 * I);
+		return value;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// CubeHeader class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline ::size_t CubeHeader::GetSize(void)
+	{
+		return 256;
+	}
+
+	inline Size2D<::size_t> CubeHeader::GetChunkGrid(void) const
+	{
+		return Size2D<::size_t>((this->size.width + this->chunkSize.width - 1) /
+			this->chunkSize.width, (this->size.height + this->chunkSize.height - 1) /
+			this->chunkSize.height);
+	}
+
+	inline ::size_t CubeHeader::GetBandChunkCount(void) const
+	{
+		return (this->nBands + this->chunkBands - 1) / this->chunkBands;
+	}
+
+	inline ::size_t CubeHeader::GetChunkCount(void) const
+	{
+		Size2D<::size_t> grid = this->GetChunkGrid();
+		return grid.width * grid.height * this->GetBandChunkCount();
+	}
+
+	inline ::size_t CubeHeader::GetChunkIndex(::size_t cx, ::size_t cy, ::size_t cb) const
+	{
+		return (this->GetChunkGrid().width * cy + cx) * this->GetBandChunkCount() + cb;
+	}
+
+	inline void CubeHeader::GetChunkExtent(::size_t index, Region<::size_t, ::size_t> &roi,
+		::size_t &firstBand, ::size_t &lastBand) const
+	{
+		const ::size_t nBandChunks = this->GetBandChunkCount();
+		const ::size_t gridWidth = this->GetChunkGrid().width;
+		const ::size_t cb = index % nBandChunks, cx = index / nBandChunks % gridWidth;
+		const ::size_t cy = index / nBandChunks / gridWidth;
+		roi.origin = Point2D<::size_t>(this->chunkSize.width * cx, this->chunkSize.height * cy);
+		roi.size = Size2D<::size_t>(
+			std::min(this->chunkSize.width, this->size.width - roi.origin.x),
+			std::min(this->chunkSize.height, this->size.height - roi.origin.y));
+		firstBand = this->chunkBands * cb;
+		lastBand = std::min(firstBand + this->chunkBands, this->nBands);
+	}
+
+	inline void CubeHeader::GetChunkStrides(const Size2D<::size_t> &sz, ::size_t nChunkBands,
+		::size_t &sx, ::size_t &sy, ::size_t &sb) const
+	{
+		switch (this->format)
+		{
+		case RawImageFormat::BSQ:
+			sx = 1;
+			sy = sz.width;
+			sb = sz.width * sz.height;
+			break;
+		case RawImageFormat::BIL:
+			sx = 1;
+			sy = sz.width * nChunkBands;
+			sb = sz.width;
+			break;
+		default:
+			sx = nChunkBands;
+			sy = sz.width * nChunkBands;
+			sb = 1;
+			break;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	inline std::vector<unsigned char> CubeHeader::ToBytes(void) const
+	{
+		std::vector<unsigned char> bytes(GetSize(), 0);
+		std::memcpy(bytes.data(), "IMGCUBE", 8);
+		const unsigned long long fields[15] = {1, this->size.width, this->size.height,
+			this->nBands, static_cast<unsigned long long>(this->dataType), this->sampleBytes,
+			this->order == ByteOrder::BIG ? 1ull : 0ull, this->chunkSize.width,
+			this->chunkSize.height, this->chunkBands,
+			static_cast<unsigned long long>(this->format),
+			static_cast<unsigned long long>(this->compression), this->shuffle ? 1ull : 0ull,
+			this->indexPosition, this->GetChunkCount()};
+		for (int I = 0; I != 15; ++I)
+			PutLittleEndian64(fields[I], bytes.data() + 8 * (I + 1));
+		return bytes;
+	}
+
+	inline void CubeHeader::FromBytes(const unsigned char *src)
+	{
+		unsigned long long fields[15];
+		for (int I = 0; I != 15; ++I)
+			fields[I] = GetLittleEndian64(src + 8 * (I + 1));
+		if (std::memcmp(src, "IMGCUBE", 8) != 0 || fields[0] != 1)
+			throw std::runtime_error("The file is not a chunked cube file.");
+
+		CubeHeader header;
+		header.size = Size2D<::size_t>(static_cast<::size_t>(fields[1]),
+			static_cast<::size_t>(fields[2]));
+		header.nBands = static_cast<::size_t>(fields[3]);
+		header.dataType = static_cast<int>(fields[4]);
+		header.sampleBytes = static_cast<::size_t>(fields[5]);
+		header.order = fields[6] == 1 ? ByteOrder::BIG : ByteOrder::LITTLE;
+		header.chunkSize = Size2D<::size_t>(static_cast<::size_t>(fields[7]),
+			static_cast<::size_t>(fields[8]));
+		header.chunkBands = static_cast<::size_t>(fields[9]);
+		header.format = static_cast<RawImageFormat>(fields[10]);
+		header.compression = static_cast<CubeCompression>(fields[11]);
+		header.shuffle = fields[12] != 0;
+		header.indexPosition = fields[13];
+		if (header.size.width == 0 || header.size.height == 0 || header.nBands == 0 ||
+			header.chunkSize.width == 0 || header.chunkSize.height == 0 ||
+			header.chunkBands == 0 || fields[10] < 1 || fields[10] > 3 || fields[11] > 1 ||
+			fields[14] != header.GetChunkCount())
+			throw std::runtime_error("The header of the chunked cube file is invalid.");
+		*this = header;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// CubeWriter<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	CubeWriter<T>::CubeWriter(const std::string &path, const Size2D<::size_t> &sz,
+		::size_t nBands, const CubeOptions &options) : file_(path, RawFile::Mode::WRITE),
+		nRows_(0), nBufferedRows_(0), position_(CubeHeader::GetSize()), closed_(false)
+	{
+		if (sz.width == 0 || sz.height == 0 || nBands == 0 || options.chunkSize.width == 0 ||
+			options.chunkSize.height == 0)
+			throw std::invalid_argument("The dimension of a cube and its chunks must not be 0.");
+		if (options.format == RawImageFormat::UNKNOWN)
+			throw std::invalid_argument("The format of chunks must be given.");
+
+		this->header_.size = sz;
+		this->header_.nBands = nBands;
+		this->header_.dataType = GetEnviDataType<T>();
+		this->header_.sampleBytes = sizeof(T);
+		this->header_.order = GetNativeByteOrder();
+		this->header_.chunkSize = options.chunkSize;
+		this->header_.chunkBands = options.chunkBands == 0 ? nBands :
+			std::min(options.chunkBands, nBands);
+		this->header_.format = options.format;
+		this->header_.compression = options.compression;
+		this->header_.shuffle = options.shuffle && sizeof(T) > 1;
+
+		std::vector<unsigned char> header = this->header_.ToBytes();
+		this->file_.WriteAt(0, header.data(), header.size());
+		this->rows_.resize(std::min(options.chunkSize.height, sz.height) * sz.width * nBands);
+		this->index_.reserve(this->header_.GetChunkCount());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Destructors.
+	template <typename T>
+	CubeWriter<T>::~CubeWriter(void)
+	{
+		try
+		{
+			this->Close();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	const CubeHeader &CubeWriter<T>::GetHeader(void) const
+	{
+		return this->header_;
+	}
+
+	template <typename T>
+	::size_t CubeWriter<T>::GetRowCount(void) const
+	{
+		return this->nRows_;
+	}
+
+	template <typename T>
+	unsigned long long CubeWriter<T>::GetStoredBytes(void) const
+	{
+		return this->position_ - CubeHeader::GetSize();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	void CubeWriter<T>::Write(const ImageFrame<T> &rows)
+	{
+		const Size2D<::size_t> &sz = this->header_.size;
+		if (this->closed_)
+			throw std::logic_error("The writer has been closed.");
+		if (rows.size.width != sz.width || rows.depth != this->header_.nBands)
+			throw std::invalid_argument("The width or the depth of the rows is unmatched.");
+		if (this->nRows_ + rows.size.height > sz.height)
+			throw std::out_of_range("The rows exceed the height of the cube.");
+
+		const ::size_t nLine = sz.width * this->header_.nBands;
+		for (::size_t Y = 0; Y != rows.size.height; ++Y)
+		{
+			const T *src = rows.data.data() + nLine * Y;
+			std::copy(src, src + nLine, this->rows_.begin() + nLine * this->nBufferedRows_);
+			++this->nBufferedRows_;
+			++this->nRows_;
+			if (this->nBufferedRows_ == this->header_.chunkSize.height ||
+				this->nRows_ == sz.height)
+				this->FlushRows();
+		}
+	}
+
+	template <typename T>
+	void CubeWriter<T>::Close(void)
+	{
+		if (this->closed_)
+			return;
+		this->closed_ = true;
+		if (this->nRows_ != this->header_.size.height)
+		{
+			this->file_.Close();
+			throw std::logic_error("Not all rows of the cube have been written.");
+		}
+
+		std::vector<unsigned char> index(16 * this->index_.size());
+		for (::size_t I = 0; I != this->index_.size(); ++I)
+		{
+			PutLittleEndian64(this->index_[I].first, index.data() + 16 * I);
+			PutLittleEndian64(this->index_[I].second, index.data() + 16 * I + 8);
+		}
+		this->file_.WriteAt(this->position_, index.data(), index.size());
+		this->header_.indexPosition = this->position_;
+		std::vector<unsigned char> header = this->header_.ToBytes();
+		this->file_.WriteAt(0, header.data(), header.size());
+		this->file_.Close();
+	}
+
+	/** Each chunk of the buffered rows is gathered into its interleave, shuffled and
+	compressed on a worker thread; the chunks are then appended in the order of the
+	index. A chunk which does not shrink is stored as is. */
+	template <typename T>
+	void CubeWriter<T>::FlushRows(void)
+	{
+		const CubeHeader &header = this->header_;
+		const ::size_t cy = (this->nRows_ - this->nBufferedRows_) / header.chunkSize.height;
+		const ::size_t nBandChunks = header.GetBandChunkCount();
+		const ::size_t nChunks = header.GetChunkGrid().width * nBandChunks;
+		const ::size_t width = header.size.width, nBands = header.nBands;
+		std::vector<std::vector<unsigned char>> encoded(nChunks);
+
+		ParallelFor(0, nChunks, 1, [&](::size_t first, ::size_t last)
+		{
+			std::vector<T> chunk;
+			std::vector<unsigned char> shuffled;
+			for (::size_t I = first; I != last; ++I)
+			{
+				Region<::size_t, ::size_t> roi;
+				::size_t b0, b1, sx, sy, sb;
+				header.GetChunkExtent(header.GetChunkIndex(I / nBandChunks, cy,
+					I % nBandChunks), roi, b0, b1);
+				header.GetChunkStrides(roi.size, b1 - b0, sx, sy, sb);
+				chunk.resize(roi.GetArea() * (b1 - b0));
+				for (::size_t Y = 0; Y != roi.size.height; ++Y)
+				{
+					const T *src = this->rows_.data() + (width * Y + roi.origin.x) * nBands;
+					for (::size_t X = 0; X != roi.size.width; ++X)
+						for (::size_t B = b0; B != b1; ++B)
+							chunk[sx * X + sy * Y + sb * (B - b0)] = src[nBands * X + B];
+				}
+
+				const ::size_t nBytes = sizeof(T) * chunk.size();
+				const unsigned char *bytes = reinterpret_cast<const unsigned char *>(chunk.data());
+				if (header.shuffle)
+				{
+					shuffled.resize(nBytes);
+					ShuffleBytes(chunk.data(), chunk.size(), sizeof(T), shuffled.data());
+					bytes = shuffled.data();
+				}
+				if (header.compression == CubeCompression::LZ4)
+					Lz4Compress(bytes, nBytes, encoded[I]);
+				if (header.compression == CubeCompression::NONE || encoded[I].size() >= nBytes)
+					encoded[I].assign(bytes, bytes + nBytes);
+			}
+		});
+
+		for (auto it = encoded.cbegin(); it != encoded.cend(); ++it)
+		{
+			this->file_.WriteAt(this->position_, it->data(), it->size());
+			this->index_.push_back(std::make_pair(this->position_,
+				static_cast<unsigned long long>(it->size())));
+			this->position_ += it->size();
+		}
+		this->nBufferedRows_ = 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// CubeReader<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	CubeReader<T>::CubeReader(const std::string &path) : file_(path, RawFile::Mode::READ),
+		nDecoded_(0)
+	{
+		std::vector<unsigned char> bytes(CubeHeader::GetSize());
+		if (this->file_.ReadAt(0, bytes.data(), bytes.size()) != bytes.size())
+			throw std::runtime_error("The file is not a chunked cube file.");
+		this->header_.FromBytes(bytes.data());
+		if (this->header_.dataType != GetEnviDataType<T>() ||
+			this->header_.sampleBytes != sizeof(T))
+			throw std::runtime_error("The data type of the cube is unmatched.");
+		if (this->header_.indexPosition == 0)
+			throw std::runtime_error("The cube file has not been closed.");
+
+		const ::size_t nChunks = this->header_.GetChunkCount();
+		const unsigned long long fileSize = this->file_.GetSize();
+		bytes.resize(16 * nChunks);
+		if (this->file_.ReadAt(this->header_.indexPosition, bytes.data(), bytes.size()) !=
+			bytes.size())
+			throw std::runtime_error("The index of the cube file is truncated.");
+		this->index_.resize(nChunks);
+		for (::size_t I = 0; I != nChunks; ++I)
+		{
+			this->index_[I].first = GetLittleEndian64(bytes.data() + 16 * I);
+			this->index_[I].second = GetLittleEndian64(bytes.data() + 16 * I + 8);
+			if (this->index_[I].first + this->index_[I].second > fileSize)
+				throw std::runtime_error("The index of the cube file is invalid.");
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	const CubeHeader &CubeReader<T>::GetHeader(void) const
+	{
+		return this->header_;
+	}
+
+	template <typename T>
+	const Size2D<::size_t> &CubeReader<T>::GetSize(void) const
+	{
+		return this->header_.size;
+	}
+
+	template <typename T>
+	::size_t CubeReader<T>::GetBandCount(void) const
+	{
+		return this->header_.nBands;
+	}
+
+	template <typename T>
+	unsigned long long CubeReader<T>::GetDecodedChunkCount(void) const
+	{
+		return this->nDecoded_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	void CubeReader<T>::Read(const Region<::size_t, ::size_t> &roi, ImageFrame<T> &dst) const
+	{
+		this->Read(roi, 0, this->header_.nBands, dst);
+	}
+
+	/** Each chunk is decompressed into a buffer of the worker thread, and the part
+	overlapping the request is copied into the destination. */
+	template <typename T>
+	void CubeReader<T>::Read(const Region<::size_t, ::size_t> &roi, ::size_t firstBand,
+		::size_t nBands, ImageFrame<T> &dst) const
+	{
+		const CubeHeader &header = this->header_;
+		if (roi.size.width == 0 || roi.size.height == 0 ||
+			roi.origin.x + roi.size.width > header.size.width ||
+			roi.origin.y + roi.size.height > header.size.height)
+			throw std::out_of_range("The region is out of the cube.");
+		if (nBands == 0 || firstBand + nBands > header.nBands)
+			throw std::out_of_range("The bands are out of the cube.");
+		dst.Reset(roi.size, nBands);
+
+		const ::size_t lastBand = firstBand + nBands;
+		T *base = dst.GetPointer(0, 0);
+		std::vector<::size_t> chunks;
+		for (::size_t cy = roi.origin.y / header.chunkSize.height;
+			cy <= (roi.origin.y + roi.size.height - 1) / header.chunkSize.height; ++cy)
+			for (::size_t cx = roi.origin.x / header.chunkSize.width;
+				cx <= (roi.origin.x + roi.size.width - 1) / header.chunkSize.width; ++cx)
+				for (::size_t cb = firstBand / header.chunkBands;
+					cb <= (lastBand - 1) / header.chunkBands; ++cb)
+					chunks.push_back(header.GetChunkIndex(cx, cy, cb));
+
+		ParallelFor(0, chunks.size(), 1, [&](::size_t first, ::size_t last)
+		{
+			std::vector<unsigned char> stored, raw;
+			std::vector<T> chunk;
+			for (::size_t I = first; I != last; ++I)
+			{
+				const std::pair<unsigned long long, unsigned long long> &entry =
+					this->index_[chunks[I]];
+				Region<::size_t, ::size_t> extent;
+				::size_t b0, b1, sx, sy, sb;
+				header.GetChunkExtent(chunks[I], extent, b0, b1);
+				header.GetChunkStrides(extent.size, b1 - b0, sx, sy, sb);
+				chunk.resize(extent.GetArea() * (b1 - b0));
+				const ::size_t nBytes = sizeof(T) * chunk.size();
+
+				stored.resize(static_cast<::size_t>(entry.second));
+				if (this->file_.ReadAt(entry.first, stored.data(), stored.size()) != stored.size())
+					throw std::runtime_error("The chunk of the cube file is truncated.");
+				const unsigned char *bytes = stored.data();
+				if (stored.size() != nBytes)
+				{
+					raw.resize(nBytes);
+					Lz4Decompress(stored.data(), stored.size(), raw.data(), nBytes);
+					bytes = raw.data();
+				}
+				if (header.shuffle)
+					UnshuffleBytes(bytes, chunk.size(), sizeof(T), chunk.data());
+				else
+					std::memcpy(chunk.data(), bytes, nBytes);
+				if (NeedsSwap(header.order))
+					SwapBytes(chunk.data(), chunk.size());
+				++this->nDecoded_;
+
+				// Overlap of the chunk and the request.
+				const ::size_t x0 = std::max(extent.origin.x, roi.origin.x);
+				const ::size_t x1 = std::min(extent.origin.x + extent.size.width,
+					roi.origin.x + roi.size.width);
+				const ::size_t y0 = std::max(extent.origin.y, roi.origin.y);
+				const ::size_t y1 = std::min(extent.origin.y + extent.size.height,
+					roi.origin.y + roi.size.height);
+				const ::size_t c0 = std::max(b0, firstBand), c1 = std::min(b1, lastBand);
+				for (::size_t Y = y0; Y != y1; ++Y)
+					for (::size_t X = x0; X != x1; ++X)
+					{
+						const T *src = chunk.data() + sx * (X - extent.origin.x) +
+							sy * (Y - extent.origin.y);
+						T *it_dst = base + nBands * (roi.size.width * (Y - roi.origin.y) +
+							X - roi.origin.x);
+						for (::size_t B = c0; B != c1; ++B)
+							it_dst[B - firstBand] = src[sb * (B - b0)];
+					}
+			}
+		});
+	}
+
+	template <typename T>
+	void CubeReader<T>::ReadBand(::size_t band, ImageFrame<T> &dst) const
+	{
+		this->Read(Region<::size_t, ::size_t>(0, 0, this->header_.size.width,
+			this->header_.size.height), band, 1, dst);
+	}
+}
+
+#endif
@@ -0,0 +1,100 @@
+#if !defined(COLOR_CONVERSION_H)
+#define COLOR_CONVERSION_H
+
+#include <vector>
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Presents the standard of the luma and chroma coefficients of YUV (Y'CbCr) data.
+
+	BT601: SDTV, JPEG and most of machine vision cameras
+	BT709: HDTV */
+	enum class YuvStandard {BT601, BT709};
+
+	/** Presents the order of color channels of 3-channel (or 4-channel) BIP images.
+
+	The 4th channel of a 4-channel source, e.g., alpha, is ignored. */
+	enum class ColorOrder {RGB, BGR};
+
+	/** Converts a color image into a gray image by the luma coefficients of BT.601.
+
+	Integral types up to 16-bit are computed in 8-bit fixed point, and other types are
+	computed in double.
+	@NOTE Destination is reset as a single-channel image of the same size; the memory is
+	not reallocated if it already has the same number of samples.
+	@exception std::invalid_argument	if source and destination are the same image */
+	template <typename T>
+	void ColorToGray(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst,
+		ColorOrder order = ColorOrder::RGB);
+
+	/** Copies a gray image into all 3 channels of a color image.
+
+	@exception std::invalid_argument	if source and destination are the same image */
+	template <typename T>
+	void GrayToColor(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst);
+
+	/** Converts an 8-bit color image into a 3-channel YUV (Y, Cb, Cr) image in 8-bit fixed
+	point.
+
+	@param [in] fullRange	true for full range (0 ~ 255, e.g., JPEG), false for video
+	range (Y: 16 ~ 235, Cb/Cr: 16 ~ 240)
+	@exception std::invalid_argument	if a 4-channel source is also the destination */
+	inline void ColorToYuv(const ImageFrame<unsigned char> &imgSrc,
+		ImageFrame<unsigned char> &imgDst, YuvStandard standard = YuvStandard::BT601,
+		bool fullRange = false, ColorOrder order = ColorOrder::RGB);
+
+	/** Converts a 3-channel YUV image into an 8-bit color image in 8-bit fixed point. */
+	inline void YuvToColor(const ImageFrame<unsigned char> &imgSrc,
+		ImageFrame<unsigned char> &imgDst, YuvStandard standard = YuvStandard::BT601,
+		bool fullRange = false, ColorOrder order = ColorOrder::RGB);
+
+	/** Converts semi-planar NV12 data, i.e., a Y plane followed by an interleaved Cb/Cr plane
+	of half width and half height, into an 8-bit color image.
+
+	Each plane may have padding bytes at the end of lines, so the number of bytes per line
+	is given for each plane. */
+	inline void Nv12ToColor(const unsigned char *y, ::size_t bytesPerLineY,
+		const unsigned char *uv, ::size_t bytesPerLineUv, ::size_t width, ::size_t height,
+		ImageFrame<unsigned char> &imgDst, YuvStandard standard = YuvStandard::BT601,
+		bool fullRange = false, ColorOrder order = ColorOrder::RGB);
+
+	/** Converts planar I420 data, i.e., a Y plane followed by a Cb plane and a Cr plane of
+	half width and half height, into an 8-bit color image. */
+	inline void I420ToColor(const unsigned char *y, ::size_t bytesPerLineY,
+		const unsigned char *u, ::size_t bytesPerLineU, const unsigned char *v,
+		::size_t bytesPerLineV, ::size_t width, ::size_t height,
+		ImageFrame<unsigned char> &imgDst, YuvStandard standard = YuvStandard::BT601,
+		bool fullRange = false, ColorOrder order = ColorOrder::RGB);
+
+	/** Converts a color image into a 3-channel HSV image.
+
+	unsigned char: H = 0 ~ 180 (2 degrees per step), S and V = 0 ~ 255, computed in 12-bit
+	fixed point with division tables.
+	float, double: H = 0 ~ 360 degrees, S and V = 0 ~ 1 for sources of 0 ~ 1.
+	@exception std::invalid_argument	if a 4-channel source is also the destination */
+	template <typename T>
+	void ColorToHsv(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst,
+		ColorOrder order = ColorOrder::RGB);
+
+	/** Converts a 3-channel HSV image into a color image.
+
+	The ranges of H, S and V are the same as ColorToHsv(). */
+	template <typename T>
+	void HsvToColor(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst,
+		ColorOrder order = ColorOrder::RGB);
+
+	/** Reorders, drops or duplicates channels.
+
+	Channel c of destination is channel channels[c] of source, e.g., {2, 1, 0} swaps RGB
+	and BGR, and {0, 1, 2} drops alpha from RGBA. */
+	template <typename T>
+	void SwizzleChannels(const ImageFrame<T> &imgSrc,
+		const std::vector<typename ImageFrame<T>::SizeType> &channels,
+		ImageFrame<T> &imgDst);
+}
+
+#include "color_conversion_inl.h"
+
+#endif
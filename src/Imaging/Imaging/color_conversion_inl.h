@@ -0,0 +1,412 @@
+#if !defined(COLOR_CONVERSION_INL_H)
+#define COLOR_CONVERSION_INL_H
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "kernels.h"
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	/** Number of lines per range of parallel loops for color conversion. */
+	const ::size_t colorGrainLines = 16;
+
+	/** Throws an exception if an image is not a 3-channel or 4-channel color image. */
+	inline void CheckColorDepth(::size_t depth)
+	{
+		if (depth != 3 && depth != 4)
+		{
+			std::ostringstream errMsg;
+			errMsg << "Depth " << depth << " is not a color image.";
+			throw std::invalid_argument(errMsg.str());
+		}
+	}
+
+	inline unsigned char Saturate(int v)
+	{
+		return static_cast<unsigned char>(v < 0 ? 0 : (v > 255 ? 255 : v));
+	}
+
+	inline YuvCoefficients GetYuvCoefficients(YuvStandard standard, bool fullRange)
+	{
+		static const YuvCoefficients table[4] = {
+			{66, 129, 25, -38, -74, 112, 112, -94, -18, 16, 298, 409, 100, 208, 516},	// 601
+			{47, 157, 16, -26, -87, 112, 112, -102, -10, 16, 298, 459, 55, 136, 541},	// 709
+			{77, 150, 29, -43, -85, 128, 128, -107, -21, 0, 256, 359, 88, 183, 454},	// 601 full
+			{54, 183, 19, -29, -99, 128, 128, -116, -12, 0, 256, 403, 48, 120, 475}};	// 709 full
+		return table[(fullRange ? 2 : 0) + (standard == YuvStandard::BT709 ? 1 : 0)];
+	}
+
+	/** Converts one YUV pixel into the red, green, blue positions of a destination pixel. */
+	inline void YuvToColorPixel(int y, int u, int v, const YuvCoefficients &k,
+		unsigned char *dst, ::size_t posR, ::size_t posB)
+	{
+		int c = k.cy * (y - k.offsetY) + 128, d = u - 128, e = v - 128;
+		dst[posR] = Saturate((c + k.rv * e) >> 8);
+		dst[1] = Saturate((c - k.gu * d - k.gv * e) >> 8);
+		dst[posB] = Saturate((c + k.bu * d) >> 8);
+	}
+
+	/** Integral types up to 16-bit are weighted by (77, 150, 29) / 256 in int, which does
+	not overflow for 16-bit samples; unsigned ones by the kernels of the current SIMD
+	level. */
+	template <typename T>
+	void ColorToGray(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst, ColorOrder order)
+	{
+		if (&imgSrc == &imgDst)
+			throw std::invalid_argument("Source and destination must be different images.");
+		CheckColorDepth(imgSrc.depth);
+		IMAGING_SCOPED_TIMER("ColorToGray", (imgSrc.depth + 1) * imgSrc.size.width *
+			imgSrc.size.height * sizeof(T), imgSrc.size.width * imgSrc.size.height);
+		imgDst.Reset(imgSrc.size, 1);
+		if (imgSrc.data.empty())
+			return;
+
+		const ::size_t d = imgSrc.depth, width = imgSrc.size.width;
+		const ::size_t posR = order == ColorOrder::RGB ? 0 : 2, posB = 2 - posR;
+		const T *src = imgSrc.data.data();
+		T *dst = imgDst.GetPointer(0, 0);
+		const int index = GetKernelIndex<T>();
+		const auto kernel = std::is_unsigned<T>::value && (index == 0 || index == 1) ?
+			GetKernels().colorToGray[index] : nullptr;
+		ParallelFor(0, imgSrc.size.height, colorGrainLines, [=](::size_t first, ::size_t last)
+		{
+			const T *s = src + d * width * first;
+			T *t = dst + width * first;
+			const ::size_t n = width * (last - first);
+			if (kernel != nullptr)
+				kernel(s, d, n, posR, t);
+			else if (std::is_integral<T>::value && sizeof(T) <= 2)
+				for (::size_t P = 0; P != n; ++P, s += d)
+					t[P] = static_cast<T>((77 * static_cast<int>(s[posR]) +
+						150 * static_cast<int>(s[1]) + 29 * static_cast<int>(s[posB]) + 128) >> 8);
+			else
+				for (::size_t P = 0; P != n; ++P, s += d)
+					t[P] = RoundOrCast<T>(0.299 * static_cast<double>(s[posR]) +
+						0.587 * static_cast<double>(s[1]) + 0.114 * static_cast<double>(s[posB]));
+		});
+	}
+
+	template <typename T>
+	void GrayToColor(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst)
+	{
+		if (&imgSrc == &imgDst)
+			throw std::invalid_argument("Source and destination must be different images.");
+		imgSrc.CheckDepth(1);
+		IMAGING_SCOPED_TIMER("GrayToColor", (imgSrc.depth + 3) * imgSrc.size.width *
+			imgSrc.size.height * sizeof(T), imgSrc.size.width * imgSrc.size.height);
+		imgDst.Reset(imgSrc.size, 3);
+		if (imgSrc.data.empty())
+			return;
+
+		const ::size_t width = imgSrc.size.width;
+		const T *src = imgSrc.data.data();
+		T *dst = imgDst.GetPointer(0, 0);
+		ParallelFor(0, imgSrc.size.height, colorGrainLines, [=](::size_t first, ::size_t last)
+		{
+			for (::size_t P = width * first; P != width * last; ++P)
+				dst[3 * P] = dst[3 * P + 1] = dst[3 * P + 2] = src[P];
+		});
+	}
+
+	inline void ColorToYuv(const ImageFrame<unsigned char> &imgSrc,
+		ImageFrame<unsigned char> &imgDst, YuvStandard standard, bool fullRange,
+		ColorOrder order)
+	{
+		CheckColorDepth(imgSrc.depth);
+		if (&imgSrc == &imgDst && imgSrc.depth != 3)
+			throw std::invalid_argument("Source and destination must be different images.");
+		IMAGING_SCOPED_TIMER("ColorToYuv", (imgSrc.depth + 3) * imgSrc.size.width *
+			imgSrc.size.height, imgSrc.size.width * imgSrc.size.height);
+		imgDst.Reset(imgSrc.size, 3);
+		if (imgSrc.data.empty())
+			return;
+
+		const YuvCoefficients k = GetYuvCoefficients(standard, fullRange);
+		const ::size_t d = imgSrc.depth, width = imgSrc.size.width;
+		const ::size_t posR = order == ColorOrder::RGB ? 0 : 2;
+		const unsigned char *src = imgSrc.data.data();
+		unsigned char *dst = imgDst.GetPointer(0, 0);
+		const auto kernel = GetKernels().colorToYuv;
+		ParallelFor(0, imgSrc.size.height, colorGrainLines, [=](::size_t first, ::size_t last)
+		{
+			kernel(src + d * width * first, d, width * (last - first), posR, k,
+				dst + 3 * width * first);
+		});
+	}
+
+	inline void YuvToColor(const ImageFrame<unsigned char> &imgSrc,
+		ImageFrame<unsigned char> &imgDst, YuvStandard standard, bool fullRange,
+		ColorOrder order)
+	{
+		imgSrc.CheckDepth(3);
+		IMAGING_SCOPED_TIMER("YuvToColor", 6 * imgSrc.size.width * imgSrc.size.height,
+			imgSrc.size.width * imgSrc.size.height);
+		imgDst.Reset(imgSrc.size, 3);
+		if (imgSrc.data.empty())
+			return;
+
+		const YuvCoefficients k = GetYuvCoefficients(standard, fullRange);
+		const ::size_t width = imgSrc.size.width;
+		const ::size_t posR = order == ColorOrder::RGB ? 0 : 2;
+		const unsigned char *src = imgSrc.data.data();
+		unsigned char *dst = imgDst.GetPointer(0, 0);
+		const auto kernel = GetKernels().yuvToColor;
+		ParallelFor(0, imgSrc.size.height, colorGrainLines, [=](::size_t first, ::size_t last)
+		{
+			kernel(src + 3 * width * first, width * (last - first), posR, k,
+				dst + 3 * width * first);
+		});
+	}
+
+	/** Each chroma sample covers 2 x 2 pixels; for an odd width or height, the last column
+	or line of chroma covers one pixel. */
+	inline void Nv12ToColor(const unsigned char *y, ::size_t bytesPerLineY,
+		const unsigned char *uv, ::size_t bytesPerLineUv, ::size_t width, ::size_t height,
+		ImageFrame<unsigned char> &imgDst, YuvStandard standard, bool fullRange,
+		ColorOrder order)
+	{
+		IMAGING_SCOPED_TIMER("Nv12ToColor", 4 * width * height +
+			2 * ((width + 1) / 2) * ((height + 1) / 2), width * height);
+		imgDst.Reset(width, height, 3);
+		if (imgDst.data.empty())
+			return;
+
+		const YuvCoefficients k = GetYuvCoefficients(standard, fullRange);
+		const ::size_t posR = order == ColorOrder::RGB ? 0 : 2, posB = 2 - posR;
+		unsigned char *dst = imgDst.GetPointer(0, 0);
+		ParallelFor(0, height, colorGrainLines, [=](::size_t first, ::size_t last)
+		{
+			for (::size_t Y = first; Y != last; ++Y)
+			{
+				const unsigned char *lineY = y + bytesPerLineY * Y;
+				const unsigned char *lineUv = uv + bytesPerLineUv * (Y / 2);
+				unsigned char *t = dst + 3 * width * Y;
+				for (::size_t X = 0; X != width; ++X, t += 3)
+					YuvToColorPixel(lineY[X], lineUv[2 * (X / 2)], lineUv[2 * (X / 2) + 1], k, t,
+						posR, posB);
+			}
+		});
+	}
+
+	inline void I420ToColor(const unsigned char *y, ::size_t bytesPerLineY,
+		const unsigned char *u, ::size_t bytesPerLineU, const unsigned char *v,
+		::size_t bytesPerLineV, ::size_t width, ::size_t height,
+		ImageFrame<unsigned char> &imgDst, YuvStandard standard, bool fullRange,
+		ColorOrder order)
+	{
+		IMAGING_SCOPED_TIMER("I420ToColor", 4 * width * height +
+			2 * ((width + 1) / 2) * ((height + 1) / 2), width * height);
+		imgDst.Reset(width, height, 3);
+		if (imgDst.data.empty())
+			return;
+
+		const YuvCoefficients k = GetYuvCoefficients(standard, fullRange);
+		const ::size_t posR = order == ColorOrder::RGB ? 0 : 2, posB = 2 - posR;
+		unsigned char *dst = imgDst.GetPointer(0, 0);
+		ParallelFor(0, height, colorGrainLines, [=](::size_t first, ::size_t last)
+		{
+			for (::size_t Y = first; Y != last; ++Y)
+			{
+				const unsigned char *lineY = y + bytesPerLineY * Y;
+				const unsigned char *lineU = u + bytesPerLineU * (Y / 2);
+				const unsigned char *lineV = v + bytesPerLineV * (Y / 2);
+				unsigned char *t = dst + 3 * width * Y;
+				for (::size_t X = 0; X != width; ++X, t += 3)
+					YuvToColorPixel(lineY[X], lineU[X / 2], lineV[X / 2], k, t, posR, posB);
+			}
+		});
+	}
+
+	/** Converts one pixel from RGB into HSV in floating point.
+
+	H is in degrees [0, 360), and S is [0, 1]. V has the same scale as the source. */
+	template <typename T>
+	void ColorToHsvPixel(T r, T g, T b, T &h, T &s, T &v)
+	{
+		T maximum = std::max(r, std::max(g, b)), minimum = std::min(r, std::min(g, b));
+		T diff = maximum - minimum;
+		v = maximum;
+		s = maximum > 0 ? diff / maximum : 0;
+		if (diff <= 0)
+			h = 0;
+		else if (maximum == r)
+			h = 60 * (g - b) / diff;
+		else if (maximum == g)
+			h = 60 * (b - r) / diff + 120;
+		else
+			h = 60 * (r - g) / diff + 240;
+		if (h < 0)
+			h += 360;
+	}
+
+	/** Converts one pixel from HSV into RGB in floating point. */
+	template <typename T>
+	void HsvToColorPixel(T h, T s, T v, T &r, T &g, T &b)
+	{
+		T hh = h / 60;
+		int sector = static_cast<int>(std::floor(hh));
+		T f = hh - sector;
+		sector %= 6;
+		if (sector < 0)
+			sector += 6;
+		T p = v * (1 - s), q = v * (1 - s * f), t = v * (1 - s * (1 - f));
+		switch (sector)
+		{
+		case 0: r = v; g = t; b = p; break;
+		case 1: r = q; g = v; b = p; break;
+		case 2: r = p; g = v; b = t; break;
+		case 3: r = p; g = q; b = v; break;
+		case 4: r = t; g = p; b = v; break;
+		default: r = v; g = p; b = q; break;
+		}
+	}
+
+	/** Computes HSV of 8-bit samples in 12-bit fixed point, where the divisions by V and by
+	(V - min) are replaced by multiplications with tables of reciprocals. */
+	inline void ColorToHsv(const unsigned char *src, ::size_t d, ::size_t n, ::size_t posR,
+		::size_t posB, unsigned char *dst)
+	{
+		const int shift = 12, half = 1 << (shift - 1);
+		int divS[256], divH[256];
+		divS[0] = divH[0] = 0;
+		for (int I = 1; I != 256; ++I)
+		{
+			divS[I] = static_cast<int>((255 << shift) / static_cast<double>(I) + 0.5);
+			divH[I] = static_cast<int>((180 << shift) / (6.0 * I) + 0.5);
+		}
+
+		for (::size_t P = 0; P != n; ++P, src += d, dst += 3)
+		{
+			int r = src[posR], g = src[1], b = src[posB];
+			int v = std::max(r, std::max(g, b)), diff = v - std::min(r, std::min(g, b));
+			int h;
+			if (v == r)
+				h = g - b;
+			else if (v == g)
+				h = b - r + 2 * diff;
+			else
+				h = r - g + 4 * diff;
+			h = (h * divH[diff] + half) >> shift;
+			if (h < 0)
+				h += 180;
+			dst[0] = static_cast<unsigned char>(h);
+			dst[1] = static_cast<unsigned char>((diff * divS[v] + half) >> shift);
+			dst[2] = static_cast<unsigned char>(v);
+		}
+	}
+
+	template <typename T>
+	void ColorToHsv(const T *src, ::size_t d, ::size_t n, ::size_t posR, ::size_t posB,
+		T *dst)
+	{
+		static_assert(std::is_floating_point<T>::value,
+			"HSV is available for only unsigned char and floating point types.");
+		for (::size_t P = 0; P != n; ++P, src += d, dst += 3)
+			ColorToHsvPixel(src[posR], src[1], src[posB], dst[0], dst[1], dst[2]);
+	}
+
+	template <typename T>
+	void ColorToHsv(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst, ColorOrder order)
+	{
+		CheckColorDepth(imgSrc.depth);
+		if (&imgSrc == &imgDst && imgSrc.depth != 3)
+			throw std::invalid_argument("Source and destination must be different images.");
+		IMAGING_SCOPED_TIMER("ColorToHsv", (imgSrc.depth + 3) * imgSrc.size.width *
+			imgSrc.size.height * sizeof(T), imgSrc.size.width * imgSrc.size.height);
+		imgDst.Reset(imgSrc.size, 3);
+		if (imgSrc.data.empty())
+			return;
+
+		const ::size_t d = imgSrc.depth, width = imgSrc.size.width;
+		const ::size_t posR = order == ColorOrder::RGB ? 0 : 2, posB = 2 - posR;
+		const T *src = imgSrc.data.data();
+		T *dst = imgDst.GetPointer(0, 0);
+		ParallelFor(0, imgSrc.size.height, colorGrainLines, [=](::size_t first, ::size_t last)
+		{
+			ColorToHsv(src + d * width * first, d, width * (last - first), posR, posB,
+				dst + 3 * width * first);
+		});
+	}
+
+	/** 8-bit HSV is converted back in float, because the inverse has no division to
+	replace. */
+	inline void HsvToColor(const unsigned char *src, ::size_t n, ::size_t posR, ::size_t posB,
+		unsigned char *dst)
+	{
+		for (::size_t P = 0; P != n; ++P, src += 3, dst += 3)
+		{
+			float r, g, b;
+			HsvToColorPixel(2.0f * src[0], src[1] / 255.0f, static_cast<float>(src[2]), r, g,
+				b);
+			dst[posR] = static_cast<unsigned char>(r + 0.5f);
+			dst[1] = static_cast<unsigned char>(g + 0.5f);
+			dst[posB] = static_cast<unsigned char>(b + 0.5f);
+		}
+	}
+
+	template <typename T>
+	void HsvToColor(const T *src, ::size_t n, ::size_t posR, ::size_t posB, T *dst)
+	{
+		static_assert(std::is_floating_point<T>::value,
+			"HSV is available for only unsigned char and floating point types.");
+		for (::size_t P = 0; P != n; ++P, src += 3, dst += 3)
+			HsvToColorPixel(src[0], src[1], src[2], dst[posR], dst[1], dst[posB]);
+	}
+
+	template <typename T>
+	void HsvToColor(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst, ColorOrder order)
+	{
+		imgSrc.CheckDepth(3);
+		IMAGING_SCOPED_TIMER("HsvToColor", (imgSrc.depth + 3) * imgSrc.size.width *
+			imgSrc.size.height * sizeof(T), imgSrc.size.width * imgSrc.size.height);
+		imgDst.Reset(imgSrc.size, 3);
+		if (imgSrc.data.empty())
+			return;
+
+		const ::size_t width = imgSrc.size.width;
+		const ::size_t posR = order == ColorOrder::RGB ? 0 : 2, posB = 2 - posR;
+		const T *src = imgSrc.data.data();
+		T *dst = imgDst.GetPointer(0, 0);
+		ParallelFor(0, imgSrc.size.height, colorGrainLines, [=](::size_t first, ::size_t last)
+		{
+			HsvToColor(src + 3 * width * first, width * (last - first), posR, posB,
+				dst + 3 * width * first);
+		});
+	}
+
+	/** Source and destination must be different images, because a pixel may be read after
+	it is overwritten. */
+	template <typename T>
+	void SwizzleChannels(const ImageFrame<T> &imgSrc,
+		const std::vector<typename ImageFrame<T>::SizeType> &channels,
+		ImageFrame<T> &imgDst)
+	{
+		if (&imgSrc == &imgDst)
+			throw std::invalid_argument("Source and destination must be different images.");
+		for (auto it = channels.cbegin(); it != channels.cend(); ++it)
+			imgSrc.CheckRange(*it);
+		IMAGING_SCOPED_TIMER("SwizzleChannels", (imgSrc.depth + channels.size()) *
+			imgSrc.size.width * imgSrc.size.height * sizeof(T),
+			imgSrc.size.width * imgSrc.size.height);
+		imgDst.Reset(imgSrc.size, channels.size());
+		if (imgDst.data.empty())
+			return;
+
+		const ::size_t dSrc = imgSrc.depth, dDst = channels.size();
+		const ::size_t width = imgSrc.size.width;
+		const T *src = imgSrc.data.data();
+		T *dst = imgDst.GetPointer(0, 0);
+		const ::size_t *pos = channels.data();
+		ParallelFor(0, imgSrc.size.height, colorGrainLines, [=](::size_t first, ::size_t last)
+		{
+			for (::size_t P = width * first; P != width * last; ++P)
+				for (::size_t C = 0; C != dDst; ++C)
+					dst[dDst * P + C] = src[dSrc * P + pos[C]];
+		});
+	}
+}
+
+#endif
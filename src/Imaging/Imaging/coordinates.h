@@ -156,6 +156,15 @@ namespace Imaging
 
 		//bool Fit(U width, U height) const;
 
+		/** Returns the number of pixels within the region, i.e., width x height. */
+		U GetArea(void) const;
+
+		/** Computes the overlapping region of this region and another region.
+
+		@return false if two regions do not overlap. The size of destination is set as 0 x 0
+		in that case. */
+		bool Intersect(const Region<T, U> &rhs, Region<T, U> &dst) const;
+
 		/** Moves the origin by the given distance. */
 		void Move(const Point2D<T> &dist);
 
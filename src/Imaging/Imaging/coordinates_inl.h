@@ -282,6 +282,35 @@ namespace Imaging
 	//}
 
 
+	template <typename T, typename U>
+	U Region<T, U>::GetArea(void) const
+	{
+		return this->size.width * this->size.height;
+	}
+
+	/** The end points are computed as T, so that a region with a negative origin is handled
+	correctly even if U is an unsigned type. */
+	template <typename T, typename U>
+	bool Region<T, U>::Intersect(const Region<T, U> &rhs, Region<T, U> &dst) const
+	{
+		T x0 = std::max(this->origin.x, rhs.origin.x);
+		T y0 = std::max(this->origin.y, rhs.origin.y);
+		T x1 = std::min(static_cast<T>(this->origin.x + this->size.width),
+			static_cast<T>(rhs.origin.x + rhs.size.width));
+		T y1 = std::min(static_cast<T>(this->origin.y + this->size.height),
+			static_cast<T>(rhs.origin.y + rhs.size.height));
+		if (x1 <= x0 || y1 <= y0)
+		{
+			dst = Region<T, U>(x0, y0, 0, 0);
+			return false;
+		}
+		else
+		{
+			dst = Region<T, U>(x0, y0, static_cast<U>(x1 - x0), static_cast<U>(y1 - y0));
+			return true;
+		}
+	}
+
 	template <typename T, typename U>
 	void Region<T, U>::Move(const Point2D<T> &dist)
 	{
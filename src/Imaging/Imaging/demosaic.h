@@ -0,0 +1,42 @@
+#if !defined(DEMOSAIC_H)
+#define DEMOSAIC_H
+
+#include "image.h"
+#include "color_conversion.h"
+
+namespace Imaging
+{
+	/** Presents the color filter array of a Bayer sensor by the colors of the top-left 2 x 2
+	pixels, line by line. */
+	enum class BayerPattern {RGGB, BGGR, GRBG, GBRG};
+
+	/** Presents the interpolation method of demosaicing.
+
+	BILINEAR: averages the nearest samples of the same color in a 3 x 3 neighborhood.
+	EDGE_AWARE: interpolates green along the direction of smaller gradient with a
+	second-order correction from the center color (Hamilton-Adams), then interpolates red
+	and blue as color differences against the interpolated green. */
+	enum class DemosaicMethod {BILINEAR, EDGE_AWARE};
+
+	/** Converts a raw Bayer mosaic into a 3-channel color image.
+
+	Source is a single-channel image of type T with padding bytes at the end of each line.
+	10-bit and 12-bit samples must be unpacked into 16-bit containers (unsigned short) with
+	bitDepth given, so interpolated values are saturated at the maximum of the bit depth.
+	Lines are processed in parallel bands. Each band keeps only a few lines of the source
+	with the borders mirrored, so no full-size intermediate copy is made, and the border
+	pixels are interpolated the same way as the interior.
+	@NOTE Destination is reset as a 3-channel image of the same size; the memory is not
+	reallocated if it already has the same number of samples.
+	@exception std::invalid_argument	if width or height is less than 2, bytesPerLine is
+	less than the effective bytes per line, or bitDepth is not within (0, 8 x sizeof(T)] */
+	template <typename T>
+	void Demosaic(const void *src, ::size_t width, ::size_t height, ::size_t bytesPerLine,
+		BayerPattern pattern, ImageFrame<T> &imgDst,
+		DemosaicMethod method = DemosaicMethod::BILINEAR, unsigned bitDepth = 8 * sizeof(T),
+		ColorOrder order = ColorOrder::RGB);
+}
+
+#include "demosaic_inl.h"
+
+#endif
@@ -0,0 +1,180 @@
+#if !defined(DEMOSAIC_INL_H)
+#define DEMOSAIC_INL_H
+
+#include <algorithm>
+#include <type_traits>
+
+#include "kernels.h"
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	/** Mirrors a position outside of [0, n) back into the range without repeating the edge,
+	e.g., -1 -> 1 and n -> n - 2, which keeps the parity of the Bayer pattern. */
+	inline ::size_t Reflect(long long i, long long n)
+	{
+		while (i < 0 || i >= n)
+			i = i < 0 ? -i : 2 * (n - 1) - i;
+		return static_cast<::size_t>(i);
+	}
+
+	/** Rolling window of consecutive lines of a Bayer mosaic converted to int.
+
+	Lines above or below the mosaic are mirrored, and each line is widened by 2 mirrored
+	samples at both ends, so the interpolation does not need to check the borders. */
+	template <typename T>
+	class BayerLines
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		BayerLines(const void *src, ::size_t width, ::size_t height, ::size_t bytesPerLine,
+			::size_t nLines) : src_(static_cast<const char *>(src)), width_(width),
+			height_(height), bytesPerLine_(bytesPerLine), top_(0),
+			buffer_((width + 4) * nLines), lines_(nLines)
+		{
+			for (::size_t K = 0; K != nLines; ++K)
+				this->lines_[K] = this->buffer_.data() + (width + 4) * K + 2;
+		}
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the lines of the window from the top. */
+		const int *const *GetLines(void) const
+		{
+			return this->lines_.data();
+		}
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Loads the window where the top line is at given line of the mosaic. */
+		void Load(long long top)
+		{
+			this->top_ = top;
+			for (::size_t K = 0; K != this->lines_.size(); ++K)
+				this->LoadLine(K, top + static_cast<long long>(K));
+		}
+
+		/** Moves the window down by one line, reusing the memory of the top line. */
+		void Advance(void)
+		{
+			std::rotate(this->lines_.begin(), this->lines_.begin() + 1, this->lines_.end());
+			++this->top_;
+			this->LoadLine(this->lines_.size() - 1,
+				this->top_ + static_cast<long long>(this->lines_.size()) - 1);
+		}
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void LoadLine(::size_t k, long long y)
+		{
+			const long long w = static_cast<long long>(this->width_);
+			const T *src = reinterpret_cast<const T *>(this->src_ +
+				this->bytesPerLine_ * Reflect(y, static_cast<long long>(this->height_)));
+			int *dst = this->lines_[k];
+			for (::size_t X = 0; X != this->width_; ++X)
+				dst[X] = src[X];
+			*(dst - 2) = dst[Reflect(-2, w)];
+			*(dst - 1) = dst[1];
+			dst[w] = dst[w - 2];
+			dst[w + 1] = dst[Reflect(w + 1, w)];
+		}
+
+		//////////////////////////////////////////////////
+		// Data.
+		const char *src_;
+		::size_t width_, height_, bytesPerLine_;
+		long long top_;
+		std::vector<int> buffer_;
+		std::vector<int *> lines_;
+	};
+
+	/** Each band of lines keeps a window of 3 source lines for BILINEAR. EDGE_AWARE keeps 7
+	source lines and 3 lines of green, because red and blue of a line need the green of the
+	adjacent lines, which needs 2 more source lines on each side. */
+	template <typename T>
+	void Demosaic(const void *src, ::size_t width, ::size_t height, ::size_t bytesPerLine,
+		BayerPattern pattern, ImageFrame<T> &imgDst, DemosaicMethod method,
+		unsigned bitDepth, ColorOrder order)
+	{
+		static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value &&
+			sizeof(T) <= 2, "Demosaicing is available for only 8-bit and 16-bit unsigned types.");
+		if (width < 2 || height < 2)
+			throw std::invalid_argument("A Bayer mosaic must have at least 2 x 2 pixels.");
+		if (bytesPerLine < width * sizeof(T))
+			throw std::invalid_argument(
+				"The number of bytes per line must be equal or greater than the "
+				"number of effective bytes per line.");
+		if (bitDepth == 0 || bitDepth > 8 * sizeof(T))
+		{
+			std::ostringstream errMsg;
+			errMsg << "Bit depth " << bitDepth << " is out of range.";
+			throw std::invalid_argument(errMsg.str());
+		}
+		IMAGING_SCOPED_TIMER("Demosaic", 4 * width * height * sizeof(T), width * height);
+		imgDst.Reset(width, height, 3);
+
+		// Position of red in the 2 x 2 cell. Blue is at the opposite corner.
+		const ::size_t rx = pattern == BayerPattern::BGGR || pattern == BayerPattern::GRBG;
+		const ::size_t ry = pattern == BayerPattern::BGGR || pattern == BayerPattern::GBRG;
+		const ::size_t posR = order == ColorOrder::RGB ? 0 : 2, posB = 2 - posR;
+		const int maxValue = static_cast<int>((1u << bitDepth) - 1);
+		const bool edgeAware = method == DemosaicMethod::EDGE_AWARE;
+		const ::size_t halo = edgeAware ? 3 : 1;
+		const ::ptrdiff_t w = static_cast<::ptrdiff_t>(width);
+		T *dst = imgDst.GetPointer(0, 0);
+		const KernelTable &kernels = GetKernels();
+		const auto interpolateGreen = kernels.interpolateGreen;
+		const auto bilinearLine = kernels.demosaicBilinearLine[GetKernelIndex<T>()];
+		const auto edgeAwareLine = kernels.demosaicEdgeAwareLine[GetKernelIndex<T>()];
+
+		// Column of the first red or blue sample of a line, which may be out of the mosaic.
+		auto GetChromaColumn = [=](long long y) -> ::ptrdiff_t
+		{
+			return static_cast<::size_t>(y & 1) == ry ? rx : 1 - rx;
+		};
+
+		ParallelFor(0, height, 32, [&](::size_t first, ::size_t last)
+		{
+			BayerLines<T> lines(src, width, height, bytesPerLine, 2 * halo + 1);
+			lines.Load(static_cast<long long>(first) - static_cast<long long>(halo));
+
+			std::vector<int> bufGreen;
+			int *green[3];
+			if (edgeAware)
+			{
+				bufGreen.resize((width + 2) * 3);
+				for (::size_t K = 0; K != 3; ++K)
+					green[K] = bufGreen.data() + (width + 2) * K + 1;
+				long long y = static_cast<long long>(first);
+				interpolateGreen(lines.GetLines(), w, GetChromaColumn(y - 1), maxValue,
+					green[0]);
+				interpolateGreen(lines.GetLines() + 1, w, GetChromaColumn(y), maxValue,
+					green[1]);
+			}
+
+			for (::size_t Y = first; Y != last; ++Y, lines.Advance())
+			{
+				const bool redLine = (Y & 1) == ry;
+				const ::size_t posC = redLine ? posR : posB, posO = redLine ? posB : posR;
+				T *line = dst + 3 * width * Y;
+				if (edgeAware)
+				{
+					interpolateGreen(lines.GetLines() + 2, w,
+						GetChromaColumn(static_cast<long long>(Y) + 1), maxValue, green[2]);
+					edgeAwareLine(lines.GetLines() + 2, green, w,
+						GetChromaColumn(static_cast<long long>(Y)), posC, posO, maxValue, line);
+					std::rotate(green, green + 1, green + 3);
+				}
+				else
+					bilinearLine(lines.GetLines(), w,
+						GetChromaColumn(static_cast<long long>(Y)), posC, posO, line);
+			}
+		});
+	}
+}
+
+#endif
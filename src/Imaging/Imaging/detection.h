@@ -0,0 +1,145 @@
+#if !defined(DETECTION_H)
+#define DETECTION_H
+
+#include <vector>
+
+#include "coordinates.h"
+
+namespace Imaging
+{
+	/** Presents how the scores of overlapping regions are updated during non-maximum
+	suppression.
+
+	HARD: greedy NMS; a region is discarded if it overlaps a kept region more than the
+	threshold.
+	LINEAR: soft-NMS; the score is multiplied by (1 - IoU) if IoU is above the threshold.
+	GAUSSIAN: soft-NMS; the score is multiplied by exp(-IoU^2 / sigma) for any overlap.
+	*/
+	enum class Suppression {HARD, LINEAR, GAUSSIAN};
+
+	/** Computes intersection over union (Jaccard index) of two regions.
+
+	@return 0 if both regions are empty. */
+	template <typename T, typename U>
+	double GetIoU(const Region<T, U> &a, const Region<T, U> &b);
+
+	/** Computes IoU of every pair between two sets of regions.
+
+	The result is stored row by row, i.e., dst[b.size() * I + J] = IoU(a[I], b[J]).
+	@NOTE Destination will be reallocated based on the size of sources. */
+	template <typename T, typename U>
+	void GetIoU(const std::vector<Region<T, U>> &a, const std::vector<Region<T, U>> &b,
+		std::vector<double> &dst);
+
+	/** Stores a set of regions as separate arrays of corner coordinates sorted by score.
+
+	Regions are sorted in descending order of score, so a range of ranks is contiguous in
+	memory and the IoU of a region against the range is computed in one branch-free loop
+	which compilers vectorize.
+	If the set is large, regions are also bucketed in a uniform grid whose cell size is the
+	average extent of a region, so that a query visits only the regions around a given
+	region instead of the whole set.
+
+	Regions are identified by their rank, i.e., the position after sorting.
+	@NOTE GetNeighbors() uses an internal buffer, so it must not be called from multiple
+	threads on the same object. */
+	template <typename T, typename U>
+	class RegionSet
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef ::size_t SizeType;
+
+		/** Minimum number of regions to build the grid. */
+		static const SizeType gridThreshold = 512;
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		RegionSet(const std::vector<Region<T, U>> &regions,
+			const std::vector<double> &scores);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the index of the region in the source set for given rank. */
+		SizeType GetIndex(SizeType rank) const;
+
+		/** Gets the number of regions. */
+		SizeType GetCount(void) const;
+
+		/** Returns true if the regions are bucketed in a grid. */
+		bool HasGrid(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Overwrites the region of a rank with the region of another rank.
+
+		This is used to gather selected regions at the front of the set, so that they can
+		be tested together by the contiguous GetIoU(). */
+		void CopyRegion(SizeType rankSrc, SizeType rankDst);
+
+		/** Computes IoU of a region against the regions of [first, last) by ranks. */
+		void GetIoU(SizeType rank, SizeType first, SizeType last, double *dst) const;
+
+		/** Computes IoU of a region against the regions of given ranks. */
+		void GetIoU(SizeType rank, const std::vector<SizeType> &others,
+			std::vector<double> &dst) const;
+
+		/** Gets the ranks of the regions sharing at least one grid cell with a region.
+
+		The region itself is not included.
+		@NOTE This function must be called only if HasGrid() is true. */
+		void GetNeighbors(SizeType rank, std::vector<SizeType> &dst) const;
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void BuildGrid(void);
+		void GetCells(SizeType rank, SizeType &cx0, SizeType &cy0, SizeType &cx1,
+			SizeType &cy1) const;
+
+		//////////////////////////////////////////////////
+		// Data.
+		std::vector<SizeType> indices_;
+		std::vector<double> x0_, y0_, x1_, y1_, area_;
+
+		double gridX_, gridY_, cellSize_;
+		SizeType nCellsX_, nCellsY_;
+		std::vector<SizeType> cellStart_, cellItems_;
+		mutable std::vector<SizeType> stamps_;
+		mutable SizeType stamp_;
+	};
+
+	/** Selects the regions which are not suppressed by a region of higher score.
+
+	@param [in] regions	candidate regions
+	@param [in] scores	score of each candidate region
+	@param [in] thIoU	IoU threshold; a region overlapping a kept region by more than this
+	value is discarded
+	@param [out] dst	indices of the kept regions in descending order of score
+	*/
+	template <typename T, typename U>
+	void SuppressNonMaxima(const std::vector<Region<T, U>> &regions,
+		const std::vector<double> &scores, double thIoU, std::vector<::size_t> &dst);
+
+	/** Selects the regions by either greedy or soft non-maximum suppression.
+
+	@param [in] regions	candidate regions
+	@param [in,out] scores	score of each candidate region; updated with the decayed score
+	@param [in] thIoU	IoU threshold for HARD and LINEAR
+	@param [in] thScore	regions whose (decayed) score falls below this value are discarded
+	@param [in] method	how the scores of overlapping regions are updated
+	@param [in] sigma	width of the Gaussian penalty for GAUSSIAN
+	@param [out] dst	indices of the kept regions in the order of selection
+	*/
+	template <typename T, typename U>
+	void SuppressNonMaxima(const std::vector<Region<T, U>> &regions,
+		std::vector<double> &scores, double thIoU, double thScore, Suppression method,
+		double sigma, std::vector<::size_t> &dst);
+}
+
+#include "detection_inl.h"
+
+#endif
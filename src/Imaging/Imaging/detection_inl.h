@@ -0,0 +1,424 @@
+#if !defined(DETECTION_INL_H)
+#define DETECTION_INL_H
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace Imaging
+{
+	template <typename T, typename U>
+	double GetIoU(const Region<T, U> &a, const Region<T, U> &b)
+	{
+		Region<T, U> roi;
+		if (!a.Intersect(b, roi))
+			return 0.0;
+		double areaI = static_cast<double>(roi.GetArea());
+		return areaI / (static_cast<double>(a.GetArea()) +
+			static_cast<double>(b.GetArea()) - areaI);
+	}
+
+	/** Corner coordinates of the second set are unpacked once, so that the inner loop runs
+	over plain arrays without branches. */
+	template <typename T, typename U>
+	void GetIoU(const std::vector<Region<T, U>> &a, const std::vector<Region<T, U>> &b,
+		std::vector<double> &dst)
+	{
+		auto nB = b.size();
+		std::vector<double> x0(nB), y0(nB), x1(nB), y1(nB), area(nB);
+		for (::size_t J = 0; J != nB; ++J)
+		{
+			x0[J] = static_cast<double>(b[J].origin.x);
+			y0[J] = static_cast<double>(b[J].origin.y);
+			x1[J] = x0[J] + static_cast<double>(b[J].size.width);
+			y1[J] = y0[J] + static_cast<double>(b[J].size.height);
+			area[J] = static_cast<double>(b[J].size.width) *
+				static_cast<double>(b[J].size.height);
+		}
+
+		dst.resize(a.size() * nB);
+		auto it_dst = dst.begin();
+		for (auto it_a = a.cbegin(), it_a_end = a.cend(); it_a != it_a_end; ++it_a)
+		{
+			double ax0 = static_cast<double>(it_a->origin.x);
+			double ay0 = static_cast<double>(it_a->origin.y);
+			double ax1 = ax0 + static_cast<double>(it_a->size.width);
+			double ay1 = ay0 + static_cast<double>(it_a->size.height);
+			double areaA = (ax1 - ax0) * (ay1 - ay0);
+			double *pDst = &(*it_dst);
+			for (::size_t J = 0; J != nB; ++J)
+			{
+				double w = std::max(0.0, std::min(ax1, x1[J]) - std::max(ax0, x0[J]));
+				double h = std::max(0.0, std::min(ay1, y1[J]) - std::max(ay0, y0[J]));
+				double areaI = w * h;
+				double areaU = areaA + area[J] - areaI;
+				pDst[J] = areaU > 0.0 ? areaI / areaU : 0.0;
+			}
+			it_dst += nB;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// RegionSet<T, U> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+
+	/** Regions are sorted by score with std::stable_sort(), so regions of the same score
+	keep their original order. */
+	template <typename T, typename U>
+	RegionSet<T, U>::RegionSet(const std::vector<Region<T, U>> &regions,
+		const std::vector<double> &scores) : gridX_(0.0), gridY_(0.0), cellSize_(0.0),
+		nCellsX_(0), nCellsY_(0), stamp_(0)
+	{
+		if (regions.size() != scores.size())
+			throw std::invalid_argument(
+			"The number of scores is unmatched with the number of regions.");
+
+		auto n = regions.size();
+		this->indices_.resize(n);
+		std::iota(this->indices_.begin(), this->indices_.end(), 0);
+		std::stable_sort(this->indices_.begin(), this->indices_.end(),
+			[&scores](SizeType a, SizeType b) { return scores[a] > scores[b]; });
+
+		this->x0_.resize(n);
+		this->y0_.resize(n);
+		this->x1_.resize(n);
+		this->y1_.resize(n);
+		this->area_.resize(n);
+		for (SizeType R = 0; R != n; ++R)
+		{
+			const Region<T, U> &roi = regions[this->indices_[R]];
+			this->x0_[R] = static_cast<double>(roi.origin.x);
+			this->y0_[R] = static_cast<double>(roi.origin.y);
+			this->x1_[R] = this->x0_[R] + static_cast<double>(roi.size.width);
+			this->y1_[R] = this->y0_[R] + static_cast<double>(roi.size.height);
+			this->area_[R] = static_cast<double>(roi.size.width) *
+				static_cast<double>(roi.size.height);
+		}
+
+		if (n >= gridThreshold)
+			this->BuildGrid();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+
+	template <typename T, typename U>
+	typename RegionSet<T, U>::SizeType RegionSet<T, U>::GetIndex(SizeType rank) const
+	{
+		return this->indices_[rank];
+	}
+
+	template <typename T, typename U>
+	typename RegionSet<T, U>::SizeType RegionSet<T, U>::GetCount(void) const
+	{
+		return this->indices_.size();
+	}
+
+	template <typename T, typename U>
+	bool RegionSet<T, U>::HasGrid(void) const
+	{
+		return !this->cellStart_.empty();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+
+	/** The cell size starts from the average extent of a region, and it is enlarged if the
+	number of cells would exceed 4 cells per region, e.g., small regions spread over a
+	wide area.
+	Cells are stored in a compressed form; the ranks in cell I are
+	cellItems_[cellStart_[I]] ~ cellItems_[cellStart_[I + 1]]. */
+	template <typename T, typename U>
+	void RegionSet<T, U>::BuildGrid(void)
+	{
+		auto n = this->GetCount();
+		double xMin = *std::min_element(this->x0_.cbegin(), this->x0_.cend());
+		double yMin = *std::min_element(this->y0_.cbegin(), this->y0_.cend());
+		double xMax = *std::max_element(this->x1_.cbegin(), this->x1_.cend());
+		double yMax = *std::max_element(this->y1_.cbegin(), this->y1_.cend());
+
+		double extent = 0.0;
+		for (SizeType R = 0; R != n; ++R)
+			extent += std::max(this->x1_[R] - this->x0_[R], this->y1_[R] - this->y0_[R]);
+		extent /= static_cast<double>(n);
+
+		this->gridX_ = xMin;
+		this->gridY_ = yMin;
+		this->cellSize_ = std::max(extent, 1.0);
+		double maxCells = 4.0 * static_cast<double>(n);
+		double nCells = std::ceil((xMax - xMin) / this->cellSize_ + 1.0) *
+			std::ceil((yMax - yMin) / this->cellSize_ + 1.0);
+		if (nCells > maxCells)
+			this->cellSize_ *= std::sqrt(nCells / maxCells) + 1.0;
+		this->nCellsX_ = static_cast<SizeType>((xMax - xMin) / this->cellSize_) + 1;
+		this->nCellsY_ = static_cast<SizeType>((yMax - yMin) / this->cellSize_) + 1;
+
+		// Count the regions of each cell, and then fill the cells.
+		this->cellStart_.assign(this->nCellsX_ * this->nCellsY_ + 1, 0);
+		SizeType cx0, cy0, cx1, cy1;
+		for (SizeType R = 0; R != n; ++R)
+		{
+			this->GetCells(R, cx0, cy0, cx1, cy1);
+			for (auto Y = cy0; Y <= cy1; ++Y)
+				for (auto X = cx0; X <= cx1; ++X)
+					++this->cellStart_[this->nCellsX_ * Y + X + 1];
+		}
+		std::partial_sum(this->cellStart_.cbegin(), this->cellStart_.cend(),
+			this->cellStart_.begin());
+		this->cellItems_.resize(this->cellStart_.back());
+		std::vector<SizeType> fill(this->cellStart_.cbegin(), this->cellStart_.cend() - 1);
+		for (SizeType R = 0; R != n; ++R)
+		{
+			this->GetCells(R, cx0, cy0, cx1, cy1);
+			for (auto Y = cy0; Y <= cy1; ++Y)
+				for (auto X = cx0; X <= cx1; ++X)
+					this->cellItems_[fill[this->nCellsX_ * Y + X]++] = R;
+		}
+		this->stamps_.assign(n, 0);
+	}
+
+	template <typename T, typename U>
+	void RegionSet<T, U>::GetCells(SizeType rank, SizeType &cx0, SizeType &cy0,
+		SizeType &cx1, SizeType &cy1) const
+	{
+		cx0 = static_cast<SizeType>((this->x0_[rank] - this->gridX_) / this->cellSize_);
+		cy0 = static_cast<SizeType>((this->y0_[rank] - this->gridY_) / this->cellSize_);
+		cx1 = std::min(static_cast<SizeType>((this->x1_[rank] - this->gridX_) /
+			this->cellSize_), this->nCellsX_ - 1);
+		cy1 = std::min(static_cast<SizeType>((this->y1_[rank] - this->gridY_) /
+			this->cellSize_), this->nCellsY_ - 1);
+	}
+
+	template <typename T, typename U>
+	void RegionSet<T, U>::CopyRegion(SizeType rankSrc, SizeType rankDst)
+	{
+		this->indices_[rankDst] = this->indices_[rankSrc];
+		this->x0_[rankDst] = this->x0_[rankSrc];
+		this->y0_[rankDst] = this->y0_[rankSrc];
+		this->x1_[rankDst] = this->x1_[rankSrc];
+		this->y1_[rankDst] = this->y1_[rankSrc];
+		this->area_[rankDst] = this->area_[rankSrc];
+	}
+
+	template <typename T, typename U>
+	void RegionSet<T, U>::GetIoU(SizeType rank, SizeType first, SizeType last,
+		double *dst) const
+	{
+		const double ax0 = this->x0_[rank], ay0 = this->y0_[rank];
+		const double ax1 = this->x1_[rank], ay1 = this->y1_[rank];
+		const double areaA = this->area_[rank];
+		const double *x0 = this->x0_.data(), *y0 = this->y0_.data();
+		const double *x1 = this->x1_.data(), *y1 = this->y1_.data();
+		const double *area = this->area_.data();
+		for (SizeType J = first; J < last; ++J)
+		{
+			double w = std::max(0.0, std::min(ax1, x1[J]) - std::max(ax0, x0[J]));
+			double h = std::max(0.0, std::min(ay1, y1[J]) - std::max(ay0, y0[J]));
+			double areaI = w * h;
+			double areaU = areaA + area[J] - areaI;
+			dst[J - first] = areaU > 0.0 ? areaI / areaU : 0.0;
+		}
+	}
+
+	template <typename T, typename U>
+	void RegionSet<T, U>::GetIoU(SizeType rank, const std::vector<SizeType> &others,
+		std::vector<double> &dst) const
+	{
+		const double ax0 = this->x0_[rank], ay0 = this->y0_[rank];
+		const double ax1 = this->x1_[rank], ay1 = this->y1_[rank];
+		const double areaA = this->area_[rank];
+		dst.resize(others.size());
+		for (SizeType I = 0; I != others.size(); ++I)
+		{
+			SizeType J = others[I];
+			double w = std::max(0.0, std::min(ax1, this->x1_[J]) - std::max(ax0, this->x0_[J]));
+			double h = std::max(0.0, std::min(ay1, this->y1_[J]) - std::max(ay0, this->y0_[J]));
+			double areaI = w * h;
+			double areaU = areaA + this->area_[J] - areaI;
+			dst[I] = areaU > 0.0 ? areaI / areaU : 0.0;
+		}
+	}
+
+	/** A region covering several cells appears in each of them, so the visited regions are
+	marked with a stamp which changes at every call instead of clearing a flag array. */
+	template <typename T, typename U>
+	void RegionSet<T, U>::GetNeighbors(SizeType rank, std::vector<SizeType> &dst) const
+	{
+		if (!this->HasGrid())
+			throw std::logic_error("The grid has not been built.");
+
+		dst.clear();
+		if (++this->stamp_ == 0)
+		{
+			std::fill(this->stamps_.begin(), this->stamps_.end(), 0);
+			this->stamp_ = 1;
+		}
+		this->stamps_[rank] = this->stamp_;
+
+		SizeType cx0, cy0, cx1, cy1;
+		this->GetCells(rank, cx0, cy0, cx1, cy1);
+		for (auto Y = cy0; Y <= cy1; ++Y)
+			for (auto X = cx0; X <= cx1; ++X)
+			{
+				auto cell = this->nCellsX_ * Y + X;
+				for (auto I = this->cellStart_[cell]; I != this->cellStart_[cell + 1]; ++I)
+				{
+					auto R = this->cellItems_[I];
+					if (this->stamps_[R] != this->stamp_)
+					{
+						this->stamps_[R] = this->stamp_;
+						dst.push_back(R);
+					}
+				}
+			}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Non-maximum suppression.
+
+	/** Regions are visited in descending order of score, and a region is kept only if it
+	does not overlap any region kept before.
+	For a small set, kept regions are gathered at the front of the set, and a region is
+	tested against them in blocks of contiguous IoU computation. The test exits at the end
+	of the first block containing an overlap, which is usually the first block because most
+	of the candidates are suppressed by the regions of the highest scores.
+	For a large set, each kept region suppresses the following regions among its neighbors
+	in the grid instead. */
+	template <typename T, typename U>
+	void SuppressNonMaxima(const std::vector<Region<T, U>> &regions,
+		const std::vector<double> &scores, double thIoU, std::vector<::size_t> &dst)
+	{
+		typedef typename RegionSet<T, U>::SizeType SizeType;
+		const SizeType blockSize = 64;
+		RegionSet<T, U> set(regions, scores);
+		auto n = set.GetCount();
+
+		dst.clear();
+		if (set.HasGrid())
+		{
+			std::vector<char> suppressed(n, 0);
+			std::vector<SizeType> neighbors;
+			std::vector<double> iou;
+			for (SizeType R = 0; R != n; ++R)
+			{
+				if (suppressed[R])
+					continue;
+				dst.push_back(set.GetIndex(R));
+				set.GetNeighbors(R, neighbors);
+				set.GetIoU(R, neighbors, iou);
+				for (SizeType I = 0; I != neighbors.size(); ++I)
+					if (neighbors[I] > R && iou[I] > thIoU)
+						suppressed[neighbors[I]] = 1;
+			}
+		}
+		else
+		{
+			std::vector<double> iou(blockSize);
+			SizeType nKept = 0;
+			for (SizeType R = 0; R != n; ++R)
+			{
+				bool keep = true;
+				for (SizeType first = 0; first < nKept && keep; first += blockSize)
+				{
+					auto last = std::min(first + blockSize, nKept);
+					set.GetIoU(R, first, last, iou.data());
+					for (SizeType J = 0; J != last - first; ++J)
+						keep = keep && !(iou[J] > thIoU);
+				}
+				if (keep)
+				{
+					set.CopyRegion(R, nKept);
+					dst.push_back(set.GetIndex(nKept++));
+				}
+			}
+		}
+	}
+
+	/** The region of the highest (decayed) score is selected one at a time from a priority
+	queue. Since decaying a score cannot update an entry inside std::priority_queue, a new
+	entry is pushed instead, and an entry is discarded when it is popped if its score is not
+	the current score of the region any more.
+	A region whose score decays to 0, e.g., any region suppressed by HARD, is not queued
+	again, so it is never selected. */
+	template <typename T, typename U>
+	void SuppressNonMaxima(const std::vector<Region<T, U>> &regions,
+		std::vector<double> &scores, double thIoU, double thScore, Suppression method,
+		double sigma, std::vector<::size_t> &dst)
+	{
+		typedef typename RegionSet<T, U>::SizeType SizeType;
+		if (method == Suppression::GAUSSIAN && sigma <= 0.0)
+			throw std::invalid_argument("Sigma must be greater than 0.");
+
+		RegionSet<T, U> set(regions, scores);
+		auto n = set.GetCount();
+		std::vector<double> current(n);
+		std::vector<char> selected(n, 0);
+		std::priority_queue<std::pair<double, SizeType>> queue;
+		for (SizeType R = 0; R != n; ++R)
+		{
+			current[R] = scores[set.GetIndex(R)];
+			queue.push(std::make_pair(current[R], n - 1 - R));	// ties by rank
+		}
+
+		std::vector<SizeType> neighbors;
+		std::vector<double> iou;
+		dst.clear();
+		while (!queue.empty())
+		{
+			auto top = queue.top();
+			queue.pop();
+			SizeType R = n - 1 - top.second;
+			if (selected[R] || top.first != current[R])
+				continue;	// stale entry
+			if (top.first < thScore)
+				break;
+			selected[R] = 1;
+			dst.push_back(set.GetIndex(R));
+
+			if (set.HasGrid())
+				set.GetNeighbors(R, neighbors);
+			else
+			{
+				neighbors.resize(n);
+				std::iota(neighbors.begin(), neighbors.end(), 0);
+			}
+			set.GetIoU(R, neighbors, iou);
+			for (SizeType I = 0; I != neighbors.size(); ++I)
+			{
+				SizeType J = neighbors[I];
+				if (selected[J] || iou[I] <= 0.0)
+					continue;
+				double weight;
+				switch (method)
+				{
+				case Suppression::HARD:
+					weight = iou[I] > thIoU ? 0.0 : 1.0;
+					break;
+				case Suppression::LINEAR:
+					weight = iou[I] > thIoU ? 1.0 - iou[I] : 1.0;
+					break;
+				case Suppression::GAUSSIAN:
+				default:
+					weight = std::exp(-iou[I] * iou[I] / sigma);
+					break;
+				}
+				if (weight != 1.0)
+				{
+					current[J] *= weight;
+					if (current[J] > 0.0)
+						queue.push(std::make_pair(current[J], n - 1 - J));
+				}
+			}
+		}
+
+		for (SizeType R = 0; R != n; ++R)
+			scores[set.GetIndex(R)] = current[R];
+	}
+}
+
+#endif
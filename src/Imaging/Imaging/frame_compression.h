@@ -0,0 +1,181 @@
+#if !defined(FRAME_COMPRESSION_H)
+#define FRAME_COMPRESSION_H
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "image.h"
+#include "frame_pool.h"
+
+namespace Imaging
+{
+	/** Presents the prediction of a sample from its decoded neighbors of the same channel.
+
+	NONE: no prediction, i.e., the samples themselves are coded
+	LEFT: the left sample, or the upper sample at the first column
+	MED: median edge detector of LOCO-I (JPEG-LS) from the left, upper and upper-left
+	samples, which follows horizontal and vertical edges */
+	enum class FramePredictor {NONE, LEFT, MED};
+
+	/** Lossless compressed copy of an ImageFrame<T> of integral samples.
+
+	Each sample is predicted from its neighbors, and the residuals are zigzag-mapped to
+	unsigned values and packed in blocks of 64 with the number of bits of the largest one.
+	Natural images with moderate noise need a few bits per sample instead of 8 x sizeof(T),
+	and both directions are simple loops over rows without any table. Rows are coded in
+	independent bands of rows, which are compressed and decompressed in parallel by
+	ParallelFor(). */
+	template <typename T>
+	class CompressedFrame
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef typename ImageFrame<T>::SizeType SizeType;
+		typedef typename std::make_unsigned<T>::type Residual;
+		static const SizeType bandRows = 32;
+		static const SizeType blockSize = 64;
+
+		//////////////////////////////////////////////////
+		// Default constructors.
+		CompressedFrame(void);
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		CompressedFrame(const ImageFrame<T> &img, FramePredictor predictor = FramePredictor::MED);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		const Size2D<SizeType> &GetSize(void) const;
+		SizeType GetDepth(void) const;
+		FramePredictor GetPredictor(void) const;
+
+		/** Gets the number of bytes of the frame before and after compression. */
+		::size_t GetRawBytes(void) const;
+		::size_t GetCompressedBytes(void) const;
+
+		/** Gets the number of raw bytes per compressed byte. */
+		double GetRatio(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+		void Compress(const ImageFrame<T> &img, FramePredictor predictor = FramePredictor::MED);
+
+		/** Restores the frame.
+
+		@NOTE Destination is reset to the dimension of the frame; the memory is not
+		reallocated if it already has the same number of samples. */
+		void Decompress(ImageFrame<T> &dst) const;
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void CompressBand(const ImageFrame<T> &img, SizeType first, SizeType last,
+			std::vector<unsigned char> &dst) const;
+		void DecompressBand(const unsigned char *src, SizeType first, SizeType last,
+			ImageFrame<T> &dst) const;
+
+		//////////////////////////////////////////////////
+		// Data.
+		Size2D<SizeType> size_;
+		SizeType depth_;
+		FramePredictor predictor_;
+		std::vector<unsigned char> data_;
+		std::vector<::size_t> bands_;		// position of each band in data_
+	};
+
+	/** Statistics of CompressedFrameHistory<T>. */
+	class CompressionStats
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Default constructors.
+		CompressionStats(void) : rawBytes(0), compressedBytes(0), nCompressed(0),
+			nDecompressed(0), bytesCompressed(0), bytesDecompressed(0), compressSeconds(0.0),
+			decompressSeconds(0.0) {}
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the number of raw bytes per compressed byte of the frames held. */
+		double GetRatio(void) const;
+
+		/** Gets the number of raw bytes compressed or decompressed per second. */
+		double GetCompressThroughput(void) const;
+		double GetDecompressThroughput(void) const;
+
+		//////////////////////////////////////////////////
+		// Data.
+
+		/** Bytes of the frames held before and after compression. */
+		unsigned long long rawBytes, compressedBytes;
+
+		/** Frames and their raw bytes compressed and decompressed so far, and the time
+		spent on them. */
+		unsigned long long nCompressed, nDecompressed;
+		unsigned long long bytesCompressed, bytesDecompressed;
+		double compressSeconds, decompressSeconds;
+	};
+
+	/** Keeps the most recent frames of a sequence compressed for look-back.
+
+	Push() compresses a frame and drops the oldest one beyond the capacity. Get()
+	decompresses a frame into a frame of a FramePool<T>, so looking back through a sequence
+	does not allocate once the pool is warm. All methods may be called from multiple
+	threads; compression and decompression run outside of the lock. */
+	template <typename T>
+	class CompressedFrameHistory
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef typename ImageFrame<T>::SizeType SizeType;
+		typedef std::shared_ptr<ImageFrame<T>> FramePtr;
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** @exception std::invalid_argument	if capacity is 0 */
+		CompressedFrameHistory(SizeType capacity,
+			FramePredictor predictor = FramePredictor::MED);
+
+		CompressedFrameHistory(const CompressedFrameHistory<T> &src) = delete;
+		CompressedFrameHistory<T> &operator=(const CompressedFrameHistory<T> &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		SizeType GetCapacity(void) const;
+		SizeType GetCount(void) const;
+		CompressionStats GetStats(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Compresses and appends a frame. */
+		void Push(const ImageFrame<T> &img);
+
+		/** Decompresses a frame by its age; 0 for the most recent one.
+
+		@exception std::out_of_range	if age is not less than GetCount() */
+		FramePtr Get(SizeType age) const;
+
+		void Clear(void);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Data.
+		SizeType capacity_;
+		FramePredictor predictor_;
+		std::shared_ptr<FramePool<T>> frames_;
+		mutable std::mutex lock_;
+		std::deque<std::shared_ptr<const CompressedFrame<T>>> history_;
+		mutable CompressionStats stats_;
+	};
+}
+
+#include "frame_compression_inl.h"
+
+#endif
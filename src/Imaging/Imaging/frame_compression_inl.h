@@ -0,0 +1,409 @@
+#if !defined(FRAME_COMPRESSION_INL_H)
+#define FRAME_COMPRESSION_INL_H
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	/** Median edge detector of LOCO-I; the minimum of left and upper on an edge above the
+	upper-left, the maximum below it, and the gradient otherwise. */
+	template <typename T>
+	T PredictMed(T a, T b, T c)
+	{
+		T lo = std::min(a, b), hi = std::max(a, b);
+		return c >= hi ? lo : (c <= lo ? hi : static_cast<T>(static_cast<long long>(a) + b - c));
+	}
+
+	/** Packs unsigned values in blocks of blockSize, each as the number of bits followed by
+	the values of that many bits from the least significant bit. */
+	template <typename U>
+	void PackBits(const U *src, ::size_t nValues, ::size_t blockSize,
+		std::vector<unsigned char> &dst)
+	{
+		for (::size_t I = 0; I < nValues; I += blockSize)
+		{
+			const ::size_t n = std::min(blockSize, nValues - I);
+			U any = 0;
+			for (::size_t K = 0; K != n; ++K)
+				any |= src[I + K];
+			unsigned nBits = 0;
+			while (nBits < 8 * sizeof(U) && (any >> nBits) != 0)
+				++nBits;
+
+			::size_t pos = dst.size();
+			dst.resize(pos + 1 + (n * nBits + 7) / 8);
+			unsigned char *out = dst.data() + pos;
+			*out++ = static_cast<unsigned char>(nBits);
+			if (nBits == 0)
+				continue;
+			unsigned long long bits = 0;
+			unsigned nFilled = 0;
+			for (::size_t K = 0; K != n; ++K)
+			{
+				bits |= static_cast<unsigned long long>(src[I + K]) << nFilled;
+				for (nFilled += nBits; nFilled >= 8; nFilled -= 8, bits >>= 8)
+					*out++ = static_cast<unsigned char>(bits);
+			}
+			if (nFilled != 0)
+				*out = static_cast<unsigned char>(bits);
+		}
+	}
+
+	/** Unpacks values packed by PackBits(), and returns the end of the packed bytes. */
+	template <typename U>
+	const unsigned char *UnpackBits(const unsigned char *src, ::size_t nValues,
+		::size_t blockSize, U *dst)
+	{
+		for (::size_t I = 0; I < nValues; I += blockSize)
+		{
+			const ::size_t n = std::min(blockSize, nValues - I);
+			const unsigned nBits = *src++;
+			if (nBits == 0)
+			{
+				std::fill(dst + I, dst + I + n, U(0));
+				continue;
+			}
+			const unsigned long long mask = (1ull << nBits) - 1;
+			unsigned long long bits = 0;
+			unsigned nFilled = 0;
+			for (::size_t K = 0; K != n; ++K)
+			{
+				for (; nFilled < nBits; nFilled += 8)
+					bits |= static_cast<unsigned long long>(*src++) << nFilled;
+				dst[I + K] = static_cast<U>(bits & mask);
+				bits >>= nBits;
+				nFilled -= nBits;
+			}
+		}
+		return src;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// CompressedFrame<T> class
+
+	template <typename T>
+	const typename CompressedFrame<T>::SizeType CompressedFrame<T>::bandRows;
+
+	template <typename T>
+	const typename CompressedFrame<T>::SizeType CompressedFrame<T>::blockSize;
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Default constructors.
+	template <typename T>
+	CompressedFrame<T>::CompressedFrame(void) : size_(0, 0), depth_(0),
+		predictor_(FramePredictor::MED)
+	{
+		static_assert(std::is_integral<T>::value && sizeof(T) <= 4,
+			"Frame compression is available for only integral types up to 32 bits.");
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	CompressedFrame<T>::CompressedFrame(const ImageFrame<T> &img, FramePredictor predictor) :
+		CompressedFrame()
+	{
+		this->Compress(img, predictor);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	const Size2D<typename CompressedFrame<T>::SizeType> &CompressedFrame<T>::GetSize(void) const
+	{
+		return this->size_;
+	}
+
+	template <typename T>
+	typename CompressedFrame<T>::SizeType CompressedFrame<T>::GetDepth(void) const
+	{
+		return this->depth_;
+	}
+
+	template <typename T>
+	FramePredictor CompressedFrame<T>::GetPredictor(void) const
+	{
+		return this->predictor_;
+	}
+
+	template <typename T>
+	::size_t CompressedFrame<T>::GetRawBytes(void) const
+	{
+		return sizeof(T) * this->size_.width * this->size_.height * this->depth_;
+	}
+
+	template <typename T>
+	::size_t CompressedFrame<T>::GetCompressedBytes(void) const
+	{
+		return this->data_.size() + sizeof(::size_t) * this->bands_.size();
+	}
+
+	template <typename T>
+	double CompressedFrame<T>::GetRatio(void) const
+	{
+		::size_t nBytes = this->GetCompressedBytes();
+		return nBytes == 0 ? 0.0 : static_cast<double>(this->GetRawBytes()) / nBytes;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+
+	/** The bands are compressed into separate buffers and concatenated into a buffer of
+	the exact size, so the memory held is the compressed size. */
+	template <typename T>
+	void CompressedFrame<T>::Compress(const ImageFrame<T> &img, FramePredictor predictor)
+	{
+		this->size_ = img.size;
+		this->depth_ = img.depth;
+		this->predictor_ = predictor;
+		const SizeType nBands = (img.size.height + bandRows - 1) / bandRows;
+		std::vector<std::vector<unsigned char>> encoded(nBands);
+		ParallelFor(0, nBands, 1, [&](::size_t first, ::size_t last)
+		{
+			for (::size_t B = first; B != last; ++B)
+				this->CompressBand(img, bandRows * B,
+				std::min(bandRows * (B + 1), img.size.height), encoded[B]);
+		});
+
+		::size_t nBytes = 0;
+		this->bands_.resize(nBands);
+		for (SizeType B = 0; B != nBands; ++B)
+		{
+			this->bands_[B] = nBytes;
+			nBytes += encoded[B].size();
+		}
+		std::vector<unsigned char> data;
+		data.reserve(nBytes);
+		for (auto it = encoded.cbegin(); it != encoded.cend(); ++it)
+			data.insert(data.end(), it->begin(), it->end());
+		this->data_.swap(data);
+	}
+
+	template <typename T>
+	void CompressedFrame<T>::Decompress(ImageFrame<T> &dst) const
+	{
+		dst.Reset(this->size_, this->depth_);
+		ParallelFor(0, this->bands_.size(), 1, [&](::size_t first, ::size_t last)
+		{
+			for (::size_t B = first; B != last; ++B)
+				this->DecompressBand(this->data_.data() + this->bands_[B], bandRows * B,
+				std::min(bandRows * (B + 1), this->size_.height), dst);
+		});
+	}
+
+	/** The first row of a band is predicted only from the left, so bands are independent.
+	The first pixel of a row is predicted from the pixel above it. Residuals are differences
+	of unsigned values, which wrap around instead of overflowing signed samples. */
+	template <typename T>
+	void CompressedFrame<T>::CompressBand(const ImageFrame<T> &img, SizeType first,
+		SizeType last, std::vector<unsigned char> &dst) const
+	{
+		const SizeType d = this->depth_, n = this->size_.width * d;
+		const unsigned shift = 8 * sizeof(T) - 1;
+		std::vector<Residual> residuals(n);
+		Residual *r = residuals.data();
+		for (SizeType Y = first; Y != last; ++Y)
+		{
+			const T *row = img.data.data() + n * Y, *up = Y != first ? row - n : nullptr;
+			const FramePredictor predictor = up ? this->predictor_ :
+				(this->predictor_ == FramePredictor::NONE ? FramePredictor::NONE :
+				FramePredictor::LEFT);
+			for (SizeType I = 0; I != std::min(d, n); ++I)
+			{
+				const T prediction = predictor == FramePredictor::NONE || !up ? T(0) : up[I];
+				r[I] = static_cast<Residual>(static_cast<Residual>(row[I]) -
+					static_cast<Residual>(prediction));
+			}
+			switch (predictor)
+			{
+			case FramePredictor::NONE:
+				for (SizeType I = d; I < n; ++I)
+					r[I] = static_cast<Residual>(row[I]);
+				break;
+			case FramePredictor::LEFT:
+				for (SizeType I = d; I < n; ++I)
+					r[I] = static_cast<Residual>(static_cast<Residual>(row[I]) -
+						static_cast<Residual>(row[I - d]));
+				break;
+			case FramePredictor::MED:
+				for (SizeType I = d; I < n; ++I)
+					r[I] = static_cast<Residual>(static_cast<Residual>(row[I]) -
+						static_cast<Residual>(PredictMed(row[I - d], up[I], up[I - d])));
+				break;
+			}
+
+			// Zigzag: 0, -1, 1, -2, 2, ... to 0, 1, 2, 3, 4, ...
+			for (SizeType I = 0; I != n; ++I)
+				r[I] = static_cast<Residual>((r[I] << 1) ^ (0u - (r[I] >> shift)));
+			PackBits(r, n, blockSize, dst);
+		}
+	}
+
+	template <typename T>
+	void CompressedFrame<T>::DecompressBand(const unsigned char *src, SizeType first,
+		SizeType last, ImageFrame<T> &dst) const
+	{
+		const SizeType d = this->depth_, n = this->size_.width * d;
+		std::vector<Residual> residuals(n);
+		Residual *r = residuals.data();
+		T *base = dst.GetPointer(0, 0);
+		for (SizeType Y = first; Y != last; ++Y)
+		{
+			src = UnpackBits(src, n, blockSize, r);
+			for (SizeType I = 0; I != n; ++I)
+				r[I] = static_cast<Residual>((r[I] >> 1) ^ (0u - (r[I] & 1)));
+
+			T *row = base + n * Y, *up = Y != first ? row - n : nullptr;
+			const FramePredictor predictor = up ? this->predictor_ :
+				(this->predictor_ == FramePredictor::NONE ? FramePredictor::NONE :
+				FramePredictor::LEFT);
+			for (SizeType I = 0; I != std::min(d, n); ++I)
+				row[I] = static_cast<T>(r[I] + (predictor == FramePredictor::NONE || !up ?
+				T(0) : up[I]));
+			switch (predictor)
+			{
+			case FramePredictor::NONE:
+				for (SizeType I = d; I < n; ++I)
+					row[I] = static_cast<T>(r[I]);
+				break;
+			case FramePredictor::LEFT:
+				for (SizeType I = d; I < n; ++I)
+					row[I] = static_cast<T>(r[I] + row[I - d]);
+				break;
+			case FramePredictor::MED:
+				for (SizeType I = d; I < n; ++I)
+					row[I] = static_cast<T>(r[I] + PredictMed(row[I - d], up[I], up[I - d]));
+				break;
+			}
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// CompressionStats class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline double CompressionStats::GetRatio(void) const
+	{
+		return this->compressedBytes == 0 ? 0.0 :
+			static_cast<double>(this->rawBytes) / this->compressedBytes;
+	}
+
+	inline double CompressionStats::GetCompressThroughput(void) const
+	{
+		return this->compressSeconds == 0.0 ? 0.0 : this->bytesCompressed / this->compressSeconds;
+	}
+
+	inline double CompressionStats::GetDecompressThroughput(void) const
+	{
+		return this->decompressSeconds == 0.0 ? 0.0 :
+			this->bytesDecompressed / this->decompressSeconds;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// CompressedFrameHistory<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	CompressedFrameHistory<T>::CompressedFrameHistory(SizeType capacity,
+		FramePredictor predictor) : capacity_(capacity), predictor_(predictor),
+		frames_(std::make_shared<FramePool<T>>())
+	{
+		if (capacity == 0)
+			throw std::invalid_argument("The capacity must be greater than 0.");
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	typename CompressedFrameHistory<T>::SizeType CompressedFrameHistory<T>::GetCapacity(
+		void) const
+	{
+		return this->capacity_;
+	}
+
+	template <typename T>
+	typename CompressedFrameHistory<T>::SizeType CompressedFrameHistory<T>::GetCount(
+		void) const
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		return this->history_.size();
+	}
+
+	template <typename T>
+	CompressionStats CompressedFrameHistory<T>::GetStats(void) const
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		return this->stats_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	void CompressedFrameHistory<T>::Push(const ImageFrame<T> &img)
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		auto frame = std::make_shared<const CompressedFrame<T>>(img, this->predictor_);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+			t0).count();
+
+		std::lock_guard<std::mutex> guard(this->lock_);
+		this->history_.push_back(frame);
+		this->stats_.rawBytes += frame->GetRawBytes();
+		this->stats_.compressedBytes += frame->GetCompressedBytes();
+		++this->stats_.nCompressed;
+		this->stats_.bytesCompressed += frame->GetRawBytes();
+		this->stats_.compressSeconds += seconds;
+		while (this->history_.size() > this->capacity_)
+		{
+			this->stats_.rawBytes -= this->history_.front()->GetRawBytes();
+			this->stats_.compressedBytes -= this->history_.front()->GetCompressedBytes();
+			this->history_.pop_front();
+		}
+	}
+
+	template <typename T>
+	typename CompressedFrameHistory<T>::FramePtr CompressedFrameHistory<T>::Get(
+		SizeType age) const
+	{
+		std::shared_ptr<const CompressedFrame<T>> frame;
+		{
+			std::lock_guard<std::mutex> guard(this->lock_);
+			if (age >= this->history_.size())
+			{
+				std::ostringstream errMsg;
+				errMsg << "Frame of age " << age << " is out of range.";
+				throw std::out_of_range(errMsg.str());
+			}
+			frame = this->history_[this->history_.size() - 1 - age];
+		}
+
+		auto t0 = std::chrono::steady_clock::now();
+		FramePtr img = this->frames_->Acquire(frame->GetSize(), frame->GetDepth());
+		frame->Decompress(*img);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+			t0).count();
+
+		std::lock_guard<std::mutex> guard(this->lock_);
+		++this->stats_.nDecompressed;
+		this->stats_.bytesDecompressed += frame->GetRawBytes();
+		this->stats_.decompressSeconds += seconds;
+		return img;
+	}
+
+	template <typename T>
+	void CompressedFrameHistory<T>::Clear(void)
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		this->history_.clear();
+		this->stats_.rawBytes = this->stats_.compressedBytes = 0;
+	}
+}
+
+#endif
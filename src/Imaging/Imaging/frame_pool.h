@@ -0,0 +1,66 @@
+#if !defined(FRAME_POOL_H)
+#define FRAME_POOL_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Pool of ImageFrame<T> objects which are reused instead of reallocated.
+
+	Acquire() returns a shared pointer whose deleter puts the frame back to the pool, so a
+	frame is recycled when the last user releases it. The memory of a recycled frame is
+	kept, and Reset() does not reallocate it for the same dimension.
+	The pool must be created by std::make_shared(), because the deleters refer to the pool
+	weakly; a frame released after the pool is destroyed is simply deleted. */
+	template <typename T>
+	class FramePool : public std::enable_shared_from_this<FramePool<T>>
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef typename ImageFrame<T>::SizeType SizeType;
+		typedef std::shared_ptr<ImageFrame<T>> FramePtr;
+
+		//////////////////////////////////////////////////
+		// Default constructors.
+		FramePool(void);
+
+		FramePool(const FramePool<T> &src) = delete;
+		FramePool<T> &operator=(const FramePool<T> &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the number of frames waiting in the pool. */
+		SizeType GetIdleCount(void) const;
+
+		/** Gets the number of frames created by the pool so far. */
+		SizeType GetAllocatedCount(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Gets a frame of given dimension; its values are not initialized if it has been
+		recycled. */
+		FramePtr Acquire(const Size2D<SizeType> &sz, SizeType d);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void Release(ImageFrame<T> *frame);
+
+		//////////////////////////////////////////////////
+		// Data.
+		mutable std::mutex lock_;
+		std::vector<std::unique_ptr<ImageFrame<T>>> idle_;
+		SizeType nAllocated_;
+	};
+}
+
+#include "frame_pool_inl.h"
+
+#endif
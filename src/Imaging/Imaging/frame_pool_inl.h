@@ -0,0 +1,72 @@
+#if !defined(FRAME_POOL_INL_H)
+#define FRAME_POOL_INL_H
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// FramePool<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Default constructors.
+	template <typename T>
+	FramePool<T>::FramePool(void) : nAllocated_(0) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	typename FramePool<T>::SizeType FramePool<T>::GetIdleCount(void) const
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		return this->idle_.size();
+	}
+
+	template <typename T>
+	typename FramePool<T>::SizeType FramePool<T>::GetAllocatedCount(void) const
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		return this->nAllocated_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	typename FramePool<T>::FramePtr FramePool<T>::Acquire(const Size2D<SizeType> &sz,
+		SizeType d)
+	{
+		std::unique_ptr<ImageFrame<T>> frame;
+		{
+			std::lock_guard<std::mutex> guard(this->lock_);
+			if (!this->idle_.empty())
+			{
+				frame = std::move(this->idle_.back());
+				this->idle_.pop_back();
+			}
+			else
+				++this->nAllocated_;
+		}
+		if (!frame)
+			frame.reset(new ImageFrame<T>(sz, d));
+		else
+			frame->Reset(sz, d);
+
+		std::weak_ptr<FramePool<T>> pool = this->shared_from_this();
+		return FramePtr(frame.release(), [pool](ImageFrame<T> *ptr)
+		{
+			auto owner = pool.lock();
+			if (owner)
+				owner->Release(ptr);
+			else
+				delete ptr;
+		});
+	}
+
+	template <typename T>
+	void FramePool<T>::Release(ImageFrame<T> *frame)
+	{
+		std::unique_ptr<ImageFrame<T>> ptr(frame);
+		std::lock_guard<std::mutex> guard(this->lock_);
+		this->idle_.push_back(std::move(ptr));
+	}
+}
+
+#endif
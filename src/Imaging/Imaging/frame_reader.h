@@ -0,0 +1,142 @@
+#if !defined(FRAME_READER_H)
+#define FRAME_READER_H
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "image.h"
+#include "frame_pool.h"
+#include "../Utilities/raw_file.h"
+#include "../Utilities/thread_pool.h"
+
+namespace Imaging
+{
+	/** Describes how frames are stored in a raw sequence file and how they are read.
+
+	A file is a header of headerBytes followed by frames of the same dimension, where
+	each frame may be preceded by its own header of frameHeaderBytes. */
+	class FrameReaderOptions
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Default constructors.
+		FrameReaderOptions(void) : format(RawImageFormat::BIP), order(ByteOrder::NATIVE),
+			headerBytes(0), frameHeaderBytes(0), nPrefetch(4), nThreads(2),
+			directIo(false) {}
+
+		//////////////////////////////////////////////////
+		// Data.
+		RawImageFormat format;
+		ByteOrder order;
+		unsigned long long headerBytes;
+		::size_t frameHeaderBytes;
+
+		/** Number of frames read ahead of the frame returned by FrameReader<T>::Next(). */
+		::size_t nPrefetch;
+
+		/** Number of I/O threads. */
+		unsigned int nThreads;
+
+		/** Bypasses the page cache (see RawFile). Frames are read into aligned buffers and
+		then copied, so this pays off only for sequences much larger than memory. */
+		bool directIo;
+	};
+
+	/** Reads frames of a raw sequence file asynchronously into pooled ImageFrame<T> objects.
+
+	Frames are read by positional reads on a pool of I/O threads, so the computation on a
+	frame overlaps the reading of the following frames.
+	Read() returns a future or calls a callback on an I/O thread for any frame. Next()
+	returns the frames in order, keeping nPrefetch frames in flight ahead of it.
+	BSQ and BIL frames are converted into BIP, and samples are swapped for the byte order,
+	while they are copied from the read buffer.
+	Frames are recycled when every shared pointer to them is released, so holding frames
+	longer than needed makes the pool allocate more frames.
+	@NOTE Next() and Seek() must be called by a single thread. */
+	template <typename T>
+	class FrameReader
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef typename ImageFrame<T>::SizeType SizeType;
+		typedef std::shared_ptr<ImageFrame<T>> FramePtr;
+
+		/** Called with the frame, or with an exception if the read has failed. */
+		typedef std::function<void(FramePtr, std::exception_ptr)> Callback;
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Opens a raw sequence file of frames of given dimension.
+
+		@exception std::runtime_error	if the file cannot be opened */
+		FrameReader(const std::string &path, const Size2D<SizeType> &sz, SizeType d,
+			const FrameReaderOptions &options = FrameReaderOptions());
+
+		FrameReader(const FrameReader<T> &src) = delete;
+		FrameReader<T> &operator=(const FrameReader<T> &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the number of complete frames in the file. */
+		SizeType GetFrameCount(void) const;
+
+		/** Checks if the file has been opened for direct I/O. */
+		bool IsDirect(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Reads a frame asynchronously.
+
+		The future throws std::out_of_range for an invalid index, or std::runtime_error for
+		a failed read. */
+		std::future<FramePtr> Read(SizeType index);
+
+		/** Reads a frame asynchronously and calls a callback on an I/O thread. */
+		void Read(SizeType index, Callback callback);
+
+		/** Checks if Next() has a frame to return. */
+		bool HasNext(void) const;
+
+		/** Gets the next frame in order, and requests the following frames.
+
+		@exception std::out_of_range	if there is no more frame */
+		std::future<FramePtr> Next(void);
+
+		/** Moves the position of Next() to a frame, discarding frames read ahead. */
+		void Seek(SizeType index);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		FramePtr Load(SizeType index);
+		void Prefetch(void);
+
+		//////////////////////////////////////////////////
+		// Data.
+		RawFile file_;
+		Size2D<SizeType> size_;
+		SizeType depth_;
+		FrameReaderOptions options_;
+		::size_t frameBytes_;
+		SizeType nFrames_;
+		std::shared_ptr<FramePool<T>> frames_;
+		std::mutex lockBuffers_;
+		std::vector<std::unique_ptr<AlignedBuffer>> buffers_;
+		std::deque<std::future<FramePtr>> queue_;
+		SizeType next_, nextRequest_;
+
+		// Declared last, so pending reads are completed before other members are destroyed.
+		ThreadPool threads_;
+	};
+}
+
+#include "frame_reader_inl.h"
+
+#endif
@@ -0,0 +1,196 @@
+#if !defined(FRAME_READER_INL_H)
+#define FRAME_READER_INL_H
+
+#include <algorithm>
+#include <cstring>
+
+namespace Imaging
+{
+	/** Converts a frame of a raw format into BIP at a raw pointer, reversing the bytes of
+	each sample if swap is true. */
+	template <typename T>
+	void ConvertToBip(const T *src, const Size2D<::size_t> &sz, ::size_t d,
+		RawImageFormat fmt, T *dst, bool swap)
+	{
+		const ::size_t nElemPerLine = d * sz.width, nElem = nElemPerLine * sz.height;
+		switch (fmt)
+		{
+		case RawImageFormat::BIP:
+			if (swap)
+				CopySwapped(src, nElem, dst);
+			else
+				std::copy(src, src + nElem, dst);
+			break;
+		case RawImageFormat::BSQ:
+			TransposeToBip(src, d, sz.width * sz.height, dst, swap);
+			break;
+		case RawImageFormat::BIL:
+			for (::size_t L = 0; L != sz.height; ++L)
+				TransposeToBip(src + nElemPerLine * L, d, sz.width, dst + nElemPerLine * L,
+					swap);
+			break;
+		default:
+			std::ostringstream errMsg;
+			errMsg << "Raw image format " << static_cast<int>(fmt) << " is not supported.";
+			throw std::logic_error(errMsg.str());
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// FrameReader<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	FrameReader<T>::FrameReader(const std::string &path, const Size2D<SizeType> &sz,
+		SizeType d, const FrameReaderOptions &options) :
+		file_(path, RawFile::Mode::READ, options.directIo), size_(sz), depth_(d),
+		options_(options), frameBytes_(sz.width * sz.height * d * sizeof(T)), nFrames_(0),
+		frames_(std::make_shared<FramePool<T>>()), next_(0), nextRequest_(0),
+		threads_(options.nThreads == 0 ? 1 : options.nThreads)
+	{
+		if (options.format == RawImageFormat::UNKNOWN)
+			throw std::invalid_argument("Raw image format must be given.");
+		unsigned long long fileSize = this->file_.GetSize();
+		unsigned long long stride = options.frameHeaderBytes + this->frameBytes_;
+		if (fileSize > options.headerBytes && stride != 0)
+			this->nFrames_ = static_cast<SizeType>((fileSize - options.headerBytes) / stride);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	typename FrameReader<T>::SizeType FrameReader<T>::GetFrameCount(void) const
+	{
+		return this->nFrames_;
+	}
+
+	template <typename T>
+	bool FrameReader<T>::IsDirect(void) const
+	{
+		return this->file_.IsDirect();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	std::future<typename FrameReader<T>::FramePtr> FrameReader<T>::Read(SizeType index)
+	{
+		return this->threads_.Submit([this, index]() { return this->Load(index); });
+	}
+
+	template <typename T>
+	void FrameReader<T>::Read(SizeType index, Callback callback)
+	{
+		this->threads_.Submit([this, index, callback]()
+		{
+			FramePtr frame;
+			try
+			{
+				frame = this->Load(index);
+			}
+			catch (...)
+			{
+				callback(nullptr, std::current_exception());
+				return;
+			}
+			callback(frame, nullptr);
+		});
+	}
+
+	template <typename T>
+	bool FrameReader<T>::HasNext(void) const
+	{
+		return this->next_ < this->nFrames_;
+	}
+
+	template <typename T>
+	std::future<typename FrameReader<T>::FramePtr> FrameReader<T>::Next(void)
+	{
+		if (!this->HasNext())
+			throw std::out_of_range("There is no more frame to read.");
+		this->Prefetch();
+		std::future<FramePtr> result = std::move(this->queue_.front());
+		this->queue_.pop_front();
+		++this->next_;
+		this->Prefetch();
+		return result;
+	}
+
+	template <typename T>
+	void FrameReader<T>::Seek(SizeType index)
+	{
+		this->queue_.clear();
+		this->next_ = this->nextRequest_ = index;
+	}
+
+	template <typename T>
+	void FrameReader<T>::Prefetch(void)
+	{
+		while (this->nextRequest_ < this->nFrames_ &&
+			this->nextRequest_ <= this->next_ + this->options_.nPrefetch)
+			this->queue_.push_back(this->Read(this->nextRequest_++));
+	}
+
+	/** A BIP frame in native byte order is read straight into the frame. Otherwise, the
+	frame is read into a pooled buffer, which is widened to aligned positions for direct
+	I/O, and converted into the frame. */
+	template <typename T>
+	typename FrameReader<T>::FramePtr FrameReader<T>::Load(SizeType index)
+	{
+		if (index >= this->nFrames_)
+		{
+			std::ostringstream errMsg;
+			errMsg << "Frame " << index << " is out of range.";
+			throw std::out_of_range(errMsg.str());
+		}
+
+		FramePtr frame = this->frames_->Acquire(this->size_, this->depth_);
+		T *dst = frame->GetPointer(0, 0);
+		const unsigned long long position = this->options_.headerBytes +
+			(this->options_.frameHeaderBytes + this->frameBytes_) *
+			static_cast<unsigned long long>(index) + this->options_.frameHeaderBytes;
+		const bool direct = this->file_.IsDirect();
+		const bool swap = NeedsSwap(this->options_.order);
+		if (!direct && this->options_.format == RawImageFormat::BIP)
+		{
+			if (this->file_.ReadAt(position, dst, this->frameBytes_) != this->frameBytes_)
+				throw std::runtime_error("Failed to read a complete frame.");
+			if (swap)
+				CopySwapped(dst, this->frameBytes_ / sizeof(T), dst);
+			return frame;
+		}
+
+		// Get a buffer from the pool.
+		std::unique_ptr<AlignedBuffer> buffer;
+		{
+			std::lock_guard<std::mutex> guard(this->lockBuffers_);
+			if (!this->buffers_.empty())
+			{
+				buffer = std::move(this->buffers_.back());
+				this->buffers_.pop_back();
+			}
+		}
+		if (!buffer)
+			buffer.reset(new AlignedBuffer(0, RawFile::GetDirectAlignment()));
+
+		const unsigned long long alignment = direct ? RawFile::GetDirectAlignment() : 1;
+		const unsigned long long first = position / alignment * alignment;
+		const unsigned long long last = (position + this->frameBytes_ + alignment - 1) /
+			alignment * alignment;
+		const ::size_t offset = static_cast<::size_t>(position - first);
+		buffer->Resize(static_cast<::size_t>(last - first));
+		::size_t nRead = this->file_.ReadAt(first, buffer->GetPointer(), buffer->GetSize());
+		if (nRead < offset + this->frameBytes_)
+			throw std::runtime_error("Failed to read a complete frame.");
+
+		const T *src = reinterpret_cast<const T *>(buffer->GetPointer() + offset);
+		ConvertToBip(src, this->size_, this->depth_, this->options_.format, dst, swap);
+
+		std::lock_guard<std::mutex> guard(this->lockBuffers_);
+		this->buffers_.push_back(std::move(buffer));
+		return frame;
+	}
+}
+
+#endif
@@ -0,0 +1,221 @@
+#if !defined(FRAME_RING_H)
+#define FRAME_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Presents what FrameRing<T>::Claim() does when the ring is full.
+
+	BLOCK: waits until a consumer releases a slot.
+	DROP_OLDEST: discards the oldest frame if it has been committed and not acquired, and
+	waits otherwise.
+	DROP_NEWEST: discards the frame about to be written, returning an empty slot. */
+	enum class RingPolicy {BLOCK, DROP_OLDEST, DROP_NEWEST};
+
+	/** Snapshot of the counters of a FrameRing<T>.
+
+	Latency is the time from committing a frame to acquiring it. */
+	class RingCounters
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Default constructors.
+		RingCounters(void) : nCommitted(0), nAcquired(0), nDroppedOldest(0),
+			nDroppedNewest(0), nAbandoned(0), totalLatency(0.0), maxLatency(0.0) {}
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		unsigned long long GetDropCount(void) const;
+		double GetMeanLatency(void) const;
+
+		//////////////////////////////////////////////////
+		// Data.
+		unsigned long long nCommitted, nAcquired, nDroppedOldest, nDroppedNewest, nAbandoned;
+
+		/** Seconds. */
+		double totalLatency, maxLatency;
+	};
+
+	/** Bounded ring of preallocated frames handed from producer threads to consumer threads
+	without locks.
+
+	A producer claims a slot, writes into its frame in place and commits it; a consumer
+	acquires the oldest committed frame as a read view and releases the slot when the view
+	is destroyed. Each slot carries a sequence number which tells whether it is free,
+	being written, committed or being read (Vyukov's bounded queue), so any number of
+	producers and consumers claim positions by a single compare-and-swap and nothing is
+	copied or allocated per frame.
+	A slot frame keeps its memory; Reset() on it does not reallocate it for the same number
+	of samples. A slot claimed and not committed is committed as abandoned, and skipped by
+	consumers.
+	Waiting for a slot or a frame spins and yields, and then sleeps briefly.
+	@NOTE Frames are handed in the order of claims; a slot being written holds back the
+	consumers of the frames claimed after it. */
+	template <typename T>
+	class FrameRing
+	{
+	protected:
+		class Slot;
+
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef typename ImageFrame<T>::SizeType SizeType;
+
+		/** Write access to a claimed slot; commits it as abandoned if not committed. */
+		class WriteSlot
+		{
+		public:
+			WriteSlot(void);
+			WriteSlot(WriteSlot &&src);
+			WriteSlot &operator=(WriteSlot &&src);
+			~WriteSlot(void);
+
+			WriteSlot(const WriteSlot &src) = delete;
+			WriteSlot &operator=(const WriteSlot &src) = delete;
+
+			/** Checks if a slot has been claimed. */
+			explicit operator bool(void) const;
+
+			/** Gets the frame to write into. */
+			ImageFrame<T> &GetFrame(void) const;
+
+			/** Gets the index of the frame in the order of claims from 0. */
+			unsigned long long GetIndex(void) const;
+
+			/** Hands the frame to consumers, and empties this object. */
+			void Commit(void);
+
+		protected:
+			friend class FrameRing<T>;
+			WriteSlot(FrameRing<T> *ring, Slot *slot, unsigned long long position);
+			void Publish(bool valid);
+
+			FrameRing<T> *ring_;
+			Slot *slot_;
+			unsigned long long position_;
+		};
+
+		/** Read access to an acquired frame; releases the slot when destroyed. */
+		class ReadView
+		{
+		public:
+			ReadView(void);
+			ReadView(ReadView &&src);
+			ReadView &operator=(ReadView &&src);
+			~ReadView(void);
+
+			ReadView(const ReadView &src) = delete;
+			ReadView &operator=(const ReadView &src) = delete;
+
+			/** Checks if a frame has been acquired. */
+			explicit operator bool(void) const;
+
+			const ImageFrame<T> &GetFrame(void) const;
+			unsigned long long GetIndex(void) const;
+
+			/** Returns the slot to producers, and empties this object. */
+			void Release(void);
+
+		protected:
+			friend class FrameRing<T>;
+			ReadView(FrameRing<T> *ring, Slot *slot, unsigned long long position);
+
+			FrameRing<T> *ring_;
+			Slot *slot_;
+			unsigned long long position_;
+		};
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Creates a ring of slots with frames of given dimension.
+
+		@exception std::invalid_argument	if capacity is 0 */
+		FrameRing(SizeType capacity, const Size2D<SizeType> &sz, SizeType d,
+			RingPolicy policy = RingPolicy::BLOCK);
+
+		FrameRing(const FrameRing<T> &src) = delete;
+		FrameRing<T> &operator=(const FrameRing<T> &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		SizeType GetCapacity(void) const;
+		RingPolicy GetPolicy(void) const;
+		RingCounters GetCounters(void) const;
+
+		/** Checks if Close() has been called. */
+		bool IsClosed(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Claims a slot to write a frame into, following the policy when the ring is full.
+
+		Returns an empty slot if the frame is dropped by DROP_NEWEST or the ring is closed. */
+		WriteSlot Claim(void);
+
+		/** Claims a slot if one is free, without dropping or waiting. */
+		WriteSlot TryClaim(void);
+
+		/** Acquires the oldest committed frame, waiting for one.
+
+		Returns an empty view if the ring is closed and has no committed frame.
+		@NOTE Release the previous view before waiting for the next frame; the producers may
+		be waiting for its slot. */
+		ReadView Acquire(void);
+
+		/** Acquires the oldest committed frame if there is one, without waiting. */
+		ReadView TryAcquire(void);
+
+		/** Wakes up waiting producers and consumers; Claim() fails from now on, and
+		Acquire() fails once the committed frames have been acquired. */
+		void Close(void);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Types.
+		class Slot
+		{
+		public:
+			std::atomic<unsigned long long> sequence;
+			ImageFrame<T> frame;
+			std::chrono::steady_clock::time_point committed;
+			bool valid;
+		};
+
+		//////////////////////////////////////////////////
+		// Methods.
+		bool ClaimPosition(unsigned long long &position);
+		bool AcquirePosition(unsigned long long &position);
+		bool DropOldest(void);
+		void Publish(Slot *slot, unsigned long long position, bool valid);
+		void Release(Slot *slot, unsigned long long position);
+
+		//////////////////////////////////////////////////
+		// Data.
+		SizeType capacity_;
+		RingPolicy policy_;
+		std::unique_ptr<Slot[]> slots_;
+		std::atomic<bool> closed_;
+
+		// Positions are on separate cache lines, so producers and consumers do not share one.
+		char pad0_[64];
+		std::atomic<unsigned long long> claimPosition_;
+		char pad1_[64];
+		std::atomic<unsigned long long> acquirePosition_;
+		char pad2_[64];
+
+		std::atomic<unsigned long long> nCommitted_, nAcquired_, nDroppedOldest_,
+			nDroppedNewest_, nAbandoned_, totalLatency_, maxLatency_;
+	};
+}
+
+#include "frame_ring_inl.h"
+
+#endif
@@ -0,0 +1,399 @@
+#if !defined(FRAME_RING_INL_H)
+#define FRAME_RING_INL_H
+
+#include <stdexcept>
+#include <thread>
+
+namespace Imaging
+{
+	/** Waits a little longer at each call; spins first, then yields, then sleeps. */
+	inline void Backoff(unsigned &nWaits)
+	{
+		if (nWaits >= 64)
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		else if (nWaits >= 16)
+			std::this_thread::yield();
+		++nWaits;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// RingCounters class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline unsigned long long RingCounters::GetDropCount(void) const
+	{
+		return this->nDroppedOldest + this->nDroppedNewest;
+	}
+
+	inline double RingCounters::GetMeanLatency(void) const
+	{
+		return this->nAcquired == 0 ? 0.0 : this->totalLatency / this->nAcquired;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// FrameRing<T>::WriteSlot class
+
+	template <typename T>
+	FrameRing<T>::WriteSlot::WriteSlot(void) : ring_(nullptr), slot_(nullptr), position_(0) {}
+
+	template <typename T>
+	FrameRing<T>::WriteSlot::WriteSlot(FrameRing<T> *ring, Slot *slot,
+		unsigned long long position) : ring_(ring), slot_(slot), position_(position) {}
+
+	template <typename T>
+	FrameRing<T>::WriteSlot::WriteSlot(WriteSlot &&src) : ring_(src.ring_), slot_(src.slot_),
+		position_(src.position_)
+	{
+		src.slot_ = nullptr;
+	}
+
+	template <typename T>
+	typename FrameRing<T>::WriteSlot &FrameRing<T>::WriteSlot::operator=(WriteSlot &&src)
+	{
+		if (this != &src)
+		{
+			this->Publish(false);
+			this->ring_ = src.ring_;
+			this->slot_ = src.slot_;
+			this->position_ = src.position_;
+			src.slot_ = nullptr;
+		}
+		return *this;
+	}
+
+	template <typename T>
+	FrameRing<T>::WriteSlot::~WriteSlot(void)
+	{
+		this->Publish(false);
+	}
+
+	template <typename T>
+	FrameRing<T>::WriteSlot::operator bool(void) const
+	{
+		return this->slot_ != nullptr;
+	}
+
+	template <typename T>
+	ImageFrame<T> &FrameRing<T>::WriteSlot::GetFrame(void) const
+	{
+		if (!this->slot_)
+			throw std::logic_error("No slot has been claimed.");
+		return this->slot_->frame;
+	}
+
+	template <typename T>
+	unsigned long long FrameRing<T>::WriteSlot::GetIndex(void) const
+	{
+		return this->position_;
+	}
+
+	template <typename T>
+	void FrameRing<T>::WriteSlot::Commit(void)
+	{
+		if (!this->slot_)
+			throw std::logic_error("No slot has been claimed.");
+		this->Publish(true);
+	}
+
+	template <typename T>
+	void FrameRing<T>::WriteSlot::Publish(bool valid)
+	{
+		if (this->slot_)
+		{
+			this->ring_->Publish(this->slot_, this->position_, valid);
+			this->slot_ = nullptr;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// FrameRing<T>::ReadView class
+
+	template <typename T>
+	FrameRing<T>::ReadView::ReadView(void) : ring_(nullptr), slot_(nullptr), position_(0) {}
+
+	template <typename T>
+	FrameRing<T>::ReadView::ReadView(FrameRing<T> *ring, Slot *slot,
+		unsigned long long position) : ring_(ring), slot_(slot), position_(position) {}
+
+	template <typename T>
+	FrameRing<T>::ReadView::ReadView(ReadView &&src) : ring_(src.ring_), slot_(src.slot_),
+		position_(src.position_)
+	{
+		src.slot_ = nullptr;
+	}
+
+	template <typename T>
+	typename FrameRing<T>::ReadView &FrameRing<T>::ReadView::operator=(ReadView &&src)
+	{
+		if (this != &src)
+		{
+			this->Release();
+			this->ring_ = src.ring_;
+			this->slot_ = src.slot_;
+			this->position_ = src.position_;
+			src.slot_ = nullptr;
+		}
+		return *this;
+	}
+
+	template <typename T>
+	FrameRing<T>::ReadView::~ReadView(void)
+	{
+		this->Release();
+	}
+
+	template <typename T>
+	FrameRing<T>::ReadView::operator bool(void) const
+	{
+		return this->slot_ != nullptr;
+	}
+
+	template <typename T>
+	const ImageFrame<T> &FrameRing<T>::ReadView::GetFrame(void) const
+	{
+		if (!this->slot_)
+			throw std::logic_error("No frame has been acquired.");
+		return this->slot_->frame;
+	}
+
+	template <typename T>
+	unsigned long long FrameRing<T>::ReadView::GetIndex(void) const
+	{
+		return this->position_;
+	}
+
+	template <typename T>
+	void FrameRing<T>::ReadView::Release(void)
+	{
+		if (this->slot_)
+		{
+			this->ring_->Release(this->slot_, this->position_);
+			this->slot_ = nullptr;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// FrameRing<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	FrameRing<T>::FrameRing(SizeType capacity, const Size2D<SizeType> &sz, SizeType d,
+		RingPolicy policy) : capacity_(capacity), policy_(policy), closed_(false),
+		claimPosition_(0), acquirePosition_(0), nCommitted_(0), nAcquired_(0),
+		nDroppedOldest_(0), nDroppedNewest_(0), nAbandoned_(0), totalLatency_(0),
+		maxLatency_(0)
+	{
+		if (capacity == 0)
+			throw std::invalid_argument("The capacity must be greater than 0.");
+		this->slots_.reset(new Slot[capacity]);
+		for (SizeType I = 0; I != capacity; ++I)
+		{
+			this->slots_[I].sequence.store(2 * I, std::memory_order_relaxed);
+			this->slots_[I].frame.Reset(sz, d);
+			this->slots_[I].valid = false;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	typename FrameRing<T>::SizeType FrameRing<T>::GetCapacity(void) const
+	{
+		return this->capacity_;
+	}
+
+	template <typename T>
+	RingPolicy FrameRing<T>::GetPolicy(void) const
+	{
+		return this->policy_;
+	}
+
+	template <typename T>
+	RingCounters FrameRing<T>::GetCounters(void) const
+	{
+		RingCounters counters;
+		counters.nCommitted = this->nCommitted_.load(std::memory_order_relaxed);
+		counters.nAcquired = this->nAcquired_.load(std::memory_order_relaxed);
+		counters.nDroppedOldest = this->nDroppedOldest_.load(std::memory_order_relaxed);
+		counters.nDroppedNewest = this->nDroppedNewest_.load(std::memory_order_relaxed);
+		counters.nAbandoned = this->nAbandoned_.load(std::memory_order_relaxed);
+		counters.totalLatency = 1e-9 * this->totalLatency_.load(std::memory_order_relaxed);
+		counters.maxLatency = 1e-9 * this->maxLatency_.load(std::memory_order_relaxed);
+		return counters;
+	}
+
+	template <typename T>
+	bool FrameRing<T>::IsClosed(void) const
+	{
+		return this->closed_.load(std::memory_order_acquire);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	typename FrameRing<T>::WriteSlot FrameRing<T>::Claim(void)
+	{
+		unsigned long long position;
+		for (unsigned nWaits = 0; !this->IsClosed(); )
+		{
+			if (this->ClaimPosition(position))
+				return WriteSlot(this, &this->slots_[position % this->capacity_], position);
+
+			if (this->policy_ == RingPolicy::DROP_NEWEST)
+			{
+				this->nDroppedNewest_.fetch_add(1, std::memory_order_relaxed);
+				break;
+			}
+			else if (this->policy_ != RingPolicy::DROP_OLDEST || !this->DropOldest())
+				Backoff(nWaits);
+		}
+		return WriteSlot();
+	}
+
+	template <typename T>
+	typename FrameRing<T>::WriteSlot FrameRing<T>::TryClaim(void)
+	{
+		unsigned long long position;
+		if (this->IsClosed() || !this->ClaimPosition(position))
+			return WriteSlot();
+		return WriteSlot(this, &this->slots_[position % this->capacity_], position);
+	}
+
+	template <typename T>
+	typename FrameRing<T>::ReadView FrameRing<T>::Acquire(void)
+	{
+		for (unsigned nWaits = 0; ; Backoff(nWaits))
+		{
+			// Checked before trying, so frames committed before Close() are not missed.
+			bool closed = this->IsClosed();
+			ReadView view = this->TryAcquire();
+			if (view || closed)
+				return view;
+		}
+	}
+
+	template <typename T>
+	typename FrameRing<T>::ReadView FrameRing<T>::TryAcquire(void)
+	{
+		unsigned long long position;
+		while (this->AcquirePosition(position))
+		{
+			Slot *slot = &this->slots_[position % this->capacity_];
+			if (!slot->valid)
+			{
+				this->Release(slot, position);
+				continue;
+			}
+
+			unsigned long long latency = static_cast<unsigned long long>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - slot->committed).count());
+			this->nAcquired_.fetch_add(1, std::memory_order_relaxed);
+			this->totalLatency_.fetch_add(latency, std::memory_order_relaxed);
+			unsigned long long maxLatency = this->maxLatency_.load(std::memory_order_relaxed);
+			while (latency > maxLatency && !this->maxLatency_.compare_exchange_weak(maxLatency,
+				latency, std::memory_order_relaxed))
+				;
+			return ReadView(this, slot, position);
+		}
+		return ReadView();
+	}
+
+	template <typename T>
+	void FrameRing<T>::Close(void)
+	{
+		this->closed_.store(true, std::memory_order_release);
+	}
+
+	/** A slot at position p is free when its sequence is 2p, committed when 2p + 1, and free
+	again for position p + capacity after it is released. Sequences are spaced by 2, so a
+	committed frame is not taken for a free slot of the next position even for a capacity
+	of 1, where p + 1 is also p + capacity. */
+	template <typename T>
+	bool FrameRing<T>::ClaimPosition(unsigned long long &position)
+	{
+		position = this->claimPosition_.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot &slot = this->slots_[position % this->capacity_];
+			long long diff = static_cast<long long>(
+				slot.sequence.load(std::memory_order_acquire) - 2 * position);
+			if (diff == 0)
+			{
+				if (this->claimPosition_.compare_exchange_weak(position, position + 1,
+					std::memory_order_relaxed))
+					return true;
+			}
+			else if (diff < 0)
+				return false;
+			else
+				position = this->claimPosition_.load(std::memory_order_relaxed);
+		}
+	}
+
+	template <typename T>
+	bool FrameRing<T>::AcquirePosition(unsigned long long &position)
+	{
+		position = this->acquirePosition_.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot &slot = this->slots_[position % this->capacity_];
+			long long diff = static_cast<long long>(
+				slot.sequence.load(std::memory_order_acquire) - (2 * position + 1));
+			if (diff == 0)
+			{
+				if (this->acquirePosition_.compare_exchange_weak(position, position + 1,
+					std::memory_order_relaxed))
+					return true;
+			}
+			else if (diff < 0)
+				return false;
+			else
+				position = this->acquirePosition_.load(std::memory_order_relaxed);
+		}
+	}
+
+	/** Only the frame in the slot of the next claim is dropped, and only if it has been
+	committed and not acquired; a slot being written or read is waited for. */
+	template <typename T>
+	bool FrameRing<T>::DropOldest(void)
+	{
+		unsigned long long position = this->claimPosition_.load(std::memory_order_relaxed);
+		if (position < this->capacity_)
+			return false;
+		unsigned long long oldest = position - this->capacity_;
+		Slot *slot = &this->slots_[oldest % this->capacity_];
+		if (slot->sequence.load(std::memory_order_acquire) != 2 * oldest + 1 ||
+			!this->acquirePosition_.compare_exchange_strong(oldest, oldest + 1,
+			std::memory_order_relaxed))
+			return false;
+
+		// An abandoned frame is not counted as dropped.
+		if (slot->valid)
+			this->nDroppedOldest_.fetch_add(1, std::memory_order_relaxed);
+		this->Release(slot, position - this->capacity_);
+		return true;
+	}
+
+	template <typename T>
+	void FrameRing<T>::Publish(Slot *slot, unsigned long long position, bool valid)
+	{
+		slot->valid = valid;
+		slot->committed = std::chrono::steady_clock::now();
+		if (valid)
+			this->nCommitted_.fetch_add(1, std::memory_order_relaxed);
+		else
+			this->nAbandoned_.fetch_add(1, std::memory_order_relaxed);
+		slot->sequence.store(2 * position + 1, std::memory_order_release);
+	}
+
+	template <typename T>
+	void FrameRing<T>::Release(Slot *slot, unsigned long long position)
+	{
+		slot->sequence.store(2 * (position + this->capacity_), std::memory_order_release);
+	}
+}
+
+#endif
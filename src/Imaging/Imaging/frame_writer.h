@@ -0,0 +1,205 @@
+#if !defined(FRAME_WRITER_H)
+#define FRAME_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "image.h"
+#include "frame_pool.h"
+#include "frame_reader.h"
+#include "../Utilities/raw_file.h"
+
+namespace Imaging
+{
+	/** Text header at the beginning of raw sequence files written by FrameWriter<T>.
+
+	The header is "key = value" lines in the style of ENVI headers, padded with zeros to
+	GetSize() bytes, so the frames start at an aligned position for direct I/O.
+	IMAGING RAW SEQUENCE
+	width = 640
+	height = 480
+	depth = 3
+	data type = 12
+	interleave = bsq
+	byte order = 0 (0: little endian, 1: big endian)
+	header offset = 4096
+	frames = 100 */
+	class RawSequenceHeader
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Default constructors.
+		RawSequenceHeader(void) : size(0, 0), depth(0), dataType(0),
+			format(RawImageFormat::BIP), order(ByteOrder::LITTLE), nFrames(0) {}
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the number of bytes of the header in a file. */
+		static ::size_t GetSize(void);
+
+		/** Gets the options to read the frames of the file by FrameReader<T>. */
+		FrameReaderOptions GetReaderOptions(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		std::string ToString(void) const;
+
+		/** Parses the text of a header.
+
+		@exception std::runtime_error	if the text is not a valid header */
+		void Parse(const std::string &text);
+
+		/** Reads the header of a file. */
+		void Read(const std::string &path);
+
+		//////////////////////////////////////////////////
+		// Data.
+		Size2D<::size_t> size;
+		::size_t depth;
+		int dataType;
+		RawImageFormat format;
+		ByteOrder order;
+		::size_t nFrames;
+	};
+
+	/** Options of FrameWriter<T>. */
+	class FrameWriterOptions
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Default constructors.
+		FrameWriterOptions(void) : format(RawImageFormat::BIP), order(ByteOrder::NATIVE),
+			queueDepth(8), chunkBytes(4 << 20), syncInterval(0), directIo(false) {}
+
+		//////////////////////////////////////////////////
+		// Data.
+
+		/** Interleave of the file; frames are converted from BIP while written. */
+		RawImageFormat format;
+		ByteOrder order;
+
+		/** Maximum number of frames waiting to be written. Write() blocks while the queue
+		is full. */
+		::size_t queueDepth;
+
+		/** Number of bytes written by a single call, rounded up to the alignment of direct
+		I/O. */
+		::size_t chunkBytes;
+
+		/** Number of frames between fsync calls; 0 syncs only at Close(). */
+		::size_t syncInterval;
+
+		/** Bypasses the page cache (see RawFile). */
+		bool directIo;
+	};
+
+	/** Writes ImageFrame<T> objects into a raw sequence file on a background thread.
+
+	Write() only queues a frame, so the calling thread, e.g., a capture thread, is not
+	stalled by the device unless the queue is full. The background thread converts each
+	frame from BIP into the interleave and the byte order of the file directly into an
+	aligned chunk buffer, and writes the chunk when it is full. The file starts with a
+	RawSequenceHeader whose number of frames is updated by Close().
+	An error on the background thread is rethrown by the next Write() or Close(). */
+	template <typename T>
+	class FrameWriter
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef typename ImageFrame<T>::SizeType SizeType;
+		typedef std::shared_ptr<const ImageFrame<T>> ConstFramePtr;
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Creates a file for frames of given dimension and starts the background thread.
+
+		@exception std::runtime_error	if the file cannot be created */
+		FrameWriter(const std::string &path, const Size2D<SizeType> &sz, SizeType d,
+			const FrameWriterOptions &options = FrameWriterOptions());
+
+		FrameWriter(const FrameWriter<T> &src) = delete;
+		FrameWriter<T> &operator=(const FrameWriter<T> &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Destructors.
+
+		/** Closes the file if Close() has not been called, ignoring errors. */
+		~FrameWriter(void);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the number of frames accepted by Write(). */
+		SizeType GetFrameCount(void) const;
+
+		/** Gets the number of frames waiting to be written. */
+		SizeType GetQueuedCount(void) const;
+
+		bool IsDirect(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Queues a copy of a frame. The copy is a pooled frame, so this costs a memory copy
+		without allocation. */
+		void Write(const ImageFrame<T> &img);
+
+		/** Queues a shared frame without copying. The frame must not be modified until it is
+		written. */
+		void Write(ConstFramePtr frame);
+
+		/** Writes all queued frames, updates the header, syncs and closes the file. */
+		void Close(void);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void Run(void);
+		template <typename F>
+		void WriteFrame(const ImageFrame<T> &img, F load);
+		template <typename F>
+		void Append(::size_t nSamples, F fill);
+		void Flush(void);
+
+		/** Writes the pending bytes of the chunk before a sync. */
+		void FlushAligned(void);
+
+		//////////////////////////////////////////////////
+		// Data.
+		RawFile file_;
+		Size2D<SizeType> size_;
+		SizeType depth_;
+		FrameWriterOptions options_;
+		std::shared_ptr<FramePool<T>> frames_;
+
+		// Shared with the background thread.
+		mutable std::mutex lock_;
+		std::condition_variable hasWork_, hasSpace_;
+		std::deque<ConstFramePtr> queue_;
+		bool stop_, closed_;
+		SizeType nAccepted_;
+		std::exception_ptr error_;
+
+		// Used only by the background thread until it is joined.
+		AlignedBuffer chunk_;
+		::size_t used_;
+		unsigned long long position_;
+		SizeType nSinceSync_;
+		std::vector<T> line_;
+
+		std::thread thread_;
+	};
+}
+
+#include "frame_writer_inl.h"
+
+#endif
@@ -0,0 +1,411 @@
+#if !defined(FRAME_WRITER_INL_H)
+#define FRAME_WRITER_INL_H
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// RawSequenceHeader class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline ::size_t RawSequenceHeader::GetSize(void)
+	{
+		return 4096;
+	}
+
+	inline FrameReaderOptions RawSequenceHeader::GetReaderOptions(void) const
+	{
+		FrameReaderOptions options;
+		options.format = this->format;
+		options.order = this->order;
+		options.headerBytes = GetSize();
+		return options;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	inline std::string RawSequenceHeader::ToString(void) const
+	{
+		const char *interleave = this->format == RawImageFormat::BSQ ? "bsq" :
+			(this->format == RawImageFormat::BIL ? "bil" : "bip");
+		std::ostringstream text;
+		text << "IMAGING RAW SEQUENCE\n" <<
+			"width = " << this->size.width << "\n" <<
+			"height = " << this->size.height << "\n" <<
+			"depth = " << this->depth << "\n" <<
+			"data type = " << this->dataType << "\n" <<
+			"interleave = " << interleave << "\n" <<
+			"byte order = " << (this->order == ByteOrder::BIG ? 1 : 0) << "\n" <<
+			"header offset = " << GetSize() << "\n" <<
+			"frames = " << this->nFrames << "\n";
+		return text.str();
+	}
+
+	inline void RawSequenceHeader::Parse(const std::string &text)
+	{
+		std::istringstream lines(text.c_str());	// up to the padding zeros
+		std::string line;
+		if (!std::getline(lines, line) || line != "IMAGING RAW SEQUENCE")
+			throw std::runtime_error("The header is not a raw sequence header.");
+
+		RawSequenceHeader header;
+		while (std::getline(lines, line))
+		{
+			::size_t pos = line.find(" = ");
+			if (pos == std::string::npos)
+				continue;
+			std::string key = line.substr(0, pos), value = line.substr(pos + 3);
+			std::istringstream number(value);
+			if (key == "width")
+				number >> header.size.width;
+			else if (key == "height")
+				number >> header.size.height;
+			else if (key == "depth")
+				number >> header.depth;
+			else if (key == "data type")
+				number >> header.dataType;
+			else if (key == "interleave")
+				header.format = value == "bsq" ? RawImageFormat::BSQ :
+				(value == "bil" ? RawImageFormat::BIL : (value == "bip" ?
+				RawImageFormat::BIP : RawImageFormat::UNKNOWN));
+			else if (key == "byte order")
+				header.order = value == "1" ? ByteOrder::BIG : ByteOrder::LITTLE;
+			else if (key == "frames")
+				number >> header.nFrames;
+		}
+		if (header.format == RawImageFormat::UNKNOWN)
+			throw std::runtime_error("The interleave of the header is unknown.");
+		*this = header;
+	}
+
+	inline void RawSequenceHeader::Read(const std::string &path)
+	{
+		RawFile file(path, RawFile::Mode::READ);
+		std::vector<char> text(GetSize() + 1, '\0');
+		file.ReadAt(0, text.data(), GetSize());
+		this->Parse(text.data());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// FrameWriter<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	FrameWriter<T>::FrameWriter(const std::string &path, const Size2D<SizeType> &sz,
+		SizeType d, const FrameWriterOptions &options) :
+		file_(path, RawFile::Mode::WRITE, options.directIo), size_(sz), depth_(d),
+		options_(options), frames_(std::make_shared<FramePool<T>>()), stop_(false),
+		closed_(false), nAccepted_(0), used_(0), position_(RawSequenceHeader::GetSize()),
+		nSinceSync_(0)
+	{
+		if (options.format == RawImageFormat::UNKNOWN)
+			throw std::invalid_argument("Raw image format must be given.");
+		if (this->options_.queueDepth == 0)
+			this->options_.queueDepth = 1;
+
+		// Round the chunk up to the alignment, which is also a multiple of sizeof(T).
+		const ::size_t alignment = RawFile::GetDirectAlignment();
+		::size_t nBytes = std::max(options.chunkBytes, alignment);
+		this->chunk_ = AlignedBuffer((nBytes + alignment - 1) / alignment * alignment,
+			alignment);
+
+		// Reserve the header; the number of frames is written by Close().
+		AlignedBuffer header(RawSequenceHeader::GetSize(), alignment);
+		std::memset(header.GetPointer(), 0, header.GetSize());
+		this->file_.WriteAt(0, header.GetPointer(), header.GetSize());
+
+		this->thread_ = std::thread(&FrameWriter<T>::Run, this);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Destructors.
+	template <typename T>
+	FrameWriter<T>::~FrameWriter(void)
+	{
+		try
+		{
+			this->Close();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	typename FrameWriter<T>::SizeType FrameWriter<T>::GetFrameCount(void) const
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		return this->nAccepted_;
+	}
+
+	template <typename T>
+	typename FrameWriter<T>::SizeType FrameWriter<T>::GetQueuedCount(void) const
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		return this->queue_.size();
+	}
+
+	template <typename T>
+	bool FrameWriter<T>::IsDirect(void) const
+	{
+		return this->file_.IsDirect();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	void FrameWriter<T>::Write(const ImageFrame<T> &img)
+	{
+		if (img.size != this->size_ || img.depth != this->depth_)
+			throw std::invalid_argument("The dimension of the frame is unmatched.");
+		auto frame = this->frames_->Acquire(img.size, img.depth);
+		std::copy(img.data.cbegin(), img.data.cend(), frame->GetIterator(0, 0));
+		this->Write(ConstFramePtr(frame));
+	}
+
+	template <typename T>
+	void FrameWriter<T>::Write(ConstFramePtr frame)
+	{
+		if (!frame || frame->size != this->size_ || frame->depth != this->depth_)
+			throw std::invalid_argument("The dimension of the frame is unmatched.");
+		std::unique_lock<std::mutex> guard(this->lock_);
+		if (this->closed_)
+			throw std::logic_error("The writer has been closed.");
+		this->hasSpace_.wait(guard, [this]()
+		{
+			return this->queue_.size() < this->options_.queueDepth || this->error_;
+		});
+		if (this->error_)
+			std::rethrow_exception(this->error_);
+		this->queue_.push_back(std::move(frame));
+		++this->nAccepted_;
+		guard.unlock();
+		this->hasWork_.notify_one();
+	}
+
+	/** The last chunk of direct I/O is padded to the alignment and the file is cut back to
+	the end of the last frame. */
+	template <typename T>
+	void FrameWriter<T>::Close(void)
+	{
+		{
+			std::lock_guard<std::mutex> guard(this->lock_);
+			if (this->closed_)
+				return;
+			this->closed_ = this->stop_ = true;
+		}
+		this->hasWork_.notify_one();
+		this->thread_.join();
+
+		if (!this->error_)
+		{
+			try
+			{
+				const ::size_t nBytes = this->used_;
+				const unsigned long long end = this->position_ + nBytes;
+				if (this->file_.IsDirect() && nBytes % RawFile::GetDirectAlignment() != 0)
+				{
+					::size_t alignment = RawFile::GetDirectAlignment();
+					this->used_ = (nBytes + alignment - 1) / alignment * alignment;
+					std::memset(this->chunk_.GetPointer() + nBytes, 0, this->used_ - nBytes);
+				}
+				this->Flush();
+				this->file_.Truncate(end);
+
+				RawSequenceHeader header;
+				header.size = this->size_;
+				header.depth = this->depth_;
+				header.dataType = GetEnviDataType<T>();
+				header.format = this->options_.format;
+				header.order = this->options_.order == ByteOrder::NATIVE ?
+					GetNativeByteOrder() : this->options_.order;
+				header.nFrames = this->nAccepted_;
+				AlignedBuffer text(RawSequenceHeader::GetSize(), RawFile::GetDirectAlignment());
+				std::memset(text.GetPointer(), 0, text.GetSize());
+				std::string str = header.ToString();
+				std::memcpy(text.GetPointer(), str.data(), std::min(str.size(), text.GetSize()));
+				this->file_.WriteAt(0, text.GetPointer(), text.GetSize());
+				this->file_.Sync();
+			}
+			catch (...)
+			{
+				this->error_ = std::current_exception();
+			}
+		}
+		this->file_.Close();
+		if (this->error_)
+			std::rethrow_exception(this->error_);
+	}
+
+	template <typename T>
+	void FrameWriter<T>::Run(void)
+	{
+		const bool swap = NeedsSwap(this->options_.order);
+		for (;;)
+		{
+			ConstFramePtr frame;
+			{
+				std::unique_lock<std::mutex> guard(this->lock_);
+				this->hasWork_.wait(guard, [this]() { return this->stop_ || !this->queue_.empty(); });
+				if (this->queue_.empty())
+					return;		// stopped and drained
+				frame = this->queue_.front();
+			}
+
+			std::exception_ptr error;
+			try
+			{
+				if (swap)
+					this->WriteFrame(*frame, [](T value) { return SwapBytes(value); });
+				else
+					this->WriteFrame(*frame, [](T value) { return value; });
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			// The frame leaves the queue after it is written, so queueDepth bounds the
+			// frames held by this writer.
+			{
+				std::lock_guard<std::mutex> guard(this->lock_);
+				this->queue_.pop_front();
+				if (error)
+				{
+					this->error_ = error;
+					this->queue_.clear();
+				}
+			}
+			this->hasSpace_.notify_all();
+			if (error)
+				return;
+		}
+	}
+
+	/** Samples are emitted in the order of the file by lines of the source, i.e., a line
+	of all channels for BIP, and a line of a channel for BIL and BSQ. */
+	template <typename T>
+	template <typename F>
+	void FrameWriter<T>::WriteFrame(const ImageFrame<T> &img, F load)
+	{
+		const ::size_t width = this->size_.width, height = this->size_.height;
+		const ::size_t d = this->depth_;
+		const T *src = img.data.data();
+		switch (this->options_.format)
+		{
+		case RawImageFormat::BIP:
+			for (::size_t Y = 0; Y != height; ++Y)
+			{
+				const T *it_src = src + d * width * Y;
+				this->Append(d * width, [=](T *dst)
+				{
+					for (::size_t I = 0; I != d * width; ++I)
+						dst[I] = load(it_src[I]);
+				});
+			}
+			break;
+		case RawImageFormat::BIL:
+			for (::size_t Y = 0; Y != height; ++Y)
+				for (::size_t C = 0; C != d; ++C)
+				{
+					const T *it_src = src + d * width * Y + C;
+					this->Append(width, [=](T *dst)
+					{
+						for (::size_t X = 0; X != width; ++X)
+							dst[X] = load(it_src[d * X]);
+					});
+				}
+			break;
+		case RawImageFormat::BSQ:
+			for (::size_t C = 0; C != d; ++C)
+				for (::size_t Y = 0; Y != height; ++Y)
+				{
+					const T *it_src = src + d * width * Y + C;
+					this->Append(width, [=](T *dst)
+					{
+						for (::size_t X = 0; X != width; ++X)
+							dst[X] = load(it_src[d * X]);
+					});
+				}
+			break;
+		default:
+			break;
+		}
+
+		if (this->options_.syncInterval != 0 &&
+			++this->nSinceSync_ >= this->options_.syncInterval)
+		{
+			this->FlushAligned();
+			this->file_.Sync();
+			this->nSinceSync_ = 0;
+		}
+	}
+
+	/** A line which does not fit into the rest of the chunk is converted into a line
+	buffer first, and split across the chunks. */
+	template <typename T>
+	template <typename F>
+	void FrameWriter<T>::Append(::size_t nSamples, F fill)
+	{
+		const ::size_t nBytes = nSamples * sizeof(T);
+		if (this->used_ + nBytes <= this->chunk_.GetSize())
+		{
+			fill(reinterpret_cast<T *>(this->chunk_.GetPointer() + this->used_));
+			this->used_ += nBytes;
+		}
+		else
+		{
+			this->line_.resize(nSamples);
+			fill(this->line_.data());
+			const char *it_src = reinterpret_cast<const char *>(this->line_.data());
+			for (::size_t done = 0; done != nBytes;)
+			{
+				::size_t n = std::min(nBytes - done, this->chunk_.GetSize() - this->used_);
+				std::memcpy(this->chunk_.GetPointer() + this->used_, it_src + done, n);
+				this->used_ += n;
+				done += n;
+				if (this->used_ == this->chunk_.GetSize())
+					this->Flush();
+			}
+		}
+		if (this->used_ == this->chunk_.GetSize())
+			this->Flush();
+	}
+
+	template <typename T>
+	void FrameWriter<T>::Flush(void)
+	{
+		if (this->used_ == 0)
+			return;
+		this->file_.WriteAt(this->position_, this->chunk_.GetPointer(), this->used_);
+		this->position_ += this->used_;
+		this->used_ = 0;
+	}
+
+	/** Direct I/O writes only whole blocks, so the rest of the chunk is moved to its start
+	and written with the next chunk. */
+	template <typename T>
+	void FrameWriter<T>::FlushAligned(void)
+	{
+		if (!this->file_.IsDirect())
+			return this->Flush();
+		const ::size_t alignment = RawFile::GetDirectAlignment();
+		const ::size_t nBytes = this->used_ / alignment * alignment;
+		if (nBytes == 0)
+			return;
+		this->file_.WriteAt(this->position_, this->chunk_.GetPointer(), nBytes);
+		this->position_ += nBytes;
+		this->used_ -= nBytes;
+		std::memmove(this->chunk_.GetPointer(), this->chunk_.GetPointer() + nBytes,
+			this->used_);
+	}
+}
+
+#endif
@@ -5,6 +5,9 @@
 #include <sstream>
 
 #include "coordinates.h"
+#include "../Utilities/byte_order.h"
+#include "../Utilities/instrumentation.h"
+#include "kernels.h"
 
 namespace Imaging
 {
@@ -13,13 +16,42 @@ namespace Imaging
 
 	The structure of source data is assumed to be identical to the image data of
 	ImageFrame<T> class as channel -> pixel -> line -> frame.
+	If source samples are stored in the other byte order than this machine, the bytes of
+	each sample are swapped while copying, so no separate pass is needed.
 	@NOTE Users must ensure the source memory is correctly allocated for the given
 	dimension.
 	@NOTE Destination will be reallocated based on the size of source data.
 	*/
 	template <typename T>
 	void Copy(const void *src, ::size_t width, ::size_t height, ::size_t depth,
-		::size_t bytesPerLine, std::vector<T> &dst);
+		::size_t bytesPerLine, std::vector<T> &dst, ByteOrder order = ByteOrder::NATIVE);
+
+	/** Presents the packing of 10-bit or 12-bit mono samples from machine vision sensors.
+
+	MONO10P: 4 samples in 5 bytes, LSB first (GenICam Mono10p)
+	MONO12P: 2 samples in 3 bytes, LSB first (GenICam Mono12p)
+	MONO10_PACKED: 2 samples in 3 bytes; the 8 most significant bits of each sample in the
+	1st and 3rd bytes, and the 2 least significant bits in the 2nd byte (GigE Vision)
+	MONO12_PACKED: same as MONO10_PACKED with 4 least significant bits (GigE Vision)
+	*/
+	enum class Packing {MONO10P, MONO12P, MONO10_PACKED, MONO12_PACKED};
+
+	/** Gets the number of effective bytes of a line of packed samples. */
+	inline ::size_t GetPackedBytesPerLine(::size_t width, Packing packing);
+
+	/** Copies packed 10-bit or 12-bit mono samples from a void raw pointer to an
+	std::vector<unsigned short> object after taking out padding bytes.
+
+	Samples are unpacked line by line while reading the source, so padding bytes are
+	skipped in the same pass. Each line must start at the beginning of a byte.
+	@NOTE Destination will be reallocated based on the size of source data.
+	*/
+	inline void Copy(const void *src, ::size_t width, ::size_t height,
+		::size_t bytesPerLine, Packing packing, std::vector<unsigned short> &dst);
+
+	/** Unpacks a line of packed samples. */
+	inline void Unpack(const unsigned char *src, ::size_t width, Packing packing,
+		unsigned short *dst);
 
 	/** Copies lines of data repeatedly from an std::vector<T> to another.
 	
@@ -38,6 +70,12 @@ namespace Imaging
 	void CopyLines(typename std::vector<T>::const_iterator it_src, ::size_t nElemPerLineSrc,
 		T *dst, ::size_t nElemPerLineDst, ::size_t nElemWidth, ::size_t nLines);
 
+	/** Copies samples from a raw pointer to another, reversing the bytes of each sample.
+
+	dst may be src to swap in place. */
+	template <typename T>
+	void CopySwapped(const T *src, ::size_t n, T *dst);
+
 	/** Reorganizes data samples in std::vector<T> from BSQ to BIP format.
 	
 	Since data samples in source data is continuous through the whole band, the number of
@@ -46,7 +84,16 @@ namespace Imaging
 	template <typename T>
 	void BsqToBip(const std::vector<T> &src,
 		typename std::vector<T>::size_type nBands,
-		typename std::vector<T>::size_type nSamplesPerBand, std::vector<T> &dst);
+		typename std::vector<T>::size_type nSamplesPerBand, std::vector<T> &dst,
+		ByteOrder order = ByteOrder::NATIVE);
+
+	/** Reorganizes data samples from a void raw pointer from BSQ to BIP format, swapping
+	bytes of each sample if the byte order of source is different from this machine.
+
+	@NOTE Destination will be reallocated based on the size of source data. */
+	template <typename T>
+	void BsqToBip(const void *src, ::size_t nBands, ::size_t nSamplesPerBand,
+		std::vector<T> &dst, ByteOrder order = ByteOrder::NATIVE);
 
 	/** Reorganizes data samples in std::vector<T> from BIL to BIP format.
 	
@@ -56,7 +103,16 @@ namespace Imaging
 	void BilToBip(const std::vector<T> &src,
 		typename std::vector<T>::size_type nBands,
 		typename std::vector<T>::size_type nSamplesPerLine,
-		typename std::vector<T>::size_type nLinesPerBand, std::vector<T> &dst);
+		typename std::vector<T>::size_type nLinesPerBand, std::vector<T> &dst,
+		ByteOrder order = ByteOrder::NATIVE);
+
+	/** Reorganizes data samples from a void raw pointer from BIL to BIP format, swapping
+	bytes of each sample if the byte order of source is different from this machine.
+
+	@NOTE Destination will be reallocated based on the size of source data. */
+	template <typename T>
+	void BilToBip(const void *src, ::size_t nBands, ::size_t nSamplesPerLine,
+		::size_t nLinesPerBand, std::vector<T> &dst, ByteOrder order = ByteOrder::NATIVE);
 
 	// TODO: Convert BIP to BSQ
 
@@ -82,6 +138,28 @@ namespace Imaging
 	*/
 	enum class RawImageFormat {UNKNOWN, BIP, BSQ, BIL};
 
+	/** Presents the interpolation of samples between pixels for Resize() and the warps of
+	warp.h.
+
+	NEAREST: nearest neighbor
+	LINEAR: bilinear interpolation of 2 x 2 pixels
+	AREA: average of the source pixels covered by a destination pixel for Resize(), and
+	LINEAR for the warps
+	CUBIC: bicubic interpolation of 4 x 4 pixels
+	LANCZO: Lanczos interpolation of 8 x 8 pixels
+	*/
+	enum class Interpolation {NEAREST, LINEAR, AREA, CUBIC, LANCZO};
+
+	/** Gets the ENVI data type code of T; 1 (8-bit unsigned), 2 (16-bit signed), 3 (32-bit
+	signed), 4 (float), 5 (double), 12 (16-bit unsigned), 13 (32-bit unsigned), 14 (64-bit
+	signed), 15 (64-bit unsigned), or 0 for other types. */
+	template <typename T>
+	int GetEnviDataType(void);
+
+	/** Element-wise expression of frames defined in image_expression.h. */
+	template <typename E>
+	class FrameExpression;
+
 	/** Pixel-based bitmap (raster) image.
 
 	This class stores image data as a std::vector<T> object, so it does NOT need to release
@@ -121,6 +199,10 @@ namespace Imaging
 		ImageFrame(ImageFrame<T> &&src);
 		ImageFrame<T> &operator=(ImageFrame<T> src);
 
+		/** Evaluates an expression of frames in a single pass (see image_expression.h). */
+		template <typename E>
+		ImageFrame<T> &operator=(const FrameExpression<E> &expr);
+
 		//////////////////////////////////////////////////
 		// Custom constructors.
 		ImageFrame(const Size2D<SizeType> &sz, SizeType d = 1);
@@ -162,17 +244,19 @@ namespace Imaging
 		The structure of source data is assumed to be identical to the image data of
 		ImageFrame<T> class. */
 		void CopyFrom(const T *src, const Size2D<SizeType> &sz, SizeType d,
-			::size_t bytesPerLine);
+			::size_t bytesPerLine, ByteOrder order = ByteOrder::NATIVE);
 		void CopyFrom(const T *src, SizeType w, SizeType h, SizeType d,
-			::size_t bytesPerLine);
+			::size_t bytesPerLine, ByteOrder order = ByteOrder::NATIVE);
 
 		/** Copies image data of an entire image from a raw pointer WITHOUT processing
 		padding bytes.
 		
 		@NOTE destination is reallocated based on the size of source image.
-		@NOTE Users must ensure there is no padding bytes at source data. */
+		@NOTE Users must ensure there is no padding bytes at source data.
+		@NOTE The format conversion and the byte swap are done in a single pass from
+		source. */
 		void CopyFrom(const T *src, const Size2D<SizeType> &sz, SizeType d,
-			RawImageFormat fmt = RawImageFormat::BIP);
+			RawImageFormat fmt = RawImageFormat::BIP, ByteOrder order = ByteOrder::NATIVE);
 
 		/** Copies image data from an std::vector<T> object.
 		
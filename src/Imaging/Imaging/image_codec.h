@@ -0,0 +1,259 @@
+#if !defined(IMAGE_CODEC_H)
+#define IMAGE_CODEC_H
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "image.h"
+#include "../Utilities/inflate.h"
+
+namespace Imaging
+{
+	/** Presents the format of an image file, detected from its first bytes.
+
+	PNM: binary and ASCII PBM, PGM and PPM (P1 - P6)
+	PNG: all color types and bit depths, including Adam7 interlacing
+	TIFF: strips of uncompressed or deflate (zlib) data, chunky or planar, 8/16/32-bit
+	integer or 32-bit floating point samples, with multiple pages */
+	enum class ImageFileFormat {UNKNOWN, PNM, PNG, TIFF};
+
+	/** Presents the type of the samples decoded from an image file. */
+	enum class SampleType {UINT8, UINT16, UINT32, FLOAT32};
+
+	/** Gets the number of bytes of a sample of given type. */
+	inline ::size_t GetSampleBytes(SampleType type);
+
+	/** Checks if T is the type of given sample type. */
+	template <typename T>
+	bool IsSampleType(SampleType type);
+
+	/** Detects the format of a file.
+
+	@exception std::runtime_error	if the file cannot be opened */
+	inline ImageFileFormat GetImageFileFormat(const std::string &path);
+
+	/** Decodes an image file row by row.
+
+	Rows are decoded in order from the top of the selected page into a buffer given by the
+	caller, so only a few rows of the image are held by the decoder regardless of the size
+	of the image, except interlaced PNG files which are decoded as a whole.
+	Samples are BIP in the native byte order. Bit depths less than 8 are scaled to 8-bit,
+	and palettes are expanded to RGB (or RGBA if the palette has transparency).
+	@exception std::runtime_error	for files which are invalid, truncated or use features
+	not supported, at the construction or while decoding */
+	class ImageDecoder
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Destructors.
+		virtual ~ImageDecoder(void) {}
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		const Size2D<::size_t> &GetSize(void) const;
+		::size_t GetDepth(void) const;
+		SampleType GetSampleType(void) const;
+
+		/** Gets the number of bytes of a decoded row. */
+		::size_t GetRowBytes(void) const;
+
+		/** Gets the number of pages, e.g., the images of a multi-page TIFF file. */
+		virtual ::size_t GetPageCount(void) const;
+
+		::size_t GetPage(void) const;
+
+		/** Gets the row to be decoded by the next ReadRow(). */
+		::size_t GetNextRow(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Selects a page and restarts from its first row.
+
+		@exception std::out_of_range	if the page does not exist */
+		void SetPage(::size_t index);
+
+		/** Decodes the next row into GetRowBytes() bytes.
+
+		@exception std::out_of_range	if all rows of the page have been decoded */
+		void ReadRow(void *dst);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** @exception std::runtime_error	if the file cannot be opened */
+		ImageDecoder(const std::string &path);
+
+		ImageDecoder(const ImageDecoder &src) = delete;
+		ImageDecoder &operator=(const ImageDecoder &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Reads the header of a page, sets size_, depth_ and type_, and prepares decoding
+		from the first row. */
+		virtual void Start(::size_t page) = 0;
+
+		virtual void Decode(unsigned char *dst) = 0;
+
+		void ReadBytes(void *dst, ::size_t nBytes);
+		void Throw(const std::string &message) const;
+
+		//////////////////////////////////////////////////
+		// Data.
+		std::string path_;
+		std::ifstream file_;
+		Size2D<::size_t> size_;
+		::size_t depth_;
+		SampleType type_;
+		::size_t page_, row_;
+	};
+
+	/** Decoder of PBM, PGM and PPM files.
+
+	Samples are 8-bit if the maximum value is less than 256, or 16-bit otherwise, without
+	scaling by the maximum value. PBM files are decoded as 0 for black and 255 for white. */
+	class PnmDecoder : public ImageDecoder
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		PnmDecoder(const std::string &path);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void Start(::size_t page) override;
+		void Decode(unsigned char *dst) override;
+		unsigned ReadNumber(void);
+
+		//////////////////////////////////////////////////
+		// Data.
+		char kind_;
+		unsigned maxValue_;
+		std::vector<unsigned char> line_;
+	};
+
+	/** Decoder of PNG files.
+
+	The image data chunks are inflated as they are read, and each row is unfiltered
+	against the previous row only. CRCs are not verified. */
+	class PngDecoder : public ImageDecoder
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		PngDecoder(const std::string &path);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void Start(::size_t page) override;
+		void Decode(unsigned char *dst) override;
+		::size_t ReadData(unsigned char *dst, ::size_t nBytes);
+		void ReadFilteredRow(::size_t nBytes);
+		void ExpandRow(const unsigned char *src, ::size_t width, unsigned char *dst) const;
+		void DecodeInterlaced(void);
+
+		//////////////////////////////////////////////////
+		// Data.
+		unsigned bitDepth_, colorType_, bytesPerPixel_;
+		bool interlaced_;
+		std::vector<unsigned char> palette_;	// RGBA
+		Inflater inflater_;
+		::size_t nChunkLeft_;
+		bool dataEnded_;
+		std::vector<unsigned char> prior_, current_;
+		std::vector<unsigned char> image_;		// decoded rows of interlaced images
+	};
+
+	/** Decoder of baseline TIFF files.
+
+	Each strip is read or inflated as its rows are decoded, so a row costs one strip
+	reader per plane. Tiled images, JPEG or LZW compression and palettes are not
+	supported. */
+	class TiffDecoder : public ImageDecoder
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		TiffDecoder(const std::string &path);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		::size_t GetPageCount(void) const override;
+
+	protected:
+		//////////////////////////////////////////////////
+		// Types and constants.
+
+		/** Reads the bytes of a strip, inflating them if compressed. */
+		class StripReader
+		{
+		public:
+			StripReader(void) : position(0), nLeft(0), compressed(false) {}
+			unsigned long long position;
+			unsigned long long nLeft;
+			bool compressed;
+			Inflater inflater;
+		};
+
+		//////////////////////////////////////////////////
+		// Methods.
+		void Start(::size_t page) override;
+		void Decode(unsigned char *dst) override;
+		unsigned ReadUnsigned(::size_t nBytes);
+		std::vector<unsigned> ReadValues(unsigned long long entry);
+		void OpenStrip(::size_t plane, ::size_t strip);
+		void ReadStrip(::size_t plane, unsigned char *dst, ::size_t nBytes);
+
+		//////////////////////////////////////////////////
+		// Data.
+		bool swap_;
+		unsigned long long fileSize_;
+		std::vector<unsigned long long> pages_;		// positions of the IFDs
+		::size_t rowsPerStrip_, stripsPerPlane_, nPlanes_, sampleBytes_;
+		unsigned compression_, predictor_;
+		bool whiteIsZero_;
+		std::vector<unsigned> stripOffsets_, stripBytes_;
+		std::vector<StripReader> strips_;
+		std::vector<unsigned char> line_;
+	};
+
+	/** Opens a decoder for the format of a file.
+
+	@exception std::runtime_error	if the file cannot be opened or the format is unknown */
+	inline std::unique_ptr<ImageDecoder> OpenImageDecoder(const std::string &path);
+
+	/** Decodes the current page of a decoder from its first row.
+
+	Rows are decoded directly into the destination if T is the sample type of the file, or
+	through a row buffer converted by static_cast otherwise.
+	@NOTE Destination is reset to the size of the image; the memory is not reallocated if
+	it already has the same number of samples, so a preallocated frame can be reused for a
+	sequence of images. */
+	template <typename T>
+	void ReadImage(ImageDecoder &decoder, ImageFrame<T> &dst);
+
+	/** Decodes a page of an image file. */
+	template <typename T>
+	void ReadImage(const std::string &path, ImageFrame<T> &dst, ::size_t page = 0);
+
+	/** Decodes all pages of an image file as frames. */
+	template <typename T>
+	void ReadImagePages(const std::string &path, std::vector<ImageFrame<T>> &dst);
+
+	/** Decodes the first page of multiple files in parallel by ParallelFor().
+
+	@exception any exception thrown by decoding; the first one is rethrown after all threads
+	have been joined */
+	template <typename T>
+	void ReadImages(const std::vector<std::string> &paths, std::vector<ImageFrame<T>> &dst);
+}
+
+#include "image_codec_inl.h"
+
+#endif
@@ -0,0 +1,864 @@
+#if !defined(IMAGE_CODEC_INL_H)
+#define IMAGE_CODEC_INL_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <type_traits>
+
+#include "../Utilities/byte_order.h"
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	inline ::size_t GetSampleBytes(SampleType type)
+	{
+		return type == SampleType::UINT8 ? 1 : (type == SampleType::UINT16 ? 2 : 4);
+	}
+
+	template <typename T>
+	bool IsSampleType(SampleType type)
+	{
+		switch (type)
+		{
+		case SampleType::UINT8:
+			return std::is_same<T, unsigned char>::value;
+		case SampleType::UINT16:
+			return std::is_same<T, unsigned short>::value;
+		case SampleType::UINT32:
+			return std::is_same<T, unsigned int>::value;
+		case SampleType::FLOAT32:
+			return std::is_same<T, float>::value;
+		default:
+			return false;
+		}
+	}
+
+	inline ImageFileFormat GetImageFileFormat(const std::string &path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			throw std::runtime_error("Failed to open " + path);
+		unsigned char magic[8] = {};
+		file.read(reinterpret_cast<char *>(magic), 8);
+		const unsigned char png[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+		if (file.gcount() == 8 && std::equal(magic, magic + 8, png))
+			return ImageFileFormat::PNG;
+		if (file.gcount() >= 4 && ((magic[0] == 'I' && magic[1] == 'I' && magic[3] == 0 &&
+			(magic[2] == 42 || magic[2] == 43)) || (magic[0] == 'M' && magic[1] == 'M' &&
+			magic[2] == 0 && (magic[3] == 42 || magic[3] == 43))))
+			return ImageFileFormat::TIFF;
+		if (file.gcount() >= 2 && magic[0] == 'P' && magic[1] >= '1' && magic[1] <= '6')
+			return ImageFileFormat::PNM;
+		return ImageFileFormat::UNKNOWN;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// ImageDecoder class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	inline ImageDecoder::ImageDecoder(const std::string &path) : path_(path),
+		file_(path, std::ios::binary), size_(0, 0), depth_(0), type_(SampleType::UINT8),
+		page_(0), row_(0)
+	{
+		if (!this->file_)
+			throw std::runtime_error("Failed to open " + path);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline const Size2D<::size_t> &ImageDecoder::GetSize(void) const
+	{
+		return this->size_;
+	}
+
+	inline ::size_t ImageDecoder::GetDepth(void) const
+	{
+		return this->depth_;
+	}
+
+	inline SampleType ImageDecoder::GetSampleType(void) const
+	{
+		return this->type_;
+	}
+
+	inline ::size_t ImageDecoder::GetRowBytes(void) const
+	{
+		return this->size_.width * this->depth_ * GetSampleBytes(this->type_);
+	}
+
+	inline ::size_t ImageDecoder::GetPageCount(void) const
+	{
+		return 1;
+	}
+
+	inline ::size_t ImageDecoder::GetPage(void) const
+	{
+		return this->page_;
+	}
+
+	inline ::size_t ImageDecoder::GetNextRow(void) const
+	{
+		return this->row_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	inline void ImageDecoder::SetPage(::size_t index)
+	{
+		if (index >= this->GetPageCount())
+		{
+			std::ostringstream errMsg;
+			errMsg << "Page " << index << " is out of range.";
+			throw std::out_of_range(errMsg.str());
+		}
+		this->file_.clear();
+		this->Start(index);
+		this->page_ = index;
+		this->row_ = 0;
+	}
+
+	inline void ImageDecoder::ReadRow(void *dst)
+	{
+		if (this->row_ >= this->size_.height)
+			throw std::out_of_range("All rows of the page have been decoded.");
+		this->Decode(static_cast<unsigned char *>(dst));
+		++this->row_;
+	}
+
+	inline void ImageDecoder::ReadBytes(void *dst, ::size_t nBytes)
+	{
+		this->file_.read(static_cast<char *>(dst), static_cast<std::streamsize>(nBytes));
+		if (static_cast<::size_t>(this->file_.gcount()) != nBytes)
+			this->Throw("The file is truncated.");
+	}
+
+	inline void ImageDecoder::Throw(const std::string &message) const
+	{
+		throw std::runtime_error(this->path_ + ": " + message);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// PnmDecoder class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	inline PnmDecoder::PnmDecoder(const std::string &path) : ImageDecoder(path), kind_(0),
+		maxValue_(0)
+	{
+		this->Start(0);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	inline void PnmDecoder::Start(::size_t)
+	{
+		this->file_.seekg(0);
+		char magic[2] = {};
+		this->ReadBytes(magic, 2);
+		if (magic[0] != 'P' || magic[1] < '1' || magic[1] > '6')
+			this->Throw("The file is not a PNM file.");
+		this->kind_ = magic[1];
+		this->size_.width = this->ReadNumber();
+		this->size_.height = this->ReadNumber();
+		const bool bitmap = this->kind_ == '1' || this->kind_ == '4';
+		this->maxValue_ = bitmap ? 1 : this->ReadNumber();
+		if (this->size_.width == 0 || this->size_.height == 0 || this->maxValue_ == 0 ||
+			this->maxValue_ > 65535)
+			this->Throw("The header of the PNM file is invalid.");
+		this->depth_ = this->kind_ == '3' || this->kind_ == '6' ? 3 : 1;
+		this->type_ = this->maxValue_ < 256 ? SampleType::UINT8 : SampleType::UINT16;
+		if (this->kind_ == '4')
+			this->line_.resize((this->size_.width + 7) / 8);
+	}
+
+	/** ASCII samples are read one by one, and a plain PBM sample is a single digit which
+	may not be separated by whitespace. */
+	inline void PnmDecoder::Decode(unsigned char *dst)
+	{
+		const ::size_t nSamples = this->size_.width * this->depth_;
+		unsigned short *dst16 = reinterpret_cast<unsigned short *>(dst);
+		switch (this->kind_)
+		{
+		case '1':
+			for (::size_t I = 0; I != nSamples; ++I)
+			{
+				int c = this->file_.get();
+				while (std::isspace(c) || c == '#')
+				{
+					if (c == '#')
+						while (c != '\n' && c != EOF)
+							c = this->file_.get();
+					c = this->file_.get();
+				}
+				if (c != '0' && c != '1')
+					this->Throw("The PBM file has an invalid sample.");
+				dst[I] = c == '1' ? 0 : 255;
+			}
+			break;
+		case '2':
+		case '3':
+			for (::size_t I = 0; I != nSamples; ++I)
+			{
+				unsigned value = this->ReadNumber();
+				if (this->type_ == SampleType::UINT8)
+					dst[I] = static_cast<unsigned char>(value);
+				else
+					dst16[I] = static_cast<unsigned short>(value);
+			}
+			break;
+		case '4':
+			this->ReadBytes(this->line_.data(), this->line_.size());
+			for (::size_t X = 0; X != nSamples; ++X)
+				dst[X] = (this->line_[X / 8] >> (7 - X % 8)) & 1 ? 0 : 255;
+			break;
+		default:
+			this->ReadBytes(dst, this->GetRowBytes());
+			if (this->type_ == SampleType::UINT16 && NeedsSwap(ByteOrder::BIG))
+				SwapBytes(dst16, nSamples);
+			break;
+		}
+	}
+
+	/** Reads a decimal number after whitespace and comments. The character after the number
+	is consumed, which is the single whitespace before the samples of a binary file. */
+	inline unsigned PnmDecoder::ReadNumber(void)
+	{
+		int c = this->file_.get();
+		while (std::isspace(c) || c == '#')
+		{
+			if (c == '#')
+				while (c != '\n' && c != EOF)
+					c = this->file_.get();
+			c = this->file_.get();
+		}
+		if (!std::isdigit(c))
+			this->Throw("The PNM file has an invalid number.");
+		unsigned long long value = 0;
+		for (; std::isdigit(c); c = this->file_.get())
+		{
+			value = 10 * value + static_cast<unsigned>(c - '0');
+			if (value > 0xFFFFFFFFull)
+				this->Throw("The PNM file has an invalid number.");
+		}
+		return static_cast<unsigned>(value);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// PngDecoder class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	inline PngDecoder::PngDecoder(const std::string &path) : ImageDecoder(path),
+		bitDepth_(0), colorType_(0), bytesPerPixel_(1), interlaced_(false), nChunkLeft_(0),
+		dataEnded_(true)
+	{
+		this->Start(0);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+
+	/** Chunks are read up to the first image data chunk. */
+	inline void PngDecoder::Start(::size_t)
+	{
+		auto ReadUnsigned = [this]() -> unsigned
+		{
+			unsigned char bytes[4];
+			this->ReadBytes(bytes, 4);
+			return (static_cast<unsigned>(bytes[0]) << 24) | (bytes[1] << 16) |
+				(bytes[2] << 8) | bytes[3];
+		};
+
+		this->file_.seekg(0);
+		unsigned char signature[8];
+		const unsigned char png[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+		this->ReadBytes(signature, 8);
+		if (!std::equal(signature, signature + 8, png))
+			this->Throw("The file is not a PNG file.");
+
+		this->palette_.assign(4 * 256, 0);
+		for (::size_t I = 0; I != 256; ++I)
+			this->palette_[4 * I + 3] = 255;
+		bool hasHeader = false, hasAlpha = false;
+		for (;;)
+		{
+			unsigned length = ReadUnsigned();
+			char type[4];
+			this->ReadBytes(type, 4);
+			std::string name(type, 4);
+			if (name == "IDAT")
+			{
+				this->nChunkLeft_ = length;
+				break;
+			}
+			std::vector<unsigned char> data(length);
+			if (length != 0)
+				this->ReadBytes(data.data(), length);
+			this->file_.seekg(4, std::ios::cur);	// CRC
+			if (name == "IHDR" && length == 13)
+			{
+				this->size_.width = (static_cast<::size_t>(data[0]) << 24) | (data[1] << 16) |
+					(data[2] << 8) | data[3];
+				this->size_.height = (static_cast<::size_t>(data[4]) << 24) | (data[5] << 16) |
+					(data[6] << 8) | data[7];
+				this->bitDepth_ = data[8];
+				this->colorType_ = data[9];
+				if (data[10] != 0 || data[11] != 0 || data[12] > 1)
+					this->Throw("The PNG file uses an unknown method.");
+				this->interlaced_ = data[12] == 1;
+				hasHeader = true;
+			}
+			else if (name == "PLTE")
+				for (::size_t I = 0; I != std::min<::size_t>(length / 3, 256); ++I)
+					std::copy(&data[3 * I], &data[3 * I] + 3, &this->palette_[4 * I]);
+			else if (name == "tRNS" && this->colorType_ == 3)
+			{
+				for (::size_t I = 0; I != std::min<::size_t>(length, 256); ++I)
+					this->palette_[4 * I + 3] = data[I];
+				hasAlpha = true;
+			}
+			else if (name == "IEND")
+				this->Throw("The PNG file has no image data.");
+		}
+
+		const unsigned b = this->bitDepth_;
+		unsigned nChannels = 0;
+		bool valid = false;
+		switch (this->colorType_)
+		{
+		case 0:
+			nChannels = 1;
+			valid = b == 1 || b == 2 || b == 4 || b == 8 || b == 16;
+			break;
+		case 2:
+			nChannels = 3;
+			valid = b == 8 || b == 16;
+			break;
+		case 3:
+			nChannels = 1;
+			valid = b == 1 || b == 2 || b == 4 || b == 8;
+			break;
+		case 4:
+			nChannels = 2;
+			valid = b == 8 || b == 16;
+			break;
+		case 6:
+			nChannels = 4;
+			valid = b == 8 || b == 16;
+			break;
+		}
+		if (!hasHeader || !valid || this->size_.width == 0 || this->size_.height == 0)
+			this->Throw("The header of the PNG file is invalid.");
+		this->depth_ = this->colorType_ == 3 ? (hasAlpha ? 4 : 3) : nChannels;
+		this->type_ = b == 16 ? SampleType::UINT16 : SampleType::UINT8;
+		this->bytesPerPixel_ = std::max(1u, nChannels * b / 8);
+
+		// Rows are padded at the front by a zero pixel for the filters.
+		::size_t nBytes = (this->size_.width * nChannels * b + 7) / 8 + this->bytesPerPixel_;
+		this->prior_.assign(nBytes, 0);
+		this->current_.assign(nBytes, 0);
+		this->dataEnded_ = false;
+		this->inflater_.Reset([this](unsigned char *dst, ::size_t n)
+		{
+			return this->ReadData(dst, n);
+		});
+		if (this->interlaced_)
+			this->DecodeInterlaced();
+		else
+			this->image_.clear();
+	}
+
+	inline void PngDecoder::Decode(unsigned char *dst)
+	{
+		if (this->interlaced_)
+		{
+			const ::size_t nBytes = this->GetRowBytes();
+			std::copy(this->image_.data() + nBytes * this->row_,
+				this->image_.data() + nBytes * (this->row_ + 1), dst);
+		}
+		else
+		{
+			this->ReadFilteredRow(this->current_.size() - this->bytesPerPixel_);
+			this->ExpandRow(this->current_.data() + this->bytesPerPixel_, this->size_.width,
+				dst);
+		}
+	}
+
+	/** Source of the inflater, which continues into the next chunk as long as it is an
+	image data chunk. */
+	inline ::size_t PngDecoder::ReadData(unsigned char *dst, ::size_t nBytes)
+	{
+		while (this->nChunkLeft_ == 0)
+		{
+			if (this->dataEnded_)
+				return 0;
+			unsigned char header[12];
+			this->file_.read(reinterpret_cast<char *>(header), 12);	// CRC, length, type
+			if (this->file_.gcount() != 12 || std::string(header + 8, header + 12) != "IDAT")
+			{
+				this->dataEnded_ = true;
+				return 0;
+			}
+			this->nChunkLeft_ = (static_cast<::size_t>(header[4]) << 24) | (header[5] << 16) |
+				(header[6] << 8) | header[7];
+		}
+		nBytes = std::min(nBytes, this->nChunkLeft_);
+		this->ReadBytes(dst, nBytes);
+		this->nChunkLeft_ -= nBytes;
+		return nBytes;
+	}
+
+	/** Inflates the filter type and the bytes of a row into current_, which is unfiltered
+	against prior_ holding the previous row. */
+	inline void PngDecoder::ReadFilteredRow(::size_t nBytes)
+	{
+		std::swap(this->prior_, this->current_);
+		const ::size_t bpp = this->bytesPerPixel_;
+		unsigned char filter = 0;
+		unsigned char *cur = this->current_.data() + bpp;
+		const unsigned char *prior = this->prior_.data() + bpp;
+		if (this->inflater_.Read(&filter, 1) != 1 || this->inflater_.Read(cur, nBytes) != nBytes)
+			this->Throw("The image data of the PNG file is truncated.");
+
+		switch (filter)
+		{
+		case 0:
+			break;
+		case 1:
+			for (::size_t I = 0; I != nBytes; ++I)
+				cur[I] = static_cast<unsigned char>(cur[I] + *(cur + I - bpp));
+			break;
+		case 2:
+			for (::size_t I = 0; I != nBytes; ++I)
+				cur[I] = static_cast<unsigned char>(cur[I] + prior[I]);
+			break;
+		case 3:
+			for (::size_t I = 0; I != nBytes; ++I)
+				cur[I] = static_cast<unsigned char>(cur[I] + ((*(cur + I - bpp) + prior[I]) >> 1));
+			break;
+		case 4:
+			for (::size_t I = 0; I != nBytes; ++I)
+			{
+				int a = *(cur + I - bpp), b = prior[I], c = *(prior + I - bpp);
+				int pa = std::abs(b - c), pb = std::abs(a - c), pc = std::abs(a + b - 2 * c);
+				int predictor = pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+				cur[I] = static_cast<unsigned char>(cur[I] + predictor);
+			}
+			break;
+		default:
+			this->Throw("The PNG file has an invalid filter type.");
+		}
+	}
+
+	inline void PngDecoder::ExpandRow(const unsigned char *src, ::size_t width,
+		unsigned char *dst) const
+	{
+		const unsigned b = this->bitDepth_;
+		const unsigned char *palette = this->palette_.data();
+		if (b == 16)
+		{
+			unsigned short *dst16 = reinterpret_cast<unsigned short *>(dst);
+			for (::size_t I = 0; I != width * this->depth_; ++I)
+				dst16[I] = static_cast<unsigned short>((src[2 * I] << 8) | src[2 * I + 1]);
+		}
+		else if (this->colorType_ == 3)
+		{
+			const ::size_t d = this->depth_;
+			for (::size_t X = 0; X != width; ++X)
+			{
+				unsigned index = b == 8 ? src[X] :
+					(src[X * b / 8] >> (8 - b - X * b % 8)) & ((1u << b) - 1);
+				std::copy(palette + 4 * index, palette + 4 * index + d, dst + d * X);
+			}
+		}
+		else if (b == 8)
+			std::copy(src, src + width * this->depth_, dst);
+		else
+		{
+			const unsigned maxValue = (1u << b) - 1;
+			for (::size_t X = 0; X != width; ++X)
+				dst[X] = static_cast<unsigned char>(
+				((src[X * b / 8] >> (8 - b - X * b % 8)) & maxValue) * 255 / maxValue);
+		}
+	}
+
+	/** Each of the 7 passes of Adam7 is a reduced image with its own filtering, whose pixels
+	are scattered into the whole image. */
+	inline void PngDecoder::DecodeInterlaced(void)
+	{
+		static const ::size_t passes[7][4] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8},
+			{2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+		const ::size_t width = this->size_.width, height = this->size_.height;
+		const ::size_t pixelBytes = this->depth_ * GetSampleBytes(this->type_);
+		const ::size_t bitsPerPixel = (this->bytesPerPixel_ == 1 && this->bitDepth_ < 8) ?
+			this->bitDepth_ : 8 * this->bytesPerPixel_;
+		this->image_.resize(this->GetRowBytes() * height);
+		std::vector<unsigned char> line(this->GetRowBytes());
+		for (int P = 0; P != 7; ++P)
+		{
+			const ::size_t x0 = passes[P][0], y0 = passes[P][1];
+			const ::size_t dx = passes[P][2], dy = passes[P][3];
+			if (width <= x0 || height <= y0)
+				continue;
+			const ::size_t w = (width - x0 + dx - 1) / dx, h = (height - y0 + dy - 1) / dy;
+			std::fill(this->current_.begin(), this->current_.end(), 0);
+			for (::size_t Y = 0; Y != h; ++Y)
+			{
+				this->ReadFilteredRow((w * bitsPerPixel + 7) / 8);
+				this->ExpandRow(this->current_.data() + this->bytesPerPixel_, w, line.data());
+				unsigned char *row = this->image_.data() + this->GetRowBytes() * (y0 + dy * Y);
+				for (::size_t X = 0; X != w; ++X)
+					std::copy(&line[pixelBytes * X], &line[pixelBytes * X] + pixelBytes,
+					row + pixelBytes * (x0 + dx * X));
+			}
+		}
+	}
+
+	/** Undoes the horizontal differencing of TIFF (predictor 2) and inverts WhiteIsZero
+	samples, both in the arithmetic of T. */
+	template <typename T>
+	void UndoPredictor(T *data, ::size_t nSamples, ::size_t stride, bool predictor,
+		bool invert)
+	{
+		if (predictor)
+			for (::size_t I = stride; I < nSamples; ++I)
+				data[I] = static_cast<T>(data[I] + data[I - stride]);
+		if (invert)
+			for (::size_t I = 0; I != nSamples; ++I)
+				data[I] = static_cast<T>(~data[I]);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// TiffDecoder class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+
+	/** The chain of IFDs is walked once to count the pages. */
+	inline TiffDecoder::TiffDecoder(const std::string &path) : ImageDecoder(path),
+		swap_(false), fileSize_(0), rowsPerStrip_(0), stripsPerPlane_(0), nPlanes_(1),
+		sampleBytes_(1), compression_(1), predictor_(1), whiteIsZero_(false)
+	{
+		this->file_.seekg(0, std::ios::end);
+		this->fileSize_ = static_cast<unsigned long long>(this->file_.tellg());
+		this->file_.seekg(0);
+		char order[2] = {};
+		this->ReadBytes(order, 2);
+		if (order[0] != order[1] || (order[0] != 'I' && order[0] != 'M'))
+			this->Throw("The file is not a TIFF file.");
+		this->swap_ = NeedsSwap(order[0] == 'I' ? ByteOrder::LITTLE : ByteOrder::BIG);
+		unsigned magic = this->ReadUnsigned(2);
+		if (magic == 43)
+			this->Throw("BigTIFF files are not supported.");
+		if (magic != 42)
+			this->Throw("The file is not a TIFF file.");
+
+		for (unsigned long long position = this->ReadUnsigned(4); position != 0;)
+		{
+			if (position + 2 > this->fileSize_ ||
+				std::find(this->pages_.cbegin(), this->pages_.cend(), position) !=
+				this->pages_.cend())
+				this->Throw("The TIFF file has an invalid directory.");
+			this->pages_.push_back(position);
+			this->file_.seekg(static_cast<std::streamoff>(position));
+			unsigned nEntries = this->ReadUnsigned(2);
+			this->file_.seekg(static_cast<std::streamoff>(position + 2 + 12 * nEntries));
+			position = this->ReadUnsigned(4);
+		}
+		if (this->pages_.empty())
+			this->Throw("The TIFF file has no image.");
+		this->Start(0);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline ::size_t TiffDecoder::GetPageCount(void) const
+	{
+		return this->pages_.size();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	inline void TiffDecoder::Start(::size_t page)
+	{
+		const unsigned long long position = this->pages_[page];
+		this->file_.seekg(static_cast<std::streamoff>(position));
+		unsigned nEntries = this->ReadUnsigned(2);
+		std::map<unsigned, unsigned long long> entries;
+		for (unsigned I = 0; I != nEntries; ++I)
+		{
+			unsigned long long entry = position + 2 + 12 * I;
+			this->file_.seekg(static_cast<std::streamoff>(entry));
+			entries[this->ReadUnsigned(2)] = entry;
+		}
+		auto GetValues = [&](unsigned tag, unsigned defaultValue) -> std::vector<unsigned>
+		{
+			auto it = entries.find(tag);
+			if (it != entries.end())
+				return this->ReadValues(it->second);
+			if (defaultValue == 0)
+			{
+				std::ostringstream errMsg;
+				errMsg << "The TIFF file has no tag " << tag << ".";
+				this->Throw(errMsg.str());
+			}
+			return std::vector<unsigned>(1, defaultValue);
+		};
+		if (entries.count(322) != 0)
+			this->Throw("Tiled TIFF files are not supported.");
+
+		const unsigned width = GetValues(256, 0)[0], height = GetValues(257, 0)[0];
+		const std::vector<unsigned> bitsPerSample = GetValues(258, 1);
+		const unsigned compression = GetValues(259, 1)[0], photometric = GetValues(262, 1)[0];
+		const unsigned nSamples = GetValues(277, 1)[0], planar = GetValues(284, 1)[0];
+		const unsigned format = GetValues(339, 1)[0];
+		this->stripOffsets_ = GetValues(273, 0);
+		this->stripBytes_ = GetValues(279, 0);
+		this->rowsPerStrip_ = std::min(GetValues(278, height)[0], height);
+		this->predictor_ = GetValues(317, 1)[0];
+
+		const unsigned b = bitsPerSample[0];
+		if (width == 0 || height == 0 || nSamples == 0 || this->rowsPerStrip_ == 0)
+			this->Throw("The TIFF file has an invalid dimension.");
+		if (std::count(bitsPerSample.cbegin(), bitsPerSample.cend(), b) !=
+			static_cast<::ptrdiff_t>(bitsPerSample.size()) || (b != 8 && b != 16 && b != 32))
+			this->Throw("The bits per sample of the TIFF file is not supported.");
+		if ((format != 1 && format != 3) || (format == 3 && b != 32))
+			this->Throw("The sample format of the TIFF file is not supported.");
+		if (compression != 1 && compression != 8 && compression != 32946)
+			this->Throw("The compression of the TIFF file is not supported.");
+		if (photometric == 3)
+			this->Throw("Palette TIFF files are not supported.");
+		if (this->predictor_ != 1 && (this->predictor_ != 2 || format == 3))
+			this->Throw("The predictor of the TIFF file is not supported.");
+
+		this->size_ = Size2D<::size_t>(width, height);
+		this->depth_ = nSamples;
+		this->type_ = b == 8 ? SampleType::UINT8 : (b == 16 ? SampleType::UINT16 :
+			(format == 3 ? SampleType::FLOAT32 : SampleType::UINT32));
+		this->sampleBytes_ = b / 8;
+		this->compression_ = compression;
+		this->whiteIsZero_ = photometric == 0 && format == 1;
+		this->nPlanes_ = planar == 2 ? nSamples : 1;
+		this->stripsPerPlane_ = (height + this->rowsPerStrip_ - 1) / this->rowsPerStrip_;
+		if (this->stripOffsets_.size() < this->stripsPerPlane_ * this->nPlanes_ ||
+			this->stripBytes_.size() < this->stripOffsets_.size())
+			this->Throw("The TIFF file has an invalid number of strips.");
+		this->strips_.resize(this->nPlanes_);
+		this->line_.resize(this->nPlanes_ > 1 ? width * this->sampleBytes_ : 0);
+	}
+
+	/** Planar images read a row of each plane and interleave them. The byte order is
+	restored before the horizontal predictor is undone, as by libtiff. */
+	inline void TiffDecoder::Decode(unsigned char *dst)
+	{
+		const ::size_t width = this->size_.width, d = this->depth_, sb = this->sampleBytes_;
+		const ::size_t nSamples = width * d;
+		if (this->row_ % this->rowsPerStrip_ == 0)
+			for (::size_t P = 0; P != this->nPlanes_; ++P)
+				this->OpenStrip(P, this->row_ / this->rowsPerStrip_);
+
+		if (this->nPlanes_ == 1)
+			this->ReadStrip(0, dst, this->GetRowBytes());
+		else
+			for (::size_t P = 0; P != this->nPlanes_; ++P)
+			{
+				this->ReadStrip(P, this->line_.data(), width * sb);
+				for (::size_t X = 0; X != width; ++X)
+					std::copy(&this->line_[sb * X], &this->line_[sb * X] + sb,
+					dst + sb * (d * X + P));
+			}
+
+		if (this->swap_ && sb == 2)
+			SwapBytes(reinterpret_cast<unsigned short *>(dst), nSamples);
+		else if (this->swap_ && sb == 4)
+			SwapBytes(reinterpret_cast<unsigned int *>(dst), nSamples);
+
+		if (this->predictor_ == 2 || this->whiteIsZero_)
+		{
+			const bool predictor = this->predictor_ == 2, invert = this->whiteIsZero_;
+			if (sb == 1)
+				UndoPredictor(dst, nSamples, d, predictor, invert);
+			else if (sb == 2)
+				UndoPredictor(reinterpret_cast<unsigned short *>(dst), nSamples, d, predictor,
+				invert);
+			else
+				UndoPredictor(reinterpret_cast<unsigned int *>(dst), nSamples, d, predictor,
+				invert);
+		}
+	}
+
+	inline unsigned TiffDecoder::ReadUnsigned(::size_t nBytes)
+	{
+		unsigned char bytes[4] = {};
+		this->ReadBytes(bytes, nBytes);
+		unsigned value = 0;
+		for (::size_t I = 0; I != nBytes; ++I)
+		{
+			bool bigEndian = this->swap_ != (GetNativeByteOrder() == ByteOrder::BIG);
+			value |= static_cast<unsigned>(bytes[I]) << (8 * (bigEndian ? nBytes - 1 - I : I));
+		}
+		return value;
+	}
+
+	/** Values of up to 4 bytes are stored in the entry itself, and longer ones at the
+	offset stored in the entry. */
+	inline std::vector<unsigned> TiffDecoder::ReadValues(unsigned long long entry)
+	{
+		this->file_.seekg(static_cast<std::streamoff>(entry + 2));
+		unsigned type = this->ReadUnsigned(2), count = this->ReadUnsigned(4);
+		::size_t size = type == 1 || type == 6 || type == 7 ? 1 : (type == 3 || type == 8 ? 2 :
+			(type == 4 || type == 9 ? 4 : 0));
+		if (size == 0 || count == 0 || static_cast<unsigned long long>(size) * count >
+			this->fileSize_)
+			this->Throw("The TIFF file has an invalid tag.");
+		if (size * count > 4)
+			this->file_.seekg(static_cast<std::streamoff>(this->ReadUnsigned(4)));
+		std::vector<unsigned> values(count);
+		for (auto it = values.begin(); it != values.end(); ++it)
+			*it = this->ReadUnsigned(size);
+		return values;
+	}
+
+	inline void TiffDecoder::OpenStrip(::size_t plane, ::size_t strip)
+	{
+		const ::size_t index = this->stripsPerPlane_ * plane + strip;
+		StripReader &reader = this->strips_[plane];
+		reader.position = this->stripOffsets_[index];
+		reader.nLeft = this->stripBytes_[index];
+		reader.compressed = this->compression_ != 1;
+		if (reader.compressed)
+			reader.inflater.Reset([this, plane](unsigned char *dst, ::size_t nBytes)
+			{
+				StripReader &reader = this->strips_[plane];
+				nBytes = static_cast<::size_t>(std::min<unsigned long long>(nBytes,
+					reader.nLeft));
+				this->file_.seekg(static_cast<std::streamoff>(reader.position));
+				this->ReadBytes(dst, nBytes);
+				reader.position += nBytes;
+				reader.nLeft -= nBytes;
+				return nBytes;
+			});
+	}
+
+	inline void TiffDecoder::ReadStrip(::size_t plane, unsigned char *dst, ::size_t nBytes)
+	{
+		StripReader &reader = this->strips_[plane];
+		if (reader.compressed)
+		{
+			if (reader.inflater.Read(dst, nBytes) != nBytes)
+				this->Throw("The strip of the TIFF file is truncated.");
+		}
+		else
+		{
+			if (nBytes > reader.nLeft)
+				this->Throw("The strip of the TIFF file is truncated.");
+			this->file_.seekg(static_cast<std::streamoff>(reader.position));
+			this->ReadBytes(dst, nBytes);
+			reader.position += nBytes;
+			reader.nLeft -= nBytes;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Global functions
+
+	inline std::unique_ptr<ImageDecoder> OpenImageDecoder(const std::string &path)
+	{
+		switch (GetImageFileFormat(path))
+		{
+		case ImageFileFormat::PNM:
+			return std::unique_ptr<ImageDecoder>(new PnmDecoder(path));
+		case ImageFileFormat::PNG:
+			return std::unique_ptr<ImageDecoder>(new PngDecoder(path));
+		case ImageFileFormat::TIFF:
+			return std::unique_ptr<ImageDecoder>(new TiffDecoder(path));
+		default:
+			throw std::runtime_error(path + ": The format of the file is unknown.");
+		}
+	}
+
+	template <typename T, typename U>
+	void CastSamples(const unsigned char *src, ::size_t nSamples, T *dst)
+	{
+		const U *it_src = reinterpret_cast<const U *>(src);
+		for (::size_t I = 0; I != nSamples; ++I)
+			dst[I] = static_cast<T>(it_src[I]);
+	}
+
+	template <typename T>
+	void ReadImage(ImageDecoder &decoder, ImageFrame<T> &dst)
+	{
+		if (decoder.GetNextRow() != 0)
+			decoder.SetPage(decoder.GetPage());
+		dst.Reset(decoder.GetSize(), decoder.GetDepth());
+		const ::size_t height = decoder.GetSize().height;
+		if (IsSampleType<T>(decoder.GetSampleType()))
+		{
+			for (::size_t Y = 0; Y != height; ++Y)
+				decoder.ReadRow(dst.GetPointer(0, Y));
+			return;
+		}
+
+		const ::size_t nSamples = decoder.GetSize().width * decoder.GetDepth();
+		std::vector<unsigned char> line(decoder.GetRowBytes());
+		for (::size_t Y = 0; Y != height; ++Y)
+		{
+			decoder.ReadRow(line.data());
+			T *it_dst = dst.GetPointer(0, Y);
+			switch (decoder.GetSampleType())
+			{
+			case SampleType::UINT8:
+				CastSamples<T, unsigned char>(line.data(), nSamples, it_dst);
+				break;
+			case SampleType::UINT16:
+				CastSamples<T, unsigned short>(line.data(), nSamples, it_dst);
+				break;
+			case SampleType::UINT32:
+				CastSamples<T, unsigned int>(line.data(), nSamples, it_dst);
+				break;
+			case SampleType::FLOAT32:
+				CastSamples<T, float>(line.data(), nSamples, it_dst);
+				break;
+			}
+		}
+	}
+
+	template <typename T>
+	void ReadImage(const std::string &path, ImageFrame<T> &dst, ::size_t page)
+	{
+		std::unique_ptr<ImageDecoder> decoder = OpenImageDecoder(path);
+		if (page != 0)
+			decoder->SetPage(page);
+		ReadImage(*decoder, dst);
+	}
+
+	template <typename T>
+	void ReadImagePages(const std::string &path, std::vector<ImageFrame<T>> &dst)
+	{
+		std::unique_ptr<ImageDecoder> decoder = OpenImageDecoder(path);
+		dst.resize(decoder->GetPageCount());
+		for (::size_t P = 0; P != dst.size(); ++P)
+		{
+			if (P != 0)
+				decoder->SetPage(P);
+			ReadImage(*decoder, dst[P]);
+		}
+	}
+
+	template <typename T>
+	void ReadImages(const std::vector<std::string> &paths, std::vector<ImageFrame<T>> &dst)
+	{
+		dst.resize(paths.size());
+		ParallelFor(0, paths.size(), 1, [&](::size_t first, ::size_t last)
+		{
+			for (::size_t I = first; I != last; ++I)
+				ReadImage(paths[I], dst[I]);
+		});
+	}
+}
+
+#endif
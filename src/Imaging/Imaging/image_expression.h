@@ -0,0 +1,307 @@
+#if !defined(IMAGE_EXPRESSION_H)
+#define IMAGE_EXPRESSION_H
+
+#include <type_traits>
+#include <utility>
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Element-wise arithmetic of ImageFrame<T> objects by expression templates.
+
+	An operator on frames, expressions or scalars returns a small expression object
+	instead of a frame, so a chain of operators and casts is evaluated in a single pass
+	over the samples without any temporary frame, when it is assigned into a frame.
+
+	ImageFrame<float> dst;
+	dst = (a - b) * gain + offset;
+	dst8 = SaturateCast<unsigned char>(Abs(a - b) * 4);
+
+	The type of each operation follows the C++ arithmetic of the operands, e.g.,
+	unsigned char - unsigned char is int, and the result is cast into the type of the
+	destination on assignment. All frames of an expression must have the same dimension.
+	The destination may be an operand, because each sample is read before it is written
+	at the same position.
+	@NOTE An expression refers to its frames, so it must be evaluated while the frames
+	exist; do not keep an expression by auto beyond the statement. */
+	template <typename E>
+	class FrameExpression
+	{
+	public:
+		/** Gets the expression as its own type. */
+		const E &Derived(void) const;
+	};
+
+	/** Frame operand of an expression. */
+	template <typename T>
+	class FrameTerm : public FrameExpression<FrameTerm<T>>
+	{
+	public:
+		typedef T ValueType;
+
+		explicit FrameTerm(const ImageFrame<T> &img);
+
+		T operator[](::size_t i) const;
+		bool HasFrame(void) const;
+		const Size2D<::size_t> &GetSize(void) const;
+		::size_t GetDepth(void) const;
+
+	protected:
+		const T *data_;
+		Size2D<::size_t> size_;
+		::size_t depth_;
+	};
+
+	/** Scalar operand of an expression, which is the same for every sample. */
+	template <typename T>
+	class ScalarTerm : public FrameExpression<ScalarTerm<T>>
+	{
+	public:
+		typedef T ValueType;
+
+		explicit ScalarTerm(T value);
+
+		T operator[](::size_t i) const;
+		bool HasFrame(void) const;
+		const Size2D<::size_t> &GetSize(void) const;
+		::size_t GetDepth(void) const;
+
+	protected:
+		T value_;
+		Size2D<::size_t> size_;
+	};
+
+	template <typename E, typename Op>
+	class UnaryExpression : public FrameExpression<UnaryExpression<E, Op>>
+	{
+	public:
+		typedef decltype(std::declval<Op>()(std::declval<typename E::ValueType>())) ValueType;
+
+		explicit UnaryExpression(const E &operand);
+
+		ValueType operator[](::size_t i) const;
+		bool HasFrame(void) const;
+		const Size2D<::size_t> &GetSize(void) const;
+		::size_t GetDepth(void) const;
+
+	protected:
+		E operand_;
+	};
+
+	template <typename L, typename R, typename Op>
+	class BinaryExpression : public FrameExpression<BinaryExpression<L, R, Op>>
+	{
+	public:
+		typedef decltype(std::declval<Op>()(std::declval<typename L::ValueType>(),
+			std::declval<typename R::ValueType>())) ValueType;
+
+		/** @exception std::invalid_argument	if the frames of both operands have different
+		dimensions */
+		BinaryExpression(const L &left, const R &right);
+
+		ValueType operator[](::size_t i) const;
+		bool HasFrame(void) const;
+		const Size2D<::size_t> &GetSize(void) const;
+		::size_t GetDepth(void) const;
+
+	protected:
+		L left_;
+		R right_;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Operations on samples.
+
+	class PlusOp
+	{
+	public:
+		template <typename A, typename B>
+		auto operator()(A a, B b) const -> decltype(a + b) { return a + b; }
+	};
+
+	class MinusOp
+	{
+	public:
+		template <typename A, typename B>
+		auto operator()(A a, B b) const -> decltype(a - b) { return a - b; }
+	};
+
+	class MultipliesOp
+	{
+	public:
+		template <typename A, typename B>
+		auto operator()(A a, B b) const -> decltype(a * b) { return a * b; }
+	};
+
+	class DividesOp
+	{
+	public:
+		template <typename A, typename B>
+		auto operator()(A a, B b) const -> decltype(a / b) { return a / b; }
+	};
+
+	class MinOp
+	{
+	public:
+		template <typename A, typename B>
+		auto operator()(A a, B b) const -> decltype(a + b) { return b < a ? b : a; }
+	};
+
+	class MaxOp
+	{
+	public:
+		template <typename A, typename B>
+		auto operator()(A a, B b) const -> decltype(a + b) { return a < b ? b : a; }
+	};
+
+	class NegateOp
+	{
+	public:
+		template <typename A>
+		auto operator()(A a) const -> decltype(-a) { return -a; }
+	};
+
+	class AbsOp
+	{
+	public:
+		template <typename A>
+		auto operator()(A a) const -> decltype(+a) { return a < 0 ? -a : +a; }
+	};
+
+	template <typename U>
+	class CastOp
+	{
+	public:
+		template <typename A>
+		U operator()(A a) const { return static_cast<U>(a); }
+	};
+
+	/** Rounds a floating point value to the nearest, and clamps a value into the range of U;
+	NaN becomes the minimum of U. */
+	template <typename U>
+	class SaturateOp
+	{
+	public:
+		template <typename A>
+		U operator()(A a) const;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Operands of operators.
+
+	/** Tells how a type is used as an operand of an expression; frames and expressions
+	are held by FrameTerm<T> and the expression itself, and arithmetic values by
+	ScalarTerm<T>. */
+	template <typename X, typename Enable = void>
+	class ExpressionTraits
+	{
+	public:
+		static const bool isOperand = false, hasFrame = false;
+	};
+
+	template <typename T>
+	class ExpressionTraits<ImageFrame<T>>
+	{
+	public:
+		static const bool isOperand = true, hasFrame = true;
+		typedef FrameTerm<T> Type;
+		static Type Make(const ImageFrame<T> &x) { return Type(x); }
+	};
+
+	template <typename E>
+	class ExpressionTraits<E, typename std::enable_if<
+		std::is_base_of<FrameExpression<E>, E>::value>::type>
+	{
+	public:
+		static const bool isOperand = true, hasFrame = true;
+		typedef E Type;
+		static const E &Make(const E &x) { return x; }
+	};
+
+	template <typename T>
+	class ExpressionTraits<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+	{
+	public:
+		static const bool isOperand = true, hasFrame = false;
+		typedef ScalarTerm<T> Type;
+		static Type Make(T x) { return Type(x); }
+	};
+
+	/** Gets the type of an operation, only if an operand is a frame or an expression. */
+	template <typename X, typename Op, typename Enable = void>
+	class UnaryResult {};
+
+	template <typename X, typename Op>
+	class UnaryResult<X, Op, typename std::enable_if<ExpressionTraits<X>::hasFrame>::type>
+	{
+	public:
+		typedef UnaryExpression<typename ExpressionTraits<X>::Type, Op> Type;
+	};
+
+	template <typename L, typename R, typename Op, typename Enable = void>
+	class BinaryResult {};
+
+	template <typename L, typename R, typename Op>
+	class BinaryResult<L, R, Op, typename std::enable_if<ExpressionTraits<L>::isOperand &&
+		ExpressionTraits<R>::isOperand &&
+		(ExpressionTraits<L>::hasFrame || ExpressionTraits<R>::hasFrame)>::type>
+	{
+	public:
+		typedef BinaryExpression<typename ExpressionTraits<L>::Type,
+			typename ExpressionTraits<R>::Type, Op> Type;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Operators and functions.
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, PlusOp>::Type operator+(const L &a, const R &b);
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, MinusOp>::Type operator-(const L &a, const R &b);
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, MultipliesOp>::Type operator*(const L &a, const R &b);
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, DividesOp>::Type operator/(const L &a, const R &b);
+
+	template <typename X>
+	typename UnaryResult<X, NegateOp>::Type operator-(const X &a);
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, MinOp>::Type Min(const L &a, const R &b);
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, MaxOp>::Type Max(const L &a, const R &b);
+
+	template <typename X>
+	typename UnaryResult<X, AbsOp>::Type Abs(const X &a);
+
+	/** Casts samples by static_cast<U>(). */
+	template <typename U, typename X>
+	typename UnaryResult<X, CastOp<U>>::Type Cast(const X &a);
+
+	/** Casts samples with rounding and clamping into the range of U. */
+	template <typename U, typename X>
+	typename UnaryResult<X, SaturateOp<U>>::Type SaturateCast(const X &a);
+
+	/** Evaluates an expression into a frame, which is reset to the dimension of the
+	expression. Ranges of samples are evaluated in parallel by ParallelFor(). */
+	template <typename E, typename T>
+	void Evaluate(const FrameExpression<E> &expr, ImageFrame<T> &dst);
+
+	/** Evaluates an expression into a region of a frame.
+
+	@exception std::invalid_argument	if the region has a different size or the frame has
+	a different depth from the expression
+	@exception std::out_of_range	if the region is out of the frame */
+	template <typename E, typename T>
+	void Evaluate(const FrameExpression<E> &expr, ImageFrame<T> &dst,
+		const Region<::size_t, ::size_t> &roi);
+}
+
+#include "image_expression_inl.h"
+
+#endif
@@ -0,0 +1,314 @@
+#if !defined(IMAGE_EXPRESSION_INL_H)
+#define IMAGE_EXPRESSION_INL_H
+
+#include <limits>
+#include <stdexcept>
+
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// FrameExpression<E> class
+	template <typename E>
+	const E &FrameExpression<E>::Derived(void) const
+	{
+		return static_cast<const E &>(*this);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// FrameTerm<T> class
+	template <typename T>
+	FrameTerm<T>::FrameTerm(const ImageFrame<T> &img) : data_(img.data.data()),
+		size_(img.size), depth_(img.depth) {}
+
+	template <typename T>
+	T FrameTerm<T>::operator[](::size_t i) const
+	{
+		return this->data_[i];
+	}
+
+	template <typename T>
+	bool FrameTerm<T>::HasFrame(void) const
+	{
+		return true;
+	}
+
+	template <typename T>
+	const Size2D<::size_t> &FrameTerm<T>::GetSize(void) const
+	{
+		return this->size_;
+	}
+
+	template <typename T>
+	::size_t FrameTerm<T>::GetDepth(void) const
+	{
+		return this->depth_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// ScalarTerm<T> class
+	template <typename T>
+	ScalarTerm<T>::ScalarTerm(T value) : value_(value), size_(0, 0) {}
+
+	template <typename T>
+	T ScalarTerm<T>::operator[](::size_t) const
+	{
+		return this->value_;
+	}
+
+	template <typename T>
+	bool ScalarTerm<T>::HasFrame(void) const
+	{
+		return false;
+	}
+
+	template <typename T>
+	const Size2D<::size_t> &ScalarTerm<T>::GetSize(void) const
+	{
+		return this->size_;
+	}
+
+	template <typename T>
+	::size_t ScalarTerm<T>::GetDepth(void) const
+	{
+		return 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// UnaryExpression<E, Op> class
+	template <typename E, typename Op>
+	UnaryExpression<E, Op>::UnaryExpression(const E &operand) : operand_(operand) {}
+
+	template <typename E, typename Op>
+	typename UnaryExpression<E, Op>::ValueType UnaryExpression<E, Op>::operator[](
+		::size_t i) const
+	{
+		return Op()(this->operand_[i]);
+	}
+
+	template <typename E, typename Op>
+	bool UnaryExpression<E, Op>::HasFrame(void) const
+	{
+		return this->operand_.HasFrame();
+	}
+
+	template <typename E, typename Op>
+	const Size2D<::size_t> &UnaryExpression<E, Op>::GetSize(void) const
+	{
+		return this->operand_.GetSize();
+	}
+
+	template <typename E, typename Op>
+	::size_t UnaryExpression<E, Op>::GetDepth(void) const
+	{
+		return this->operand_.GetDepth();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// BinaryExpression<L, R, Op> class
+	template <typename L, typename R, typename Op>
+	BinaryExpression<L, R, Op>::BinaryExpression(const L &left, const R &right) :
+		left_(left), right_(right)
+	{
+		if (left.HasFrame() && right.HasFrame() && (left.GetSize() != right.GetSize() ||
+			left.GetDepth() != right.GetDepth()))
+		{
+			std::ostringstream errMsg;
+			errMsg << "Frames of " << left.GetSize().width << " x " << left.GetSize().height <<
+				" x " << left.GetDepth() << " and " << right.GetSize().width << " x " <<
+				right.GetSize().height << " x " << right.GetDepth() <<
+				" cannot be in the same expression.";
+			throw std::invalid_argument(errMsg.str());
+		}
+	}
+
+	template <typename L, typename R, typename Op>
+	typename BinaryExpression<L, R, Op>::ValueType BinaryExpression<L, R, Op>::operator[](
+		::size_t i) const
+	{
+		return Op()(this->left_[i], this->right_[i]);
+	}
+
+	template <typename L, typename R, typename Op>
+	bool BinaryExpression<L, R, Op>::HasFrame(void) const
+	{
+		return this->left_.HasFrame() || this->right_.HasFrame();
+	}
+
+	template <typename L, typename R, typename Op>
+	const Size2D<::size_t> &BinaryExpression<L, R, Op>::GetSize(void) const
+	{
+		return this->left_.HasFrame() ? this->left_.GetSize() : this->right_.GetSize();
+	}
+
+	template <typename L, typename R, typename Op>
+	::size_t BinaryExpression<L, R, Op>::GetDepth(void) const
+	{
+		return this->left_.HasFrame() ? this->left_.GetDepth() : this->right_.GetDepth();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// SaturateOp<U> class
+
+	/** Floating point to integer; rounds half away from zero. */
+	template <typename U, typename A>
+	typename std::enable_if<std::is_floating_point<A>::value && std::is_integral<U>::value,
+		U>::type SaturateSample(A a)
+	{
+		if (!(a > static_cast<A>(std::numeric_limits<U>::min())))
+			return std::numeric_limits<U>::min();
+		else if (a >= static_cast<A>(std::numeric_limits<U>::max()))
+			return std::numeric_limits<U>::max();
+		else
+			return static_cast<U>(a + (a < 0 ? A(-0.5) : A(0.5)));
+	}
+
+	template <typename U, typename A>
+	typename std::enable_if<std::is_integral<A>::value && std::is_integral<U>::value,
+		U>::type SaturateSample(A a)
+	{
+		if (std::is_signed<A>::value && a < A(0))
+			return static_cast<long long>(a) < static_cast<long long>(
+			std::numeric_limits<U>::min()) ? std::numeric_limits<U>::min() : static_cast<U>(a);
+		else
+			return static_cast<unsigned long long>(a) > static_cast<unsigned long long>(
+			std::numeric_limits<U>::max()) ? std::numeric_limits<U>::max() : static_cast<U>(a);
+	}
+
+	template <typename U, typename A>
+	typename std::enable_if<std::is_floating_point<U>::value, U>::type SaturateSample(A a)
+	{
+		return static_cast<U>(a);
+	}
+
+	template <typename U>
+	template <typename A>
+	U SaturateOp<U>::operator()(A a) const
+	{
+		return SaturateSample<U>(a);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Operators and functions.
+	template <typename L, typename R>
+	typename BinaryResult<L, R, PlusOp>::Type operator+(const L &a, const R &b)
+	{
+		return typename BinaryResult<L, R, PlusOp>::Type(ExpressionTraits<L>::Make(a),
+			ExpressionTraits<R>::Make(b));
+	}
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, MinusOp>::Type operator-(const L &a, const R &b)
+	{
+		return typename BinaryResult<L, R, MinusOp>::Type(ExpressionTraits<L>::Make(a),
+			ExpressionTraits<R>::Make(b));
+	}
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, MultipliesOp>::Type operator*(const L &a, const R &b)
+	{
+		return typename BinaryResult<L, R, MultipliesOp>::Type(ExpressionTraits<L>::Make(a),
+			ExpressionTraits<R>::Make(b));
+	}
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, DividesOp>::Type operator/(const L &a, const R &b)
+	{
+		return typename BinaryResult<L, R, DividesOp>::Type(ExpressionTraits<L>::Make(a),
+			ExpressionTraits<R>::Make(b));
+	}
+
+	template <typename X>
+	typename UnaryResult<X, NegateOp>::Type operator-(const X &a)
+	{
+		return typename UnaryResult<X, NegateOp>::Type(ExpressionTraits<X>::Make(a));
+	}
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, MinOp>::Type Min(const L &a, const R &b)
+	{
+		return typename BinaryResult<L, R, MinOp>::Type(ExpressionTraits<L>::Make(a),
+			ExpressionTraits<R>::Make(b));
+	}
+
+	template <typename L, typename R>
+	typename BinaryResult<L, R, MaxOp>::Type Max(const L &a, const R &b)
+	{
+		return typename BinaryResult<L, R, MaxOp>::Type(ExpressionTraits<L>::Make(a),
+			ExpressionTraits<R>::Make(b));
+	}
+
+	template <typename X>
+	typename UnaryResult<X, AbsOp>::Type Abs(const X &a)
+	{
+		return typename UnaryResult<X, AbsOp>::Type(ExpressionTraits<X>::Make(a));
+	}
+
+	template <typename U, typename X>
+	typename UnaryResult<X, CastOp<U>>::Type Cast(const X &a)
+	{
+		return typename UnaryResult<X, CastOp<U>>::Type(ExpressionTraits<X>::Make(a));
+	}
+
+	template <typename U, typename X>
+	typename UnaryResult<X, SaturateOp<U>>::Type SaturateCast(const X &a)
+	{
+		return typename UnaryResult<X, SaturateOp<U>>::Type(ExpressionTraits<X>::Make(a));
+	}
+
+	/** The loop over a range is a plain loop over the index with every operation inlined,
+	so compilers vectorize it. */
+	template <typename E, typename T>
+	void Evaluate(const FrameExpression<E> &expr, ImageFrame<T> &dst)
+	{
+		const E &e = expr.Derived();
+		dst.Reset(e.GetSize(), e.GetDepth());
+		if (dst.data.empty())
+			return;
+		T *p = dst.GetPointer(0, 0);
+		ParallelFor(0, dst.data.size(), 1 << 15, [&e, p](::size_t first, ::size_t last)
+		{
+			for (::size_t I = first; I < last; ++I)
+				p[I] = static_cast<T>(e[I]);
+		});
+	}
+
+	template <typename E, typename T>
+	void Evaluate(const FrameExpression<E> &expr, ImageFrame<T> &dst,
+		const Region<::size_t, ::size_t> &roi)
+	{
+		const E &e = expr.Derived();
+		if (roi.size != e.GetSize() || dst.depth != e.GetDepth())
+			throw std::invalid_argument(
+			"The region of the destination must have the dimension of the expression.");
+		if (roi.GetArea() == 0)
+			return;
+		dst.CheckRange(roi.origin.x + roi.size.width - 1, roi.origin.y + roi.size.height - 1);
+
+		const ::size_t n = roi.size.width * dst.depth;
+		ParallelFor(0, roi.size.height, (1 << 15) / (n + 1) + 1, [&](::size_t first,
+			::size_t last)
+		{
+			for (::size_t Y = first; Y != last; ++Y)
+			{
+				T *p = dst.GetPointer(roi.origin.x, roi.origin.y + Y);
+				const ::size_t offset = n * Y;
+				for (::size_t I = 0; I != n; ++I)
+					p[I] = static_cast<T>(e[offset + I]);
+			}
+		});
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// ImageFrame<T> class
+	template <typename T>
+	template <typename E>
+	ImageFrame<T> &ImageFrame<T>::operator=(const FrameExpression<E> &expr)
+	{
+		Evaluate(expr, *this);
+		return *this;
+	}
+}
+
+#endif
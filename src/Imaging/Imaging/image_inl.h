@@ -1,15 +1,47 @@
 #if !defined(IMAGE_INL_H)
 #define IMAGE_INL_H
 
+#include <type_traits>
+
 namespace Imaging
 {
+	template <typename T>
+	int GetEnviDataType(void)
+	{
+		return std::is_same<T, unsigned char>::value ? 1 :
+			std::is_same<T, short>::value ? 2 :
+			std::is_same<T, int>::value ? 3 :
+			std::is_same<T, float>::value ? 4 :
+			std::is_same<T, double>::value ? 5 :
+			std::is_same<T, unsigned short>::value ? 12 :
+			std::is_same<T, unsigned int>::value ? 13 :
+			std::is_same<T, long long>::value ? 14 :
+			std::is_same<T, unsigned long long>::value ? 15 : 0;
+	}
+
 	template <typename T>
 	void Copy(const void *src, ::size_t width, ::size_t height, ::size_t depth,
-		::size_t bytesPerLine, std::vector<T> &dst)
+		::size_t bytesPerLine, std::vector<T> &dst, ByteOrder order)
 	{
 		::size_t nElemPerLine = depth * width;
 		::size_t nElem = nElemPerLine * height;
-		if (bytesPerLine == nElemPerLine * sizeof(T))
+		IMAGING_SCOPED_TIMER("Copy", 2 * nElem * sizeof(T), width * height);
+		if (NeedsSwap(order))
+		{
+			if (bytesPerLine < nElemPerLine * sizeof(T))
+				throw std::invalid_argument(
+					"The number of bytes per line must be equal or greater than the "
+					"number of effective bytes per line.");
+			if (dst.size() != nElem)
+				dst.resize(nElem);
+
+			// Swap bytes while copying line by line.
+			const char *it_src = reinterpret_cast<const char *>(src);
+			for (::size_t Y = 0; Y != height; ++Y, it_src += bytesPerLine)
+				CopySwapped(reinterpret_cast<const T *>(it_src), nElemPerLine,
+					dst.data() + nElemPerLine * Y);
+		}
+		else if (bytesPerLine == nElemPerLine * sizeof(T))
 			Copy(reinterpret_cast<const T *>(src), nElem, dst);
 		else if (bytesPerLine > nElemPerLine * sizeof(T))
 		{
@@ -33,6 +65,76 @@ namespace Imaging
 				"number of effective bytes per line.");
 	}
 
+	::size_t GetPackedBytesPerLine(::size_t width, Packing packing)
+	{
+		switch (packing)
+		{
+		case Packing::MONO10P:
+			return (10 * width + 7) / 8;
+		case Packing::MONO10_PACKED:
+			return 3 * (width / 2) + 2 * (width % 2);
+		default:
+			return (12 * width + 7) / 8;
+		}
+	}
+
+	void Copy(const void *src, ::size_t width, ::size_t height, ::size_t bytesPerLine,
+		Packing packing, std::vector<unsigned short> &dst)
+	{
+		if (bytesPerLine < GetPackedBytesPerLine(width, packing))
+			throw std::invalid_argument(
+				"The number of bytes per line must be equal or greater than the "
+				"number of effective bytes per line.");
+
+		// Resize destination for given dimension.
+		if (dst.size() != width * height)
+			dst.resize(width * height);
+
+		const unsigned char *it_src = reinterpret_cast<const unsigned char *>(src);
+		for (::size_t Y = 0; Y != height; ++Y, it_src += bytesPerLine)
+			Unpack(it_src, width, packing, dst.data() + width * Y);
+	}
+
+	/** Full groups of samples (4 samples in 5 bytes for MONO10P, 2 samples in 3 bytes for
+	others) are unpacked by the kernels of the current SIMD level. Remaining samples of
+	LSB-first packings are read as 16 bits from the byte where each sample starts. */
+	void Unpack(const unsigned char *src, ::size_t width, Packing packing,
+		unsigned short *dst)
+	{
+		const ::size_t groupSamples = packing == Packing::MONO10P ? 4 : 2;
+		const ::size_t nGroups = width / groupSamples;
+		GetKernels().unpackGroups[static_cast<int>(packing)](src, nGroups, dst);
+		::size_t X = groupSamples * nGroups;
+		src += (groupSamples == 4 ? 5 : 3) * nGroups;
+		if (X == width)
+			return;
+
+		unsigned bits = 12, mask = 0x0FFF;
+		switch (packing)
+		{
+		case Packing::MONO10P:
+			bits = 10;
+			mask = 0x03FF;
+			break;
+		case Packing::MONO12P:
+			break;
+		case Packing::MONO10_PACKED:
+			dst[X] = static_cast<unsigned short>(src[0] << 2 | (src[1] & 0x03));
+			return;
+		case Packing::MONO12_PACKED:
+			dst[X] = static_cast<unsigned short>(src[0] << 4 | (src[1] & 0x0F));
+			return;
+		}
+
+		// src is at the beginning of the remaining samples of LSB-first packings.
+		for (::size_t I = 0; X != width; ++X, ++I)
+		{
+			::size_t bit = bits * I;
+			const unsigned char *s = src + bit / 8;
+			dst[X] = static_cast<unsigned short>((s[0] | s[1] << 8) >> (bit % 8) & mask);
+		}
+	}
+
 	template <typename T>
 	void CopyLines(typename std::vector<T>::const_iterator it_src,
 		typename std::vector<T>::size_type nElemPerLineSrc,
@@ -69,12 +171,58 @@ namespace Imaging
 		}
 	}
 
+	/** Transposes nBands x nSamples samples into nSamples x nBands samples, loading each
+	sample through load().
+
+	Samples are processed in blocks of pixels, so the destination of a block stays in the
+	cache while every band of the block is read sequentially. */
+	template <typename T, typename F>
+	void TransposeToBip(const T *src, ::size_t nBands, ::size_t nSamples, T *dst, F load)
+	{
+		const ::size_t blockSize = 64;
+		for (::size_t first = 0; first < nSamples; first += blockSize)
+		{
+			const ::size_t last = std::min(first + blockSize, nSamples);
+			for (::size_t B = 0; B != nBands; ++B)
+			{
+				const T *it_src = src + nSamples * B;
+				for (::size_t I = first; I != last; ++I)
+					dst[nBands * I + B] = load(it_src[I]);
+			}
+		}
+	}
+
+	template <typename T>
+	void CopySwapped(const T *src, ::size_t n, T *dst)
+	{
+		const int index = GetKernelIndex<T>();
+		if (index >= 0)
+			GetKernels().copySwapped[index](src, n, dst);
+		else
+			for (::size_t I = 0; I != n; ++I)
+				dst[I] = SwapBytes(src[I]);
+	}
+
+	/** Arithmetic samples are transposed by the kernels of the current SIMD level. */
+	template <typename T>
+	void TransposeToBip(const T *src, ::size_t nBands, ::size_t nSamples, T *dst, bool swap)
+	{
+		const int index = GetKernelIndex<T>();
+		if (index >= 0)
+			GetKernels().transposeToBip[index](src, nBands, nSamples, dst, swap);
+		else if (swap)
+			TransposeToBip(src, nBands, nSamples, dst, [](T value) { return SwapBytes(value); });
+		else
+			TransposeToBip(src, nBands, nSamples, dst, [](T value) { return value; });
+	}
+
 	/** Check the dimension of source and desitination data, and skip the
 	boundary check by using [] instead of at().	*/
 	template <typename T>
 	void BsqToBip(const std::vector<T> &src,
 		typename std::vector<T>::size_type nBands,
-		typename std::vector<T>::size_type nSamplesPerBand, std::vector<T> &dst)
+		typename std::vector<T>::size_type nSamplesPerBand, std::vector<T> &dst,
+		ByteOrder order)
 	{
 		// Check the size of source/destination.
 		auto totalCount = nBands * nSamplesPerBand;
@@ -82,35 +230,54 @@ namespace Imaging
 			throw std::runtime_error(
 			"The size of source or destination block is unmatched for given dimension.");
 
-		// Copy data samples band by band.
-		for (auto B = 0; B != nBands; ++B)
-		{
-			auto it_src = src.cbegin() + nSamplesPerBand * B;			
-			for (auto inc = 0; inc != nSamplesPerBand; ++inc, ++it_src)
-				dst[nBands * inc + B] = *it_src;
-		}
+		BsqToBip(src.data(), nBands, nSamplesPerBand, dst, order);
+	}
+
+	template <typename T>
+	void BsqToBip(const void *src, ::size_t nBands, ::size_t nSamplesPerBand,
+		std::vector<T> &dst, ByteOrder order)
+	{
+		IMAGING_SCOPED_TIMER("BsqToBip", 2 * nBands * nSamplesPerBand * sizeof(T),
+			nSamplesPerBand);
+		if (dst.size() != nBands * nSamplesPerBand)
+			dst.resize(nBands * nSamplesPerBand);
+
+		TransposeToBip(reinterpret_cast<const T *>(src), nBands, nSamplesPerBand, dst.data(),
+			NeedsSwap(order));
 	}
 
 	template <typename T>
 	void BilToBip(const std::vector<T> &src,
 		typename std::vector<T>::size_type nBands,
 		typename std::vector<T>::size_type nSamplesPerLine,
-		typename std::vector<T>::size_type nLinesPerBand, std::vector<T> &dst)
+		typename std::vector<T>::size_type nLinesPerBand, std::vector<T> &dst,
+		ByteOrder order)
 	{
 		// Check the size of source/destination.
 		auto totalCount = nBands * nSamplesPerLine * nLinesPerBand;
 		if (src.size() != totalCount || dst.size() != totalCount)
 			throw std::runtime_error(
 			"The size of source or destination block is unmatched for given dimension.");
-	
-		// Copy data samples line by line.
-		for (auto L = 0; L != nLinesPerBand; ++L)
-			for (auto B = 0; B != nBands; ++B)
-			{
-				auto it_src = src.cbegin() + nSamplesPerLine * nBands * L + nSamplesPerLine * B;
-				for (auto inc = 0; inc != nSamplesPerLine; ++inc, ++it_src)
-					dst[nSamplesPerLine * nBands * L + nBands * inc + B] = *it_src;
-			}
+
+		BilToBip(src.data(), nBands, nSamplesPerLine, nLinesPerBand, dst, order);
+	}
+
+	/** Each line of BIL data is a small BSQ block of nBands x nSamplesPerLine samples. */
+	template <typename T>
+	void BilToBip(const void *src, ::size_t nBands, ::size_t nSamplesPerLine,
+		::size_t nLinesPerBand, std::vector<T> &dst, ByteOrder order)
+	{
+		const ::size_t nElemPerLine = nBands * nSamplesPerLine;
+		IMAGING_SCOPED_TIMER("BilToBip", 2 * nElemPerLine * nLinesPerBand * sizeof(T),
+			nSamplesPerLine * nLinesPerBand);
+		if (dst.size() != nElemPerLine * nLinesPerBand)
+			dst.resize(nElemPerLine * nLinesPerBand);
+
+		const T *it_src = reinterpret_cast<const T *>(src);
+		const bool swap = NeedsSwap(order);
+		for (::size_t L = 0; L != nLinesPerBand; ++L)
+			TransposeToBip(it_src + nElemPerLine * L, nBands, nSamplesPerLine,
+				dst.data() + nElemPerLine * L, swap);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////////////
@@ -310,6 +477,9 @@ namespace Imaging
 		// Check source/destination ROI.
 		imgSrc.CheckRange(roiSrc);	// TODO: Change CheckRange() into protected, and try again.
 		this->CheckRange(orgnDst, roiSrc.size);
+		IMAGING_SCOPED_TIMER("ImageFrame::CopyFrom",
+			2 * roiSrc.size.width * roiSrc.size.height * this->depth * sizeof(T),
+			roiSrc.size.width * roiSrc.size.height);
 
 		// Copy line by line.
 		auto it_src = imgSrc.GetIterator(roiSrc.origin.x, roiSrc.origin.y);
@@ -321,11 +491,11 @@ namespace Imaging
 
 	template <typename T>
 	void ImageFrame<T>::CopyFrom(const T *src, const Size2D<SizeType> &sz, SizeType d,
-		::size_t bytesPerLine)
+		::size_t bytesPerLine, ByteOrder order)
 	{
 		// Copy image data into an std::vector<T> object after taking off padding bytes.
 		std::vector<T> temp;
-		Copy(src, sz.width, sz.height, d, bytesPerLine, temp);
+		Copy(src, sz.width, sz.height, d, bytesPerLine, temp, order);
 
 		// Move the temp data block without reallocating data_.
 		this->data_ = std::move(temp);
@@ -335,33 +505,30 @@ namespace Imaging
 
 	template <typename T>
 	void ImageFrame<T>::CopyFrom(const T *src, SizeType w, SizeType h, SizeType d,
-		::size_t bytesPerLine)
+		::size_t bytesPerLine, ByteOrder order)
 	{
-		this->CopyFrom(src, Size2D<SizeType>(w, h), d, bytesPerLine);
+		this->CopyFrom(src, Size2D<SizeType>(w, h), d, bytesPerLine, order);
 	}
 
 	template <typename T>
 	void ImageFrame<T>::CopyFrom(const T *src, const Size2D<SizeType> &sz,
-		SizeType d,	RawImageFormat fmt)
+		SizeType d,	RawImageFormat fmt, ByteOrder order)
 	{
-		// Copy raw image data into an std::vector<T> in prior to format conversion.
-		std::vector<T> dataSrc;
-		Copy(src, d * sz.width * sz.height, dataSrc);
-
-		// Copy image data pixel by pixel.
+		// Convert raw image data directly from source, so each sample is read once.
 		std::vector<T> temp;
 		switch (fmt)
 		{
 		case Imaging::RawImageFormat::BIP:
-			this->MoveFrom(std::move(dataSrc), sz, depth);
+			Copy(src, sz.width, sz.height, d, d * sz.width * sizeof(T), temp, order);
+			this->MoveFrom(std::move(temp), sz, d);
 			break;
 		case Imaging::RawImageFormat::BSQ:
-			BsqToBip(dataSrc, depth, sz.width * sz.height, temp);
-			this->MoveFrom(std::move(temp), sz, depth);
+			BsqToBip(src, d, sz.width * sz.height, temp, order);
+			this->MoveFrom(std::move(temp), sz, d);
 			break;
 		case Imaging::RawImageFormat::BIL:
-			BilToBip(dataSrc, depth, sz.width, sz.height, temp);
-			this->MoveFrom(std::move(temp), sz, depth);
+			BilToBip(src, d, sz.width, sz.height, temp, order);
+			this->MoveFrom(std::move(temp), sz, d);
 			break;
 		case Imaging::RawImageFormat::UNKNOWN:
 		default:
@@ -398,6 +565,10 @@ namespace Imaging
 	void ImageFrame<T>::CopyTo(const Region<SizeType, SizeType> &roiSrc,
 		ImageFrame<T> &imgDst) const
 	{
+		IMAGING_SCOPED_TIMER("ImageFrame::CopyTo",
+			2 * roiSrc.size.width * roiSrc.size.height * this->depth * sizeof(T),
+			roiSrc.size.width * roiSrc.size.height);
+
 		// Reset destination image for given dimension.
 		imgDst.Reset(roiSrc.size.width, roiSrc.size.height, this->depth);
 
@@ -10,8 +10,6 @@ namespace Imaging
 	template <typename T>
 	int GetOpenCvType(void);
 
-	enum class Interpolation {NEAREST, LINEAR, AREA, CUBIC, LANCZO};
-
 	/** Resizes image data from a source ROI, and copies the resized image data to
 	destination image.
 	
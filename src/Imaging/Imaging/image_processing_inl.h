@@ -35,6 +35,8 @@ namespace Imaging
 		// Reset destination image.
 		Size2D<typename ImageFrame<T>::SizeType> szDst;
 		RoundAs(roiSrc.size * zm, szDst);
+		IMAGING_SCOPED_TIMER("Resize", (roiSrc.size.width * roiSrc.size.height +
+			szDst.width * szDst.height) * imgSrc.depth * sizeof(T), szDst.width * szDst.height);
 		imgDst.Reset(szDst.width, szDst.height, imgSrc.depth);
 
 		/* Create a temporary image for given source ROI to create cv::Mat objects.
@@ -0,0 +1,139 @@
+#if !defined(INTEGRAL_IMAGE_H)
+#define INTEGRAL_IMAGE_H
+
+#include <type_traits>
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Selects the default accumulator types of an integral image for given sample type.
+
+	The sum is accumulated as following.
+	8-bit integral types -> unsigned int or int (32-bit) by the signedness
+	other integral types -> unsigned long long or long long (64-bit) by the signedness
+	floating point types -> double
+	The sum of squares is accumulated as following.
+	integral types up to 16-bit -> unsigned long long
+	other types -> double
+	64-bit integral samples are not supported.
+
+	Every accumulator is a widening of the sample by the rules of Copy() for
+	std::array<T, N>, so the conversion of a sample is free of overflow. 32-bit sums of
+	8-bit samples hold frames up to about 16.8 MP; larger frames need a 64-bit sum type as
+	the second argument of IntegralImage. The total of a frame is checked against the range
+	of the accumulator when an integral image is built. */
+	template <typename T>
+	class IntegralTraits
+	{
+	public:
+		static_assert(std::is_arithmetic<T>::value && (std::is_floating_point<T>::value ||
+			sizeof(T) <= 4), "64-bit integral samples are not supported.");
+
+		typedef typename std::conditional<std::is_floating_point<T>::value, double,
+			typename std::conditional<sizeof(T) == 1,
+			typename std::conditional<std::is_unsigned<T>::value, unsigned int, int>::type,
+			typename std::conditional<std::is_unsigned<T>::value, unsigned long long,
+			long long>::type>::type>::type SumType;
+		typedef typename std::conditional<std::is_integral<T>::value && sizeof(T) <= 2,
+			unsigned long long, double>::type SquareType;
+	};
+
+	/** Summed-area table of an ImageFrame<T> for constant-time sums over any region.
+
+	The integral image is stored as an ImageFrame of (width + 1) x (height + 1) pixels with
+	the same depth as the source, where I(x, y, c) is the sum of the source samples of
+	channel c over [0, 0] ~ (x, y). The first line and the first column are zeros, so the
+	sum over a region is always computed from four samples without checking boundaries.
+
+	The sum of squares is optional because it doubles the memory and build time, and it is
+	required only for Variance(). S is the accumulator of the sums, which must be a
+	widening of T by the rules of Copy() for std::array<T, N>. */
+	template <typename T, typename S = typename IntegralTraits<T>::SumType>
+	class IntegralImage
+	{
+		static_assert((std::is_integral<T>::value && std::is_floating_point<S>::value &&
+			sizeof(T) < sizeof(S)) ||
+			(std::is_floating_point<T>::value && std::is_floating_point<S>::value &&
+			sizeof(T) <= sizeof(S)) ||
+			(std::is_integral<T>::value && std::is_integral<S>::value &&
+			std::is_signed<T>::value == std::is_signed<S>::value && sizeof(T) <= sizeof(S)) ||
+			(std::is_unsigned<T>::value && std::is_integral<S>::value &&
+			std::is_signed<S>::value && sizeof(T) < sizeof(S)),
+			"The sum type must be a widening of the sample type.");
+
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef typename ImageFrame<T>::SizeType SizeType;
+		typedef S SumType;
+		typedef typename IntegralTraits<T>::SquareType SquareType;
+
+		//////////////////////////////////////////////////
+		// Default constructors.
+		IntegralImage(void);
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		IntegralImage(const ImageFrame<T> &img, bool squared = true);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the integral image of the sums. */
+		const ImageFrame<SumType> &GetSums(void) const;
+
+		/** Gets the integral image of the sums of squares.
+
+		It is empty if the integral image was built without squares. */
+		const ImageFrame<SquareType> &GetSquares(void) const;
+
+		/** Gets the size of the source image. */
+		Size2D<SizeType> GetSize(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Builds the integral images from a source image.
+
+		Existing buffers are reused if the dimension is not changed.
+		@exception std::overflow_error	if the sum over the whole frame could exceed the
+		range of the accumulator */
+		void Build(const ImageFrame<T> &img, bool squared = true);
+
+		/** Computes the sum of the samples of a channel over a region. */
+		SumType Sum(const Region<SizeType, SizeType> &roi, SizeType c = 0) const;
+
+		/** Computes the sum of the squares of the samples of a channel over a region. */
+		SquareType SumOfSquares(const Region<SizeType, SizeType> &roi, SizeType c = 0) const;
+
+		/** Computes the mean of the samples of a channel over a region. */
+		double Mean(const Region<SizeType, SizeType> &roi, SizeType c = 0) const;
+
+		/** Computes the (population) variance of the samples of a channel over a region.
+
+		@exception std::logic_error	if the integral image was built without squares */
+		double Variance(const Region<SizeType, SizeType> &roi, SizeType c = 0) const;
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void CheckRange(const Region<SizeType, SizeType> &roi, SizeType c) const;
+
+		template <typename U, typename F>
+		static void Accumulate(const ImageFrame<T> &img, F op, ImageFrame<U> &dst);
+
+		template <typename U>
+		static U GetSum(const ImageFrame<U> &img, const Region<SizeType, SizeType> &roi,
+			SizeType c);
+
+		//////////////////////////////////////////////////
+		// Data.
+		ImageFrame<SumType> sums_;
+		ImageFrame<SquareType> squares_;
+	};
+}
+
+#include "integral_image_inl.h"
+
+#endif
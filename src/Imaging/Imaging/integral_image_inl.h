@@ -0,0 +1,212 @@
+#if !defined(INTEGRAL_IMAGE_INL_H)
+#define INTEGRAL_IMAGE_INL_H
+
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// IntegralImage<T, S> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Default constructors.
+	template <typename T, typename S>
+	IntegralImage<T, S>::IntegralImage(void) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T, typename S>
+	IntegralImage<T, S>::IntegralImage(const ImageFrame<T> &img, bool squared)
+	{
+		this->Build(img, squared);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T, typename S>
+	const ImageFrame<typename IntegralImage<T, S>::SumType> &
+		IntegralImage<T, S>::GetSums(void) const
+	{
+		return this->sums_;
+	}
+
+	template <typename T, typename S>
+	const ImageFrame<typename IntegralImage<T, S>::SquareType> &
+		IntegralImage<T, S>::GetSquares(void) const
+	{
+		return this->squares_;
+	}
+
+	template <typename T, typename S>
+	Size2D<typename IntegralImage<T, S>::SizeType> IntegralImage<T, S>::GetSize(void) const
+	{
+		if (this->sums_.data.empty())
+			return Size2D<SizeType>(0, 0);
+		else
+			return Size2D<SizeType>(this->sums_.size.width - 1, this->sums_.size.height - 1);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+
+	/** The capacity of an integral accumulator is checked with the largest magnitude of a
+	sample, so the check is done once per frame instead of once per addition like
+	SafeAdd(). */
+	template <typename T, typename S>
+	void IntegralImage<T, S>::Build(const ImageFrame<T> &img, bool squared)
+	{
+		double nPixels = static_cast<double>(img.size.width) *
+			static_cast<double>(img.size.height);
+		double maxSample = std::max(
+			std::abs(static_cast<double>(std::numeric_limits<T>::lowest())),
+			static_cast<double>(std::numeric_limits<T>::max()));
+		if (std::is_integral<SumType>::value && nPixels * maxSample >
+			static_cast<double>(std::numeric_limits<SumType>::max()))
+			throw std::overflow_error(
+			"The sum of the frame could exceed the range of the accumulator.");
+		if (squared && std::is_integral<SquareType>::value &&
+			nPixels * maxSample * maxSample >
+			static_cast<double>(std::numeric_limits<SquareType>::max()))
+			throw std::overflow_error(
+			"The sum of squares of the frame could exceed the range of the accumulator.");
+
+		Accumulate(img, [](T v) { return static_cast<SumType>(v); }, this->sums_);
+
+		if (squared)
+		{
+			// Square in a type wide enough for the sample, and then widen the product.
+			typedef typename std::conditional<std::is_integral<T>::value, long long,
+				double>::type ProductType;
+			Accumulate(img, [](T v) { return static_cast<SquareType>(
+				static_cast<ProductType>(v) * static_cast<ProductType>(v)); },
+				this->squares_);
+		}
+		else
+			this->squares_.Clear();
+	}
+
+	/** Builds an integral image in two passes.
+
+	1) Each line is accumulated horizontally in parallel over lines. Since samples are
+	BIP, the running sum of a channel is the element one pixel (depth elements) before, so
+	all channels are accumulated in one loop.
+	2) Each line is added to the next line in parallel over column ranges. This pass runs
+	over contiguous elements without dependency inside a line, which compilers vectorize.
+	*/
+	template <typename T, typename S>
+	template <typename U, typename F>
+	void IntegralImage<T, S>::Accumulate(const ImageFrame<T> &img, F op, ImageFrame<U> &dst)
+	{
+		const SizeType w = img.size.width, h = img.size.height, d = img.depth;
+		dst.Reset(w + 1, h + 1, d);
+		if (dst.data.empty())
+			return;
+
+		U *pDst = dst.GetPointer(0, 0);
+		const SizeType nElemPerLineSrc = d * w, nElemPerLineDst = d * (w + 1);
+		std::fill(pDst, pDst + nElemPerLineDst, static_cast<U>(0));
+		if (img.data.empty())
+			return;
+		const T *pSrc = img.data.data();
+
+		ParallelFor(0, h, 64, [=](SizeType first, SizeType last)
+		{
+			for (SizeType Y = first; Y != last; ++Y)
+			{
+				const T *src = pSrc + nElemPerLineSrc * Y;
+				U *line = pDst + nElemPerLineDst * (Y + 1);
+				std::fill(line, line + d, static_cast<U>(0));
+				for (SizeType I = 0; I != nElemPerLineSrc; ++I)
+					line[I + d] = line[I] + op(src[I]);
+			}
+		});
+
+		ParallelFor(0, nElemPerLineDst, 1024, [=](SizeType first, SizeType last)
+		{
+			for (SizeType Y = 2; Y <= h; ++Y)
+			{
+				const U *prev = pDst + nElemPerLineDst * (Y - 1);
+				U *line = pDst + nElemPerLineDst * Y;
+				for (SizeType I = first; I != last; ++I)
+					line[I] += prev[I];
+			}
+		});
+	}
+
+	template <typename T, typename S>
+	void IntegralImage<T, S>::CheckRange(const Region<SizeType, SizeType> &roi, SizeType c)
+		const
+	{
+		Size2D<SizeType> sz = this->GetSize();
+		if (c >= this->sums_.depth)
+		{
+			std::ostringstream errMsg;
+			errMsg << "Channel c = " << c << " is out of range.";
+			throw std::out_of_range(errMsg.str());
+		}
+		if (roi.origin.x + roi.size.width > sz.width ||
+			roi.origin.y + roi.size.height > sz.height)
+		{
+			std::ostringstream errMsg;
+			errMsg << "[" << roi.origin.x << ", " << roi.origin.y << "] ~ (" <<
+				roi.origin.x + roi.size.width << ", " << roi.origin.y + roi.size.height <<
+				") is out of range.";
+			throw std::out_of_range(errMsg.str());
+		}
+	}
+
+	/** The terms are added before subtracted, so the result is correct even if an unsigned
+	intermediate value wraps around. */
+	template <typename T, typename S>
+	template <typename U>
+	U IntegralImage<T, S>::GetSum(const ImageFrame<U> &img,
+		const Region<SizeType, SizeType> &roi, SizeType c)
+	{
+		const U *p = img.data.data() + c;
+		const SizeType d = img.depth, nElemPerLine = d * img.size.width;
+		const SizeType x0 = d * roi.origin.x, x1 = d * (roi.origin.x + roi.size.width);
+		const SizeType y0 = nElemPerLine * roi.origin.y;
+		const SizeType y1 = nElemPerLine * (roi.origin.y + roi.size.height);
+		return p[y1 + x1] + p[y0 + x0] - p[y0 + x1] - p[y1 + x0];
+	}
+
+	template <typename T, typename S>
+	typename IntegralImage<T, S>::SumType IntegralImage<T, S>::Sum(
+		const Region<SizeType, SizeType> &roi, SizeType c) const
+	{
+		this->CheckRange(roi, c);
+		return GetSum(this->sums_, roi, c);
+	}
+
+	template <typename T, typename S>
+	typename IntegralImage<T, S>::SquareType IntegralImage<T, S>::SumOfSquares(
+		const Region<SizeType, SizeType> &roi, SizeType c) const
+	{
+		if (this->squares_.data.empty())
+			throw std::logic_error("The integral image was built without squares.");
+		this->CheckRange(roi, c);
+		return GetSum(this->squares_, roi, c);
+	}
+
+	template <typename T, typename S>
+	double IntegralImage<T, S>::Mean(const Region<SizeType, SizeType> &roi, SizeType c) const
+	{
+		if (roi.GetArea() == 0)
+			throw std::invalid_argument("The region is empty.");
+		return static_cast<double>(this->Sum(roi, c)) / static_cast<double>(roi.GetArea());
+	}
+
+	/** Computed as E[X^2] - E[X]^2. A negative result from rounding errors of floating
+	point accumulators is clamped to 0. */
+	template <typename T, typename S>
+	double IntegralImage<T, S>::Variance(const Region<SizeType, SizeType> &roi, SizeType c)
+		const
+	{
+		double mean = this->Mean(roi, c);
+		double meanSq = static_cast<double>(this->SumOfSquares(roi, c)) /
+			static_cast<double>(roi.GetArea());
+		return std::max(meanSq - mean * mean, 0.0);
+	}
+}
+
+#endif
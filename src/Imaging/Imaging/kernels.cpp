@@ -0,0 +1,102 @@
+#include "kernels.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+namespace Imaging
+{
+	// Levels other than the baseline are compiled only if the build enables them, by
+	// defining IMAGING_KERNELS_SSE41, IMAGING_KERNELS_AVX2 and IMAGING_KERNELS_AVX512.
+	namespace Baseline
+	{
+		const KernelTable &GetKernelTable(void);
+	}
+
+#if defined(IMAGING_KERNELS_SSE41)
+	namespace Sse41
+	{
+		const KernelTable &GetKernelTable(void);
+	}
+#endif
+
+#if defined(IMAGING_KERNELS_AVX2)
+	namespace Avx2
+	{
+		const KernelTable &GetKernelTable(void);
+	}
+#endif
+
+#if defined(IMAGING_KERNELS_AVX512)
+	namespace Avx512
+	{
+		const KernelTable &GetKernelTable(void);
+	}
+#endif
+
+	namespace
+	{
+		/** Gets the kernels of a level, or nullptr if they have not been compiled. */
+		const KernelTable *FindKernelTable(SimdLevel level)
+		{
+			switch (level)
+			{
+			case SimdLevel::BASELINE:
+				return &Baseline::GetKernelTable();
+#if defined(IMAGING_KERNELS_SSE41)
+			case SimdLevel::SSE41:
+				return &Sse41::GetKernelTable();
+#endif
+#if defined(IMAGING_KERNELS_AVX2)
+			case SimdLevel::AVX2:
+				return &Avx2::GetKernelTable();
+#endif
+#if defined(IMAGING_KERNELS_AVX512)
+			case SimdLevel::AVX512:
+				return &Avx512::GetKernelTable();
+#endif
+			default:
+				return nullptr;
+			}
+		}
+
+		/** Current level, which is chosen on the first use. */
+		std::atomic<int> &GetCurrentKernelLevel(void)
+		{
+			static std::atomic<int> current(-1);
+			if (current.load(std::memory_order_acquire) < 0)
+			{
+				int level = static_cast<int>(GetCpuSimdLevel());
+				while (level > 0 && FindKernelTable(static_cast<SimdLevel>(level)) == nullptr)
+					--level;
+				int expected = -1;
+				current.compare_exchange_strong(expected, level, std::memory_order_acq_rel);
+			}
+			return current;
+		}
+	}
+
+	const KernelTable &GetKernels(void)
+	{
+		return *FindKernelTable(GetKernelLevel());
+	}
+
+	SimdLevel GetKernelLevel(void)
+	{
+		return static_cast<SimdLevel>(GetCurrentKernelLevel().load(std::memory_order_acquire));
+	}
+
+	bool IsKernelLevelAvailable(SimdLevel level)
+	{
+		return FindKernelTable(level) != nullptr &&
+			static_cast<int>(level) <= static_cast<int>(GetCpuSimdLevel());
+	}
+
+	void SetKernelLevel(SimdLevel level)
+	{
+		if (!IsKernelLevelAvailable(level))
+			throw std::invalid_argument(std::string("Kernels of ") + GetSimdLevelName(level) +
+			" are not available on this build or CPU.");
+		GetCurrentKernelLevel().store(static_cast<int>(level), std::memory_order_release);
+	}
+}
@@ -0,0 +1,123 @@
+#if !defined(KERNELS_H)
+#define KERNELS_H
+
+#include <cstddef>
+
+#include "../Utilities/cpu_features.h"
+
+namespace Imaging
+{
+	/** Coefficients of YUV conversion scaled by 256 (8-bit fixed point).
+
+	Forward: Y = offsetY + (yr R + yg G + yb B) / 256, U = 128 + (ur R + ug G + ub B) / 256,
+	V = 128 + (vr R + vg G + vb B) / 256.
+	Inverse: C = Y - offsetY, D = U - 128, E = V - 128, R = (cy C + rv E) / 256,
+	G = (cy C - gu D - gv E) / 256, B = (cy C + bu D) / 256. */
+	class YuvCoefficients
+	{
+	public:
+		int yr, yg, yb, ur, ug, ub, vr, vg, vb, offsetY;
+		int cy, rv, gu, gv, bu;
+	};
+
+	/** Hot loops on raw samples, compiled once for each SIMD level and chosen at run time.
+
+	Samples are treated as elements of 1, 2, 4 or 8 bytes, and each array is indexed by
+	the base-2 logarithm of the element size. The kernels of a level are compiled in their
+	own translation unit with the instruction set of the level, so one binary runs the best
+	code on any CPU. */
+	class KernelTable
+	{
+	public:
+		/** Copies n elements, reversing the bytes of each; dst may be src. */
+		void (*copySwapped[4])(const void *src, ::size_t n, void *dst);
+
+		/** Transposes nBands x nSamples elements into nSamples x nBands elements, i.e.,
+		BSQ to BIP, reversing the bytes of each if swap is true. */
+		void (*transposeToBip[4])(const void *src, ::size_t nBands, ::size_t nSamples,
+			void *dst, bool swap);
+
+		/** Transposes width x height pixels into height x width pixels, indexed by the
+		bytes of a pixel minus 1, i.e., pixels of 1 to 8 bytes. Lines of src and dst are
+		strides of bytes apart, which may be negative to flip the lines. */
+		void (*transposePixels[8])(const void *src, ::ptrdiff_t srcStride, ::size_t width,
+			::size_t height, void *dst, ::ptrdiff_t dstStride);
+
+		/** Copies n pixels in reverse order, indexed by the bytes of a pixel minus 1;
+		dst may be src. */
+		void (*reversePixels[8])(const void *src, ::size_t n, void *dst);
+
+		/** Blurs 5 lines of width pixels by [1 4 6 4 1] / 16 vertically and horizontally,
+		and stores the pixels [first, last) of the line decimated by 2, i.e., the blurred
+		pixels 2 * first, ..., 2 * (last - 1). Pixels beyond the ends of the lines are
+		reflected without repeating the edge pixel. Indexed by the base-2 logarithm of the
+		sample size for unsigned 8-bit and 16-bit samples and float; the buffer holds
+		(2 * (last - first) + 4) * depth elements of twice the sample size, or of float. */
+		void (*reduceLines[3])(const void *const *lines, ::size_t width, ::size_t depth,
+			::size_t first, ::size_t last, void *dst, void *buffer);
+
+		/** Stores the minimum or the maximum of each pair of n elements of a and b; dst may
+		be a or b. Indexed by the base-2 logarithm of the sample size for unsigned 8-bit and
+		16-bit samples and float. */
+		void (*minSamples[3])(const void *a, const void *b, ::size_t n, void *dst);
+		void (*maxSamples[3])(const void *a, const void *b, ::size_t n, void *dst);
+
+		/** Weights red, green and blue of n pixels of depth elements by (77, 150, 29) / 256
+		into n gray elements; red is the element posR of a pixel, green 1 and blue
+		2 - posR. Indexed by the base-2 logarithm of the sample size for unsigned 8-bit
+		and 16-bit samples. */
+		void (*colorToGray[2])(const void *src, ::size_t depth, ::size_t n, ::size_t posR,
+			void *dst);
+
+		/** Converts n 8-bit color pixels of depth elements into 3-element YUV pixels, and
+		n YUV pixels into color pixels of 3 elements; dst may be src for 3 elements. */
+		void (*colorToYuv)(const unsigned char *src, ::size_t depth, ::size_t n,
+			::size_t posR, const YuvCoefficients &k, unsigned char *dst);
+		void (*yuvToColor)(const unsigned char *src, ::size_t n, ::size_t posR,
+			const YuvCoefficients &k, unsigned char *dst);
+
+		/** Interpolates the green of a line of a Bayer mosaic of int samples from 5 lines
+		centered at the line (Hamilton-Adams). cx is the column of the first red or blue
+		sample of the line, and green is widened by 1 mirrored sample at both ends. */
+		void (*interpolateGreen)(const int *const *lines, ::ptrdiff_t width, ::ptrdiff_t cx,
+			int maxValue, int *green);
+
+		/** Interpolates a line of a Bayer mosaic into width color pixels of 3 elements from
+		3 lines centered at the line, by averaging the nearest samples of the same color,
+		or by the differences from the green of the 3 lines. posC is the channel of the red
+		or blue samples of the line and posO the other one. Indexed by the base-2
+		logarithm of the sample size for unsigned 8-bit and 16-bit samples. */
+		void (*demosaicBilinearLine[2])(const int *const *lines, ::ptrdiff_t width,
+			::ptrdiff_t cx, ::size_t posC, ::size_t posO, void *dst);
+		void (*demosaicEdgeAwareLine[2])(const int *const *lines, const int *const *green,
+			::ptrdiff_t width, ::ptrdiff_t cx, ::size_t posC, ::size_t posO, int maxValue,
+			void *dst);
+
+		/** Unpacks n full groups of packed 10-bit or 12-bit samples into 16-bit samples,
+		i.e., 4 samples in 5 bytes for MONO10P and 2 samples in 3 bytes for the others.
+		Indexed by Packing of image.h. */
+		void (*unpackGroups[4])(const unsigned char *src, ::size_t n, unsigned short *dst);
+	};
+
+	/** Gets the kernels of the current level, which is the highest level both compiled
+	and supported by this CPU unless it has been changed by SetKernelLevel(). */
+	const KernelTable &GetKernels(void);
+
+	SimdLevel GetKernelLevel(void);
+
+	/** Checks if the kernels of a level have been compiled and are supported by this CPU. */
+	bool IsKernelLevelAvailable(SimdLevel level);
+
+	/** Selects the kernels of a level for every thread, e.g., to compare levels.
+
+	@exception std::invalid_argument	if the level is not available */
+	void SetKernelLevel(SimdLevel level);
+
+	/** Gets the index of the kernels for elements of type T, or -1 if there is none. */
+	template <typename T>
+	int GetKernelIndex(void);
+}
+
+#include "kernels_inl.h"
+
+#endif
@@ -0,0 +1,2 @@
+#define IMAGING_KERNEL_NAMESPACE Avx2
+#include "kernels_impl.h"
@@ -0,0 +1,2 @@
+#define IMAGING_KERNEL_NAMESPACE Avx512
+#include "kernels_impl.h"
@@ -0,0 +1,2 @@
+#define IMAGING_KERNEL_NAMESPACE Baseline
+#include "kernels_impl.h"
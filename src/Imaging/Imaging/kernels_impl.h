@@ -0,0 +1,648 @@
+/** Kernels compiled into the namespace IMAGING_KERNEL_NAMESPACE by each kernels_*.cpp with
+the instruction set of its level.
+
+@NOTE Everything here must have internal linkage and must not call inline functions or
+templates of other headers. Otherwise the linker may keep a single copy compiled for a
+higher level, which would then be run on a CPU without it. */
+
+#if !defined(IMAGING_KERNEL_NAMESPACE)
+#error IMAGING_KERNEL_NAMESPACE must be defined before including kernels_impl.h.
+#endif
+
+#include "kernels.h"
+
+#include <cstring>
+
+namespace Imaging
+{
+	namespace IMAGING_KERNEL_NAMESPACE
+	{
+		namespace
+		{
+			typedef unsigned char Byte;
+			typedef unsigned short Word;
+			typedef unsigned int DoubleWord;
+			typedef unsigned long long QuadWord;
+
+			/** Shifts and masks are vectorized as byte shuffles. */
+			Byte Swap(Byte value)
+			{
+				return value;
+			}
+
+			Word Swap(Word value)
+			{
+				return static_cast<Word>(value << 8 | value >> 8);
+			}
+
+			DoubleWord Swap(DoubleWord value)
+			{
+				return value << 24 | (value & 0xFF00u) << 8 | (value >> 8 & 0xFF00u) |
+					value >> 24;
+			}
+
+			QuadWord Swap(QuadWord value)
+			{
+				return static_cast<QuadWord>(Swap(static_cast<DoubleWord>(value))) << 32 |
+					Swap(static_cast<DoubleWord>(value >> 32));
+			}
+
+			template <typename U>
+			void CopySwapped(const void *src, ::size_t n, void *dst)
+			{
+				const U *s = static_cast<const U *>(src);
+				U *d = static_cast<U *>(dst);
+				for (::size_t I = 0; I != n; ++I)
+					d[I] = Swap(s[I]);
+			}
+
+			template <typename U, bool swap>
+			U Load(U value)
+			{
+				return swap ? Swap(value) : value;
+			}
+
+			/** A fixed number of bands is interleaved by a single pass over the bands. */
+			template <typename U, bool swap, ::size_t N>
+			void TransposeFixed(const U *src, ::size_t nSamples, U *dst)
+			{
+				const U *s[N];
+				for (::size_t B = 0; B != N; ++B)
+					s[B] = src + nSamples * B;
+				for (::size_t I = 0; I != nSamples; ++I)
+					for (::size_t B = 0; B != N; ++B)
+						dst[N * I + B] = Load<U, swap>(s[B][I]);
+			}
+
+			/** Other numbers of bands are processed in blocks of samples, so the destination
+			of a block stays in the cache while every band of the block is read. */
+			template <typename U, bool swap>
+			void TransposeBlocks(const U *src, ::size_t nBands, ::size_t nSamples, U *dst)
+			{
+				const ::size_t blockSize = 64;
+				for (::size_t first = 0; first < nSamples; first += blockSize)
+				{
+					const ::size_t last = first + blockSize < nSamples ? first + blockSize :
+						nSamples;
+					for (::size_t B = 0; B != nBands; ++B)
+					{
+						const U *s = src + nSamples * B;
+						for (::size_t I = first; I != last; ++I)
+							dst[nBands * I + B] = Load<U, swap>(s[I]);
+					}
+				}
+			}
+
+			template <typename U, bool swap>
+			void TransposeToBip(const U *src, ::size_t nBands, ::size_t nSamples, U *dst)
+			{
+				switch (nBands)
+				{
+				case 1:
+					TransposeFixed<U, swap, 1>(src, nSamples, dst);
+					break;
+				case 2:
+					TransposeFixed<U, swap, 2>(src, nSamples, dst);
+					break;
+				case 3:
+					TransposeFixed<U, swap, 3>(src, nSamples, dst);
+					break;
+				case 4:
+					TransposeFixed<U, swap, 4>(src, nSamples, dst);
+					break;
+				default:
+					TransposeBlocks<U, swap>(src, nBands, nSamples, dst);
+				}
+			}
+
+			template <typename U>
+			void TransposeToBip(const void *src, ::size_t nBands, ::size_t nSamples,
+				void *dst, bool swap)
+			{
+				const U *s = static_cast<const U *>(src);
+				U *d = static_cast<U *>(dst);
+				if (swap)
+					TransposeToBip<U, true>(s, nBands, nSamples, d);
+				else
+					TransposeToBip<U, false>(s, nBands, nSamples, d);
+			}
+
+			/** Pixel of N bytes. Pixels of 1, 2, 4 and 8 bytes are integers, so a tile of
+			them is transposed by shuffles in registers. */
+			template <::size_t N>
+			class Pixel
+			{
+			public:
+				typedef struct
+				{
+					Byte bytes[N];
+				} Type;
+			};
+
+			template <>
+			class Pixel<1>
+			{
+			public:
+				typedef Byte Type;
+			};
+
+			template <>
+			class Pixel<2>
+			{
+			public:
+				typedef Word Type;
+			};
+
+			template <>
+			class Pixel<4>
+			{
+			public:
+				typedef DoubleWord Type;
+			};
+
+			template <>
+			class Pixel<8>
+			{
+			public:
+				typedef QuadWord Type;
+			};
+
+			/** Pixels are moved by memcpy(), since lines may not be aligned for P. */
+			template <::size_t N>
+			typename Pixel<N>::Type LoadPixel(const Byte *src)
+			{
+				typename Pixel<N>::Type value;
+				std::memcpy(&value, src, N);
+				return value;
+			}
+
+			template <::size_t N>
+			void StorePixel(typename Pixel<N>::Type value, Byte *dst)
+			{
+				std::memcpy(dst, &value, N);
+			}
+
+			/** Loads a tile of 8 x 8 pixels of 1, 2, 4 or 8 bytes into a local tile and stores
+			it transposed. */
+			template <::size_t N>
+			void TransposeTileOfIntegers(const Byte *src, ::ptrdiff_t srcStride, Byte *dst,
+				::ptrdiff_t dstStride)
+			{
+				const int tileSize = 8;
+				typename Pixel<N>::Type tile[tileSize][tileSize];
+				for (int y = 0; y != tileSize; ++y)
+					for (int x = 0; x != tileSize; ++x)
+						tile[x][y] = LoadPixel<N>(src + srcStride * y + N * x);
+				for (int x = 0; x != tileSize; ++x)
+					for (int y = 0; y != tileSize; ++y)
+						StorePixel<N>(tile[x][y], dst + dstStride * x + N * y);
+			}
+
+			/** Pixels of other sizes, e.g., 3 channels, are moved by whole lines of a tile;
+			the bytes are gathered between local lines. */
+			template <::size_t N>
+			void TransposeTileOfBytes(const Byte *src, ::ptrdiff_t srcStride, Byte *dst,
+				::ptrdiff_t dstStride)
+			{
+				const int tileSize = 8;
+				Byte tile[tileSize][tileSize * N], line[tileSize * N];
+				for (int y = 0; y != tileSize; ++y)
+					std::memcpy(tile[y], src + srcStride * y, tileSize * N);
+				for (int x = 0; x != tileSize; ++x)
+				{
+					for (int y = 0; y != tileSize; ++y)
+						for (::size_t B = 0; B != N; ++B)
+							line[N * y + B] = tile[y][N * x + B];
+					std::memcpy(dst + dstStride * x, line, tileSize * N);
+				}
+			}
+
+			/** Full tiles are transposed in local tiles, and the partial tiles at the
+			right and bottom pixel by pixel. */
+			template <::size_t N>
+			void TransposePixels(const void *src, ::ptrdiff_t srcStride, ::size_t width,
+				::size_t height, void *dst, ::ptrdiff_t dstStride)
+			{
+				const ::size_t tileSize = 8;
+				const Byte *s = static_cast<const Byte *>(src);
+				Byte *d = static_cast<Byte *>(dst);
+				const ::size_t fullWidth = width - width % tileSize;
+				const ::size_t fullHeight = height - height % tileSize;
+				for (::size_t Y = 0; Y != fullHeight; Y += tileSize)
+					for (::size_t X = 0; X != fullWidth; X += tileSize)
+					{
+						const ::ptrdiff_t x = static_cast<::ptrdiff_t>(X);
+						const ::ptrdiff_t y = static_cast<::ptrdiff_t>(Y);
+						if ((N & (N - 1)) == 0)
+							TransposeTileOfIntegers<N>(s + srcStride * y + N * X, srcStride,
+								d + dstStride * x + N * Y, dstStride);
+						else
+							TransposeTileOfBytes<N>(s + srcStride * y + N * X, srcStride,
+								d + dstStride * x + N * Y, dstStride);
+					}
+				for (::size_t Y = 0; Y != height; ++Y)
+				{
+					const Byte *line = s + srcStride * static_cast<::ptrdiff_t>(Y);
+					for (::size_t X = Y < fullHeight ? fullWidth : 0; X != width; ++X)
+						StorePixel<N>(LoadPixel<N>(line + N * X),
+							d + dstStride * static_cast<::ptrdiff_t>(X) + N * Y);
+				}
+			}
+
+			/** Pixels are swapped from both ends, so dst may be src. */
+			template <::size_t N>
+			void ReversePixels(const void *src, ::size_t n, void *dst)
+			{
+				const Byte *s = static_cast<const Byte *>(src);
+				Byte *d = static_cast<Byte *>(dst);
+				for (::size_t I = 0, J = n - 1; I < n / 2; ++I, --J)
+				{
+					const typename Pixel<N>::Type first = LoadPixel<N>(s + N * I);
+					const typename Pixel<N>::Type last = LoadPixel<N>(s + N * J);
+					StorePixel<N>(last, d + N * I);
+					StorePixel<N>(first, d + N * J);
+				}
+				if (n % 2 != 0)
+					StorePixel<N>(LoadPixel<N>(s + N * (n / 2)), d + N * (n / 2));
+			}
+
+			/** Index of the pixel i of a line of n pixels reflected about its ends without
+			repeating the edge pixel, e.g., -2, -1, n, n + 1 -> 2, 1, n - 2, n - 3. */
+			::ptrdiff_t Reflect(::ptrdiff_t i, ::ptrdiff_t n)
+			{
+				if (n == 1)
+					return 0;
+				const ::ptrdiff_t period = 2 * (n - 1);
+				i = (i < 0 ? -i : i) % period;
+				return i < n ? i : period - i;
+			}
+
+			/** Rounds a sum of weights 256 to a sample; floating point sums are exact
+			divisions by the power of 2. */
+			template <typename A>
+			A Normalize(A sum)
+			{
+				return (sum + 128) >> 8;
+			}
+
+			float Normalize(float sum)
+			{
+				return sum / 256.0f;
+			}
+
+			/** Every output pixel reads 5 pixels of the buffer, 2 pixels apart from the
+			previous one. A fixed depth keeps the offsets constant for vectorization. */
+			template <typename U, typename A, ::size_t D>
+			void ReduceHorizontal(const A *buffer, ::size_t n, U *dst)
+			{
+				for (::size_t X = 0; X != n; ++X)
+					for (::size_t C = 0; C != D; ++C)
+					{
+						const A *p = buffer + 2 * D * X + C;
+						dst[D * X + C] = static_cast<U>(Normalize(p[0] + p[4 * D] +
+							4 * (p[D] + p[3 * D]) + 6 * p[2 * D]));
+					}
+			}
+
+			template <typename U, typename A>
+			void ReduceHorizontal(const A *buffer, ::size_t n, ::size_t depth, U *dst)
+			{
+				switch (depth)
+				{
+				case 1:
+					ReduceHorizontal<U, A, 1>(buffer, n, dst);
+					break;
+				case 2:
+					ReduceHorizontal<U, A, 2>(buffer, n, dst);
+					break;
+				case 3:
+					ReduceHorizontal<U, A, 3>(buffer, n, dst);
+					break;
+				case 4:
+					ReduceHorizontal<U, A, 4>(buffer, n, dst);
+					break;
+				default:
+					for (::size_t X = 0; X != n; ++X)
+						for (::size_t C = 0; C != depth; ++C)
+						{
+							const A *p = buffer + depth * 2 * X + C;
+							dst[depth * X + C] = static_cast<U>(Normalize(p[0] +
+								p[4 * depth] + 4 * (p[depth] + p[3 * depth]) +
+								6 * p[2 * depth]));
+						}
+				}
+			}
+
+			/** The vertical sums of the pixels 2 * first - 2, ..., 2 * last + 1 are stored
+			in the buffer, which is wide enough for the sums of 16 samples, and then reduced
+			horizontally. The pixels beyond the ends of the lines are copied from the sums of
+			the reflected pixels, which are always in the buffer. */
+			template <typename U, typename A>
+			void ReduceLines(const void *const *lines, ::size_t width, ::size_t depth,
+				::size_t first, ::size_t last, void *dst, void *buffer)
+			{
+				const U *l0 = static_cast<const U *>(lines[0]);
+				const U *l1 = static_cast<const U *>(lines[1]);
+				const U *l2 = static_cast<const U *>(lines[2]);
+				const U *l3 = static_cast<const U *>(lines[3]);
+				const U *l4 = static_cast<const U *>(lines[4]);
+				A *b = static_cast<A *>(buffer);
+				const ::ptrdiff_t w = static_cast<::ptrdiff_t>(width);
+				const ::ptrdiff_t q0 = 2 * static_cast<::ptrdiff_t>(first) - 2;
+				const ::ptrdiff_t q1 = 2 * static_cast<::ptrdiff_t>(last) + 2;
+				const ::ptrdiff_t s0 = q0 < 0 ? 0 : q0, s1 = q1 < w ? q1 : w;
+				for (::size_t I = depth * static_cast<::size_t>(s0),
+					L = depth * static_cast<::size_t>(s1),
+					J = depth * static_cast<::size_t>(s0 - q0); I != L; ++I, ++J)
+					b[J] = static_cast<A>(l0[I] + l4[I] + 4 * (l1[I] + l3[I]) + 6 * l2[I]);
+				for (::ptrdiff_t q = q0; q != q1; ++q)
+					if (q == s0)
+						q = s1 - 1;
+					else
+						std::memcpy(b + depth * static_cast<::size_t>(q - q0),
+							b + depth * static_cast<::size_t>(Reflect(q, w) - q0),
+							depth * sizeof(A));
+				ReduceHorizontal(b, last - first, depth, static_cast<U *>(dst));
+			}
+
+			/** Comparisons without branches are vectorized as packed minimums and
+			maximums. */
+			template <typename U>
+			void MinSamples(const void *a, const void *b, ::size_t n, void *dst)
+			{
+				const U *s = static_cast<const U *>(a), *t = static_cast<const U *>(b);
+				U *d = static_cast<U *>(dst);
+				for (::size_t I = 0; I != n; ++I)
+					d[I] = t[I] < s[I] ? t[I] : s[I];
+			}
+
+			template <typename U>
+			void MaxSamples(const void *a, const void *b, ::size_t n, void *dst)
+			{
+				const U *s = static_cast<const U *>(a), *t = static_cast<const U *>(b);
+				U *d = static_cast<U *>(dst);
+				for (::size_t I = 0; I != n; ++I)
+					d[I] = s[I] < t[I] ? t[I] : s[I];
+			}
+
+			/** A fixed depth keeps the offsets of the channels constant for vectorization. */
+			template <typename U, ::size_t D>
+			void ColorToGray(const U *src, ::size_t n, ::size_t posR, U *dst)
+			{
+				const U *r = src + posR, *g = src + 1, *b = src + 2 - posR;
+				for (::size_t P = 0; P != n; ++P)
+					dst[P] = static_cast<U>((77 * static_cast<int>(r[D * P]) +
+						150 * static_cast<int>(g[D * P]) + 29 * static_cast<int>(b[D * P]) +
+						128) >> 8);
+			}
+
+			template <typename U>
+			void ColorToGray(const void *src, ::size_t depth, ::size_t n, ::size_t posR,
+				void *dst)
+			{
+				const U *s = static_cast<const U *>(src);
+				U *d = static_cast<U *>(dst);
+				if (depth == 3)
+					ColorToGray<U, 3>(s, n, posR, d);
+				else
+					ColorToGray<U, 4>(s, n, posR, d);
+			}
+
+			Byte Saturate(int v)
+			{
+				return static_cast<Byte>(v < 0 ? 0 : (v > 255 ? 255 : v));
+			}
+
+			template <::size_t D>
+			void ColorToYuv(const Byte *src, ::size_t n, ::size_t posR,
+				const YuvCoefficients &k, Byte *dst)
+			{
+				for (::size_t P = 0; P != n; ++P)
+				{
+					const Byte *s = src + D * P;
+					const int r = s[posR], g = s[1], b = s[2 - posR];
+					const int y = (k.yr * r + k.yg * g + k.yb * b + 128) >> 8;
+					const int u = (k.ur * r + k.ug * g + k.ub * b + 128) >> 8;
+					const int v = (k.vr * r + k.vg * g + k.vb * b + 128) >> 8;
+					dst[3 * P] = Saturate(k.offsetY + y);
+					dst[3 * P + 1] = Saturate(128 + u);
+					dst[3 * P + 2] = Saturate(128 + v);
+				}
+			}
+
+			void ColorToYuv(const Byte *src, ::size_t depth, ::size_t n, ::size_t posR,
+				const YuvCoefficients &k, Byte *dst)
+			{
+				if (depth == 3)
+					ColorToYuv<3>(src, n, posR, k, dst);
+				else
+					ColorToYuv<4>(src, n, posR, k, dst);
+			}
+
+			void YuvToColor(const Byte *src, ::size_t n, ::size_t posR,
+				const YuvCoefficients &k, Byte *dst)
+			{
+				for (::size_t P = 0; P != n; ++P)
+				{
+					const int c = k.cy * (src[3 * P] - k.offsetY) + 128;
+					const int d = src[3 * P + 1] - 128, e = src[3 * P + 2] - 128;
+					const Byte r = Saturate((c + k.rv * e) >> 8);
+					const Byte g = Saturate((c - k.gu * d - k.gv * e) >> 8);
+					const Byte b = Saturate((c + k.bu * d) >> 8);
+					dst[3 * P + posR] = r;
+					dst[3 * P + 1] = g;
+					dst[3 * P + 2 - posR] = b;
+				}
+			}
+
+			int Abs(int v)
+			{
+				return v < 0 ? -v : v;
+			}
+
+			int Saturate(int v, int maxValue)
+			{
+				return v < 0 ? 0 : (v > maxValue ? maxValue : v);
+			}
+
+			/** Interpolates green of a line (Hamilton-Adams).
+
+			At a red or blue sample, the green is interpolated along the direction with the
+			smaller sum of the green gradient and the second derivative of the center color,
+			and corrected by half of that second derivative. Both directions are blended if
+			the sums are equal.
+			@param [in] r	5 lines centered at the line
+			@param [in] cx	column of the first red or blue sample of the line; 0 or 1
+			@param [out] g	green of the line, widened by 1 mirrored sample at both ends */
+			void InterpolateGreen(const int *const *r, ::ptrdiff_t width, ::ptrdiff_t cx,
+				int maxValue, int *g)
+			{
+				const int *pm2 = r[0], *pm = r[1], *p0 = r[2], *pp = r[3], *pp2 = r[4];
+				for (::ptrdiff_t X = 1 - cx; X < width; X += 2)
+					g[X] = p0[X];
+				for (::ptrdiff_t X = cx; X < width; X += 2)
+				{
+					int lapH = 2 * p0[X] - p0[X - 2] - p0[X + 2];
+					int lapV = 2 * p0[X] - pm2[X] - pp2[X];
+					int dH = Abs(p0[X - 1] - p0[X + 1]) + Abs(lapH);
+					int dV = Abs(pm[X] - pp[X]) + Abs(lapV);
+					int v;
+					if (dH < dV)
+						v = (2 * (p0[X - 1] + p0[X + 1]) + lapH + 2) / 4;
+					else if (dV < dH)
+						v = (2 * (pm[X] + pp[X]) + lapV + 2) / 4;
+					else
+						v = (2 * (p0[X - 1] + p0[X + 1] + pm[X] + pp[X]) + lapH + lapV + 4) /
+							8;
+					g[X] = Saturate(v, maxValue);
+				}
+				g[-1] = g[1];
+				g[width] = g[width - 2];
+			}
+
+			/** Interpolates a line by averaging the nearest samples of the same color.
+
+			Red and blue are handled the same way, so posC is the channel of the red or blue
+			samples on this line and posO is the other one.
+			@param [in] r	3 lines centered at the line */
+			template <typename U>
+			void DemosaicBilinearLine(const int *const *r, ::ptrdiff_t width, ::ptrdiff_t cx,
+				::size_t posC, ::size_t posO, U *dst)
+			{
+				const int *pm = r[0], *p0 = r[1], *pp = r[2];
+				for (::ptrdiff_t X = cx; X < width; X += 2)
+				{
+					U *t = dst + 3 * X;
+					t[posC] = static_cast<U>(p0[X]);
+					t[1] = static_cast<U>((p0[X - 1] + p0[X + 1] + pm[X] + pp[X] + 2) >> 2);
+					t[posO] = static_cast<U>((pm[X - 1] + pm[X + 1] + pp[X - 1] + pp[X + 1] +
+						2) >> 2);
+				}
+				for (::ptrdiff_t X = 1 - cx; X < width; X += 2)
+				{
+					U *t = dst + 3 * X;
+					t[posC] = static_cast<U>((p0[X - 1] + p0[X + 1] + 1) >> 1);
+					t[1] = static_cast<U>(p0[X]);
+					t[posO] = static_cast<U>((pm[X] + pp[X] + 1) >> 1);
+				}
+			}
+
+			/** Interpolates red and blue of a line as the differences from the interpolated
+			green.
+
+			@param [in] r	3 lines centered at the line
+			@param [in] g	green of the same 3 lines */
+			template <typename U>
+			void DemosaicEdgeAwareLine(const int *const *r, const int *const *g,
+				::ptrdiff_t width, ::ptrdiff_t cx, ::size_t posC, ::size_t posO, int maxValue,
+				U *dst)
+			{
+				const int *pm = r[0], *p0 = r[1], *pp = r[2];
+				const int *gm = g[0], *g0 = g[1], *gp = g[2];
+				for (::ptrdiff_t X = cx; X < width; X += 2)
+				{
+					U *t = dst + 3 * X;
+					int diff = (pm[X - 1] - gm[X - 1]) + (pm[X + 1] - gm[X + 1]) +
+						(pp[X - 1] - gp[X - 1]) + (pp[X + 1] - gp[X + 1]);
+					t[posC] = static_cast<U>(p0[X]);
+					t[1] = static_cast<U>(g0[X]);
+					t[posO] = static_cast<U>(Saturate(g0[X] + diff / 4, maxValue));
+				}
+				for (::ptrdiff_t X = 1 - cx; X < width; X += 2)
+				{
+					U *t = dst + 3 * X;
+					int diffC = (p0[X - 1] - g0[X - 1]) + (p0[X + 1] - g0[X + 1]);
+					int diffO = (pm[X] - gm[X]) + (pp[X] - gp[X]);
+					t[posC] = static_cast<U>(Saturate(p0[X] + diffC / 2, maxValue));
+					t[1] = static_cast<U>(p0[X]);
+					t[posO] = static_cast<U>(Saturate(p0[X] + diffO / 2, maxValue));
+				}
+			}
+
+			template <typename U>
+			void DemosaicBilinearLine(const int *const *r, ::ptrdiff_t width, ::ptrdiff_t cx,
+				::size_t posC, ::size_t posO, void *dst)
+			{
+				DemosaicBilinearLine(r, width, cx, posC, posO, static_cast<U *>(dst));
+			}
+
+			template <typename U>
+			void DemosaicEdgeAwareLine(const int *const *r, const int *const *g,
+				::ptrdiff_t width, ::ptrdiff_t cx, ::size_t posC, ::size_t posO, int maxValue,
+				void *dst)
+			{
+				DemosaicEdgeAwareLine(r, g, width, cx, posC, posO, maxValue,
+					static_cast<U *>(dst));
+			}
+
+			/** Sample K of a group lies at bit 2 K of the 16-bit word at byte K, so every
+			sample is that word shifted to the top and back by fixed amounts. Groups of 5
+			bytes have no vector load pattern, so the loop stays scalar. */
+			void UnpackMono10p(const Byte *src, ::size_t n, Word *dst)
+			{
+				for (::size_t I = 0; I != n; ++I, src += 5, dst += 4)
+					for (::size_t K = 0; K != 4; ++K)
+					{
+						const Word word = static_cast<Word>(src[K] | src[K + 1] << 8),
+							top = static_cast<Word>(word << (6 - 2 * K));
+						dst[K] = static_cast<Word>(top >> 6);
+					}
+			}
+
+			void UnpackMono12p(const Byte *src, ::size_t n, Word *dst)
+			{
+				for (::size_t I = 0; I != n; ++I, src += 3, dst += 2)
+				{
+					dst[0] = static_cast<Word>(src[0] | (src[1] & 0x0F) << 8);
+					dst[1] = static_cast<Word>(src[1] >> 4 | src[2] << 4);
+				}
+			}
+
+			void UnpackMono10Packed(const Byte *src, ::size_t n, Word *dst)
+			{
+				for (::size_t I = 0; I != n; ++I, src += 3, dst += 2)
+				{
+					dst[0] = static_cast<Word>(src[0] << 2 | (src[1] & 0x03));
+					dst[1] = static_cast<Word>(src[2] << 2 | (src[1] >> 4 & 0x03));
+				}
+			}
+
+			void UnpackMono12Packed(const Byte *src, ::size_t n, Word *dst)
+			{
+				for (::size_t I = 0; I != n; ++I, src += 3, dst += 2)
+				{
+					dst[0] = static_cast<Word>(src[0] << 4 | (src[1] & 0x0F));
+					dst[1] = static_cast<Word>(src[2] << 4 | src[1] >> 4);
+				}
+			}
+
+			const KernelTable kernels = {
+				{CopySwapped<Byte>, CopySwapped<Word>, CopySwapped<DoubleWord>,
+				CopySwapped<QuadWord>},
+				{TransposeToBip<Byte>, TransposeToBip<Word>, TransposeToBip<DoubleWord>,
+				TransposeToBip<QuadWord>},
+				{TransposePixels<1>, TransposePixels<2>, TransposePixels<3>,
+				TransposePixels<4>, TransposePixels<5>, TransposePixels<6>,
+				TransposePixels<7>, TransposePixels<8>},
+				{ReversePixels<1>, ReversePixels<2>, ReversePixels<3>, ReversePixels<4>,
+				ReversePixels<5>, ReversePixels<6>, ReversePixels<7>, ReversePixels<8>},
+				{ReduceLines<Byte, Word>, ReduceLines<Word, DoubleWord>,
+				ReduceLines<float, float>},
+				{MinSamples<Byte>, MinSamples<Word>, MinSamples<float>},
+				{MaxSamples<Byte>, MaxSamples<Word>, MaxSamples<float>},
+				{ColorToGray<Byte>, ColorToGray<Word>},
+				ColorToYuv,
+				YuvToColor,
+				InterpolateGreen,
+				{DemosaicBilinearLine<Byte>, DemosaicBilinearLine<Word>},
+				{DemosaicEdgeAwareLine<Byte>, DemosaicEdgeAwareLine<Word>},
+				{UnpackMono10p, UnpackMono12p, UnpackMono10Packed, UnpackMono12Packed}
+			};
+		}
+
+		const KernelTable &GetKernelTable(void)
+		{
+			return kernels;
+		}
+	}
+}
@@ -0,0 +1,16 @@
+#if !defined(KERNELS_INL_H)
+#define KERNELS_INL_H
+
+#include <type_traits>
+
+namespace Imaging
+{
+	template <typename T>
+	int GetKernelIndex(void)
+	{
+		return !std::is_arithmetic<T>::value ? -1 : sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 :
+			sizeof(T) == 4 ? 2 : sizeof(T) == 8 ? 3 : -1;
+	}
+}
+
+#endif
@@ -0,0 +1,2 @@
+#define IMAGING_KERNEL_NAMESPACE Sse41
+#include "kernels_impl.h"
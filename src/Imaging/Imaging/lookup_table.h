@@ -0,0 +1,128 @@
+#if !defined(LOOKUP_TABLE_H)
+#define LOOKUP_TABLE_H
+
+#include <type_traits>
+#include <vector>
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Table of output values of type U for every value of an 8-bit or 16-bit integral type
+	T.
+
+	A table holds one or more channels of 256 or 65536 entries. How the channels are used
+	depends on the depth of the source image in Apply().
+	1 channel: the same table is applied to all channels of the source (shared).
+	depth channels: each channel of the source uses its own table (per-channel).
+	N channels for a single-channel source: each table produces one channel of the
+	destination, i.e., the destination has N channels (color map). */
+	template <typename T, typename U>
+	class LookupTable
+	{
+		static_assert(std::is_integral<T>::value && sizeof(T) <= 2,
+			"Lookup tables are available for only 8-bit and 16-bit integral types.");
+
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef ::size_t SizeType;
+
+		//////////////////////////////////////////////////
+		// Default constructors.
+		LookupTable(void);
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Creates a table of given channels where every entry is 0. */
+		LookupTable(SizeType d);
+
+		/** Creates a table of given channels filled by func(value, c). */
+		template <typename F>
+		LookupTable(SizeType d, F func);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the number of channels. */
+		SizeType GetDepth(void) const;
+
+		/** Gets the number of entries per channel, i.e., the number of values of T. */
+		static SizeType GetLength(void);
+
+		/** Gets the position of a value in a channel of the table. */
+		static SizeType GetIndex(T value);
+
+		/** Gets the entries of a channel. */
+		U *GetTable(SizeType c = 0);
+		const U *GetTable(SizeType c = 0) const;
+
+		/** Accesses the entry of a value for a channel. */
+		U &operator()(T value, SizeType c = 0);
+		const U &operator()(T value, SizeType c = 0) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Fills every entry of every channel by U func(T value, SizeType c). */
+		template <typename F>
+		void Fill(F func);
+
+		void Reset(SizeType d);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void CheckRange(SizeType c) const;
+
+		//////////////////////////////////////////////////
+		// Data.
+		std::vector<U> data_;
+		SizeType depth_;
+	};
+
+	/** Fills a table with gamma correction, U = S * ((value - min) / (max - min))^gamma.
+
+	S is the maximum value of U for integral types and 1 for floating point types, and min
+	and max are the limits of T. */
+	template <typename T, typename U>
+	void SetGamma(double gamma, LookupTable<T, U> &lut);
+
+	/** Fills a table with a linear stretch of [low, high] into [0, S] where values outside
+	are saturated. */
+	template <typename T, typename U>
+	void SetContrastStretch(T low, T high, LookupTable<T, U> &lut);
+
+	/** Fills a table with a binary threshold; S if value > th, and 0 otherwise. */
+	template <typename T, typename U>
+	void SetThreshold(T th, LookupTable<T, U> &lut);
+
+	/** Maps the samples of a raw pointer through a lookup table.
+
+	The usage of the table is determined the same way as Apply() for images, and the
+	destination must hold nPixels x (the depth of destination) elements.
+	Source and destination may be the same memory if T and U are the same type and the
+	table is shared or per-channel. */
+	template <typename T, typename U>
+	void Apply(const T *src, ::size_t nPixels, ::size_t depth, const LookupTable<T, U> &lut,
+		U *dst);
+
+	/** Maps the samples of an image through a lookup table into a destination image.
+
+	@NOTE Destination will be reset based on the size of source and the usage of the table.
+	@exception std::invalid_argument	if the depth of the table does not match any usage
+	*/
+	template <typename T, typename U>
+	void Apply(const ImageFrame<T> &imgSrc, const LookupTable<T, U> &lut,
+		ImageFrame<U> &imgDst);
+
+	/** Maps the samples of an image through a shared or per-channel lookup table in place.
+	*/
+	template <typename T>
+	void Apply(ImageFrame<T> &img, const LookupTable<T, T> &lut);
+}
+
+#include "lookup_table_inl.h"
+
+#endif
@@ -0,0 +1,250 @@
+#if !defined(LOOKUP_TABLE_INL_H)
+#define LOOKUP_TABLE_INL_H
+
+#include <cmath>
+
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// LookupTable<T, U> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Default constructors.
+	template <typename T, typename U>
+	LookupTable<T, U>::LookupTable(void) : depth_(0) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T, typename U>
+	LookupTable<T, U>::LookupTable(SizeType d) : depth_(0)
+	{
+		this->Reset(d);
+	}
+
+	template <typename T, typename U>
+	template <typename F>
+	LookupTable<T, U>::LookupTable(SizeType d, F func) : depth_(0)
+	{
+		this->Reset(d);
+		this->Fill(func);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T, typename U>
+	typename LookupTable<T, U>::SizeType LookupTable<T, U>::GetDepth(void) const
+	{
+		return this->depth_;
+	}
+
+	template <typename T, typename U>
+	typename LookupTable<T, U>::SizeType LookupTable<T, U>::GetLength(void)
+	{
+		return static_cast<SizeType>(1) << (8 * sizeof(T));
+	}
+
+	/** Signed values are offset by the minimum value, so the entries are always stored in
+	ascending order of values. */
+	template <typename T, typename U>
+	typename LookupTable<T, U>::SizeType LookupTable<T, U>::GetIndex(T value)
+	{
+		return static_cast<SizeType>(static_cast<int>(value) -
+			static_cast<int>(std::numeric_limits<T>::lowest()));
+	}
+
+	template <typename T, typename U>
+	U *LookupTable<T, U>::GetTable(SizeType c)
+	{
+		this->CheckRange(c);
+		return this->data_.data() + GetLength() * c;
+	}
+
+	template <typename T, typename U>
+	const U *LookupTable<T, U>::GetTable(SizeType c) const
+	{
+		this->CheckRange(c);
+		return this->data_.data() + GetLength() * c;
+	}
+
+	template <typename T, typename U>
+	U &LookupTable<T, U>::operator()(T value, SizeType c)
+	{
+		return this->GetTable(c)[GetIndex(value)];
+	}
+
+	template <typename T, typename U>
+	const U &LookupTable<T, U>::operator()(T value, SizeType c) const
+	{
+		return this->GetTable(c)[GetIndex(value)];
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T, typename U>
+	void LookupTable<T, U>::CheckRange(SizeType c) const
+	{
+		if (c >= this->depth_)
+		{
+			std::ostringstream errMsg;
+			errMsg << "Channel c = " << c << " is out of range.";
+			throw std::out_of_range(errMsg.str());
+		}
+	}
+
+	/** The loop runs over values with int, so that it terminates for the maximum value of
+	T. */
+	template <typename T, typename U>
+	template <typename F>
+	void LookupTable<T, U>::Fill(F func)
+	{
+		const int first = std::numeric_limits<T>::lowest(), last = std::numeric_limits<T>::max();
+		auto it = this->data_.begin();
+		for (SizeType C = 0; C != this->depth_; ++C)
+			for (int V = first; V <= last; ++V, ++it)
+				*it = func(static_cast<T>(V), C);
+	}
+
+	template <typename T, typename U>
+	void LookupTable<T, U>::Reset(SizeType d)
+	{
+		this->data_.assign(GetLength() * d, static_cast<U>(0));
+		this->depth_ = d;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Table generators.
+
+	/** Gets the full scale of an output type; the maximum value for integral types and 1 for
+	floating point types. */
+	template <typename U>
+	double GetFullScale(void)
+	{
+		return std::is_floating_point<U>::value ? 1.0 :
+			static_cast<double>(std::numeric_limits<U>::max());
+	}
+
+	template <typename T, typename U>
+	void SetGamma(double gamma, LookupTable<T, U> &lut)
+	{
+		const double low = std::numeric_limits<T>::lowest();
+		const double range = static_cast<double>(std::numeric_limits<T>::max()) - low;
+		const double scale = GetFullScale<U>();
+		lut.Fill([=](T v, ::size_t) { return RoundOrCast<U>(
+			scale * std::pow((static_cast<double>(v) - low) / range, gamma)); });
+	}
+
+	template <typename T, typename U>
+	void SetContrastStretch(T low, T high, LookupTable<T, U> &lut)
+	{
+		if (!(low < high))
+			throw std::invalid_argument("Low must be smaller than high.");
+		const double scale = GetFullScale<U>();
+		const double gain = scale / (static_cast<double>(high) - static_cast<double>(low));
+		lut.Fill([=](T v, ::size_t) -> U
+		{
+			if (v <= low)
+				return static_cast<U>(0);
+			else if (v >= high)
+				return RoundOrCast<U>(scale);
+			else
+				return RoundOrCast<U>(gain *
+					(static_cast<double>(v) - static_cast<double>(low)));
+		});
+	}
+
+	template <typename T, typename U>
+	void SetThreshold(T th, LookupTable<T, U> &lut)
+	{
+		const U high = RoundOrCast<U>(GetFullScale<U>());
+		lut.Fill([=](T v, ::size_t) { return v > th ? high : static_cast<U>(0); });
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Apply.
+
+	/** Throws an exception if a table of dLut channels cannot be applied to depth channels,
+	i.e., it is neither a single table, a table per channel nor a color map of a gray
+	image. */
+	inline void CheckLookupDepth(::size_t dLut, ::size_t depth)
+	{
+		if (dLut > 1 && depth > 1 && dLut != depth)
+		{
+			std::ostringstream errMsg;
+			errMsg << "A table of " << dLut << " channels cannot be applied to " << depth <<
+				" channels.";
+			throw std::invalid_argument(errMsg.str());
+		}
+	}
+
+	/** Pixels are split into ranges processed in parallel. Each usage has its own loop, so
+	the innermost loop does not select tables per sample. */
+	template <typename T, typename U>
+	void Apply(const T *src, ::size_t nPixels, ::size_t depth, const LookupTable<T, U> &lut,
+		U *dst)
+	{
+		const ::size_t dLut = lut.GetDepth(), length = lut.GetLength();
+		if (dLut == 0 || nPixels == 0 || depth == 0)
+			return;
+		CheckLookupDepth(dLut, depth);
+		IMAGING_SCOPED_TIMER("Apply", nPixels * depth * sizeof(T) +
+			nPixels * (depth == 1 ? dLut : depth) * sizeof(U), nPixels);
+		const U *table = lut.GetTable(0);
+		const ::size_t grain = 16384;
+
+		if (dLut == 1)
+			ParallelFor(0, nPixels * depth, grain, [=](::size_t first, ::size_t last)
+			{
+				for (::size_t I = first; I != last; ++I)
+					dst[I] = table[LookupTable<T, U>::GetIndex(src[I])];
+			});
+		else if (dLut == depth)
+			ParallelFor(0, nPixels, grain, [=](::size_t first, ::size_t last)
+			{
+				for (::size_t P = first; P != last; ++P)
+					for (::size_t C = 0; C != depth; ++C)
+						dst[depth * P + C] = table[length * C +
+							LookupTable<T, U>::GetIndex(src[depth * P + C])];
+			});
+		else
+		{
+			if (static_cast<const void *>(src) == static_cast<const void *>(dst))
+				throw std::invalid_argument("A color map cannot be applied in place.");
+			ParallelFor(0, nPixels, grain, [=](::size_t first, ::size_t last)
+			{
+				for (::size_t P = first; P != last; ++P)
+				{
+					const U *t = table + LookupTable<T, U>::GetIndex(src[P]);
+					for (::size_t C = 0; C != dLut; ++C)
+						dst[dLut * P + C] = t[length * C];
+				}
+			});
+		}
+	}
+
+	template <typename T, typename U>
+	void Apply(const ImageFrame<T> &imgSrc, const LookupTable<T, U> &lut,
+		ImageFrame<U> &imgDst)
+	{
+		auto dLut = lut.GetDepth();
+		CheckLookupDepth(dLut, imgSrc.depth);
+		auto dDst = (imgSrc.depth == 1 && dLut > 1) ? dLut : imgSrc.depth;
+		if (static_cast<const void *>(&imgSrc) != static_cast<const void *>(&imgDst))
+			imgDst.Reset(imgSrc.size, dDst);
+		if (imgSrc.data.empty())
+			return;
+		Apply(imgSrc.data.data(), imgSrc.size.width * imgSrc.size.height, imgSrc.depth, lut,
+			imgDst.GetPointer(0, 0));
+	}
+
+	template <typename T>
+	void Apply(ImageFrame<T> &img, const LookupTable<T, T> &lut)
+	{
+		if (img.depth == 1 && lut.GetDepth() > 1)
+			throw std::invalid_argument("A color map cannot be applied in place.");
+		Apply(img, lut, img);
+	}
+}
+
+#endif
@@ -0,0 +1,125 @@
+#if !defined(MORPHOLOGY_H)
+#define MORPHOLOGY_H
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Grayscale morphology of images of any depth, where each channel is filtered
+	separately. Binary masks, e.g., 0 and 255 of unsigned char, are filtered by the same
+	functions, since the minimum and the maximum of a binary neighborhood are its AND and
+	OR.
+
+	A structuring element is anchored at (width / 2, height / 2), and pixels beyond the
+	edges are ignored. Erosion is the minimum over the element placed at each pixel, and
+	dilation is the maximum over the element reflected about its anchor, so opening is
+	never brighter and closing is never darker than the source, also for elements of even
+	sizes or without symmetry.
+
+	A rectangle is decomposed into a line and a column, which are filtered by van Herk and
+	Gil-Werman in 3 comparisons per sample for any size. Short lines, columns and other
+	elements are filtered by the minimum or the maximum of whole shifted lines, which is
+	done by the kernels of kernels.h for unsigned 8-bit and 16-bit samples and float. Lines
+	run in parallel.
+
+	The destination is reset to the size and depth of the source, and it may be the source.
+	The overloads taking a MorphologyBuffer keep their temporary frame and line buffers in
+	it, so filtering frames of the same dimension again allocates nothing on one thread.
+	@exception std::invalid_argument	if a rectangle has no pixels, or an element is not
+	a single channel with at least one nonzero pixel */
+
+	/** Temporary frame and line buffers of the morphology functions, which grow to the
+	largest frame filtered and are kept between calls. A buffer must not be used by two
+	calls at the same time. */
+	template <typename T>
+	class MorphologyBuffer
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the temporary frame. */
+		ImageFrame<T> &GetFrame(void);
+
+		/** Gets line buffers of at least n samples. */
+		T *GetLines(::size_t n);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Data.
+		ImageFrame<T> frame_;
+		std::vector<T> lines_;
+	};
+
+	/** Erodes an image by a rectangle. */
+	template <typename T>
+	void Erode(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst);
+	template <typename T>
+	void Erode(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst,
+		MorphologyBuffer<T> &buffer);
+
+	/** Erodes an image by the nonzero pixels of an element. */
+	template <typename T>
+	void Erode(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst);
+	template <typename T>
+	void Erode(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer);
+
+	/** Dilates an image by a rectangle. */
+	template <typename T>
+	void Dilate(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst);
+	template <typename T>
+	void Dilate(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst,
+		MorphologyBuffer<T> &buffer);
+
+	/** Dilates an image by the nonzero pixels of an element. */
+	template <typename T>
+	void Dilate(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst);
+	template <typename T>
+	void Dilate(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer);
+
+	/** Opens an image, i.e., erodes and then dilates it, which removes bright features
+	smaller than the element. */
+	template <typename T>
+	void Open(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst);
+	template <typename T>
+	void Open(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst,
+		MorphologyBuffer<T> &buffer);
+
+	template <typename T>
+	void Open(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst);
+	template <typename T>
+	void Open(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer);
+
+	/** Closes an image, i.e., dilates and then erodes it, which fills dark features smaller
+	than the element. */
+	template <typename T>
+	void Close(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst);
+	template <typename T>
+	void Close(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst,
+		MorphologyBuffer<T> &buffer);
+
+	template <typename T>
+	void Close(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst);
+	template <typename T>
+	void Close(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer);
+}
+
+#include "morphology_inl.h"
+
+#endif
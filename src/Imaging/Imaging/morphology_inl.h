@@ -0,0 +1,487 @@
+#if !defined(MORPHOLOGY_INL_H)
+#define MORPHOLOGY_INL_H
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "image_expression.h"
+#include "kernels.h"
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	/** Runs of up to this number of samples are filtered by the shifted lines directly, and
+	longer runs by van Herk and Gil-Werman. */
+	const ::size_t morphologyDirectLength = 8;
+	const ::size_t morphologyGrainLines = 16;
+
+	/** Stores Op of each pair of n samples of a and b; dst may be a or b. */
+	typedef void (*MorphologyKernel)(const void *a, const void *b, ::size_t n, void *dst);
+
+	template <typename T, typename Op>
+	void CombineSamples(const void *a, const void *b, ::size_t n, void *dst)
+	{
+		const T *s = static_cast<const T *>(a), *t = static_cast<const T *>(b);
+		T *d = static_cast<T *>(dst);
+		const Op op;
+		for (::size_t I = 0; I != n; ++I)
+			d[I] = static_cast<T>(op(s[I], t[I]));
+	}
+
+	/** Gets the kernels of kernels.h for unsigned 8-bit and 16-bit samples and float. */
+	template <typename T>
+	MorphologyKernel GetMorphologyKernel(MinOp)
+	{
+		const int index = GetKernelIndex<T>();
+		return (std::is_unsigned<T>::value && (index == 0 || index == 1)) ||
+			std::is_same<T, float>::value ? GetKernels().minSamples[index] :
+			CombineSamples<T, MinOp>;
+	}
+
+	template <typename T>
+	MorphologyKernel GetMorphologyKernel(MaxOp)
+	{
+		const int index = GetKernelIndex<T>();
+		return (std::is_unsigned<T>::value && (index == 0 || index == 1)) ||
+			std::is_same<T, float>::value ? GetKernels().maxSamples[index] :
+			CombineSamples<T, MaxOp>;
+	}
+
+	/** Gets the identity of Op, which stands for the pixels beyond the edges. */
+	template <typename T>
+	T GetMorphologyIdentity(MinOp)
+	{
+		return std::numeric_limits<T>::max();
+	}
+
+	template <typename T>
+	T GetMorphologyIdentity(MaxOp)
+	{
+		return std::numeric_limits<T>::lowest();
+	}
+
+	/** Clips a run of k samples starting before samples before each sample to n - 1
+	samples on either side, since the samples beyond the edges are ignored. */
+	inline void ClipMorphologyRun(::size_t n, ::size_t &k, ::size_t &before)
+	{
+		const ::size_t after = std::min(k - 1 - before, n - 1);
+		before = std::min(before, n - 1);
+		k = before + after + 1;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// MorphologyBuffer<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	ImageFrame<T> &MorphologyBuffer<T>::GetFrame(void)
+	{
+		return this->frame_;
+	}
+
+	template <typename T>
+	T *MorphologyBuffer<T>::GetLines(::size_t n)
+	{
+		if (this->lines_.size() < n)
+			this->lines_.resize(n);
+		return this->lines_.data();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Filters.
+
+	/** Gets the number of bands of n items, one for each thread, of at least grain items. */
+	inline ::size_t GetMorphologyBandCount(::size_t n, ::size_t grain)
+	{
+		return std::max<::size_t>(1, std::min<::size_t>(GetThreadCount(), n / grain));
+	}
+
+	/** Filters every line by Op over the pixels [x - before, x - before + k) of each pixel
+	x. A line is copied between pixels of the identity, so runs need no checks at the
+	edges, and the source may be the destination.
+	Longer runs are split into blocks of k pixels. Op from the start of each block to
+	every pixel is kept in g, and Op from every pixel to the end of its block replaces the
+	copied line, so the run of each pixel is Op of one sample of each. The lines are split
+	into a band for each thread, each with its line buffers. */
+	template <typename T, typename Op>
+	void FilterMorphologyLines(const ImageFrame<T> &imgSrc, ::size_t k, ::size_t before,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer)
+	{
+		const ::size_t w = imgSrc.size.width, h = imgSrc.size.height, d = imgSrc.depth;
+		const ::size_t n = w * d;
+		imgDst.Reset(imgSrc.size, d);
+		const T *pSrc = imgSrc.data.data();
+		T *pDst = imgDst.GetPointer(0, 0);
+		const MorphologyKernel combine = GetMorphologyKernel<T>(Op());
+		const T identity = GetMorphologyIdentity<T>(Op());
+		const ::size_t m = (w + k - 1) * d, nBlock = k * d;
+		const ::size_t nLines = k > morphologyDirectLength ? 2 * m : m;
+		const ::size_t nBands = GetMorphologyBandCount(h, morphologyGrainLines);
+		T *lines = buffer.GetLines(nBands * nLines);
+		ParallelFor(0, nBands, 1, [=](::size_t firstBand, ::size_t lastBand)
+		{
+			const Op op;
+			for (::size_t B = firstBand; B != lastBand; ++B)
+			{
+				T *p = lines + nLines * B, *g = p + m;
+				for (::size_t Y = h * B / nBands; Y != h * (B + 1) / nBands; ++Y)
+				{
+					T *dst = pDst + n * Y;
+					std::fill(p, p + before * d, identity);
+					std::copy_n(pSrc + n * Y, n, p + before * d);
+					std::fill(p + before * d + n, p + m, identity);
+					if (k <= morphologyDirectLength)
+					{
+						std::copy_n(p, n, dst);
+						for (::size_t J = 1; J < k; ++J)
+							combine(dst, p + J * d, n, dst);
+						continue;
+					}
+
+					for (::size_t I = 0; I < m; I += nBlock)
+					{
+						const ::size_t end = std::min(I + nBlock, m);
+						std::copy_n(p + I, d, g + I);
+						for (::size_t J = I + d; J < end; ++J)
+							g[J] = static_cast<T>(op(g[J - d], p[J]));
+						for (::size_t J = end - d; J-- != I;)
+							p[J] = static_cast<T>(op(p[J], p[J + d]));
+					}
+					combine(p, g + (k - 1) * d, n, dst);
+				}
+			}
+		});
+	}
+
+	/** Filters every column by Op over the lines [y - before, y - before + k) of each line
+	y, by Op of whole lines. The source must not be the destination.
+	Longer runs are filtered by van Herk and Gil-Werman as FilterMorphologyLines(), on
+	bands of at least 2 * k lines, each with the lines of the blocks read by the band. The
+	lines beyond the edges are the identity. The bands are split into a range for each
+	thread, each with its line buffers. */
+	template <typename T, typename Op>
+	void FilterMorphologyColumns(const ImageFrame<T> &imgSrc, ::size_t k, ::size_t before,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer)
+	{
+		const ::size_t h = imgSrc.size.height, n = imgSrc.size.width * imgSrc.depth;
+		imgDst.Reset(imgSrc.size, imgSrc.depth);
+		const T *pSrc = imgSrc.data.data();
+		T *pDst = imgDst.GetPointer(0, 0);
+		const MorphologyKernel combine = GetMorphologyKernel<T>(Op());
+		const T identity = GetMorphologyIdentity<T>(Op());
+		if (k <= morphologyDirectLength)
+		{
+			ParallelFor(0, h, morphologyGrainLines, [=](::size_t first, ::size_t last)
+			{
+				for (::size_t Y = first; Y != last; ++Y)
+				{
+					const ::size_t y0 = Y < before ? 0 : Y - before;
+					const ::size_t y1 = std::min(h, Y + k - before);
+					T *dst = pDst + n * Y;
+					std::copy_n(pSrc + n * y0, n, dst);
+					for (::size_t I = y0 + 1; I < y1; ++I)
+						combine(dst, pSrc + n * I, n, dst);
+				}
+			});
+			return;
+		}
+
+		const ::size_t nBandLines = std::max<::size_t>(2 * k, 64);
+		const ::size_t nBands = (h + nBandLines - 1) / nBandLines;
+		const ::size_t nRanges = GetMorphologyBandCount(nBands, 1);
+		const ::size_t m = std::min(nBandLines, h) + k - 1;
+		T *lines = buffer.GetLines(2 * m * n * nRanges);
+		ParallelFor(0, nRanges, 1, [=](::size_t firstRange, ::size_t lastRange)
+		{
+			for (::size_t R = firstRange; R != lastRange; ++R)
+			{
+				T *g = lines + 2 * m * n * R, *s = g + m * n;
+				for (::size_t B = nBands * R / nRanges; B != nBands * (R + 1) / nRanges; ++B)
+				{
+					const ::size_t y0 = B * nBandLines, y1 = std::min(h, y0 + nBandLines);
+					const ::size_t mBand = y1 - y0 + k - 1;
+
+					// Line i of the band is the source line y0 - before + i, or the
+					// identity.
+					auto Source = [=](::size_t i) -> const T *
+					{
+						const ::size_t y = y0 + i;
+						return y >= before && y - before < h ? pSrc + n * (y - before) :
+							nullptr;
+					};
+					auto Combine = [=](const T *a, ::size_t i, T *dst)
+					{
+						if (const T *src = Source(i))
+							combine(a, src, n, dst);
+						else
+							std::copy_n(a, n, dst);
+					};
+					auto Start = [=](::size_t i, T *dst)
+					{
+						if (const T *src = Source(i))
+							std::copy_n(src, n, dst);
+						else
+							std::fill(dst, dst + n, identity);
+					};
+					for (::size_t I = 0; I < mBand; I += k)
+					{
+						const ::size_t end = std::min(I + k, mBand);
+						Start(I, g + n * I);
+						for (::size_t J = I + 1; J != end; ++J)
+							Combine(g + n * (J - 1), J, g + n * J);
+						Start(end - 1, s + n * (end - 1));
+						for (::size_t J = end - 1; J-- != I;)
+							Combine(s + n * (J + 1), J, s + n * J);
+					}
+					for (::size_t Y = y0; Y != y1; ++Y)
+						combine(s + n * (Y - y0), g + n * (Y - y0 + k - 1), n, pDst + n * Y);
+				}
+			}
+		});
+	}
+
+	/** A rectangle is filtered along the columns into the destination, and then along its
+	lines in place. In place, the lines are filtered first, and the columns into the frame
+	of the buffer, which is then swapped with the destination. */
+	template <typename T, typename Op>
+	void FilterMorphology(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, bool reflect,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer)
+	{
+		if (szElement.width == 0 || szElement.height == 0)
+			throw std::invalid_argument("The structuring element has no pixels.");
+		if (imgSrc.data.empty())
+		{
+			imgDst.Reset(imgSrc.size, imgSrc.depth);
+			return;
+		}
+
+		::size_t kx = szElement.width, ky = szElement.height;
+		::size_t bx = reflect ? kx - 1 - kx / 2 : kx / 2;
+		::size_t by = reflect ? ky - 1 - ky / 2 : ky / 2;
+		ClipMorphologyRun(imgSrc.size.width, kx, bx);
+		ClipMorphologyRun(imgSrc.size.height, ky, by);
+		if (ky == 1)
+			return FilterMorphologyLines<T, Op>(imgSrc, kx, bx, imgDst, buffer);
+		if (&imgSrc != &imgDst)
+			FilterMorphologyColumns<T, Op>(imgSrc, ky, by, imgDst, buffer);
+		else
+		{
+			if (kx != 1)
+				FilterMorphologyLines<T, Op>(imgDst, kx, bx, imgDst, buffer);
+			FilterMorphologyColumns<T, Op>(imgDst, ky, by, buffer.GetFrame(), buffer);
+			std::swap(imgDst, buffer.GetFrame());
+			return;
+		}
+		if (kx != 1)
+			FilterMorphologyLines<T, Op>(imgDst, kx, bx, imgDst, buffer);
+	}
+
+	/** Each destination line starts from the identity and is combined with the part of the
+	source line shifted by each pixel of the element that falls inside the source. In
+	place, the destination is the frame of the buffer, which is then swapped with it. */
+	template <typename T, typename Op>
+	void FilterMorphology(const ImageFrame<T> &imgSrc,
+		const ImageFrame<unsigned char> &element, bool reflect, ImageFrame<T> &imgDst,
+		MorphologyBuffer<T> &buffer)
+	{
+		if (element.depth != 1 || std::find_if(element.data.cbegin(), element.data.cend(),
+			[](unsigned char v) { return v != 0; }) == element.data.cend())
+			throw std::invalid_argument(
+			"The structuring element needs a single channel with a nonzero pixel.");
+		if (imgSrc.data.empty())
+		{
+			imgDst.Reset(imgSrc.size, imgSrc.depth);
+			return;
+		}
+		if (&imgSrc == &imgDst)
+		{
+			FilterMorphology<T, Op>(imgSrc, element, reflect, buffer.GetFrame(), buffer);
+			std::swap(imgDst, buffer.GetFrame());
+			return;
+		}
+
+		const ::ptrdiff_t w = static_cast<::ptrdiff_t>(imgSrc.size.width);
+		const ::ptrdiff_t h = static_cast<::ptrdiff_t>(imgSrc.size.height);
+		const ::size_t d = imgSrc.depth, n = imgSrc.size.width * d;
+		const ::ptrdiff_t ax = static_cast<::ptrdiff_t>(element.size.width / 2);
+		const ::ptrdiff_t ay = static_cast<::ptrdiff_t>(element.size.height / 2);
+		imgDst.Reset(imgSrc.size, d);
+		const T *pSrc = imgSrc.data.data();
+		T *pDst = imgDst.GetPointer(0, 0);
+		const MorphologyKernel combine = GetMorphologyKernel<T>(Op());
+		const T identity = GetMorphologyIdentity<T>(Op());
+		ParallelFor(0, imgSrc.size.height, morphologyGrainLines,
+			[&](::size_t first, ::size_t last)
+		{
+			for (::size_t Y = first; Y != last; ++Y)
+			{
+				T *dst = pDst + n * Y;
+				std::fill(dst, dst + n, identity);
+				for (::size_t J = 0; J != element.size.height; ++J)
+					for (::size_t I = 0; I != element.size.width; ++I)
+					{
+						if (*element.GetPointer(I, J) == 0)
+							continue;
+						::ptrdiff_t dx = static_cast<::ptrdiff_t>(I) - ax;
+						::ptrdiff_t dy = static_cast<::ptrdiff_t>(J) - ay;
+						if (reflect)
+						{
+							dx = -dx;
+							dy = -dy;
+						}
+						const ::ptrdiff_t y = static_cast<::ptrdiff_t>(Y) + dy;
+						const ::ptrdiff_t x0 = std::max<::ptrdiff_t>(0, -dx);
+						const ::ptrdiff_t x1 = std::min(w, w - dx);
+						if (y < 0 || y >= h || x0 >= x1)
+							continue;
+						combine(dst + d * x0, pSrc + n * y + d * (x0 + dx), d * (x1 - x0),
+							dst + d * x0);
+					}
+			}
+		});
+	}
+
+	template <typename T>
+	void Erode(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst)
+	{
+		MorphologyBuffer<T> buffer;
+		Erode(imgSrc, szElement, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Erode(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst,
+		MorphologyBuffer<T> &buffer)
+	{
+		IMAGING_SCOPED_TIMER("Erode", 2 * imgSrc.data.size() * sizeof(T),
+			imgSrc.size.width * imgSrc.size.height);
+		FilterMorphology<T, MinOp>(imgSrc, szElement, false, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Erode(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst)
+	{
+		MorphologyBuffer<T> buffer;
+		Erode(imgSrc, element, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Erode(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer)
+	{
+		IMAGING_SCOPED_TIMER("Erode", 2 * imgSrc.data.size() * sizeof(T),
+			imgSrc.size.width * imgSrc.size.height);
+		FilterMorphology<T, MinOp>(imgSrc, element, false, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Dilate(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst)
+	{
+		MorphologyBuffer<T> buffer;
+		Dilate(imgSrc, szElement, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Dilate(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst,
+		MorphologyBuffer<T> &buffer)
+	{
+		IMAGING_SCOPED_TIMER("Dilate", 2 * imgSrc.data.size() * sizeof(T),
+			imgSrc.size.width * imgSrc.size.height);
+		FilterMorphology<T, MaxOp>(imgSrc, szElement, true, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Dilate(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst)
+	{
+		MorphologyBuffer<T> buffer;
+		Dilate(imgSrc, element, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Dilate(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer)
+	{
+		IMAGING_SCOPED_TIMER("Dilate", 2 * imgSrc.data.size() * sizeof(T),
+			imgSrc.size.width * imgSrc.size.height);
+		FilterMorphology<T, MaxOp>(imgSrc, element, true, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Open(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst)
+	{
+		MorphologyBuffer<T> buffer;
+		Open(imgSrc, szElement, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Open(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst,
+		MorphologyBuffer<T> &buffer)
+	{
+		Erode(imgSrc, szElement, imgDst, buffer);
+		Dilate(imgDst, szElement, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Open(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst)
+	{
+		MorphologyBuffer<T> buffer;
+		Open(imgSrc, element, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Open(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer)
+	{
+		Erode(imgSrc, element, imgDst, buffer);
+		Dilate(imgDst, element, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Close(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst)
+	{
+		MorphologyBuffer<T> buffer;
+		Close(imgSrc, szElement, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Close(const ImageFrame<T> &imgSrc,
+		const Size2D<typename ImageFrame<T>::SizeType> &szElement, ImageFrame<T> &imgDst,
+		MorphologyBuffer<T> &buffer)
+	{
+		Dilate(imgSrc, szElement, imgDst, buffer);
+		Erode(imgDst, szElement, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Close(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst)
+	{
+		MorphologyBuffer<T> buffer;
+		Close(imgSrc, element, imgDst, buffer);
+	}
+
+	template <typename T>
+	void Close(const ImageFrame<T> &imgSrc, const ImageFrame<unsigned char> &element,
+		ImageFrame<T> &imgDst, MorphologyBuffer<T> &buffer)
+	{
+		Dilate(imgSrc, element, imgDst, buffer);
+		Erode(imgDst, element, imgDst, buffer);
+	}
+}
+
+#endif
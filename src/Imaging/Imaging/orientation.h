@@ -0,0 +1,69 @@
+#if !defined(ORIENTATION_H)
+#define ORIENTATION_H
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Rotations by multiples of 90 degrees, flips and transposition of images of any depth.
+
+	Pixels are moved as a whole by the kernels of kernels.h for pixels up to 8 bytes, e.g.,
+	1, 3 or 4 channels of 8-bit or 16-bit samples, and by copies of the samples otherwise.
+	Transposition is done in tiles, which run in parallel, so both source and destination
+	lines of a tile stay in cache.
+
+	The destination is reset to the size and depth of the result. If source and destination
+	are the same image, the in-place variant is used.
+
+	The in-place variants of Rotate90(), Rotate270() and Transpose() need a square image,
+	since the lines of any other image change their length.
+	@exception std::invalid_argument	if an in-place transposition is not square */
+
+	/** Rotates an image by 90 degrees clockwise, i.e., the bottom-left pixel moves to the
+	top-left. */
+	template <typename T>
+	void Rotate90(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst);
+
+	template <typename T>
+	void Rotate90(ImageFrame<T> &img);
+
+	/** Rotates an image by 180 degrees. */
+	template <typename T>
+	void Rotate180(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst);
+
+	template <typename T>
+	void Rotate180(ImageFrame<T> &img);
+
+	/** Rotates an image by 270 degrees clockwise, i.e., the top-right pixel moves to the
+	top-left. */
+	template <typename T>
+	void Rotate270(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst);
+
+	template <typename T>
+	void Rotate270(ImageFrame<T> &img);
+
+	/** Mirrors the pixels of every line. */
+	template <typename T>
+	void FlipHorizontal(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst);
+
+	template <typename T>
+	void FlipHorizontal(ImageFrame<T> &img);
+
+	/** Mirrors the order of the lines. */
+	template <typename T>
+	void FlipVertical(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst);
+
+	template <typename T>
+	void FlipVertical(ImageFrame<T> &img);
+
+	/** Swaps x and y of every pixel, i.e., mirrors an image about its main diagonal. */
+	template <typename T>
+	void Transpose(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst);
+
+	template <typename T>
+	void Transpose(ImageFrame<T> &img);
+}
+
+#include "orientation_inl.h"
+
+#endif
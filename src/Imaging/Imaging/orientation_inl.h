@@ -0,0 +1,345 @@
+#if !defined(ORIENTATION_INL_H)
+#define ORIENTATION_INL_H
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "kernels.h"
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	/** Gets the pixels of a side of a tile of transposition. Lines of frames are often
+	strided by multiples of 1 KB, so the lines of a tile fall into a few sets of the L1 cache;
+	a tile of at most 16 lines of 128 bytes keeps them from evicting each other. */
+	inline ::size_t GetOrientationTileSize(::size_t pixelBytes)
+	{
+		return pixelBytes <= 4 ? 32 : 16;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Pixels of raw lines.
+	//
+	// Lines are strides of bytes apart. A negative stride from the last line walks the
+	// lines bottom up, which turns a transposition into a rotation.
+
+	/** Transposes width x height pixels of given bytes into height x width pixels. */
+	inline void TransposePixels(const char *src, ::ptrdiff_t srcStride, ::size_t width,
+		::size_t height, char *dst, ::ptrdiff_t dstStride, ::size_t pixelBytes)
+	{
+		if (pixelBytes - 1 < 8)
+			GetKernels().transposePixels[pixelBytes - 1](src, srcStride, width, height, dst,
+				dstStride);
+		else
+			for (::size_t Y = 0; Y != height; ++Y)
+				for (::size_t X = 0; X != width; ++X)
+					std::memcpy(dst + dstStride * static_cast<::ptrdiff_t>(X) +
+						pixelBytes * Y, src + srcStride * static_cast<::ptrdiff_t>(Y) +
+						pixelBytes * X, pixelBytes);
+	}
+
+	/** Copies n pixels of given bytes in reverse order; dst may be src. */
+	inline void ReversePixels(const char *src, ::size_t n, char *dst, ::size_t pixelBytes)
+	{
+		if (pixelBytes - 1 < 8)
+			GetKernels().reversePixels[pixelBytes - 1](src, n, dst);
+		else
+		{
+			for (::size_t I = 0, J = n - 1; I < n / 2; ++I, --J)
+				for (::size_t B = 0; B != pixelBytes; ++B)
+				{
+					const char first = src[pixelBytes * I + B];
+					const char last = src[pixelBytes * J + B];
+					dst[pixelBytes * I + B] = last;
+					dst[pixelBytes * J + B] = first;
+				}
+			if (n % 2 != 0 && src != dst)
+				std::memcpy(dst + pixelBytes * (n / 2), src + pixelBytes * (n / 2),
+					pixelBytes);
+		}
+	}
+
+	/** Transposes width x height pixels in tiles, which run in parallel. */
+	inline void TransposeTiles(const char *src, ::ptrdiff_t srcStride, ::size_t width,
+		::size_t height, char *dst, ::ptrdiff_t dstStride, ::size_t pixelBytes)
+	{
+		const ::size_t n = GetOrientationTileSize(pixelBytes);
+		const ::size_t nx = (width + n - 1) / n, ny = (height + n - 1) / n;
+		ParallelFor(0, nx * ny, 1, [&](::size_t first, ::size_t last)
+		{
+			for (::size_t I = first; I != last; ++I)
+			{
+				const ::size_t X = n * (I % nx), Y = n * (I / nx);
+				const ::ptrdiff_t x = static_cast<::ptrdiff_t>(X);
+				const ::ptrdiff_t y = static_cast<::ptrdiff_t>(Y);
+				TransposePixels(src + srcStride * y + pixelBytes * X, srcStride,
+					std::min(n, width - X), std::min(n, height - Y),
+					dst + dstStride * x + pixelBytes * Y, dstStride, pixelBytes);
+			}
+		});
+	}
+
+	/** Transposes size x size pixels in place. A tile above the diagonal is transposed into
+	a buffer, its mirror tile below the diagonal is transposed into its place, and the
+	buffer is copied into the mirror tile. The buffer is on the stack for pixels of up to
+	16 bytes. */
+	inline void TransposeSquare(char *data, ::size_t size, ::size_t pixelBytes)
+	{
+		const ::size_t n = GetOrientationTileSize(pixelBytes), nTiles = (size + n - 1) / n;
+		const ::ptrdiff_t stride = static_cast<::ptrdiff_t>(pixelBytes * size);
+		ParallelFor(0, nTiles * nTiles, 1, [&](::size_t first, ::size_t last)
+		{
+			char local[4096];
+			std::vector<char> heap(n * n * pixelBytes > sizeof(local) ?
+				n * n * pixelBytes : 0);
+			char *buffer = heap.empty() ? local : heap.data();
+			for (::size_t I = first; I != last; ++I)
+			{
+				const ::size_t X = n * (I % nTiles), Y = n * (I / nTiles);
+				if (X < Y)
+					continue;
+				const ::size_t w = std::min(n, size - X), h = std::min(n, size - Y);
+				char *tile = data + stride * static_cast<::ptrdiff_t>(Y) + pixelBytes * X;
+				char *mirror = data + stride * static_cast<::ptrdiff_t>(X) + pixelBytes * Y;
+				const ::ptrdiff_t bufferStride = static_cast<::ptrdiff_t>(pixelBytes * h);
+				TransposePixels(tile, stride, w, h, buffer, bufferStride, pixelBytes);
+				if (X != Y)
+					TransposePixels(mirror, stride, h, w, tile, stride, pixelBytes);
+				for (::size_t L = 0; L != w; ++L)
+					std::memcpy(mirror + stride * static_cast<::ptrdiff_t>(L),
+						buffer + bufferStride * static_cast<::ptrdiff_t>(L),
+						pixelBytes * h);
+			}
+		});
+	}
+
+	/** Reverses the pixels of every line of width x height pixels; dst may be src. */
+	inline void ReverseLines(const char *src, ::ptrdiff_t srcStride, ::size_t width,
+		::size_t height, char *dst, ::ptrdiff_t dstStride, ::size_t pixelBytes)
+	{
+		ParallelFor(0, height, 16, [&](::size_t first, ::size_t last)
+		{
+			for (::size_t Y = first; Y != last; ++Y)
+				ReversePixels(src + srcStride * static_cast<::ptrdiff_t>(Y), width,
+					dst + dstStride * static_cast<::ptrdiff_t>(Y), pixelBytes);
+		});
+	}
+
+	/** Reverses the order of lines of given bytes in place. */
+	inline void SwapLines(char *data, ::size_t bytesPerLine, ::size_t height)
+	{
+		ParallelFor(0, height / 2, 16, [&](::size_t first, ::size_t last)
+		{
+			for (::size_t Y = first; Y != last; ++Y)
+				std::swap_ranges(data + bytesPerLine * Y, data + bytesPerLine * (Y + 1),
+					data + bytesPerLine * (height - 1 - Y));
+		});
+	}
+
+	/** Gets the lines of an image to be written, or nullptr if it is empty. */
+	template <typename T>
+	char *GetOrientationLines(ImageFrame<T> &img)
+	{
+		return img.data.empty() ? nullptr : reinterpret_cast<char *>(img.GetPointer(0, 0));
+	}
+
+	/** Gets the lines of a source and resets a destination to given size. */
+	template <typename T>
+	const char *PrepareOrientation(const ImageFrame<T> &imgSrc, ::size_t width,
+		::size_t height, ImageFrame<T> &imgDst, char *&dst)
+	{
+		imgDst.Reset(width, height, imgSrc.depth);
+		dst = GetOrientationLines(imgDst);
+		return reinterpret_cast<const char *>(imgSrc.data.data());
+	}
+
+	template <typename T>
+	void CheckSquare(const ImageFrame<T> &img)
+	{
+		if (img.size.width != img.size.height)
+			throw std::invalid_argument(
+				"An image must be square to be transposed in place.");
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Rotations, flips and transposition.
+
+	template <typename T>
+	void Rotate90(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst)
+	{
+		if (&imgSrc == &imgDst)
+			return Rotate90(imgDst);
+		const ::size_t w = imgSrc.size.width, h = imgSrc.size.height;
+		const ::size_t pb = imgSrc.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("Rotate90", 2 * w * h * pb, w * h);
+		char *dst;
+		const char *src = PrepareOrientation(imgSrc, h, w, imgDst, dst);
+		if (dst == nullptr)
+			return;
+		const ::ptrdiff_t stride = static_cast<::ptrdiff_t>(pb * w);
+		TransposeTiles(src + stride * static_cast<::ptrdiff_t>(h - 1), -stride, w, h, dst,
+			static_cast<::ptrdiff_t>(pb * h), pb);
+	}
+
+	template <typename T>
+	void Rotate90(ImageFrame<T> &img)
+	{
+		CheckSquare(img);
+		const ::size_t n = img.size.width, pb = img.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("Rotate90", 4 * n * n * pb, n * n);
+		if (char *data = GetOrientationLines(img))
+		{
+			const ::ptrdiff_t stride = static_cast<::ptrdiff_t>(pb * n);
+			TransposeSquare(data, n, pb);
+			ReverseLines(data, stride, n, n, data, stride, pb);
+		}
+	}
+
+	template <typename T>
+	void Rotate180(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst)
+	{
+		if (&imgSrc == &imgDst)
+			return Rotate180(imgDst);
+		const ::size_t w = imgSrc.size.width, h = imgSrc.size.height;
+		const ::size_t pb = imgSrc.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("Rotate180", 2 * w * h * pb, w * h);
+		char *dst;
+		const char *src = PrepareOrientation(imgSrc, w, h, imgDst, dst);
+		if (dst == nullptr)
+			return;
+		const ::ptrdiff_t stride = static_cast<::ptrdiff_t>(pb * w);
+		ReverseLines(src + stride * static_cast<::ptrdiff_t>(h - 1), -stride, w, h, dst,
+			stride, pb);
+	}
+
+	template <typename T>
+	void Rotate180(ImageFrame<T> &img)
+	{
+		const ::size_t w = img.size.width, h = img.size.height, pb = img.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("Rotate180", 4 * w * h * pb, w * h);
+		if (char *data = GetOrientationLines(img))
+		{
+			const ::ptrdiff_t stride = static_cast<::ptrdiff_t>(pb * w);
+			SwapLines(data, pb * w, h);
+			ReverseLines(data, stride, w, h, data, stride, pb);
+		}
+	}
+
+	template <typename T>
+	void Rotate270(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst)
+	{
+		if (&imgSrc == &imgDst)
+			return Rotate270(imgDst);
+		const ::size_t w = imgSrc.size.width, h = imgSrc.size.height;
+		const ::size_t pb = imgSrc.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("Rotate270", 2 * w * h * pb, w * h);
+		char *dst;
+		const char *src = PrepareOrientation(imgSrc, h, w, imgDst, dst);
+		if (dst == nullptr)
+			return;
+		const ::ptrdiff_t stride = static_cast<::ptrdiff_t>(pb * h);
+		TransposeTiles(src, static_cast<::ptrdiff_t>(pb * w), w, h,
+			dst + stride * static_cast<::ptrdiff_t>(w - 1), -stride, pb);
+	}
+
+	template <typename T>
+	void Rotate270(ImageFrame<T> &img)
+	{
+		CheckSquare(img);
+		const ::size_t n = img.size.width, pb = img.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("Rotate270", 4 * n * n * pb, n * n);
+		if (char *data = GetOrientationLines(img))
+		{
+			TransposeSquare(data, n, pb);
+			SwapLines(data, pb * n, n);
+		}
+	}
+
+	template <typename T>
+	void FlipHorizontal(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst)
+	{
+		if (&imgSrc == &imgDst)
+			return FlipHorizontal(imgDst);
+		const ::size_t w = imgSrc.size.width, h = imgSrc.size.height;
+		const ::size_t pb = imgSrc.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("FlipHorizontal", 2 * w * h * pb, w * h);
+		char *dst;
+		const char *src = PrepareOrientation(imgSrc, w, h, imgDst, dst);
+		if (dst == nullptr)
+			return;
+		const ::ptrdiff_t stride = static_cast<::ptrdiff_t>(pb * w);
+		ReverseLines(src, stride, w, h, dst, stride, pb);
+	}
+
+	template <typename T>
+	void FlipHorizontal(ImageFrame<T> &img)
+	{
+		const ::size_t w = img.size.width, h = img.size.height, pb = img.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("FlipHorizontal", 2 * w * h * pb, w * h);
+		if (char *data = GetOrientationLines(img))
+		{
+			const ::ptrdiff_t stride = static_cast<::ptrdiff_t>(pb * w);
+			ReverseLines(data, stride, w, h, data, stride, pb);
+		}
+	}
+
+	template <typename T>
+	void FlipVertical(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst)
+	{
+		if (&imgSrc == &imgDst)
+			return FlipVertical(imgDst);
+		const ::size_t w = imgSrc.size.width, h = imgSrc.size.height;
+		const ::size_t pb = imgSrc.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("FlipVertical", 2 * w * h * pb, w * h);
+		char *dst;
+		const char *src = PrepareOrientation(imgSrc, w, h, imgDst, dst);
+		if (dst == nullptr)
+			return;
+		const ::size_t bytesPerLine = pb * w;
+		ParallelFor(0, h, 16, [&](::size_t first, ::size_t last)
+		{
+			for (::size_t Y = first; Y != last; ++Y)
+				std::memcpy(dst + bytesPerLine * Y, src + bytesPerLine * (h - 1 - Y),
+					bytesPerLine);
+		});
+	}
+
+	template <typename T>
+	void FlipVertical(ImageFrame<T> &img)
+	{
+		const ::size_t w = img.size.width, h = img.size.height, pb = img.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("FlipVertical", 2 * w * h * pb, w * h);
+		if (char *data = GetOrientationLines(img))
+			SwapLines(data, pb * w, h);
+	}
+
+	template <typename T>
+	void Transpose(const ImageFrame<T> &imgSrc, ImageFrame<T> &imgDst)
+	{
+		if (&imgSrc == &imgDst)
+			return Transpose(imgDst);
+		const ::size_t w = imgSrc.size.width, h = imgSrc.size.height;
+		const ::size_t pb = imgSrc.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("Transpose", 2 * w * h * pb, w * h);
+		char *dst;
+		const char *src = PrepareOrientation(imgSrc, h, w, imgDst, dst);
+		if (dst == nullptr)
+			return;
+		TransposeTiles(src, static_cast<::ptrdiff_t>(pb * w), w, h, dst,
+			static_cast<::ptrdiff_t>(pb * h), pb);
+	}
+
+	template <typename T>
+	void Transpose(ImageFrame<T> &img)
+	{
+		CheckSquare(img);
+		const ::size_t n = img.size.width, pb = img.depth * sizeof(T);
+		IMAGING_SCOPED_TIMER("Transpose", 2 * n * n * pb, n * n);
+		if (char *data = GetOrientationLines(img))
+			TransposeSquare(data, n, pb);
+	}
+}
+
+#endif
@@ -0,0 +1,295 @@
+#if !defined(PIPELINE_H)
+#define PIPELINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "image.h"
+#include "frame_pool.h"
+
+namespace Imaging
+{
+	/** Timing of a stage of a Pipeline after or during Run(). */
+	class StageStats
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Default constructors.
+		StageStats(void) : parallelism(0), nFrames(0), nInPlace(0), busySeconds(0.0) {}
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the mean seconds of processing a frame on a thread. */
+		double GetMeanSeconds(void) const;
+
+		//////////////////////////////////////////////////
+		// Data.
+		std::string name;
+		unsigned int parallelism;
+
+		/** Frames processed, and those processed in the frame of the previous stage. */
+		unsigned long long nFrames, nInPlace;
+
+		/** Seconds spent in the function of the stage, summed over its threads. */
+		double busySeconds;
+	};
+
+	/** Frame in flight through a Pipeline with its index in the order of the source. */
+	template <typename T>
+	class PipelineItem
+	{
+	public:
+		unsigned long long index;
+		std::shared_ptr<ImageFrame<T>> frame;
+	};
+
+	/** Bounded queue between stages of a Pipeline.
+
+	It is closed when every thread of the stage feeding it has finished, and Pop() fails
+	once it is closed and empty. Abort() closes it at once and drops what it holds. */
+	template <typename T>
+	class FrameChannel
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		FrameChannel(::size_t capacity, unsigned int nProducers);
+
+		FrameChannel(const FrameChannel<T> &src) = delete;
+		FrameChannel<T> &operator=(const FrameChannel<T> &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Waits for room and queues an item; returns false if aborted. */
+		bool Push(PipelineItem<T> item);
+
+		/** Waits for an item; returns false if closed and empty, or aborted. */
+		bool Pop(PipelineItem<T> &item);
+
+		/** Tells that a producer thread has finished. */
+		void Done(void);
+
+		void Abort(void);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Data.
+		std::mutex lock_;
+		std::condition_variable changed_;
+		std::deque<PipelineItem<T>> items_;
+		::size_t capacity_;
+		unsigned int nProducers_;
+		bool aborted_;
+	};
+
+	/** Node of a Pipeline run by a number of threads. */
+	class PipelineNode
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** @exception std::invalid_argument	if parallelism is 0 */
+		PipelineNode(const std::string &name, unsigned int parallelism);
+
+		virtual ~PipelineNode(void) {}
+
+		PipelineNode(const PipelineNode &src) = delete;
+		PipelineNode &operator=(const PipelineNode &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		const std::string &GetName(void) const;
+		unsigned int GetParallelism(void) const;
+		StageStats GetStats(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Prepares the node after the graph has been built. */
+		virtual void Start(void) {}
+
+		/** Body of a thread of the node. */
+		virtual void Work(void) = 0;
+
+		/** Tells the following nodes that a thread has finished. */
+		virtual void Finish(void) = 0;
+
+		/** Wakes up and stops every thread of the node. */
+		virtual void Abort(void) = 0;
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Calls func() and adds its time to the statistics, and to Instrumentation and
+		Tracer as operation "Pipeline/<name>" if IMAGING_INSTRUMENTATION is defined. */
+		template <typename F>
+		void Measure(F func);
+
+		/** Counts a frame processed. */
+		void Count(bool inPlace = false);
+
+		//////////////////////////////////////////////////
+		// Data.
+		std::string name_;
+		unsigned int parallelism_;
+		std::atomic<unsigned long long> nFrames_, nInPlace_, busyNanoseconds_;
+		::size_t operation_;
+	};
+
+	/** Node producing frames of type T from a pool into channels to the following nodes. */
+	template <typename T>
+	class PipelineOutput : public PipelineNode
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		PipelineOutput(const std::string &name, unsigned int parallelism);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		::size_t GetConsumerCount(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Adds a channel to a following node. */
+		std::shared_ptr<FrameChannel<T>> Connect(::size_t capacity);
+
+		virtual void Finish(void);
+		virtual void Abort(void);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Hands an item to every following node; returns false if aborted. */
+		bool Emit(const PipelineItem<T> &item);
+
+		//////////////////////////////////////////////////
+		// Data.
+		std::shared_ptr<FramePool<T>> frames_;
+		std::vector<std::shared_ptr<FrameChannel<T>>> outputs_;
+	};
+
+	/** Output of a stage of a Pipeline, to which following stages are connected. */
+	template <typename T>
+	class PipelinePort
+	{
+	public:
+		PipelinePort(void) : node(nullptr) {}
+		explicit PipelinePort(PipelineOutput<T> *node) : node(node) {}
+
+		PipelineOutput<T> *node;
+	};
+
+	/** Graph of stages connected by bounded queues of pooled frames.
+
+	A source fills frames in the order of indices; a stage reads a frame and writes another
+	frame, or modifies a frame in place; a sink consumes frames. Each node runs on its own
+	number of threads, so a slow stage is given more threads to keep up with the others.
+	Each node producing frames takes them from its own FramePool, and a frame returns to
+	the pool when every following node has released it.
+	An in-place stage modifies the frame of the previous stage if it is the only stage
+	following it, and works on a pooled copy otherwise.
+	Frames reach a stage of more than 1 thread out of order; an ordered sink puts them
+	back in the order of indices.
+	If a function throws, every node is stopped and Run() rethrows the first exception.
+
+	Pipeline pipeline(4);
+	auto raw = pipeline.AddSource<unsigned short>("ingest", sz, 1, Read);
+	auto gray = pipeline.AddStage<unsigned short, float>("convert", raw, Convert, 4);
+	auto smooth = pipeline.AddInPlaceStage<float>("filter", gray, Filter, 2);
+	pipeline.AddSink<float>("write", smooth, Write);
+	pipeline.Run(); */
+	class Pipeline
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Creates an empty pipeline whose queues hold given number of frames.
+
+		@exception std::invalid_argument	if capacity is 0 */
+		explicit Pipeline(::size_t capacity = 4);
+
+		Pipeline(const Pipeline &src) = delete;
+		Pipeline &operator=(const Pipeline &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the timing of every node in the order they have been added. */
+		std::vector<StageStats> GetStats(void) const;
+
+		/** Gets the seconds of the last Run(). */
+		double GetElapsedSeconds(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Adds a source filling frames of given dimension.
+
+		func(index, frame) fills the frame of an index and returns true, or returns false if
+		there is no frame of the index. Indices increase from 0 and the source stops at the
+		first false, so func() must return false for any index after that. func() is called
+		concurrently if parallelism is greater than 1. */
+		template <typename T>
+		PipelinePort<T> AddSource(const std::string &name, const Size2D<::size_t> &sz,
+			::size_t d, std::function<bool(unsigned long long, ImageFrame<T> &)> func,
+			unsigned int parallelism = 1);
+
+		/** Adds a stage writing a frame from a frame of the previous stage.
+
+		The output frame has the dimension of the input frame; func() may reset it. */
+		template <typename In, typename Out>
+		PipelinePort<Out> AddStage(const std::string &name, const PipelinePort<In> &input,
+			std::function<void(const ImageFrame<In> &, ImageFrame<Out> &)> func,
+			unsigned int parallelism = 1);
+
+		/** Adds a stage modifying a frame of the previous stage. */
+		template <typename T>
+		PipelinePort<T> AddInPlaceStage(const std::string &name, const PipelinePort<T> &input,
+			std::function<void(ImageFrame<T> &)> func, unsigned int parallelism = 1);
+
+		/** Adds a stage consuming frames of the previous stage by func(index, frame).
+
+		@exception std::invalid_argument	if ordered and parallelism is greater than 1 */
+		template <typename T>
+		void AddSink(const std::string &name, const PipelinePort<T> &input,
+			std::function<void(unsigned long long, const ImageFrame<T> &)> func,
+			unsigned int parallelism = 1, bool ordered = true);
+
+		/** Runs every node until the sources run out of frames and the queues are drained.
+
+		@exception std::logic_error	if the pipeline has no node or has been run */
+		void Run(void);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void CheckPort(const PipelineNode *node) const;
+		void Abort(void);
+
+		//////////////////////////////////////////////////
+		// Data.
+		::size_t capacity_;
+		std::vector<std::unique_ptr<PipelineNode>> nodes_;
+		bool started_;
+		double elapsed_;
+	};
+}
+
+#include "pipeline_inl.h"
+
+#endif
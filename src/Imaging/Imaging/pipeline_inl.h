@@ -0,0 +1,556 @@
+#if !defined(PIPELINE_INL_H)
+#define PIPELINE_INL_H
+
+#include <chrono>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+
+#include "../Utilities/thread_pool.h"
+#include "../Utilities/trace.h"
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// StageStats class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline double StageStats::GetMeanSeconds(void) const
+	{
+		return this->nFrames == 0 ? 0.0 : this->busySeconds / this->nFrames;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// FrameChannel<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	FrameChannel<T>::FrameChannel(::size_t capacity, unsigned int nProducers) :
+		capacity_(capacity), nProducers_(nProducers), aborted_(false) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	bool FrameChannel<T>::Push(PipelineItem<T> item)
+	{
+		std::unique_lock<std::mutex> guard(this->lock_);
+		this->changed_.wait(guard, [this]()
+		{
+			return this->aborted_ || this->items_.size() < this->capacity_;
+		});
+		if (this->aborted_)
+			return false;
+		this->items_.push_back(std::move(item));
+		this->changed_.notify_all();
+		return true;
+	}
+
+	template <typename T>
+	bool FrameChannel<T>::Pop(PipelineItem<T> &item)
+	{
+		std::unique_lock<std::mutex> guard(this->lock_);
+		this->changed_.wait(guard, [this]()
+		{
+			return this->aborted_ || !this->items_.empty() || this->nProducers_ == 0;
+		});
+		if (this->aborted_ || this->items_.empty())
+			return false;
+		item = std::move(this->items_.front());
+		this->items_.pop_front();
+		this->changed_.notify_all();
+		return true;
+	}
+
+	template <typename T>
+	void FrameChannel<T>::Done(void)
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		if (this->nProducers_ != 0)
+			--this->nProducers_;
+		this->changed_.notify_all();
+	}
+
+	template <typename T>
+	void FrameChannel<T>::Abort(void)
+	{
+		std::lock_guard<std::mutex> guard(this->lock_);
+		this->aborted_ = true;
+		this->items_.clear();
+		this->changed_.notify_all();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// PipelineNode class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	inline PipelineNode::PipelineNode(const std::string &name, unsigned int parallelism) :
+		name_(name), parallelism_(parallelism), nFrames_(0), nInPlace_(0), busyNanoseconds_(0),
+		operation_(0)
+	{
+		if (parallelism == 0)
+			throw std::invalid_argument("The parallelism of a stage must be greater than 0.");
+#if defined(IMAGING_INSTRUMENTATION)
+		this->operation_ = Instrumentation::Register("Pipeline/" + name);
+#endif
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline const std::string &PipelineNode::GetName(void) const
+	{
+		return this->name_;
+	}
+
+	inline unsigned int PipelineNode::GetParallelism(void) const
+	{
+		return this->parallelism_;
+	}
+
+	inline StageStats PipelineNode::GetStats(void) const
+	{
+		StageStats stats;
+		stats.name = this->name_;
+		stats.parallelism = this->parallelism_;
+		stats.nFrames = this->nFrames_.load(std::memory_order_relaxed);
+		stats.nInPlace = this->nInPlace_.load(std::memory_order_relaxed);
+		stats.busySeconds = 1e-9 * this->busyNanoseconds_.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename F>
+	void PipelineNode::Measure(F func)
+	{
+#if defined(IMAGING_INSTRUMENTATION)
+		AllocationScope scope(this->operation_);
+#endif
+		auto t0 = std::chrono::steady_clock::now();
+		func();
+		const auto ns = static_cast<unsigned long long>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - t0).count());
+		this->busyNanoseconds_.fetch_add(ns, std::memory_order_relaxed);
+#if defined(IMAGING_INSTRUMENTATION)
+		Instrumentation::Record(this->operation_, ns, 0, 0);
+		if (Tracer::IsEnabled())
+			Tracer::Record(this->operation_, t0, ns);
+#endif
+	}
+
+	inline void PipelineNode::Count(bool inPlace)
+	{
+		this->nFrames_.fetch_add(1, std::memory_order_relaxed);
+		if (inPlace)
+			this->nInPlace_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// PipelineOutput<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	PipelineOutput<T>::PipelineOutput(const std::string &name, unsigned int parallelism) :
+		PipelineNode(name, parallelism), frames_(std::make_shared<FramePool<T>>()) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	::size_t PipelineOutput<T>::GetConsumerCount(void) const
+	{
+		return this->outputs_.size();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	std::shared_ptr<FrameChannel<T>> PipelineOutput<T>::Connect(::size_t capacity)
+	{
+		auto channel = std::make_shared<FrameChannel<T>>(capacity, this->parallelism_);
+		this->outputs_.push_back(channel);
+		return channel;
+	}
+
+	template <typename T>
+	void PipelineOutput<T>::Finish(void)
+	{
+		for (auto it = this->outputs_.begin(); it != this->outputs_.end(); ++it)
+			(*it)->Done();
+	}
+
+	template <typename T>
+	void PipelineOutput<T>::Abort(void)
+	{
+		for (auto it = this->outputs_.begin(); it != this->outputs_.end(); ++it)
+			(*it)->Abort();
+	}
+
+	template <typename T>
+	bool PipelineOutput<T>::Emit(const PipelineItem<T> &item)
+	{
+		for (auto it = this->outputs_.begin(); it != this->outputs_.end(); ++it)
+			if (!(*it)->Push(item))
+				return false;
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Nodes of each kind.
+
+	template <typename T>
+	class PipelineSource : public PipelineOutput<T>
+	{
+	public:
+		typedef std::function<bool(unsigned long long, ImageFrame<T> &)> Function;
+
+		PipelineSource(const std::string &name, unsigned int parallelism,
+			const Size2D<::size_t> &sz, ::size_t d, Function func) :
+			PipelineOutput<T>(name, parallelism), size_(sz), depth_(d), func_(func), next_(0),
+			end_(std::numeric_limits<unsigned long long>::max()), stopped_(false) {}
+
+		/** A worker stops only at or after the first index without a frame, so the indices
+		taken before it are filled even if another worker has run out at a later one. */
+		virtual void Work(void)
+		{
+			for (;;)
+			{
+				PipelineItem<T> item;
+				item.index = this->next_.fetch_add(1);
+				if (this->stopped_.load() || item.index >= this->end_.load())
+					break;
+				item.frame = this->frames_->Acquire(this->size_, this->depth_);
+				bool filled = false;
+				this->Measure([&]() { filled = this->func_(item.index, *item.frame); });
+				if (!filled)
+				{
+					unsigned long long end = this->end_.load();
+					while (item.index < end && !this->end_.compare_exchange_weak(end,
+						item.index))
+						;
+					break;
+				}
+				this->Count();
+				if (!this->Emit(item))
+					break;
+			}
+		}
+
+		virtual void Abort(void)
+		{
+			this->stopped_.store(true);
+			PipelineOutput<T>::Abort();
+		}
+
+	protected:
+		Size2D<::size_t> size_;
+		::size_t depth_;
+		Function func_;
+		std::atomic<unsigned long long> next_, end_;
+		std::atomic<bool> stopped_;
+	};
+
+	template <typename In, typename Out>
+	class PipelineStage : public PipelineOutput<Out>
+	{
+	public:
+		typedef std::function<void(const ImageFrame<In> &, ImageFrame<Out> &)> Function;
+
+		PipelineStage(const std::string &name, unsigned int parallelism,
+			std::shared_ptr<FrameChannel<In>> input, Function func) :
+			PipelineOutput<Out>(name, parallelism), input_(input), func_(func) {}
+
+		virtual void Work(void)
+		{
+			PipelineItem<In> item;
+			while (this->input_->Pop(item))
+			{
+				PipelineItem<Out> result;
+				result.index = item.index;
+				result.frame = this->frames_->Acquire(item.frame->size, item.frame->depth);
+				this->Measure([&]() { this->func_(*item.frame, *result.frame); });
+				this->Count();
+				item.frame.reset();
+				if (!this->Emit(result))
+					break;
+			}
+		}
+
+		virtual void Abort(void)
+		{
+			this->input_->Abort();
+			PipelineOutput<Out>::Abort();
+		}
+
+	protected:
+		std::shared_ptr<FrameChannel<In>> input_;
+		Function func_;
+	};
+
+	template <typename T>
+	class PipelineInPlaceStage : public PipelineOutput<T>
+	{
+	public:
+		typedef std::function<void(ImageFrame<T> &)> Function;
+
+		PipelineInPlaceStage(const std::string &name, unsigned int parallelism,
+			const PipelineOutput<T> *previous, std::shared_ptr<FrameChannel<T>> input,
+			Function func) : PipelineOutput<T>(name, parallelism), previous_(previous),
+			input_(input), func_(func), inPlace_(false) {}
+
+		virtual void Start(void)
+		{
+			this->inPlace_ = this->previous_->GetConsumerCount() == 1;
+		}
+
+		virtual void Work(void)
+		{
+			PipelineItem<T> item;
+			while (this->input_->Pop(item))
+			{
+				this->Measure([&]()
+				{
+					if (!this->inPlace_)
+					{
+						auto copy = this->frames_->Acquire(item.frame->size, item.frame->depth);
+						copy->CopyFrom(item.frame->data, item.frame->size, item.frame->depth);
+						item.frame = copy;
+					}
+					this->func_(*item.frame);
+				});
+				this->Count(this->inPlace_);
+				if (!this->Emit(item))
+					break;
+				item.frame.reset();
+			}
+		}
+
+		virtual void Abort(void)
+		{
+			this->input_->Abort();
+			PipelineOutput<T>::Abort();
+		}
+
+	protected:
+		const PipelineOutput<T> *previous_;
+		std::shared_ptr<FrameChannel<T>> input_;
+		Function func_;
+		bool inPlace_;
+	};
+
+	template <typename T>
+	class PipelineSink : public PipelineNode
+	{
+	public:
+		typedef std::function<void(unsigned long long, const ImageFrame<T> &)> Function;
+
+		PipelineSink(const std::string &name, unsigned int parallelism,
+			std::shared_ptr<FrameChannel<T>> input, Function func, bool ordered) :
+			PipelineNode(name, parallelism), input_(input), func_(func), ordered_(ordered),
+			next_(0) {}
+
+		virtual void Work(void)
+		{
+			PipelineItem<T> item;
+			while (this->input_->Pop(item))
+			{
+				if (!this->ordered_)
+				{
+					this->Consume(item.index, *item.frame);
+					continue;
+				}
+
+				// Holds frames arriving early until the frames before them have arrived.
+				this->pending_[item.index] = std::move(item.frame);
+				for (auto it = this->pending_.find(this->next_); it != this->pending_.end();
+					it = this->pending_.find(this->next_))
+				{
+					this->Consume(it->first, *it->second);
+					this->pending_.erase(it);
+					++this->next_;
+				}
+			}
+		}
+
+		virtual void Finish(void) {}
+
+		virtual void Abort(void)
+		{
+			this->input_->Abort();
+		}
+
+	protected:
+		void Consume(unsigned long long index, const ImageFrame<T> &frame)
+		{
+			this->Measure([&]() { this->func_(index, frame); });
+			this->Count();
+		}
+
+		std::shared_ptr<FrameChannel<T>> input_;
+		Function func_;
+		bool ordered_;
+		unsigned long long next_;
+		std::map<unsigned long long, std::shared_ptr<ImageFrame<T>>> pending_;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Pipeline class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	inline Pipeline::Pipeline(::size_t capacity) : capacity_(capacity), started_(false),
+		elapsed_(0.0)
+	{
+		if (capacity == 0)
+			throw std::invalid_argument("The capacity of queues must be greater than 0.");
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline std::vector<StageStats> Pipeline::GetStats(void) const
+	{
+		std::vector<StageStats> stats;
+		for (auto it = this->nodes_.cbegin(); it != this->nodes_.cend(); ++it)
+			stats.push_back((*it)->GetStats());
+		return stats;
+	}
+
+	inline double Pipeline::GetElapsedSeconds(void) const
+	{
+		return this->elapsed_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	PipelinePort<T> Pipeline::AddSource(const std::string &name, const Size2D<::size_t> &sz,
+		::size_t d, std::function<bool(unsigned long long, ImageFrame<T> &)> func,
+		unsigned int parallelism)
+	{
+		std::unique_ptr<PipelineSource<T>> node(new PipelineSource<T>(name, parallelism, sz, d,
+			func));
+		PipelinePort<T> port(node.get());
+		this->nodes_.push_back(std::move(node));
+		return port;
+	}
+
+	template <typename In, typename Out>
+	PipelinePort<Out> Pipeline::AddStage(const std::string &name,
+		const PipelinePort<In> &input,
+		std::function<void(const ImageFrame<In> &, ImageFrame<Out> &)> func,
+		unsigned int parallelism)
+	{
+		this->CheckPort(input.node);
+		std::unique_ptr<PipelineStage<In, Out>> node(new PipelineStage<In, Out>(name,
+			parallelism, input.node->Connect(this->capacity_), func));
+		PipelinePort<Out> port(node.get());
+		this->nodes_.push_back(std::move(node));
+		return port;
+	}
+
+	template <typename T>
+	PipelinePort<T> Pipeline::AddInPlaceStage(const std::string &name,
+		const PipelinePort<T> &input, std::function<void(ImageFrame<T> &)> func,
+		unsigned int parallelism)
+	{
+		this->CheckPort(input.node);
+		std::unique_ptr<PipelineInPlaceStage<T>> node(new PipelineInPlaceStage<T>(name,
+			parallelism, input.node, input.node->Connect(this->capacity_), func));
+		PipelinePort<T> port(node.get());
+		this->nodes_.push_back(std::move(node));
+		return port;
+	}
+
+	template <typename T>
+	void Pipeline::AddSink(const std::string &name, const PipelinePort<T> &input,
+		std::function<void(unsigned long long, const ImageFrame<T> &)> func,
+		unsigned int parallelism, bool ordered)
+	{
+		this->CheckPort(input.node);
+		if (ordered && parallelism > 1)
+			throw std::invalid_argument("An ordered sink must run on a single thread.");
+		this->nodes_.push_back(std::unique_ptr<PipelineNode>(new PipelineSink<T>(name,
+			parallelism, input.node->Connect(this->capacity_), func, ordered)));
+	}
+
+	/** Every thread of every node is started at once, since the nodes wait for each other
+	through the queues. */
+	inline void Pipeline::Run(void)
+	{
+		if (this->nodes_.empty())
+			throw std::logic_error("A pipeline must have a node to run.");
+		if (this->started_)
+			throw std::logic_error("A pipeline can be run only once.");
+		this->started_ = true;
+
+		unsigned int nThreads = 0;
+		for (auto it = this->nodes_.begin(); it != this->nodes_.end(); ++it)
+		{
+			(*it)->Start();
+			nThreads += (*it)->GetParallelism();
+		}
+
+		auto t0 = std::chrono::steady_clock::now();
+		std::exception_ptr error;
+		{
+			ThreadPool threads(nThreads);
+			std::vector<std::future<void>> results;
+			for (auto it = this->nodes_.begin(); it != this->nodes_.end(); ++it)
+			{
+				PipelineNode *node = it->get();
+				for (unsigned int I = 0; I != node->GetParallelism(); ++I)
+					results.push_back(threads.Submit([this, node]()
+					{
+#if defined(IMAGING_INSTRUMENTATION)
+						Tracer::SetThreadName(node->GetName());
+#endif
+						try
+						{
+							node->Work();
+						}
+						catch (...)
+						{
+							this->Abort();
+							throw;
+						}
+						node->Finish();
+					}));
+			}
+			for (auto it = results.begin(); it != results.end(); ++it)
+			{
+				try
+				{
+					it->get();
+				}
+				catch (...)
+				{
+					if (!error)
+						error = std::current_exception();
+				}
+			}
+		}
+		this->elapsed_ = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+			t0).count();
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	inline void Pipeline::CheckPort(const PipelineNode *node) const
+	{
+		for (auto it = this->nodes_.cbegin(); it != this->nodes_.cend(); ++it)
+			if (it->get() == node)
+				return;
+		throw std::invalid_argument("The port does not belong to the pipeline.");
+	}
+
+	inline void Pipeline::Abort(void)
+	{
+		for (auto it = this->nodes_.begin(); it != this->nodes_.end(); ++it)
+			(*it)->Abort();
+	}
+}
+
+#endif
@@ -0,0 +1,156 @@
+#if !defined(PYRAMID_H)
+#define PYRAMID_H
+
+#include <type_traits>
+#include <vector>
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Selects the types of the sums of a Pyramid<T> for given sample type.
+
+	The accumulator holds a sum of 256 samples weighted by [1 4 6 4 1] x [1 4 6 4 1], and the
+	Laplacian holds a signed difference of two samples.
+	unsigned 8-bit -> unsigned short, short
+	unsigned 16-bit -> unsigned int, int
+	other integral types up to 16-bit -> int, int
+	32-bit integral types -> (unsigned) long long, long long
+	floating point types -> T, T
+	64-bit integral types are not supported. */
+	template <typename T>
+	class PyramidTraits
+	{
+	public:
+		static_assert(std::is_arithmetic<T>::value && (std::is_floating_point<T>::value ||
+			sizeof(T) <= 4), "64-bit integral samples are not supported.");
+
+		typedef typename std::conditional<std::is_floating_point<T>::value, T,
+			typename std::conditional<std::is_unsigned<T>::value && sizeof(T) <= 2,
+			typename std::conditional<sizeof(T) == 1, unsigned short, unsigned int>::type,
+			typename std::conditional<sizeof(T) <= 2, int,
+			typename std::conditional<std::is_unsigned<T>::value, unsigned long long,
+			long long>::type>::type>::type>::type AccumulatorType;
+		typedef typename std::conditional<std::is_floating_point<T>::value, T,
+			typename std::conditional<sizeof(T) == 1, short,
+			typename std::conditional<sizeof(T) == 2, int, long long>::type>::type>::type
+			LaplacianType;
+	};
+
+	/** Gaussian and Laplacian pyramids of a frame in preallocated levels, for detection at
+	multiple scales.
+
+	Level 0 is a copy of the source frame or an ROI of it, and each next level is the
+	previous level blurred by [1 4 6 4 1] / 16 in both directions and decimated by 2, i.e.,
+	(width + 1) / 2 x (height + 1) / 2 pixels. Pixels beyond the edges are reflected without
+	repeating the edge pixel. The blur and the decimation are fused into a single pass over
+	the lines of a level, computed by the kernels of kernels.h for unsigned 8-bit and
+	16-bit samples and float, and in parallel over the lines of each level.
+	Laplacian level i is Gaussian level i minus the expansion of Gaussian level i + 1 by 2,
+	so there is one Laplacian level less than Gaussian levels, and the top of the Laplacian
+	pyramid is the top Gaussian level.
+
+	Levels are exposed as read-only frames owned by the pyramid, which stay valid and keep
+	their memory until the pyramid is reset to another dimension. Building a frame of the
+	same dimension again does not allocate memory, and Update() recomputes only the pixels
+	of every level depending on a changed region of the source. Integral samples are
+	rounded to the nearest. */
+	template <typename T>
+	class Pyramid
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef typename ImageFrame<T>::SizeType SizeType;
+		typedef typename PyramidTraits<T>::AccumulatorType AccumulatorType;
+		typedef typename PyramidTraits<T>::LaplacianType LaplacianType;
+
+		//////////////////////////////////////////////////
+		// Default constructors.
+		Pyramid(void);
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Allocates the levels of a pyramid for frames of given dimension.
+
+		@param [in] nLevels	number of Gaussian levels including level 0
+		@exception std::invalid_argument	if nLevels is 0 */
+		Pyramid(const Size2D<SizeType> &sz, SizeType d, SizeType nLevels,
+			bool laplacian = false);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the number of Gaussian levels. */
+		SizeType GetLevelCount(void) const;
+
+		/** Gets a Gaussian level.
+
+		@exception std::out_of_range	if there is no such level */
+		const ImageFrame<T> &GetLevel(SizeType level) const;
+
+		/** Gets a Laplacian level; [0 ~ GetLevelCount() - 1).
+
+		@exception std::logic_error	if the pyramid has no Laplacian levels
+		@exception std::out_of_range	if there is no such level */
+		const ImageFrame<LaplacianType> &GetLaplacian(SizeType level) const;
+
+		bool HasLaplacian(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Builds every level from a source frame or an ROI of it.
+
+		The levels are reset to the dimension of the source if it is changed.
+		@exception std::logic_error	if the pyramid has no levels
+		@exception std::out_of_range	if the ROI is not within the source */
+		void Build(const ImageFrame<T> &img);
+		void Build(const ImageFrame<T> &img, const Region<SizeType, SizeType> &roi);
+
+		/** Rebuilds the levels from a source frame or an ROI of it which is changed only in
+		a region, given relative to the ROI, since the last build.
+
+		@exception std::invalid_argument	if the dimension of the source or the ROI is not
+		the dimension of level 0
+		@exception std::out_of_range	if a region is not within the source or the ROI */
+		void Update(const ImageFrame<T> &img, const Region<SizeType, SizeType> &changed);
+		void Update(const ImageFrame<T> &img, const Region<SizeType, SizeType> &roi,
+			const Region<SizeType, SizeType> &changed);
+
+		/** Allocates the levels for frames of given dimension.
+
+		Existing buffers are reused if the dimension is not changed.
+		@exception std::invalid_argument	if nLevels is 0 */
+		void Reset(const Size2D<SizeType> &sz, SizeType d, SizeType nLevels,
+			bool laplacian = false);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void Propagate(Region<SizeType, SizeType> changed);
+		void Reduce(SizeType level, const Region<SizeType, SizeType> &roi);
+		void Expand(SizeType level, const Region<SizeType, SizeType> &roi);
+
+		/** Runs func(Y, lines, expanded) on the lines [first, last) split into bands, with
+		the buffers of the band. */
+		template <typename F>
+		void ForEachBand(SizeType first, SizeType last, F func);
+
+		//////////////////////////////////////////////////
+		// Data.
+		std::vector<ImageFrame<T>> levels_;
+		std::vector<ImageFrame<LaplacianType>> laplacians_;
+		bool laplacian_;
+
+		/** Line buffers of each band. */
+		std::vector<AccumulatorType> lines_;
+		std::vector<LaplacianType> expanded_;
+		SizeType nBands_;
+	};
+}
+
+#include "pyramid_inl.h"
+
+#endif
@@ -0,0 +1,437 @@
+#if !defined(PYRAMID_INL_H)
+#define PYRAMID_INL_H
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "kernels.h"
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Helper functions.
+
+	/** Index of the pixel i of a line of n pixels reflected about its ends without repeating
+	the edge pixel, as the kernels of kernels.h. */
+	inline ::size_t GetReflectedIndex(::ptrdiff_t i, ::size_t n)
+	{
+		if (n == 1)
+			return 0;
+		const ::ptrdiff_t period = 2 * (static_cast<::ptrdiff_t>(n) - 1);
+		i = (i < 0 ? -i : i) % period;
+		return static_cast<::size_t>(i < static_cast<::ptrdiff_t>(n) ? i : period - i);
+	}
+
+	/** Divides a weighted sum by 2^shift, rounding integral samples to the nearest. */
+	template <typename T, typename A>
+	T NormalizePyramidSum(A sum, int shift, std::true_type)
+	{
+		return static_cast<T>((sum + (static_cast<A>(1) << (shift - 1))) >> shift);
+	}
+
+	template <typename T, typename A>
+	T NormalizePyramidSum(A sum, int shift, std::false_type)
+	{
+		return static_cast<T>(sum / static_cast<A>(1 << shift));
+	}
+
+	template <typename T, typename A>
+	T NormalizePyramidSum(A sum, int shift)
+	{
+		return NormalizePyramidSum<T>(sum, shift, std::is_integral<A>());
+	}
+
+	/** A fixed depth keeps the offsets of the 5 pixels constant for vectorization. */
+	template <typename T, typename A, ::size_t D>
+	void ReducePyramidLine(const A *buffer, ::size_t n, ::size_t depth, T *dst)
+	{
+		const ::size_t d = D == 0 ? depth : D;
+		for (::size_t X = 0; X != n; ++X)
+			for (::size_t C = 0; C != d; ++C)
+			{
+				const A *p = buffer + d * 2 * X + C;
+				dst[d * X + C] = NormalizePyramidSum<T>(p[0] + p[4 * d] +
+					4 * (p[d] + p[3 * d]) + 6 * p[2 * d], 8);
+			}
+	}
+
+	/** Same as reduceLines of kernels.h for any sample type, with the buffer of A. */
+	template <typename T, typename A>
+	void ReducePyramidLines(const void *const *lines, ::size_t width, ::size_t depth,
+		::size_t first, ::size_t last, void *dst, void *buffer)
+	{
+		const T *l[5];
+		for (int I = 0; I != 5; ++I)
+			l[I] = static_cast<const T *>(lines[I]);
+		A *b = static_cast<A *>(buffer);
+		T *d = static_cast<T *>(dst);
+		const ::ptrdiff_t q0 = 2 * static_cast<::ptrdiff_t>(first) - 2;
+		const ::ptrdiff_t q1 = 2 * static_cast<::ptrdiff_t>(last) + 2;
+		const ::ptrdiff_t s0 = std::max<::ptrdiff_t>(q0, 0);
+		const ::ptrdiff_t s1 = std::min(q1, static_cast<::ptrdiff_t>(width));
+		for (::size_t I = depth * s0, L = depth * s1, J = depth * (s0 - q0); I != L;
+			++I, ++J)
+			b[J] = static_cast<A>(l[0][I]) + static_cast<A>(l[4][I]) +
+				4 * (static_cast<A>(l[1][I]) + static_cast<A>(l[3][I])) +
+				6 * static_cast<A>(l[2][I]);
+		for (::ptrdiff_t q = q0; q != q1; ++q)
+			if (q == s0)
+				q = s1 - 1;
+			else
+				std::copy_n(b + depth * (GetReflectedIndex(q, width) - q0), depth,
+					b + depth * (q - q0));
+		switch (depth)
+		{
+		case 1:
+			return ReducePyramidLine<T, A, 1>(b, last - first, depth, d);
+		case 3:
+			return ReducePyramidLine<T, A, 3>(b, last - first, depth, d);
+		case 4:
+			return ReducePyramidLine<T, A, 4>(b, last - first, depth, d);
+		default:
+			return ReducePyramidLine<T, A, 0>(b, last - first, depth, d);
+		}
+	}
+
+	/** Stores the horizontal sums of the expansion of the pixels [first, last) from the
+	vertical sums of the pixels of the next level from i0, by pairs of even and odd pixels.
+	*/
+	template <typename L, ::size_t D>
+	void ExpandPyramidLine(const L *buffer, ::size_t first, ::size_t last, ::ptrdiff_t i0,
+		::size_t depth, L *dst)
+	{
+		const ::size_t d = D == 0 ? depth : D;
+		const L *b = buffer + d * static_cast<::size_t>(static_cast<::ptrdiff_t>(first / 2) -
+			i0);
+		::size_t X = first;
+		if (X % 2 != 0)
+		{
+			for (::size_t C = 0; C != d; ++C)
+				dst[C] = static_cast<L>(4 * (b[C] + b[C + d]));
+			++X;
+			b += d;
+			dst += d;
+		}
+		for (; X + 1 < last; X += 2, b += d, dst += 2 * d)
+			for (::size_t C = 0; C != d; ++C)
+			{
+				dst[C] = static_cast<L>(b[C - d] + b[C + d] + 6 * b[C]);
+				dst[C + d] = static_cast<L>(4 * (b[C] + b[C + d]));
+			}
+		if (X != last)
+			for (::size_t C = 0; C != d; ++C)
+				dst[C] = static_cast<L>(b[C - d] + b[C + d] + 6 * b[C]);
+	}
+
+	/** Gets the range of the lines or the pixels of the next level depending on the range
+	[first, last) of a level, i.e., the outputs reading [2 * x - 2, 2 * x + 2]. Reflected
+	inputs stay in the window of their output. */
+	template <typename T>
+	void GetReducedRange(T first, T last, T n, T &firstDst, T &lastDst)
+	{
+		firstDst = first < 2 ? 0 : (first - 1) / 2;
+		lastDst = std::min(n, (last + 1) / 2 + 1);
+	}
+
+	/** Gets the range of a Laplacian level to be updated for the range [first, last) of its
+	Gaussian level and the range [firstNext, lastNext) of the next level, which is read by
+	the expansion of the pixels [2 * i - 2, 2 * i + 3), including reflected pixels. */
+	template <typename T>
+	void GetExpandedRange(T first, T last, T firstNext, T lastNext, T n, T &firstDst,
+		T &lastDst)
+	{
+		firstDst = std::min(first, firstNext < 1 ? 0 : 2 * firstNext - 2);
+		lastDst = std::min(n, std::max(last, 2 * lastNext + 2));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Pyramid<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Default constructors.
+	template <typename T>
+	Pyramid<T>::Pyramid(void) : laplacian_(false), nBands_(0) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	Pyramid<T>::Pyramid(const Size2D<SizeType> &sz, SizeType d, SizeType nLevels,
+		bool laplacian) : laplacian_(false), nBands_(0)
+	{
+		this->Reset(sz, d, nLevels, laplacian);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	typename Pyramid<T>::SizeType Pyramid<T>::GetLevelCount(void) const
+	{
+		return this->levels_.size();
+	}
+
+	template <typename T>
+	const ImageFrame<T> &Pyramid<T>::GetLevel(SizeType level) const
+	{
+		if (level >= this->levels_.size())
+			throw std::out_of_range("The pyramid has no such level.");
+		return this->levels_[level];
+	}
+
+	template <typename T>
+	const ImageFrame<typename Pyramid<T>::LaplacianType> &Pyramid<T>::GetLaplacian(
+		SizeType level) const
+	{
+		if (!this->laplacian_)
+			throw std::logic_error("The pyramid has no Laplacian levels.");
+		if (level >= this->laplacians_.size())
+			throw std::out_of_range("The pyramid has no such Laplacian level.");
+		return this->laplacians_[level];
+	}
+
+	template <typename T>
+	bool Pyramid<T>::HasLaplacian(void) const
+	{
+		return this->laplacian_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename T>
+	void Pyramid<T>::Build(const ImageFrame<T> &img)
+	{
+		this->Build(img, Region<SizeType, SizeType>(0, 0, img.size.width, img.size.height));
+	}
+
+	template <typename T>
+	void Pyramid<T>::Build(const ImageFrame<T> &img, const Region<SizeType, SizeType> &roi)
+	{
+		if (this->levels_.empty())
+			throw std::logic_error("The pyramid has no levels.");
+		if (roi.size != this->levels_[0].size || img.depth != this->levels_[0].depth)
+			this->Reset(roi.size, img.depth, this->levels_.size(), this->laplacian_);
+		if (roi.GetArea() == 0 || img.depth == 0)
+			return;
+		this->levels_[0].CopyFrom(img, roi, Point2D<SizeType>(0, 0));
+		this->Propagate(Region<SizeType, SizeType>(0, 0, roi.size.width, roi.size.height));
+	}
+
+	template <typename T>
+	void Pyramid<T>::Update(const ImageFrame<T> &img,
+		const Region<SizeType, SizeType> &changed)
+	{
+		this->Update(img, Region<SizeType, SizeType>(0, 0, img.size.width, img.size.height),
+			changed);
+	}
+
+	template <typename T>
+	void Pyramid<T>::Update(const ImageFrame<T> &img, const Region<SizeType, SizeType> &roi,
+		const Region<SizeType, SizeType> &changed)
+	{
+		if (this->levels_.empty() || roi.size != this->levels_[0].size ||
+			img.depth != this->levels_[0].depth)
+			throw std::invalid_argument(
+			"The dimension of the source is not the dimension of the pyramid.");
+		if (changed.origin.x + changed.size.width > roi.size.width ||
+			changed.origin.y + changed.size.height > roi.size.height)
+			throw std::out_of_range("The changed region is not within the ROI.");
+		if (changed.GetArea() == 0 || img.depth == 0)
+			return;
+		this->levels_[0].CopyFrom(img, changed + roi.origin, changed.origin);
+		this->Propagate(changed);
+	}
+
+	/** Every level is allocated at once, so building a frame only writes into them. The
+	line buffers of the bands are sized for the widest reduction and expansion, i.e., from
+	and to level 0. */
+	template <typename T>
+	void Pyramid<T>::Reset(const Size2D<SizeType> &sz, SizeType d, SizeType nLevels,
+		bool laplacian)
+	{
+		if (nLevels == 0)
+			throw std::invalid_argument("A pyramid needs at least one level.");
+		this->levels_.resize(nLevels);
+		Size2D<SizeType> szLevel = sz;
+		for (auto &level : this->levels_)
+		{
+			level.Reset(szLevel, d);
+			szLevel = Size2D<SizeType>((szLevel.width + 1) / 2, (szLevel.height + 1) / 2);
+		}
+
+		this->laplacian_ = laplacian;
+		this->laplacians_.resize(laplacian ? nLevels - 1 : 0);
+		for (SizeType L = 0; L != this->laplacians_.size(); ++L)
+			this->laplacians_[L].Reset(this->levels_[L].size, d);
+
+		const SizeType w = nLevels > 1 ? this->levels_[1].size.width : 0;
+		this->nBands_ = std::max(1u, GetThreadCount());
+		this->lines_.resize(this->nBands_ * (2 * w + 4) * d);
+		this->expanded_.resize(laplacian ? this->nBands_ * (w + 3) * d : 0);
+	}
+
+	/** Each level is reduced from the changed region of the previous level, and the
+	Laplacian of the previous level is updated once both of its Gaussian levels are. */
+	template <typename T>
+	void Pyramid<T>::Propagate(Region<SizeType, SizeType> changed)
+	{
+		IMAGING_SCOPED_TIMER("Pyramid", changed.GetArea() * this->levels_[0].depth *
+			sizeof(T) * (this->laplacian_ ? 3 : 2), changed.GetArea());
+		for (SizeType L = 0; L + 1 < this->levels_.size(); ++L)
+		{
+			const Size2D<SizeType> &sz = this->levels_[L].size;
+			const Size2D<SizeType> &szNext = this->levels_[L + 1].size;
+			Region<SizeType, SizeType> next;
+			SizeType last;
+			GetReducedRange(changed.origin.x, changed.origin.x + changed.size.width,
+				szNext.width, next.origin.x, last);
+			next.size.width = last - next.origin.x;
+			GetReducedRange(changed.origin.y, changed.origin.y + changed.size.height,
+				szNext.height, next.origin.y, last);
+			next.size.height = last - next.origin.y;
+			this->Reduce(L, next);
+
+			if (this->laplacian_)
+			{
+				Region<SizeType, SizeType> roi;
+				GetExpandedRange(changed.origin.x, changed.origin.x + changed.size.width,
+					next.origin.x, next.origin.x + next.size.width, sz.width, roi.origin.x,
+					last);
+				roi.size.width = last - roi.origin.x;
+				GetExpandedRange(changed.origin.y, changed.origin.y + changed.size.height,
+					next.origin.y, next.origin.y + next.size.height, sz.height,
+					roi.origin.y, last);
+				roi.size.height = last - roi.origin.y;
+				this->Expand(L, roi);
+			}
+			changed = next;
+		}
+	}
+
+	/** Each line of the next level reads 5 reflected lines of the level; unsigned 8-bit and
+	16-bit samples and float are reduced by the kernels of kernels.h. */
+	template <typename T>
+	void Pyramid<T>::Reduce(SizeType level, const Region<SizeType, SizeType> &roi)
+	{
+		const ImageFrame<T> &src = this->levels_[level];
+		ImageFrame<T> &dst = this->levels_[level + 1];
+		const SizeType w = src.size.width, h = src.size.height, d = src.depth;
+		const SizeType wDst = dst.size.width;
+		const T *pSrc = src.data.data();
+		T *pDst = dst.GetPointer(0, 0);
+		const int index = GetKernelIndex<T>();
+		const auto reduce = (std::is_unsigned<T>::value && (index == 0 || index == 1)) ||
+			std::is_same<T, float>::value ? GetKernels().reduceLines[index] :
+			ReducePyramidLines<T, AccumulatorType>;
+		const SizeType first = roi.origin.x, last = roi.origin.x + roi.size.width;
+		this->ForEachBand(roi.origin.y, roi.origin.y + roi.size.height,
+			[=](SizeType Y, AccumulatorType *buffer, LaplacianType *)
+		{
+			const void *lines[5];
+			for (int I = 0; I != 5; ++I)
+				lines[I] = pSrc + w * d * GetReflectedIndex(
+				2 * static_cast<::ptrdiff_t>(Y) + I - 2, h);
+			reduce(lines, w, d, first, last, pDst + (wDst * Y + first) * d, buffer);
+		});
+	}
+
+	/** The expansion of the next level is the next level upsampled by inserting zeros and
+	blurred by [1 4 6 4 1] / 8, i.e., [1 6 1] / 8 at even positions and [4 4] / 8 at odd
+	positions. Each line is blurred vertically into the buffer of the band, and then
+	horizontally at each pixel. */
+	template <typename T>
+	void Pyramid<T>::Expand(SizeType level, const Region<SizeType, SizeType> &roi)
+	{
+		typedef LaplacianType L;
+		const ImageFrame<T> &fine = this->levels_[level], &coarse = this->levels_[level + 1];
+		ImageFrame<L> &lap = this->laplacians_[level];
+		const SizeType w = fine.size.width, d = fine.depth;
+		const SizeType wNext = coarse.size.width, hNext = coarse.size.height;
+		const T *pFine = fine.data.data(), *pCoarse = coarse.data.data();
+		L *pLap = lap.GetPointer(0, 0);
+		const SizeType first = roi.origin.x, last = roi.origin.x + roi.size.width;
+
+		// Pixels [i0, i1) of the next level.
+		const ::ptrdiff_t i0 = static_cast<::ptrdiff_t>(first / 2) - 1;
+		const ::ptrdiff_t i1 = static_cast<::ptrdiff_t>(last / 2) + 2;
+		const ::ptrdiff_t s0 = std::max<::ptrdiff_t>(i0, 0);
+		const ::ptrdiff_t s1 = std::min(i1, static_cast<::ptrdiff_t>(wNext));
+		this->ForEachBand(roi.origin.y, roi.origin.y + roi.size.height,
+			[=](SizeType Y, AccumulatorType *, L *buffer)
+		{
+			const ::ptrdiff_t y = static_cast<::ptrdiff_t>(Y / 2);
+			const T *l0 = pCoarse + wNext * d * GetReflectedIndex(y - 1, hNext);
+			const T *l1 = pCoarse + wNext * d * GetReflectedIndex(y, hNext);
+			const T *l2 = pCoarse + wNext * d * GetReflectedIndex(y + 1, hNext);
+			if (Y % 2 == 0)
+				for (::size_t I = d * s0, M = d * s1, J = d * (s0 - i0); I != M; ++I, ++J)
+					buffer[J] = static_cast<L>(static_cast<L>(l0[I]) +
+						static_cast<L>(l2[I]) + 6 * static_cast<L>(l1[I]));
+			else
+				for (::size_t I = d * s0, M = d * s1, J = d * (s0 - i0); I != M; ++I, ++J)
+					buffer[J] = static_cast<L>(4 * (static_cast<L>(l1[I]) +
+						static_cast<L>(l2[I])));
+			for (::ptrdiff_t i = i0; i != i1; ++i)
+				if (i == s0)
+					i = s1 - 1;
+				else
+					std::copy_n(buffer + d * (GetReflectedIndex(i, wNext) - i0), d,
+						buffer + d * (i - i0));
+
+			// The sums are stored into the Laplacian line, and then subtracted from the
+			// line of the level in a contiguous loop.
+			L *dst = pLap + (w * Y + first) * d;
+			switch (d)
+			{
+			case 1:
+				ExpandPyramidLine<L, 1>(buffer, first, last, i0, d, dst);
+				break;
+			case 3:
+				ExpandPyramidLine<L, 3>(buffer, first, last, i0, d, dst);
+				break;
+			case 4:
+				ExpandPyramidLine<L, 4>(buffer, first, last, i0, d, dst);
+				break;
+			default:
+				ExpandPyramidLine<L, 0>(buffer, first, last, i0, d, dst);
+			}
+
+			const T *src = pFine + (w * Y + first) * d;
+			for (SizeType I = 0, n = (last - first) * d; I != n; ++I)
+				dst[I] = static_cast<L>(static_cast<L>(src[I]) -
+					NormalizePyramidSum<L>(dst[I], 6));
+		});
+	}
+
+	/** The lines are split into as many bands as threads, at least 8 lines each, and every
+	band owns its line buffers. The buffers grow if more threads are set after Reset(). */
+	template <typename T>
+	template <typename F>
+	void Pyramid<T>::ForEachBand(SizeType first, SizeType last, F func)
+	{
+		const SizeType nThreads = GetThreadCount();
+		if (nThreads > this->nBands_)
+		{
+			const SizeType nLines = this->lines_.size() / this->nBands_;
+			const SizeType nExpanded = this->expanded_.size() / this->nBands_;
+			this->nBands_ = nThreads;
+			this->lines_.resize(this->nBands_ * nLines);
+			this->expanded_.resize(this->nBands_ * nExpanded);
+		}
+		const SizeType n = last - first;
+		const SizeType nBands = std::min(this->nBands_, (n + 7) / 8);
+		const SizeType nLines = this->lines_.size() / this->nBands_;
+		const SizeType nExpanded = this->expanded_.size() / this->nBands_;
+		AccumulatorType *lines = this->lines_.data();
+		LaplacianType *expanded = this->expanded_.data();
+		ParallelFor(0, nBands, 1, [=](SizeType firstBand, SizeType lastBand)
+		{
+			for (SizeType B = firstBand; B != lastBand; ++B)
+				for (SizeType Y = first + n * B / nBands, L = first + n * (B + 1) / nBands;
+					Y != L; ++Y)
+					func(Y, lines + nLines * B, expanded + nExpanded * B);
+		});
+	}
+}
+
+#endif
@@ -0,0 +1,111 @@
+#if !defined(STATISTICS_H)
+#define STATISTICS_H
+
+#include <vector>
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Per-channel histogram and summary statistics of an ImageFrame<T>.
+
+	Two kinds of bins are supported.
+	Direct bins: one bin per sample value for 8-bit and 16-bit integral types, i.e., 256 or
+	65536 bins. Min, max, mean and standard deviation are derived from the histogram, so
+	the pass over the image only counts samples.
+	Uniform bins: a given number of bins of the same width over [lower, upper) for any
+	type. Samples below or above the range are counted at the first or the last bin, and
+	min, max, sum and sum of squares are accumulated during the same pass. NaN samples are
+	ignored.
+
+	The pass is split into ranges of lines which are processed in parallel. Each range
+	counts into its own partial histogram, and the partial results are merged at the end,
+	so no synchronization is needed per sample. */
+	template <typename T>
+	class Histogram
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef typename ImageFrame<T>::SizeType SizeType;
+
+		//////////////////////////////////////////////////
+		// Default constructors.
+
+		/** Creates a histogram with direct bins, which is available for only 8-bit and
+		16-bit integral types. */
+		Histogram(void);
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Creates a histogram with uniform bins over [lower, upper). */
+		Histogram(double lower, double upper, SizeType nBins);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the number of bins per channel. */
+		SizeType GetBinCount(void) const;
+
+		/** Gets the number of channels of the last computed image. */
+		SizeType GetDepth(void) const;
+
+		/** Gets the number of samples of a bin. */
+		SizeType GetCount(SizeType bin, SizeType c = 0) const;
+
+		/** Gets the counts of all bins of a channel. */
+		const SizeType *GetCounts(SizeType c = 0) const;
+
+		/** Gets the sample value at the lower edge of a bin. */
+		double GetBinValue(SizeType bin) const;
+
+		/** Gets the number of samples counted for a channel. */
+		SizeType GetTotal(SizeType c = 0) const;
+
+		double GetMin(SizeType c = 0) const;
+		double GetMax(SizeType c = 0) const;
+		double GetMean(SizeType c = 0) const;
+
+		/** Gets the (population) standard deviation of a channel. */
+		double GetStdDev(SizeType c = 0) const;
+
+		/** Gets the sample value below which given percentage of samples fall.
+
+		For direct bins, the result is a sample value. For uniform bins, the result is
+		interpolated linearly within the bin.
+		@param [in] p	percentage; [0 ~ 100] */
+		double GetPercentile(double p, SizeType c = 0) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Computes the histogram and statistics of the entire image. */
+		void Compute(const ImageFrame<T> &img);
+
+		/** Computes the histogram and statistics of an ROI of the image. */
+		void Compute(const ImageFrame<T> &img, const Region<SizeType, SizeType> &roi);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void CheckRange(SizeType c) const;
+		void CountDirect(const T *src, SizeType nElemPerLine, SizeType width,
+			SizeType nLines, SizeType *counts) const;
+		void CountUniform(const T *src, SizeType nElemPerLine, SizeType width,
+			SizeType nLines, SizeType *counts, double *minimum, double *maximum,
+			double *sums, double *squares) const;
+
+		//////////////////////////////////////////////////
+		// Data.
+		bool direct_;
+		double lower_, upper_, scale_;
+		SizeType nBins_, depth_;
+		std::vector<SizeType> counts_, totals_;
+		std::vector<double> min_, max_, sums_, squares_;
+	};
+}
+
+#include "statistics_inl.h"
+
+#endif
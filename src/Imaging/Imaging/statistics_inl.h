@@ -0,0 +1,363 @@
+#if !defined(STATISTICS_INL_H)
+#define STATISTICS_INL_H
+
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+#include "kernels.h"
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	/** Stores the minimum or the maximum of each pair of n samples of a and b into dst. A
+	NaN of b is ignored. */
+	typedef void (*ExtremaKernel)(const void *a, const void *b, ::size_t n, void *dst);
+
+	template <typename T>
+	void MinimizeSamples(const void *a, const void *b, ::size_t n, void *dst)
+	{
+		const T *s = static_cast<const T *>(a), *t = static_cast<const T *>(b);
+		T *d = static_cast<T *>(dst);
+		for (::size_t I = 0; I != n; ++I)
+			d[I] = t[I] < s[I] ? t[I] : s[I];
+	}
+
+	template <typename T>
+	void MaximizeSamples(const void *a, const void *b, ::size_t n, void *dst)
+	{
+		const T *s = static_cast<const T *>(a), *t = static_cast<const T *>(b);
+		T *d = static_cast<T *>(dst);
+		for (::size_t I = 0; I != n; ++I)
+			d[I] = s[I] < t[I] ? t[I] : s[I];
+	}
+
+	/** Gets the kernels of kernels.h for unsigned 8-bit and 16-bit samples and float. */
+	template <typename T>
+	void GetExtremaKernels(ExtremaKernel &minimize, ExtremaKernel &maximize)
+	{
+		const int index = GetKernelIndex<T>();
+		const bool kernel = (std::is_unsigned<T>::value && (index == 0 || index == 1)) ||
+			std::is_same<T, float>::value;
+		minimize = kernel ? GetKernels().minSamples[index] : MinimizeSamples<T>;
+		maximize = kernel ? GetKernels().maxSamples[index] : MaximizeSamples<T>;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Histogram<T> class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Default constructors.
+	template <typename T>
+	Histogram<T>::Histogram(void) : direct_(true), depth_(0)
+	{
+		static_assert(std::is_integral<T>::value && sizeof(T) <= 2,
+			"Direct bins are available for only 8-bit and 16-bit integral types.");
+		this->lower_ = static_cast<double>(std::numeric_limits<T>::lowest());
+		this->upper_ = static_cast<double>(std::numeric_limits<T>::max()) + 1.0;
+		this->nBins_ = static_cast<SizeType>(this->upper_ - this->lower_);
+		this->scale_ = 1.0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	template <typename T>
+	Histogram<T>::Histogram(double lower, double upper, SizeType nBins) :
+		direct_(false), lower_(lower), upper_(upper), nBins_(nBins), depth_(0)
+	{
+		if (nBins == 0 || !(upper > lower))
+			throw std::invalid_argument("The range or the number of bins is invalid.");
+		this->scale_ = static_cast<double>(nBins) / (upper - lower);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	template <typename T>
+	typename Histogram<T>::SizeType Histogram<T>::GetBinCount(void) const
+	{
+		return this->nBins_;
+	}
+
+	template <typename T>
+	typename Histogram<T>::SizeType Histogram<T>::GetDepth(void) const
+	{
+		return this->depth_;
+	}
+
+	template <typename T>
+	typename Histogram<T>::SizeType Histogram<T>::GetCount(SizeType bin, SizeType c) const
+	{
+		this->CheckRange(c);
+		if (bin >= this->nBins_)
+		{
+			std::ostringstream errMsg;
+			errMsg << "Bin " << bin << " is out of range.";
+			throw std::out_of_range(errMsg.str());
+		}
+		return this->counts_[this->nBins_ * c + bin];
+	}
+
+	template <typename T>
+	const typename Histogram<T>::SizeType *Histogram<T>::GetCounts(SizeType c) const
+	{
+		this->CheckRange(c);
+		return this->counts_.data() + this->nBins_ * c;
+	}
+
+	template <typename T>
+	double Histogram<T>::GetBinValue(SizeType bin) const
+	{
+		return this->lower_ + static_cast<double>(bin) / this->scale_;
+	}
+
+	template <typename T>
+	typename Histogram<T>::SizeType Histogram<T>::GetTotal(SizeType c) const
+	{
+		this->CheckRange(c);
+		return this->totals_[c];
+	}
+
+	template <typename T>
+	double Histogram<T>::GetMin(SizeType c) const
+	{
+		if (this->GetTotal(c) == 0)
+			throw std::logic_error("No sample has been counted.");
+		return this->min_[c];
+	}
+
+	template <typename T>
+	double Histogram<T>::GetMax(SizeType c) const
+	{
+		if (this->GetTotal(c) == 0)
+			throw std::logic_error("No sample has been counted.");
+		return this->max_[c];
+	}
+
+	template <typename T>
+	double Histogram<T>::GetMean(SizeType c) const
+	{
+		if (this->GetTotal(c) == 0)
+			throw std::logic_error("No sample has been counted.");
+		return this->sums_[c] / static_cast<double>(this->totals_[c]);
+	}
+
+	template <typename T>
+	double Histogram<T>::GetStdDev(SizeType c) const
+	{
+		double mean = this->GetMean(c);
+		double var = this->squares_[c] / static_cast<double>(this->totals_[c]) - mean * mean;
+		return std::sqrt(std::max(var, 0.0));
+	}
+
+	template <typename T>
+	double Histogram<T>::GetPercentile(double p, SizeType c) const
+	{
+		if (p < 0.0 || p > 100.0)
+			throw std::invalid_argument("Percentage must be within [0, 100].");
+		if (this->GetTotal(c) == 0)
+			throw std::logic_error("No sample has been counted.");
+
+		const SizeType *counts = this->GetCounts(c);
+		double target = p / 100.0 * static_cast<double>(this->totals_[c]);
+		double cumulative = 0.0;
+		for (SizeType B = 0; B != this->nBins_; ++B)
+		{
+			if (counts[B] == 0)
+				continue;
+			double next = cumulative + static_cast<double>(counts[B]);
+			if (next >= target)
+			{
+				if (this->direct_)
+					return this->GetBinValue(B);
+				double frac = (target - cumulative) / static_cast<double>(counts[B]);
+				return this->GetBinValue(B) + frac / this->scale_;
+			}
+			cumulative = next;
+		}
+		return this->GetBinValue(this->nBins_);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+
+	template <typename T>
+	void Histogram<T>::CheckRange(SizeType c) const
+	{
+		if (c >= this->depth_)
+		{
+			std::ostringstream errMsg;
+			errMsg << "Channel c = " << c << " is out of range.";
+			throw std::out_of_range(errMsg.str());
+		}
+	}
+
+	template <typename T>
+	void Histogram<T>::Compute(const ImageFrame<T> &img)
+	{
+		this->Compute(img,
+			Region<SizeType, SizeType>(0, 0, img.size.width, img.size.height));
+	}
+
+	/** Each range of lines gets its own partial results, which are merged under a lock
+	once at the end of the range. */
+	template <typename T>
+	void Histogram<T>::Compute(const ImageFrame<T> &img,
+		const Region<SizeType, SizeType> &roi)
+	{
+		const SizeType d = img.depth, nBins = this->nBins_;
+		this->depth_ = d;
+		this->counts_.assign(nBins * d, 0);
+		this->totals_.assign(d, 0);
+		this->min_.assign(d, std::numeric_limits<double>::infinity());
+		this->max_.assign(d, -std::numeric_limits<double>::infinity());
+		this->sums_.assign(d, 0.0);
+		this->squares_.assign(d, 0.0);
+		if (roi.GetArea() == 0 || d == 0)
+			return;
+
+		// Check both corners of the ROI.
+		img.CheckRange(roi.origin.x, roi.origin.y);
+		img.CheckRange(roi.origin.x + roi.size.width - 1, roi.origin.y + roi.size.height - 1);
+
+		const T *src = img.GetPointer(roi.origin.x, roi.origin.y);
+		const SizeType nElemPerLine = d * img.size.width, width = roi.size.width;
+		std::mutex lock;
+		ParallelFor(0, roi.size.height, 64, [&](SizeType first, SizeType last)
+		{
+			std::vector<SizeType> counts(nBins * d, 0);
+			std::vector<double> minimum(d, std::numeric_limits<double>::infinity());
+			std::vector<double> maximum(d, -std::numeric_limits<double>::infinity());
+			std::vector<double> sums(d, 0.0), squares(d, 0.0);
+			if (this->direct_)
+				this->CountDirect(src + nElemPerLine * first, nElemPerLine, width,
+					last - first, counts.data());
+			else
+				this->CountUniform(src + nElemPerLine * first, nElemPerLine, width,
+					last - first, counts.data(), minimum.data(), maximum.data(), sums.data(),
+					squares.data());
+
+			std::lock_guard<std::mutex> guard(lock);
+			for (SizeType I = 0; I != counts.size(); ++I)
+				this->counts_[I] += counts[I];
+			for (SizeType C = 0; C != d; ++C)
+			{
+				this->min_[C] = std::min(this->min_[C], minimum[C]);
+				this->max_[C] = std::max(this->max_[C], maximum[C]);
+				this->sums_[C] += sums[C];
+				this->squares_[C] += squares[C];
+			}
+		});
+
+		for (SizeType C = 0; C != d; ++C)
+		{
+			const SizeType *counts = this->counts_.data() + nBins * C;
+			for (SizeType B = 0; B != nBins; ++B)
+				this->totals_[C] += counts[B];
+		}
+
+		// Derive the statistics from direct bins.
+		if (this->direct_)
+			for (SizeType C = 0; C != d; ++C)
+			{
+				const SizeType *counts = this->counts_.data() + nBins * C;
+				for (SizeType B = 0; B != nBins; ++B)
+				{
+					if (counts[B] == 0)
+						continue;
+					double v = this->GetBinValue(B), n = static_cast<double>(counts[B]);
+					this->min_[C] = std::min(this->min_[C], v);
+					this->max_[C] = std::max(this->max_[C], v);
+					this->sums_[C] += n * v;
+					this->squares_[C] += n * v * v;
+				}
+			}
+	}
+
+	/** Single-channel images take a separate loop, which is the common case of masks and
+	mono sensors.
+	For 8-bit samples, four interleaved sub-histograms are counted and summed at the end.
+	Flat regions hit the same bin repeatedly, and consecutive increments of one counter
+	would otherwise wait for each other through memory. */
+	template <typename T>
+	void Histogram<T>::CountDirect(const T *src, SizeType nElemPerLine, SizeType width,
+		SizeType nLines, SizeType *counts) const
+	{
+		const SizeType d = this->depth_, nBins = this->nBins_;
+		const long long offset = static_cast<long long>(this->lower_);
+		if (d == 1 && sizeof(T) == 1)
+		{
+			std::vector<SizeType> sub(4 * nBins, 0);
+			SizeType *sub0 = sub.data(), *sub1 = sub0 + nBins, *sub2 = sub1 + nBins,
+				*sub3 = sub2 + nBins;
+			for (SizeType Y = 0; Y != nLines; ++Y, src += nElemPerLine)
+			{
+				SizeType X = 0;
+				for (; X + 4 <= width; X += 4)
+				{
+					++sub0[static_cast<SizeType>(static_cast<long long>(src[X]) - offset)];
+					++sub1[static_cast<SizeType>(static_cast<long long>(src[X + 1]) - offset)];
+					++sub2[static_cast<SizeType>(static_cast<long long>(src[X + 2]) - offset)];
+					++sub3[static_cast<SizeType>(static_cast<long long>(src[X + 3]) - offset)];
+				}
+				for (; X != width; ++X)
+					++sub0[static_cast<SizeType>(static_cast<long long>(src[X]) - offset)];
+			}
+			for (SizeType B = 0; B != nBins; ++B)
+				counts[B] += sub0[B] + sub1[B] + sub2[B] + sub3[B];
+		}
+		else
+			for (SizeType Y = 0; Y != nLines; ++Y, src += nElemPerLine)
+			{
+				if (d == 1)
+					for (SizeType X = 0; X != width; ++X)
+						++counts[static_cast<SizeType>(static_cast<long long>(src[X]) - offset)];
+				else
+					for (SizeType X = 0; X != width; ++X)
+						for (SizeType C = 0; C != d; ++C)
+							++counts[nBins * C + static_cast<SizeType>(
+								static_cast<long long>(src[d * X + C]) - offset)];
+			}
+	}
+
+	/** The minimum and the maximum are kept per element of a line by the kernels of
+	kernels.h, which are vectorized, and reduced to the channels once at the end. */
+	template <typename T>
+	void Histogram<T>::CountUniform(const T *src, SizeType nElemPerLine, SizeType width,
+		SizeType nLines, SizeType *counts, double *minimum, double *maximum, double *sums,
+		double *squares) const
+	{
+		const SizeType d = this->depth_, nBins = this->nBins_, n = d * width;
+		const double last = static_cast<double>(nBins - 1);
+		ExtremaKernel minimize, maximize;
+		GetExtremaKernels<T>(minimize, maximize);
+		std::vector<T> low(n, std::numeric_limits<T>::has_infinity ?
+			std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max());
+		std::vector<T> high(n, std::numeric_limits<T>::has_infinity ?
+			-std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest());
+		for (SizeType Y = 0; Y != nLines; ++Y, src += nElemPerLine)
+		{
+			minimize(low.data(), src, n, low.data());
+			maximize(high.data(), src, n, high.data());
+			for (SizeType X = 0; X != width; ++X)
+				for (SizeType C = 0; C != d; ++C)
+				{
+					double v = static_cast<double>(src[d * X + C]);
+					if (v != v)
+						continue;	// NaN
+					double f = (v - this->lower_) * this->scale_;
+					f = f < 0.0 ? 0.0 : (f > last ? last : f);
+					++counts[nBins * C + static_cast<SizeType>(f)];
+					sums[C] += v;
+					squares[C] += v * v;
+				}
+		}
+		for (SizeType I = 0; I != n; ++I)
+		{
+			minimum[I % d] = std::min(minimum[I % d], static_cast<double>(low[I]));
+			maximum[I % d] = std::max(maximum[I % d], static_cast<double>(high[I]));
+		}
+	}
+}
+
+#endif
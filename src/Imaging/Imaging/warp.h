@@ -0,0 +1,141 @@
+#if !defined(WARP_H)
+#define WARP_H
+
+#include <array>
+#include <vector>
+
+#include "image.h"
+
+namespace Imaging
+{
+	/** Source position of every destination pixel in an ROI of a destination image, for
+	Remap().
+
+	Positions are kept in fixed point with fractionBits bits below the pixel, so a table of
+	a fixed camera calibration, e.g., for lens undistortion, is built once and reused for
+	every frame. Integral positions are the centers of the pixels. */
+	class RemapTable
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		typedef ::size_t SizeType;
+
+		/** Number of bits below a pixel of the source positions. */
+		static const int fractionBits = 8;
+
+		//////////////////////////////////////////////////
+		// Default constructors.
+		RemapTable(void);
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Creates a table for every pixel of a destination of given size, where every
+		pixel maps to source position (0, 0). */
+		RemapTable(const Size2D<SizeType> &szDst);
+
+		/** Creates a table for the pixels of an ROI of a destination of given size.
+
+		@exception std::out_of_range	if the ROI is not within the destination */
+		RemapTable(const Size2D<SizeType> &szDst, const Region<SizeType, SizeType> &roiDst);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the size of the destination. */
+		const Size2D<SizeType> &GetSize(void) const;
+
+		/** Gets the ROI of the destination covered by the table. */
+		const Region<SizeType, SizeType> &GetRegion(void) const;
+
+		/** Gets the source position of a destination pixel in the ROI. */
+		Point2D<double> GetPosition(SizeType x, SizeType y) const;
+
+		/** Gets the fixed-point positions (x, y) of the pixels of the ROI on a line. */
+		const int *GetLine(SizeType y) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Sets the source position of every pixel (x, y) of the ROI as
+		Point2D<double> func(x, y), which is called in parallel. */
+		template <typename F>
+		void Fill(F func);
+
+		/** Sets the positions of an affine transform of source to destination,
+		(x', y') = (m[0] x + m[1] y + m[2], m[3] x + m[4] y + m[5]).
+
+		@exception std::invalid_argument	if the transform is not invertible */
+		void SetAffine(const std::array<double, 6> &m);
+
+		/** Sets the positions of a perspective transform of source to destination,
+		(x', y') = ((m[0] x + m[1] y + m[2]) / w, (m[3] x + m[4] y + m[5]) / w) where
+		w = m[6] x + m[7] y + m[8].
+
+		@exception std::invalid_argument	if the transform is not invertible */
+		void SetPerspective(const std::array<double, 9> &m);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Data.
+		Size2D<SizeType> size_;
+		Region<SizeType, SizeType> roi_;
+		std::vector<int> positions_;
+	};
+
+	/** Gets the inverse of an affine transform of 2 x 3 elements.
+
+	@exception std::invalid_argument	if the transform is not invertible */
+	inline std::array<double, 6> GetInverseAffine(const std::array<double, 6> &m);
+
+	/** Gets the inverse of a perspective transform of 3 x 3 elements.
+
+	@exception std::invalid_argument	if the transform is not invertible */
+	inline std::array<double, 9> GetInversePerspective(const std::array<double, 9> &m);
+
+	/** Samples a source image at the positions of a remap table into the ROI of the table
+	in a destination image.
+
+	Samples outside of the source are border. Pixels of the destination outside of the ROI
+	are kept, unless the destination is reset because its size or depth does not match.
+	Source and destination must be different images. */
+	template <typename T>
+	void Remap(const ImageFrame<T> &imgSrc, const RemapTable &table, ImageFrame<T> &imgDst,
+		Interpolation interp = Interpolation::LINEAR, T border = T());
+
+	/** Transforms a source image by an affine transform of source to destination, i.e.,
+	each destination pixel is sampled at the inverse transform of its position.
+
+	The destination is reset to given size. */
+	template <typename T>
+	void WarpAffine(const ImageFrame<T> &imgSrc, const std::array<double, 6> &m,
+		const Size2D<::size_t> &szDst, ImageFrame<T> &imgDst,
+		Interpolation interp = Interpolation::LINEAR, T border = T());
+
+	/** Transforms a source image by an affine transform into only an ROI of a destination
+	image of given size, keeping the other pixels as Remap(). */
+	template <typename T>
+	void WarpAffine(const ImageFrame<T> &imgSrc, const std::array<double, 6> &m,
+		const Size2D<::size_t> &szDst, const Region<::size_t, ::size_t> &roiDst,
+		ImageFrame<T> &imgDst, Interpolation interp = Interpolation::LINEAR, T border = T());
+
+	/** Transforms a source image by a perspective transform of source to destination.
+
+	The destination is reset to given size. */
+	template <typename T>
+	void WarpPerspective(const ImageFrame<T> &imgSrc, const std::array<double, 9> &m,
+		const Size2D<::size_t> &szDst, ImageFrame<T> &imgDst,
+		Interpolation interp = Interpolation::LINEAR, T border = T());
+
+	/** Transforms a source image by a perspective transform into only an ROI of a
+	destination image of given size, keeping the other pixels as Remap(). */
+	template <typename T>
+	void WarpPerspective(const ImageFrame<T> &imgSrc, const std::array<double, 9> &m,
+		const Size2D<::size_t> &szDst, const Region<::size_t, ::size_t> &roiDst,
+		ImageFrame<T> &imgDst, Interpolation interp = Interpolation::LINEAR, T border = T());
+}
+
+#include "warp_inl.h"
+
+#endif
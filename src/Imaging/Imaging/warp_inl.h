@@ -0,0 +1,578 @@
+#if !defined(WARP_INL_H)
+#define WARP_INL_H
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "image_expression.h"
+#include "../Utilities/parallel.h"
+
+namespace Imaging
+{
+	/** Destination pixels of a tile processed by a thread of the warps. A tile covers a
+	compact area of the source even under rotation, which stays in cache. */
+	const ::size_t warpTileWidth = 256, warpTileHeight = 16;
+
+	/** Converts a source position into fixed point of RemapTable. Positions far outside of
+	any source, including NaN, are limited so that they still fit in int. */
+	inline int ToRemapPosition(double v)
+	{
+		const double limit = static_cast<double>(1 << 22);
+		if (!(v > -limit))
+			v = -limit;
+		else if (v > limit)
+			v = limit;
+		// Truncation of the positive sum is the floor.
+		const double offset = 2147483648.0;
+		return static_cast<int>(static_cast<long long>(v * (1 << RemapTable::fractionBits) +
+			(0.5 + offset)) - static_cast<long long>(offset));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// RemapTable class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Default constructors.
+	inline RemapTable::RemapTable(void) : size_(0, 0), roi_(0, 0, 0, 0) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	inline RemapTable::RemapTable(const Size2D<SizeType> &szDst) :
+		RemapTable(szDst, Region<SizeType, SizeType>(0, 0, szDst.width, szDst.height)) {}
+
+	inline RemapTable::RemapTable(const Size2D<SizeType> &szDst,
+		const Region<SizeType, SizeType> &roiDst) : size_(szDst), roi_(roiDst)
+	{
+		if (roiDst.origin.x + roiDst.size.width > szDst.width ||
+			roiDst.origin.y + roiDst.size.height > szDst.height)
+			throw std::out_of_range("The ROI is out of the destination.");
+		this->positions_.resize(2 * roiDst.size.width * roiDst.size.height);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline const Size2D<RemapTable::SizeType> &RemapTable::GetSize(void) const
+	{
+		return this->size_;
+	}
+
+	inline const Region<RemapTable::SizeType, RemapTable::SizeType> &RemapTable::GetRegion(
+		void) const
+	{
+		return this->roi_;
+	}
+
+	inline Point2D<double> RemapTable::GetPosition(SizeType x, SizeType y) const
+	{
+		if (x < this->roi_.origin.x || x >= this->roi_.origin.x + this->roi_.size.width)
+			throw std::out_of_range("The position is out of the ROI.");
+		const int *p = this->GetLine(y) + 2 * (x - this->roi_.origin.x);
+		const double scale = 1.0 / (1 << fractionBits);
+		return Point2D<double>(p[0] * scale, p[1] * scale);
+	}
+
+	inline const int *RemapTable::GetLine(SizeType y) const
+	{
+		if (y < this->roi_.origin.y || y >= this->roi_.origin.y + this->roi_.size.height)
+			throw std::out_of_range("The line is out of the ROI.");
+		return this->positions_.data() +
+			2 * this->roi_.size.width * (y - this->roi_.origin.y);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	template <typename F>
+	void RemapTable::Fill(F func)
+	{
+		const Region<SizeType, SizeType> roi = this->roi_;
+		int *positions = this->positions_.data();
+		ParallelFor(0, roi.size.height, 16, [&](::size_t first, ::size_t last)
+		{
+			for (::size_t Y = first; Y != last; ++Y)
+			{
+				int *p = positions + 2 * roi.size.width * Y;
+				for (::size_t X = 0; X != roi.size.width; ++X, p += 2)
+				{
+					const Point2D<double> pos = func(roi.origin.x + X, roi.origin.y + Y);
+					p[0] = ToRemapPosition(pos.x);
+					p[1] = ToRemapPosition(pos.y);
+				}
+			}
+		});
+	}
+
+	inline void RemapTable::SetAffine(const std::array<double, 6> &m)
+	{
+		const std::array<double, 6> a = GetInverseAffine(m);
+		this->Fill([&a](::size_t x, ::size_t y)
+		{
+			return Point2D<double>(a[0] * x + a[1] * y + a[2], a[3] * x + a[4] * y + a[5]);
+		});
+	}
+
+	inline void RemapTable::SetPerspective(const std::array<double, 9> &m)
+	{
+		const std::array<double, 9> a = GetInversePerspective(m);
+		this->Fill([&a](::size_t x, ::size_t y)
+		{
+			const double w = 1.0 / (a[6] * x + a[7] * y + a[8]);
+			return Point2D<double>((a[0] * x + a[1] * y + a[2]) * w,
+				(a[3] * x + a[4] * y + a[5]) * w);
+		});
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Transforms.
+
+	inline std::array<double, 6> GetInverseAffine(const std::array<double, 6> &m)
+	{
+		const double det = m[0] * m[4] - m[1] * m[3];
+		if (det == 0.0 || !std::isfinite(det))
+			throw std::invalid_argument("The affine transform is not invertible.");
+		std::array<double, 6> a;
+		a[0] = m[4] / det;
+		a[1] = -m[1] / det;
+		a[3] = -m[3] / det;
+		a[4] = m[0] / det;
+		a[2] = -(a[0] * m[2] + a[1] * m[5]);
+		a[5] = -(a[3] * m[2] + a[4] * m[5]);
+		return a;
+	}
+
+	/** The inverse is the adjugate divided by the determinant. */
+	inline std::array<double, 9> GetInversePerspective(const std::array<double, 9> &m)
+	{
+		std::array<double, 9> a;
+		a[0] = m[4] * m[8] - m[5] * m[7];
+		a[1] = m[2] * m[7] - m[1] * m[8];
+		a[2] = m[1] * m[5] - m[2] * m[4];
+		a[3] = m[5] * m[6] - m[3] * m[8];
+		a[4] = m[0] * m[8] - m[2] * m[6];
+		a[5] = m[2] * m[3] - m[0] * m[5];
+		a[6] = m[3] * m[7] - m[4] * m[6];
+		a[7] = m[1] * m[6] - m[0] * m[7];
+		a[8] = m[0] * m[4] - m[1] * m[3];
+		const double det = m[0] * a[0] + m[1] * a[3] + m[2] * a[6];
+		if (det == 0.0 || !std::isfinite(det))
+			throw std::invalid_argument("The perspective transform is not invertible.");
+		for (auto &v : a)
+			v /= det;
+		return a;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Sampling of a line.
+
+	/** Weights of K taps for every fraction of a pixel of RemapTable. */
+	template <int K, typename F>
+	std::vector<float> GetInterpolationWeights(F func)
+	{
+		const int nSteps = 1 << RemapTable::fractionBits;
+		std::vector<float> weights(K * nSteps);
+		for (int I = 0; I != nSteps; ++I)
+		{
+			const double t = static_cast<double>(I) / nSteps;
+			double w[K], sum = 0.0;
+			for (int k = 0; k != K; ++k)
+				sum += w[k] = func(t + K / 2 - 1 - k);
+			for (int k = 0; k != K; ++k)
+				weights[K * I + k] = static_cast<float>(w[k] / sum);
+		}
+		return weights;
+	}
+
+	/** Bicubic weights of a = -0.75 for 4 taps from the pixel before the position. */
+	inline const float *GetCubicWeights(void)
+	{
+		static const std::vector<float> weights = GetInterpolationWeights<4>([](double x)
+		{
+			const double a = -0.75;
+			x = std::abs(x);
+			return x <= 1.0 ? ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0 :
+				x < 2.0 ? ((a * x - 5.0 * a) * x + 8.0 * a) * x - 4.0 * a : 0.0;
+		});
+		return weights.data();
+	}
+
+	/** Lanczos weights of a = 4 for 8 taps from the 3rd pixel before the position. */
+	inline const float *GetLanczosWeights(void)
+	{
+		static const std::vector<float> weights = GetInterpolationWeights<8>([](double x)
+		{
+			const double pi = 3.14159265358979323846;
+			if (std::abs(x) < 1e-9)
+				return 1.0;
+			return x <= -4.0 || x >= 4.0 ? 0.0 :
+				4.0 * std::sin(pi * x) * std::sin(pi * x / 4.0) / (pi * pi * x * x);
+		});
+		return weights.data();
+	}
+
+	/** Source of a line, where samples outside are border. */
+	template <typename T>
+	class RemapSource
+	{
+	public:
+		T Get(long long x, long long y, ::size_t c) const
+		{
+			return x >= 0 && y >= 0 && x < this->width && y < this->height ?
+				this->data[(this->width * y + x) * this->depth + c] : this->border;
+		}
+
+		const T *data;
+		long long width, height;
+		::size_t depth;
+		T border;
+	};
+
+	/** Depth is a constant D, or the depth of the source if D is 0. */
+	template <typename T, ::size_t D>
+	void RemapNearest(const RemapSource<T> &src, const int *pos, ::size_t n, T *dst)
+	{
+		const ::size_t d = D != 0 ? D : src.depth;
+		const int bits = RemapTable::fractionBits, half = 1 << (bits - 1);
+		for (::size_t P = 0; P != n; ++P, pos += 2, dst += d)
+		{
+			const int x = (pos[0] + half) >> bits, y = (pos[1] + half) >> bits;
+			if (x >= 0 && y >= 0 && x < src.width && y < src.height)
+			{
+				const T *s = src.data + (src.width * y + x) * d;
+				for (::size_t C = 0; C != d; ++C)
+					dst[C] = s[C];
+			}
+			else
+				for (::size_t C = 0; C != d; ++C)
+					dst[C] = src.border;
+		}
+	}
+
+	/** Interpolates the 4 pixels from s, where the bottom line is stride samples apart. */
+	template <typename T, ::size_t D>
+	void InterpolateLinearFixed(const T *s, ::size_t d, ::size_t stride, unsigned fx,
+		unsigned fy, T *dst)
+	{
+		const int bits = RemapTable::fractionBits;
+		const unsigned one = 1u << bits, round = 1u << (2 * bits - 1);
+		for (::size_t C = 0; C != (D != 0 ? D : d); ++C)
+		{
+			const unsigned top = s[C] * (one - fx) + s[C + d] * fx;
+			const unsigned bottom = s[C + stride] * (one - fx) + s[C + stride + d] * fx;
+			dst[C] = static_cast<T>((top * (one - fy) + bottom * fy + round) >> (2 * bits));
+		}
+	}
+
+	/** 8-bit and 16-bit unsigned samples are interpolated in 32-bit fixed point, where the
+	weights are the fractions of RemapTable. 65535 x 256 x 256 does not overflow.
+
+	Pixels are processed in chunks; the offsets and weights of a chunk are computed first
+	without branches, so the compiler vectorizes them and the loads of the samples do not
+	wait for branches. Pixels whose taps are not all inside are redone with the border. */
+	template <typename T, ::size_t D>
+	void RemapLinear(const RemapSource<T> &src, const int *pos, ::size_t n, T *dst,
+		std::true_type)
+	{
+		const ::size_t d = D != 0 ? D : src.depth;
+		const int bits = RemapTable::fractionBits;
+		const unsigned one = 1u << bits, mask = one - 1, round = 1u << (2 * bits - 1);
+		const ::size_t stride = static_cast<::size_t>(src.width) * d, chunkSize = 64;
+		const bool hasInside = src.width > 1 && src.height > 1;
+		const int xLast = static_cast<int>(std::min<long long>(src.width - 1, INT_MAX));
+		const int yLast = static_cast<int>(std::min<long long>(src.height - 1, INT_MAX));
+		::size_t offsets[chunkSize];
+		unsigned wx[chunkSize], wy[chunkSize];
+		for (::size_t first = 0; first < n; first += chunkSize)
+		{
+			const ::size_t m = std::min(chunkSize, n - first);
+			const int *p = pos + 2 * first;
+			T *line = dst + d * first;
+			bool outside = !hasInside;
+			for (::size_t I = 0; I != m; ++I)
+			{
+				const int x = p[2 * I] >> bits, y = p[2 * I + 1] >> bits;
+				const bool inside = x >= 0 && y >= 0 && x < xLast && y < yLast;
+				outside |= !inside;
+				offsets[I] = inside ? stride * y + d * x : 0;
+				wx[I] = static_cast<unsigned>(p[2 * I]) & mask;
+				wy[I] = static_cast<unsigned>(p[2 * I + 1]) & mask;
+			}
+			if (hasInside)
+				for (::size_t I = 0; I != m; ++I)
+					InterpolateLinearFixed<T, D>(src.data + offsets[I], d, stride, wx[I],
+						wy[I], line + d * I);
+			if (!outside)
+				continue;
+			for (::size_t I = 0; I != m; ++I)
+			{
+				const int x = p[2 * I] >> bits, y = p[2 * I + 1] >> bits;
+				if (x >= 0 && y >= 0 && x + 1 < src.width && y + 1 < src.height)
+					continue;
+				for (::size_t C = 0; C != d; ++C)
+				{
+					const unsigned top = src.Get(x, y, C) * (one - wx[I]) +
+						src.Get(x + 1, y, C) * wx[I];
+					const unsigned bottom = src.Get(x, y + 1, C) * (one - wx[I]) +
+						src.Get(x + 1, y + 1, C) * wx[I];
+					line[d * I + C] = static_cast<T>((top * (one - wy[I]) + bottom * wy[I] +
+						round) >> (2 * bits));
+				}
+			}
+		}
+	}
+
+	/** Other types are interpolated in float, or in double for double and 32-bit or
+	larger integers. */
+	template <typename T, ::size_t D>
+	void RemapLinear(const RemapSource<T> &src, const int *pos, ::size_t n, T *dst,
+		std::false_type)
+	{
+		typedef typename std::conditional<std::is_same<T, float>::value ||
+			(std::is_integral<T>::value && sizeof(T) <= 2), float, double>::type W;
+		const ::size_t d = D != 0 ? D : src.depth;
+		const int bits = RemapTable::fractionBits, mask = (1 << bits) - 1;
+		const W scale = W(1) / (1 << bits);
+		for (::size_t P = 0; P != n; ++P, pos += 2, dst += d)
+		{
+			const int x = pos[0] >> bits, y = pos[1] >> bits;
+			const W fx = (pos[0] & mask) * scale, fy = (pos[1] & mask) * scale;
+			for (::size_t C = 0; C != d; ++C)
+			{
+				const W top = src.Get(x, y, C) * (1 - fx) + src.Get(x + 1, y, C) * fx;
+				const W bottom = src.Get(x, y + 1, C) * (1 - fx) +
+					src.Get(x + 1, y + 1, C) * fx;
+				dst[C] = SaturateSample<T>(top * (1 - fy) + bottom * fy);
+			}
+		}
+	}
+
+	/** Interpolates K x K pixels by weights of every fraction of a pixel. Every channel of
+	a tap is accumulated together for a constant depth D inside of the source. */
+	template <typename T, int K, ::size_t D>
+	void RemapSeparable(const RemapSource<T> &src, const int *pos, ::size_t n, T *dst,
+		const float *weights)
+	{
+		typedef typename std::conditional<std::is_same<T, double>::value ||
+			(std::is_integral<T>::value && sizeof(T) > 2), double, float>::type W;
+		const ::size_t d = D != 0 ? D : src.depth, nSums = D != 0 ? D : 1;
+		const int bits = RemapTable::fractionBits, mask = (1 << bits) - 1;
+		for (::size_t P = 0; P != n; ++P, pos += 2, dst += d)
+		{
+			const int x0 = (pos[0] >> bits) - (K / 2 - 1);
+			const int y0 = (pos[1] >> bits) - (K / 2 - 1);
+			const float *wx = weights + K * (pos[0] & mask);
+			const float *wy = weights + K * (pos[1] & mask);
+			if (D != 0 && x0 >= 0 && y0 >= 0 && x0 + K <= src.width && y0 + K <= src.height)
+			{
+				W sum[nSums] = {};
+				const T *s = src.data + (src.width * y0 + x0) * d;
+				for (int ky = 0; ky != K; ++ky, s += src.width * d)
+				{
+					W line[nSums] = {};
+					for (int kx = 0; kx != K; ++kx)
+						for (::size_t C = 0; C != nSums; ++C)
+							line[C] += wx[kx] * static_cast<W>(s[d * kx + C]);
+					for (::size_t C = 0; C != nSums; ++C)
+						sum[C] += wy[ky] * line[C];
+				}
+				for (::size_t C = 0; C != nSums; ++C)
+					dst[C] = SaturateSample<T>(sum[C]);
+			}
+			else
+				for (::size_t C = 0; C != d; ++C)
+				{
+					W sum = 0;
+					for (int ky = 0; ky != K; ++ky)
+					{
+						W line = 0;
+						for (int kx = 0; kx != K; ++kx)
+							line += wx[kx] * static_cast<W>(src.Get(x0 + kx, y0 + ky, C));
+						sum += wy[ky] * line;
+					}
+					dst[C] = SaturateSample<T>(sum);
+				}
+		}
+	}
+
+	/** Samples the positions of n pixels into a line of destination, where the depth is a
+	constant D, or the depth of the source if D is 0. */
+	template <::size_t D, typename T>
+	void RemapLine(const RemapSource<T> &src, const int *pos, ::size_t n, T *dst,
+		Interpolation interp)
+	{
+		typedef std::integral_constant<bool, std::is_integral<T>::value &&
+			std::is_unsigned<T>::value && sizeof(T) <= 2> Fixed;
+		switch (interp)
+		{
+		case Interpolation::NEAREST:
+			return RemapNearest<T, D>(src, pos, n, dst);
+		case Interpolation::CUBIC:
+			return RemapSeparable<T, 4, D>(src, pos, n, dst, GetCubicWeights());
+		case Interpolation::LANCZO:
+			return RemapSeparable<T, 8, D>(src, pos, n, dst, GetLanczosWeights());
+		default:
+			return RemapLinear<T, D>(src, pos, n, dst, Fixed());
+		}
+	}
+
+	template <typename T>
+	void RemapLine(const RemapSource<T> &src, const int *pos, ::size_t n, T *dst,
+		Interpolation interp)
+	{
+		switch (src.depth)
+		{
+		case 1:
+			return RemapLine<1>(src, pos, n, dst, interp);
+		case 3:
+			return RemapLine<3>(src, pos, n, dst, interp);
+		case 4:
+			return RemapLine<4>(src, pos, n, dst, interp);
+		default:
+			return RemapLine<0>(src, pos, n, dst, interp);
+		}
+	}
+
+	/** Calls func(roiTile) for the tiles of an ROI in parallel. */
+	template <typename F>
+	void ForEachWarpTile(const Region<::size_t, ::size_t> &roi, F func)
+	{
+		const ::size_t nx = (roi.size.width + warpTileWidth - 1) / warpTileWidth;
+		const ::size_t ny = (roi.size.height + warpTileHeight - 1) / warpTileHeight;
+		ParallelFor(0, nx * ny, 1, [&](::size_t first, ::size_t last)
+		{
+			for (::size_t I = first; I != last; ++I)
+			{
+				const ::size_t x = roi.origin.x + warpTileWidth * (I % nx);
+				const ::size_t y = roi.origin.y + warpTileHeight * (I / nx);
+				func(Region<::size_t, ::size_t>(x, y,
+					std::min(warpTileWidth, roi.origin.x + roi.size.width - x),
+					std::min(warpTileHeight, roi.origin.y + roi.size.height - y)));
+			}
+		});
+	}
+
+	/** Prepares the destination of a warp and gets the source of its lines. */
+	template <typename T>
+	RemapSource<T> PrepareRemap(const ImageFrame<T> &imgSrc, const Size2D<::size_t> &szDst,
+		const Region<::size_t, ::size_t> &roiDst, ImageFrame<T> &imgDst, T border)
+	{
+		if (&imgSrc == &imgDst)
+			throw std::invalid_argument("Source and destination must be different images.");
+		if (roiDst.origin.x + roiDst.size.width > szDst.width ||
+			roiDst.origin.y + roiDst.size.height > szDst.height)
+			throw std::out_of_range("The ROI is out of the destination.");
+		if (imgDst.size != szDst || imgDst.depth != imgSrc.depth)
+			imgDst.Reset(szDst, imgSrc.depth);
+
+		RemapSource<T> src;
+		src.data = imgSrc.data.data();
+		src.width = static_cast<long long>(imgSrc.size.width);
+		src.height = static_cast<long long>(imgSrc.size.height);
+		src.depth = imgSrc.depth;
+		src.border = border;
+		return src;
+	}
+
+	/** Samples the source at Point2D<double> func(x, y) of every destination pixel of an
+	ROI, computing the positions of a line of a tile at a time. */
+	template <typename T, typename F>
+	void WarpByFunction(const ImageFrame<T> &imgSrc, const Size2D<::size_t> &szDst,
+		const Region<::size_t, ::size_t> &roiDst, ImageFrame<T> &imgDst,
+		Interpolation interp, T border, F func)
+	{
+		const RemapSource<T> src = PrepareRemap(imgSrc, szDst, roiDst, imgDst, border);
+		if (src.depth == 0)
+			return;
+		ForEachWarpTile(roiDst, [&](const Region<::size_t, ::size_t> &tile)
+		{
+			int pos[2 * warpTileWidth];
+			for (::size_t Y = tile.origin.y; Y != tile.origin.y + tile.size.height; ++Y)
+			{
+				for (::size_t X = 0; X != tile.size.width; ++X)
+				{
+					const Point2D<double> p = func(tile.origin.x + X, Y);
+					pos[2 * X] = ToRemapPosition(p.x);
+					pos[2 * X + 1] = ToRemapPosition(p.y);
+				}
+				RemapLine(src, pos, tile.size.width, imgDst.GetPointer(tile.origin.x, Y),
+					interp);
+			}
+		});
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Remap and warps.
+
+	template <typename T>
+	void Remap(const ImageFrame<T> &imgSrc, const RemapTable &table, ImageFrame<T> &imgDst,
+		Interpolation interp, T border)
+	{
+		const Region<::size_t, ::size_t> &roi = table.GetRegion();
+		IMAGING_SCOPED_TIMER("Remap", 2 * roi.size.width * roi.size.height * imgSrc.depth *
+			sizeof(T), roi.size.width * roi.size.height);
+		const RemapSource<T> src = PrepareRemap(imgSrc, table.GetSize(), roi, imgDst,
+			border);
+		if (src.depth == 0)
+			return;
+		ForEachWarpTile(roi, [&](const Region<::size_t, ::size_t> &tile)
+		{
+			for (::size_t Y = tile.origin.y; Y != tile.origin.y + tile.size.height; ++Y)
+				RemapLine(src, table.GetLine(Y) + 2 * (tile.origin.x - roi.origin.x),
+					tile.size.width, imgDst.GetPointer(tile.origin.x, Y), interp);
+		});
+	}
+
+	template <typename T>
+	void WarpAffine(const ImageFrame<T> &imgSrc, const std::array<double, 6> &m,
+		const Size2D<::size_t> &szDst, ImageFrame<T> &imgDst, Interpolation interp,
+		T border)
+	{
+		WarpAffine(imgSrc, m, szDst, Region<::size_t, ::size_t>(0, 0, szDst.width,
+			szDst.height), imgDst, interp, border);
+	}
+
+	template <typename T>
+	void WarpAffine(const ImageFrame<T> &imgSrc, const std::array<double, 6> &m,
+		const Size2D<::size_t> &szDst, const Region<::size_t, ::size_t> &roiDst,
+		ImageFrame<T> &imgDst, Interpolation interp, T border)
+	{
+		IMAGING_SCOPED_TIMER("WarpAffine", 2 * roiDst.size.width * roiDst.size.height *
+			imgSrc.depth * sizeof(T), roiDst.size.width * roiDst.size.height);
+		const std::array<double, 6> a = GetInverseAffine(m);
+		WarpByFunction(imgSrc, szDst, roiDst, imgDst, interp, border,
+			[&a](::size_t x, ::size_t y)
+		{
+			return Point2D<double>(a[0] * x + a[1] * y + a[2], a[3] * x + a[4] * y + a[5]);
+		});
+	}
+
+	template <typename T>
+	void WarpPerspective(const ImageFrame<T> &imgSrc, const std::array<double, 9> &m,
+		const Size2D<::size_t> &szDst, ImageFrame<T> &imgDst, Interpolation interp,
+		T border)
+	{
+		WarpPerspective(imgSrc, m, szDst, Region<::size_t, ::size_t>(0, 0, szDst.width,
+			szDst.height), imgDst, interp, border);
+	}
+
+	template <typename T>
+	void WarpPerspective(const ImageFrame<T> &imgSrc, const std::array<double, 9> &m,
+		const Size2D<::size_t> &szDst, const Region<::size_t, ::size_t> &roiDst,
+		ImageFrame<T> &imgDst, Interpolation interp, T border)
+	{
+		IMAGING_SCOPED_TIMER("WarpPerspective", 2 * roiDst.size.width * roiDst.size.height *
+			imgSrc.depth * sizeof(T), roiDst.size.width * roiDst.size.height);
+		const std::array<double, 9> a = GetInversePerspective(m);
+		WarpByFunction(imgSrc, szDst, roiDst, imgDst, interp, border,
+			[&a](::size_t x, ::size_t y)
+		{
+			const double w = 1.0 / (a[6] * x + a[7] * y + a[8]);
+			return Point2D<double>((a[0] * x + a[1] * y + a[2]) * w,
+				(a[3] * x + a[4] * y + a[5]) * w);
+		});
+	}
+}
+
+#endif
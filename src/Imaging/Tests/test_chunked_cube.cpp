@@ -0,0 +1,168 @@
+/** This file contains the test functions to test classes and functions defined in
+chunked_cube.h */
+#include "../Imaging/chunked_cube.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <cstdio>
+
+/** Gets a smooth spectrum with a little texture, like a hyperspectral scene. */
+unsigned short GetCubeValue(::size_t x, ::size_t y, ::size_t b)
+{
+	return static_cast<unsigned short>(1000 + 3 * x + 2 * y + 40 * b + (x * 7 + y * 3) % 5);
+}
+
+Imaging::ImageFrame<unsigned short> MakeCube(::size_t width, ::size_t height,
+	::size_t nBands)
+{
+	Imaging::ImageFrame<unsigned short> cube(width, height, nBands);
+	for (::size_t Y = 0; Y != height; ++Y)
+		for (::size_t X = 0; X != width; ++X)
+			for (::size_t B = 0; B != nBands; ++B)
+				*cube.GetPointer(X, Y, B) = GetCubeValue(X, Y, B);
+	return cube;
+}
+
+bool CheckCubeRegion(const Imaging::ImageFrame<unsigned short> &img, ::size_t x0, ::size_t y0,
+	::size_t b0)
+{
+	for (::size_t Y = 0; Y != img.size.height; ++Y)
+		for (::size_t X = 0; X != img.size.width; ++X)
+			for (::size_t B = 0; B != img.depth; ++B)
+				if (*img.GetPointer(X, Y, B) != GetCubeValue(x0 + X, y0 + Y, b0 + B))
+					return false;
+	return true;
+}
+
+void TestCubeFormat(Imaging::RawImageFormat format, ::size_t chunkBands,
+	Imaging::CubeCompression compression, bool shuffle)
+{
+	using namespace Imaging;
+
+	const std::string path = "test_chunked_cube.cube";
+	const ::size_t width = 150, height = 90, nBands = 20;
+	ImageFrame<unsigned short> cube = MakeCube(width, height, nBands);
+	CubeOptions options;
+	options.chunkSize = Size2D<::size_t>(32, 24);
+	options.chunkBands = chunkBands;
+	options.format = format;
+	options.compression = compression;
+	options.shuffle = shuffle;
+	unsigned long long nStored = 0;
+	{
+		// Rows are given in pieces not aligned to the chunks.
+		CubeWriter<unsigned short> writer(path, cube.size, nBands, options);
+		for (::size_t Y = 0; Y < height; Y += 25)
+		{
+			::size_t h = std::min<::size_t>(25, height - Y);
+			std::vector<unsigned short> rows(cube.data.begin() + width * nBands * Y,
+				cube.data.begin() + width * nBands * (Y + h));
+			writer.Write(ImageFrame<unsigned short>(std::move(rows), Size2D<::size_t>(width, h),
+				nBands));
+		}
+		writer.Close();
+		nStored = writer.GetStoredBytes();
+	}
+	std::cout << "Stored " << 2 * cube.data.size() << " bytes as " << nStored <<
+		" bytes." << std::endl;
+	if (compression == CubeCompression::LZ4 && nStored >= 2 * cube.data.size())
+		throw std::logic_error("CubeWriter::Write()");
+
+	CubeReader<unsigned short> reader(path);
+	ImageFrame<unsigned short> img;
+	reader.Read(Region<::size_t, ::size_t>(0, 0, width, height), img);
+	if (img.data != cube.data)
+		throw std::logic_error("CubeReader::Read()");
+
+	// A region inside a single column and row of chunks decodes only those chunks.
+	unsigned long long nDecoded = reader.GetDecodedChunkCount();
+	reader.Read(Region<::size_t, ::size_t>(40, 50, 20, 10), 3, 2, img);
+	if (!CheckCubeRegion(img, 40, 50, 3) || reader.GetDecodedChunkCount() - nDecoded !=
+		(chunkBands == 1 ? 2 : 1))
+		throw std::logic_error("CubeReader::Read()");
+
+	reader.Read(Region<::size_t, ::size_t>(31, 23, 119, 67), 5, 15, img);
+	if (!CheckCubeRegion(img, 31, 23, 5))
+		throw std::logic_error("CubeReader::Read()");
+	reader.ReadBand(19, img);
+	if (img.depth != 1 || !CheckCubeRegion(img, 0, 0, 19))
+		throw std::logic_error("CubeReader::ReadBand()");
+
+	try
+	{
+		reader.Read(Region<::size_t, ::size_t>(140, 0, 11, 1), img);
+		throw std::logic_error("CubeReader::Read()");
+	}
+	catch (const std::out_of_range &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	std::remove(path.c_str());
+}
+
+void TestCubeErrors(void)
+{
+	using namespace Imaging;
+
+	const std::string path = "test_chunked_cube.cube";
+	{
+		CubeWriter<unsigned short> writer(path, Size2D<::size_t>(10, 10), 2);
+		writer.Write(MakeCube(10, 4, 2));
+		try
+		{
+			writer.Write(MakeCube(10, 7, 2));
+			throw std::logic_error("CubeWriter::Write()");
+		}
+		catch (const std::out_of_range &ex)
+		{
+			std::cout << ex.what() << std::endl;
+		}
+		try
+		{
+			writer.Close();
+			throw std::logic_error("CubeWriter::Close()");
+		}
+		catch (const std::logic_error &ex)
+		{
+			std::cout << ex.what() << std::endl;
+		}
+	}
+	try
+	{
+		CubeReader<unsigned short> reader(path);
+		throw std::logic_error("CubeReader()");
+	}
+	catch (const std::runtime_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	{
+		CubeWriter<unsigned short> writer(path, Size2D<::size_t>(10, 10), 2);
+		writer.Write(MakeCube(10, 10, 2));
+	}
+	try
+	{
+		CubeReader<float> reader(path);
+		throw std::logic_error("CubeReader()");
+	}
+	catch (const std::runtime_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	std::remove(path.c_str());
+}
+
+void TestChunkedCubes(void)
+{
+	using namespace Imaging;
+
+	std::cout << std::endl << "Test for chunked_cube.h has started." << std::endl;
+	SetThreadCount(4);		// force the parallel path on any machine
+	TestCubeFormat(RawImageFormat::BIP, 0, CubeCompression::LZ4, true);
+	TestCubeFormat(RawImageFormat::BSQ, 1, CubeCompression::LZ4, false);
+	TestCubeFormat(RawImageFormat::BIL, 7, CubeCompression::NONE, true);
+	TestCubeErrors();
+	SetThreadCount(0);
+	std::cout << "Test for chunked_cube.h has been completed." << std::endl;
+}
@@ -0,0 +1,208 @@
+/** This file contains the test functions to test classes and functions defined in
+color_conversion.h */
+#include "../Imaging/color_conversion.h"
+#include "../Utilities/parallel.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <random>
+
+Imaging::ImageFrame<unsigned char> MakeRandomColor(::size_t width, ::size_t height,
+	::size_t depth)
+{
+	std::mt19937 gen(5);
+	std::uniform_int_distribution<int> dist(0, 255);
+	std::vector<unsigned char> src(width * height * depth);
+	for (auto it = src.begin(); it != src.end(); ++it)
+		*it = static_cast<unsigned char>(dist(gen));
+	return Imaging::ImageFrame<unsigned char>(std::move(src),
+		Imaging::Size2D<::size_t>(width, height), depth);
+}
+
+void TestGrayAndSwizzle(void)
+{
+	using namespace Imaging;
+
+	ImageFrame<unsigned char> rgba = MakeRandomColor(31, 17, 4), gray, rgb, bgr, color;
+	SwizzleChannels(rgba, {0, 1, 2}, rgb);
+	SwizzleChannels(rgb, {2, 1, 0}, bgr);
+	if (rgb.depth != 3 || *bgr.GetPointer(5, 3, 0) != *rgba.GetPointer(5, 3, 2))
+		throw std::logic_error("SwizzleChannels()");
+
+	ColorToGray(rgba, gray);
+	ImageFrame<unsigned char> grayBgr;
+	ColorToGray(bgr, grayBgr, ColorOrder::BGR);
+	if (gray.depth != 1 || gray.data != grayBgr.data)
+		throw std::logic_error("ColorToGray()");
+	for (::size_t I = 0; I != gray.data.size(); ++I)
+	{
+		double expected = 0.299 * rgb.data[3 * I] + 0.587 * rgb.data[3 * I + 1] +
+			0.114 * rgb.data[3 * I + 2];
+		if (std::abs(gray.data[I] - expected) > 1.0)
+			throw std::logic_error("ColorToGray()");
+	}
+
+	// Floating point gray of a gray color is the gray itself.
+	ImageFrame<float> grayF(8, 4, 1), colorF, grayF2;
+	for (::size_t I = 0; I != grayF.data.size(); ++I)
+		*grayF.GetPointer(I % 8, I / 8) = static_cast<float>(I) / 32.0f;
+	GrayToColor(grayF, colorF);
+	ColorToGray(colorF, grayF2);
+	for (::size_t I = 0; I != grayF.data.size(); ++I)
+		if (std::abs(grayF.data[I] - grayF2.data[I]) > 1e-5)
+			throw std::logic_error("GrayToColor()");
+
+	try
+	{
+		ColorToGray(gray, color);
+		throw std::logic_error("ColorToGray()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	// A conversion changing the depth is not done in place.
+	try
+	{
+		ColorToGray(rgba, rgba);
+		throw std::logic_error("ColorToGray()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	try
+	{
+		GrayToColor(gray, gray);
+		throw std::logic_error("GrayToColor()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	try
+	{
+		ColorToYuv(rgba, rgba);
+		throw std::logic_error("ColorToYuv()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	if (rgba.depth != 4 || gray.depth != 1)
+		throw std::logic_error("ColorToGray()");
+
+	std::cout << "Gray conversion and swizzle were successful." << std::endl;
+}
+
+void TestYuv(void)
+{
+	using namespace Imaging;
+
+	const ::size_t width = 37, height = 21;
+	ImageFrame<unsigned char> rgb = MakeRandomColor(width, height, 3), yuv, rgb2;
+	const YuvStandard standards[2] = {YuvStandard::BT601, YuvStandard::BT709};
+	for (int S = 0; S != 2; ++S)
+		for (int R = 0; R != 2; ++R)
+		{
+			// Video range loses precision by the narrower range of codes.
+			ColorToYuv(rgb, yuv, standards[S], R == 1);
+			YuvToColor(yuv, rgb2, standards[S], R == 1);
+			int tolerance = R == 1 ? 3 : 4;
+			for (::size_t I = 0; I != rgb.data.size(); ++I)
+				if (std::abs(rgb.data[I] - rgb2.data[I]) > tolerance)
+					throw std::logic_error("YuvToColor(ColorToYuv())");
+		}
+
+	// Video range black and white.
+	ImageFrame<unsigned char> pixel(1, 1, 3), pixelYuv;
+	ColorToYuv(pixel, pixelYuv);
+	if (pixelYuv.data != std::vector<unsigned char>({16, 128, 128}))
+		throw std::logic_error("ColorToYuv()");
+	std::fill(pixel.GetPointer(0, 0), pixel.GetPointer(0, 0) + 3, 255);
+	ColorToYuv(pixel, pixelYuv);
+	if (pixelYuv.data != std::vector<unsigned char>({235, 128, 128}))
+		throw std::logic_error("ColorToYuv()");
+
+	// NV12 and I420 of the same chroma must match YuvToColor() with upsampled chroma.
+	std::vector<unsigned char> planeY(40 * height), planeU(20 * 11), planeV(20 * 11),
+		planeUv(48 * 11);
+	for (::size_t Y = 0; Y != height; ++Y)
+		for (::size_t X = 0; X != width; ++X)
+			planeY[40 * Y + X] = *yuv.GetPointer(X, Y, 0);
+	for (::size_t Y = 0; Y != 11; ++Y)
+		for (::size_t X = 0; X != 19; ++X)
+		{
+			planeU[20 * Y + X] = *yuv.GetPointer(2 * X, 2 * Y, 1);
+			planeV[20 * Y + X] = *yuv.GetPointer(2 * X, 2 * Y, 2);
+			planeUv[48 * Y + 2 * X] = planeU[20 * Y + X];
+			planeUv[48 * Y + 2 * X + 1] = planeV[20 * Y + X];
+		}
+	ImageFrame<unsigned char> yuv444(width, height, 3), expected, nv12, i420;
+	for (::size_t Y = 0; Y != height; ++Y)
+		for (::size_t X = 0; X != width; ++X)
+		{
+			*yuv444.GetPointer(X, Y, 0) = planeY[40 * Y + X];
+			*yuv444.GetPointer(X, Y, 1) = planeU[20 * (Y / 2) + X / 2];
+			*yuv444.GetPointer(X, Y, 2) = planeV[20 * (Y / 2) + X / 2];
+		}
+	YuvToColor(yuv444, expected, YuvStandard::BT709, false, ColorOrder::BGR);
+	Nv12ToColor(planeY.data(), 40, planeUv.data(), 48, width, height, nv12,
+		YuvStandard::BT709, false, ColorOrder::BGR);
+	I420ToColor(planeY.data(), 40, planeU.data(), 20, planeV.data(), 20, width, height, i420,
+		YuvStandard::BT709, false, ColorOrder::BGR);
+	if (nv12.data != expected.data || i420.data != expected.data)
+		throw std::logic_error("Nv12ToColor(), I420ToColor()");
+
+	std::cout << "YUV conversion was successful." << std::endl;
+}
+
+void TestHsv(void)
+{
+	using namespace Imaging;
+
+	// Red, yellow, green, cyan, blue, magenta, gray and black.
+	std::vector<unsigned char> colors = {255, 0, 0, 255, 255, 0, 0, 255, 0, 0, 255, 255,
+		0, 0, 255, 255, 0, 255, 128, 128, 128, 0, 0, 0};
+	std::vector<unsigned char> hsvExpected = {0, 255, 255, 30, 255, 255, 60, 255, 255,
+		90, 255, 255, 120, 255, 255, 150, 255, 255, 0, 0, 128, 0, 0, 0};
+	ImageFrame<unsigned char> img(colors, Size2D<::size_t>(8, 1), 3), hsv, img2;
+	ColorToHsv(img, hsv);
+	if (hsv.data != hsvExpected)
+		throw std::logic_error("ColorToHsv()");
+	HsvToColor(hsv, img2);
+	if (img2.data != colors)
+		throw std::logic_error("HsvToColor()");
+
+	// 8-bit round trip loses precision by 2 degrees per step of H.
+	ImageFrame<unsigned char> bgr = MakeRandomColor(40, 30, 3), bgr2;
+	ColorToHsv(bgr, hsv, ColorOrder::BGR);
+	HsvToColor(hsv, bgr2, ColorOrder::BGR);
+	for (::size_t I = 0; I != bgr.data.size(); ++I)
+		if (std::abs(bgr.data[I] - bgr2.data[I]) > 8)
+			throw std::logic_error("HsvToColor(ColorToHsv())");
+
+	// Floating point round trip is exact within rounding errors.
+	ImageFrame<double> rgbD(40, 30, 3), hsvD, rgbD2;
+	for (::size_t I = 0; I != rgbD.data.size(); ++I)
+		*(rgbD.GetPointer(0, 0) + I) = bgr.data[I] / 255.0;
+	ColorToHsv(rgbD, hsvD);
+	HsvToColor(hsvD, rgbD2);
+	for (::size_t I = 0; I != rgbD.data.size(); ++I)
+		if (std::abs(rgbD.data[I] - rgbD2.data[I]) > 1e-9)
+			throw std::logic_error("HsvToColor(ColorToHsv())");
+
+	std::cout << "HSV conversion was successful." << std::endl;
+}
+
+void TestColorConversions(void)
+{
+	std::cout << std::endl << "Test for color_conversion.h has started." << std::endl;
+	Imaging::SetThreadCount(4);		// force the parallel path on any machine
+	TestGrayAndSwizzle();
+	TestYuv();
+	TestHsv();
+	Imaging::SetThreadCount(0);
+	std::cout << "Test for color_conversion.h has been completed." << std::endl;
+}
@@ -0,0 +1,140 @@
+/** This file contains the test functions to test classes and functions defined in
+demosaic.h */
+#include "../Imaging/demosaic.h"
+#include "../Utilities/parallel.h"
+
+#include <stdexcept>
+#include <iostream>
+
+/** Samples a color image through a Bayer pattern into lines of given bytes per line. */
+template <typename T>
+std::vector<char> Mosaic(const Imaging::ImageFrame<T> &img, Imaging::BayerPattern pattern,
+	::size_t bytesPerLine)
+{
+	const char *names[4] = {"RGGB", "BGGR", "GRBG", "GBRG"};
+	const char *name = names[static_cast<int>(pattern)];
+	std::vector<char> raw(bytesPerLine * img.size.height, 0);
+	for (::size_t Y = 0; Y != img.size.height; ++Y)
+	{
+		T *line = reinterpret_cast<T *>(raw.data() + bytesPerLine * Y);
+		for (::size_t X = 0; X != img.size.width; ++X)
+		{
+			char color = name[2 * (Y % 2) + X % 2];
+			line[X] = *img.GetPointer(X, Y, color == 'R' ? 0 : (color == 'G' ? 1 : 2));
+		}
+	}
+	return raw;
+}
+
+template <typename T>
+double GetMeanError(const Imaging::ImageFrame<T> &img1, const Imaging::ImageFrame<T> &img2)
+{
+	double sum = 0.0;
+	for (::size_t I = 0; I != img1.data.size(); ++I)
+		sum += std::abs(static_cast<double>(img1.data[I]) - static_cast<double>(img2.data[I]));
+	return sum / static_cast<double>(img1.data.size());
+}
+
+void TestDemosaicFlat(void)
+{
+	using namespace Imaging;
+
+	// A flat color must be reproduced exactly everywhere including the borders.
+	const BayerPattern patterns[4] = {BayerPattern::RGGB, BayerPattern::BGGR,
+		BayerPattern::GRBG, BayerPattern::GBRG};
+	const DemosaicMethod methods[2] = {DemosaicMethod::BILINEAR,
+		DemosaicMethod::EDGE_AWARE};
+	ImageFrame<unsigned char> img(13, 9, 3), dst;
+	for (::size_t I = 0; I != img.data.size(); ++I)
+		*(img.GetPointer(0, 0) + I) = static_cast<unsigned char>(I % 3 == 0 ? 200 :
+		(I % 3 == 1 ? 90 : 30));
+	for (int P = 0; P != 4; ++P)
+		for (int M = 0; M != 2; ++M)
+		{
+			std::vector<char> raw = Mosaic(img, patterns[P], 16);
+			Demosaic(raw.data(), 13, 9, 16, patterns[P], dst, methods[M]);
+			if (dst.data != img.data)
+				throw std::logic_error("Demosaic()");
+		}
+
+	// BGR order swaps red and blue.
+	std::vector<char> raw = Mosaic(img, BayerPattern::GRBG, 13);
+	Demosaic(raw.data(), 13, 9, 13, BayerPattern::GRBG, dst, DemosaicMethod::BILINEAR, 8,
+		ColorOrder::BGR);
+	if (*dst.GetPointer(4, 4, 0) != 30 || *dst.GetPointer(4, 4, 2) != 200)
+		throw std::logic_error("Demosaic()");
+
+	try
+	{
+		Demosaic(raw.data(), 13, 9, 12, BayerPattern::GRBG, dst);
+		throw std::logic_error("Demosaic()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	std::cout << "Demosaicing of flat colors was successful." << std::endl;
+}
+
+void TestDemosaicEdges(void)
+{
+	using namespace Imaging;
+
+	// 12-bit gray image with diagonal stripes and a smooth color ramp.
+	const ::size_t width = 64, height = 48;
+	ImageFrame<unsigned short> img(width, height, 3), bilinear, edgeAware;
+	for (::size_t Y = 0; Y != height; ++Y)
+		for (::size_t X = 0; X != width; ++X)
+		{
+			int base = ((X + 2 * Y) / 6) % 2 == 0 ? 600 : 3400;
+			*img.GetPointer(X, Y, 0) = static_cast<unsigned short>(base + 8 * X);
+			*img.GetPointer(X, Y, 1) = static_cast<unsigned short>(base);
+			*img.GetPointer(X, Y, 2) = static_cast<unsigned short>(base + 4 * Y);
+		}
+	std::vector<char> raw = Mosaic(img, BayerPattern::BGGR, 2 * width + 6);
+	Demosaic(raw.data(), width, height, 2 * width + 6, BayerPattern::BGGR, bilinear,
+		DemosaicMethod::BILINEAR, 12);
+	Demosaic(raw.data(), width, height, 2 * width + 6, BayerPattern::BGGR, edgeAware,
+		DemosaicMethod::EDGE_AWARE, 12);
+	for (auto it = edgeAware.data.cbegin(); it != edgeAware.data.cend(); ++it)
+		if (*it > 4095)
+			throw std::logic_error("Demosaic(EDGE_AWARE)");
+
+	// The kernels of every SIMD level give the same result.
+	const SimdLevel best = GetKernelLevel();
+	for (auto level : {SimdLevel::BASELINE, SimdLevel::SSE41, SimdLevel::AVX2,
+		SimdLevel::AVX512})
+		if (IsKernelLevelAvailable(level))
+		{
+			SetKernelLevel(level);
+			ImageFrame<unsigned short> other;
+			Demosaic(raw.data(), width, height, 2 * width + 6, BayerPattern::BGGR, other,
+				DemosaicMethod::BILINEAR, 12);
+			if (other.data != bilinear.data)
+				throw std::logic_error("Demosaic(BILINEAR)");
+			Demosaic(raw.data(), width, height, 2 * width + 6, BayerPattern::BGGR, other,
+				DemosaicMethod::EDGE_AWARE, 12);
+			if (other.data != edgeAware.data)
+				throw std::logic_error("Demosaic(EDGE_AWARE)");
+		}
+	SetKernelLevel(best);
+
+	double errBilinear = GetMeanError(img, bilinear), errEdge = GetMeanError(img, edgeAware);
+	std::cout << "Mean error of bilinear: " << errBilinear << ", edge-aware: " << errEdge <<
+		std::endl;
+	if (!(errEdge < errBilinear))
+		throw std::logic_error("Demosaic(EDGE_AWARE)");
+
+	std::cout << "Demosaicing of edges was successful." << std::endl;
+}
+
+void TestDemosaic(void)
+{
+	std::cout << std::endl << "Test for demosaic.h has started." << std::endl;
+	Imaging::SetThreadCount(4);		// force the parallel path on any machine
+	TestDemosaicFlat();
+	TestDemosaicEdges();
+	Imaging::SetThreadCount(0);
+	std::cout << "Test for demosaic.h has been completed." << std::endl;
+}
@@ -0,0 +1,130 @@
+/** This file contains the test functions to test classes and functions defined in
+detection.h */
+#include "../Imaging/detection.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <random>
+
+/** Creates random regions clustered around a few centers, i.e., typical raw output of a
+detector, with random scores. */
+void MakeCandidates(::size_t count, int width, int height,
+	std::vector<Imaging::Region<int, int>> &regions, std::vector<double> &scores)
+{
+	std::mt19937 gen(1);
+	std::uniform_int_distribution<int> center_x(0, width), center_y(0, height);
+	std::uniform_int_distribution<int> jitter(-4, 4), extent(16, 48);
+	std::uniform_real_distribution<double> score(0.0, 1.0);
+
+	regions.clear();
+	scores.clear();
+	int cx = 0, cy = 0, w = 0, h = 0;
+	for (::size_t I = 0; I != count; ++I)
+	{
+		if (I % 16 == 0)
+		{
+			cx = center_x(gen);
+			cy = center_y(gen);
+			w = extent(gen);
+			h = extent(gen);
+		}
+		regions.push_back(Imaging::Region<int, int>(cx + jitter(gen), cy + jitter(gen),
+			w + jitter(gen), h + jitter(gen)));
+		scores.push_back(score(gen));
+	}
+}
+
+/** Reference greedy NMS by testing every pair. */
+void SuppressNonMaximaReference(const std::vector<Imaging::Region<int, int>> &regions,
+	const std::vector<double> &scores, double thIoU, std::vector<::size_t> &dst)
+{
+	std::vector<::size_t> order(regions.size());
+	for (::size_t I = 0; I != order.size(); ++I)
+		order[I] = I;
+	std::stable_sort(order.begin(), order.end(),
+		[&scores](::size_t a, ::size_t b) { return scores[a] > scores[b]; });
+	dst.clear();
+	for (auto it = order.cbegin(); it != order.cend(); ++it)
+	{
+		bool keep = true;
+		for (auto it_kept = dst.cbegin(); it_kept != dst.cend() && keep; ++it_kept)
+			keep = Imaging::GetIoU(regions[*it], regions[*it_kept]) <= thIoU;
+		if (keep)
+			dst.push_back(*it);
+	}
+}
+
+void TestIoU(void)
+{
+	using namespace Imaging;
+
+	Region<int, unsigned int> roi1(0, 0, 4, 4), roi2(2, 2, 4, 4), roi3(4, 0, 2, 2), roi4;
+	if (roi1.GetArea() != 16)
+		throw std::logic_error("Region<T, U>::GetArea()");
+	if (!roi1.Intersect(roi2, roi4) || roi4 != Region<int, unsigned int>(2, 2, 2, 2))
+		throw std::logic_error("Region<T, U>::Intersect()");
+	if (roi1.Intersect(roi3, roi4) || roi4.GetArea() != 0)
+		throw std::logic_error("Region<T, U>::Intersect()");
+
+	Region<int, unsigned int> roi5(-2, -2, 4, 4);
+	if (!roi1.Intersect(roi5, roi4) || roi4 != Region<int, unsigned int>(0, 0, 2, 2))
+		throw std::logic_error("Region<T, U>::Intersect()");
+
+	if (GetIoU(roi1, roi2) != 4.0 / 28.0 || GetIoU(roi1, roi3) != 0.0)
+		throw std::logic_error("GetIoU()");
+
+	std::vector<Region<int, unsigned int>> a, b;
+	a.push_back(roi1);
+	a.push_back(roi2);
+	b.push_back(roi1);
+	b.push_back(roi2);
+	b.push_back(roi3);
+	std::vector<double> iou;
+	GetIoU(a, b, iou);
+	for (::size_t I = 0; I != a.size(); ++I)
+		for (::size_t J = 0; J != b.size(); ++J)
+			if (iou[b.size() * I + J] != GetIoU(a[I], b[J]))
+				throw std::logic_error("GetIoU()");
+
+	std::cout << "IoU of regions was successful." << std::endl;
+}
+
+void TestSuppressNonMaxima(::size_t count)
+{
+	using namespace Imaging;
+
+	std::vector<Region<int, int>> regions;
+	std::vector<double> scores;
+	MakeCandidates(count, 1024, 1024, regions, scores);
+
+	// Greedy NMS against the reference; the grid is used when count >= 512.
+	std::vector<::size_t> kept, expected;
+	SuppressNonMaxima(regions, scores, 0.5, kept);
+	SuppressNonMaximaReference(regions, scores, 0.5, expected);
+	if (kept != expected)
+		throw std::logic_error("SuppressNonMaxima()");
+
+	// Soft-NMS with HARD must be identical to greedy NMS.
+	std::vector<double> decayed = scores;
+	SuppressNonMaxima(regions, decayed, 0.5, 0.0, Suppression::HARD, 0.5, kept);
+	if (kept != expected)
+		throw std::logic_error("SuppressNonMaxima(HARD)");
+
+	// Soft-NMS keeps at least the regions of greedy NMS.
+	decayed = scores;
+	SuppressNonMaxima(regions, decayed, 0.5, 0.0, Suppression::GAUSSIAN, 0.5, kept);
+	if (kept.size() < expected.size() || kept.front() != expected.front())
+		throw std::logic_error("SuppressNonMaxima(GAUSSIAN)");
+
+	std::cout << "NMS of " << count << " regions kept " << expected.size() <<
+		" regions." << std::endl;
+}
+
+void TestDetection(void)
+{
+	std::cout << std::endl << "Test for detection.h has started." << std::endl;
+	TestIoU();
+	TestSuppressNonMaxima(100);
+	TestSuppressNonMaxima(2000);
+	std::cout << "Test for detection.h has been completed." << std::endl;
+}
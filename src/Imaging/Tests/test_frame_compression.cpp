@@ -0,0 +1,151 @@
+/** This file contains the test functions to test classes and functions defined in
+frame_compression.h */
+#include "../Imaging/frame_compression.h"
+#include "../Imaging/image_codec.h"
+#include "../Utilities/parallel.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <limits>
+#include <random>
+
+/** Makes a 16-bit frame of smooth gradients with a little noise. */
+Imaging::ImageFrame<unsigned short> MakeSmoothFrame(::size_t width, ::size_t height,
+	::size_t depth, unsigned seed)
+{
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<int> noise(0, 3);
+	Imaging::ImageFrame<unsigned short> img(width, height, depth);
+	for (::size_t Y = 0; Y != height; ++Y)
+		for (::size_t X = 0; X != width; ++X)
+			for (::size_t C = 0; C != depth; ++C)
+				*img.GetPointer(X, Y, C) = static_cast<unsigned short>(1000 + 7 * X + 5 * Y +
+				300 * C + seed + noise(gen));
+	return img;
+}
+
+template <typename T>
+void CheckRoundTrip(const Imaging::ImageFrame<T> &img, Imaging::FramePredictor predictor)
+{
+	Imaging::CompressedFrame<T> frame(img, predictor);
+	Imaging::ImageFrame<T> dst;
+	frame.Decompress(dst);
+	if (dst.size != img.size || dst.depth != img.depth || dst.data != img.data)
+		throw std::logic_error("CompressedFrame::Decompress()");
+}
+
+void TestCompressedFrame(void)
+{
+	using namespace Imaging;
+
+	const FramePredictor predictors[3] = {FramePredictor::NONE, FramePredictor::LEFT,
+		FramePredictor::MED};
+	ImageFrame<unsigned short> smooth = MakeSmoothFrame(200, 150, 3, 1);
+	ImageFrame<unsigned char> lenna;
+	ReadImage("Lenna.png", lenna);
+
+	std::mt19937 gen(3);
+	std::uniform_int_distribution<int> dist(-32768, 32767);
+	ImageFrame<unsigned int> random(67, 45, 2);
+	ImageFrame<short> signedFrame(65, 33, 1);
+	ImageFrame<int> fullRange(31, 17, 3);
+	for (::size_t I = 0; I != random.data.size(); ++I)
+		*(random.GetPointer(0, 0) + I) = static_cast<unsigned int>(gen());
+	for (::size_t I = 0; I != signedFrame.data.size(); ++I)
+		*(signedFrame.GetPointer(0, 0) + I) = static_cast<short>(dist(gen));
+	// Neighbors at both ends of the range overflow int if the residuals are signed.
+	std::uniform_int_distribution<int> distInt(std::numeric_limits<int>::min(),
+		std::numeric_limits<int>::max());
+	for (::size_t I = 0; I != fullRange.data.size(); ++I)
+		*(fullRange.GetPointer(0, 0) + I) = I % 5 == 0 ? std::numeric_limits<int>::min() :
+		(I % 5 == 1 ? std::numeric_limits<int>::max() : distInt(gen));
+	ImageFrame<unsigned char> tiny(1, 1, 1), empty;
+	*tiny.GetPointer(0, 0) = 200;
+
+	for (int P = 0; P != 3; ++P)
+	{
+		CheckRoundTrip(smooth, predictors[P]);
+		CheckRoundTrip(lenna, predictors[P]);
+		CheckRoundTrip(random, predictors[P]);
+		CheckRoundTrip(signedFrame, predictors[P]);
+		CheckRoundTrip(fullRange, predictors[P]);
+		CheckRoundTrip(tiny, predictors[P]);
+		CheckRoundTrip(empty, predictors[P]);
+	}
+
+	// Prediction pays off on smooth data; random data does not grow much.
+	CompressedFrame<unsigned short> none(smooth, FramePredictor::NONE),
+		med(smooth, FramePredictor::MED);
+	CompressedFrame<unsigned char> lennaMed(lenna);
+	CompressedFrame<unsigned int> randomMed(random);
+	std::cout << "Compression ratio of a smooth 16-bit frame without prediction: " <<
+		none.GetRatio() << ", with MED: " << med.GetRatio() << ", Lenna: " <<
+		lennaMed.GetRatio() << ", random: " << randomMed.GetRatio() << std::endl;
+	if (med.GetRatio() < 1.5 || !(med.GetRatio() > none.GetRatio()) ||
+		lennaMed.GetRatio() < 1.2 || randomMed.GetRatio() < 0.9)
+		throw std::logic_error("CompressedFrame::GetRatio()");
+
+	// Decompressing into a frame of the same sample count reuses its memory.
+	ImageFrame<unsigned short> dst(150, 200, 3);
+	const unsigned short *p = dst.GetPointer(0, 0);
+	med.Decompress(dst);
+	if (dst.GetPointer(0, 0) != p || dst.data != smooth.data)
+		throw std::logic_error("CompressedFrame::Decompress()");
+
+	std::cout << "Compressed frames were successful." << std::endl;
+}
+
+void TestCompressedFrameHistory(void)
+{
+	using namespace Imaging;
+
+	CompressedFrameHistory<unsigned short> history(3);
+	for (unsigned N = 0; N != 5; ++N)
+		history.Push(MakeSmoothFrame(64, 40, 1, 100 * N));
+	if (history.GetCount() != 3)
+		throw std::logic_error("CompressedFrameHistory::Push()");
+	for (unsigned A = 0; A != 3; ++A)
+		if (history.Get(A)->data != MakeSmoothFrame(64, 40, 1, 100 * (4 - A)).data)
+			throw std::logic_error("CompressedFrameHistory::Get()");
+
+	CompressionStats stats = history.GetStats();
+	if (stats.nCompressed != 5 || stats.nDecompressed != 3 ||
+		stats.rawBytes != 3 * 64 * 40 * 2 || stats.bytesCompressed != 5 * 64 * 40 * 2 ||
+		stats.bytesDecompressed != 3 * 64 * 40 * 2 || !(stats.GetRatio() > 1.0))
+		throw std::logic_error("CompressedFrameHistory::GetStats()");
+
+	try
+	{
+		history.Get(3);
+		throw std::logic_error("CompressedFrameHistory::Get()");
+	}
+	catch (const std::out_of_range &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	try
+	{
+		CompressedFrameHistory<unsigned short> invalid(0);
+		throw std::logic_error("CompressedFrameHistory()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	history.Clear();
+	if (history.GetCount() != 0 || history.GetStats().compressedBytes != 0)
+		throw std::logic_error("CompressedFrameHistory::Clear()");
+
+	std::cout << "Compressed frame history was successful." << std::endl;
+}
+
+void TestFrameCompression(void)
+{
+	std::cout << std::endl << "Test for frame_compression.h has started." << std::endl;
+	Imaging::SetThreadCount(4);		// force the parallel path on any machine
+	TestCompressedFrame();
+	TestCompressedFrameHistory();
+	Imaging::SetThreadCount(0);
+	std::cout << "Test for frame_compression.h has been completed." << std::endl;
+}
@@ -0,0 +1,129 @@
+/** This file contains the test functions to test classes and functions defined in
+frame_reader.h */
+#include "../Imaging/frame_reader.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <atomic>
+#include <cstdio>
+
+/** Gets the value of a sample of a frame of the test sequence. */
+unsigned short GetSequenceValue(::size_t index, ::size_t x, ::size_t y, ::size_t c)
+{
+	return static_cast<unsigned short>(index * 1000 + y * 37 + x * 3 + c);
+}
+
+/** Writes a test sequence of BSQ frames in big-endian with headers. */
+void WriteSequence(const std::string &path, ::size_t width, ::size_t height, ::size_t depth,
+	::size_t nFrames, ::size_t headerBytes, ::size_t frameHeaderBytes)
+{
+	std::ofstream file(path, std::ios::binary);
+	std::vector<char> header(headerBytes, 'H'), frameHeader(frameHeaderBytes, 'F');
+	file.write(header.data(), header.size());
+	for (::size_t N = 0; N != nFrames; ++N)
+	{
+		file.write(frameHeader.data(), frameHeader.size());
+		for (::size_t C = 0; C != depth; ++C)
+			for (::size_t Y = 0; Y != height; ++Y)
+				for (::size_t X = 0; X != width; ++X)
+				{
+					unsigned short v = GetSequenceValue(N, X, Y, C);
+					char bytes[2] = {static_cast<char>(v >> 8), static_cast<char>(v & 0xFF)};
+					file.write(bytes, 2);
+				}
+	}
+}
+
+bool CheckSequenceFrame(const Imaging::ImageFrame<unsigned short> &img, ::size_t index)
+{
+	for (::size_t Y = 0; Y != img.size.height; ++Y)
+		for (::size_t X = 0; X != img.size.width; ++X)
+			for (::size_t C = 0; C != img.depth; ++C)
+				if (*img.GetPointer(X, Y, C) != GetSequenceValue(index, X, Y, C))
+					return false;
+	return true;
+}
+
+void TestFrameReaderSequence(bool directIo)
+{
+	using namespace Imaging;
+
+	const std::string path = "test_frame_reader.raw";
+	const ::size_t width = 100, height = 60, depth = 3, nFrames = 12;
+	WriteSequence(path, width, height, depth, nFrames, 1000, 24);
+
+	FrameReaderOptions options;
+	options.format = RawImageFormat::BSQ;
+	options.order = ByteOrder::BIG;
+	options.headerBytes = 1000;
+	options.frameHeaderBytes = 24;
+	options.nPrefetch = 3;
+	options.directIo = directIo;
+	{
+		FrameReader<unsigned short> reader(path, Size2D<::size_t>(width, height), depth,
+			options);
+		if (reader.GetFrameCount() != nFrames)
+			throw std::logic_error("FrameReader::GetFrameCount()");
+		std::cout << "Direct I/O " << (directIo ? "requested" : "not requested") <<
+			", opened as " << (reader.IsDirect() ? "direct." : "buffered.") << std::endl;
+
+		// Sequential frames with read-ahead.
+		::size_t N = 0;
+		for (; reader.HasNext(); ++N)
+		{
+			FrameReader<unsigned short>::FramePtr frame = reader.Next().get();
+			if (!CheckSequenceFrame(*frame, N))
+				throw std::logic_error("FrameReader::Next()");
+		}
+		if (N != nFrames)
+			throw std::logic_error("FrameReader::Next()");
+
+		// Random access by futures and callbacks.
+		reader.Seek(nFrames - 2);
+		if (!CheckSequenceFrame(*reader.Next().get(), nFrames - 2))
+			throw std::logic_error("FrameReader::Seek()");
+		if (!CheckSequenceFrame(*reader.Read(5).get(), 5))
+			throw std::logic_error("FrameReader::Read()");
+
+		std::atomic<int> nCalled(0), nFailed(0);
+		for (::size_t I = 0; I != nFrames; ++I)
+			reader.Read(I, [&, I](FrameReader<unsigned short>::FramePtr frame,
+				std::exception_ptr error)
+			{
+				if (error || !CheckSequenceFrame(*frame, I))
+					++nFailed;
+				++nCalled;
+			});
+		reader.Read(nFrames, [&](FrameReader<unsigned short>::FramePtr frame,
+			std::exception_ptr error)
+		{
+			if (!error || frame)
+				++nFailed;
+			++nCalled;
+		});
+		while (nCalled != static_cast<int>(nFrames) + 1)
+			std::this_thread::yield();
+		if (nFailed != 0)
+			throw std::logic_error("FrameReader::Read(Callback)");
+
+		try
+		{
+			reader.Read(nFrames).get();
+			throw std::logic_error("FrameReader::Read()");
+		}
+		catch (const std::out_of_range &ex)
+		{
+			std::cout << ex.what() << std::endl;
+		}
+	}
+	std::remove(path.c_str());
+}
+
+void TestFrameReaders(void)
+{
+	std::cout << std::endl << "Test for frame_reader.h has started." << std::endl;
+	TestFrameReaderSequence(false);
+	TestFrameReaderSequence(true);
+	std::cout << "Test for frame_reader.h has been completed." << std::endl;
+}
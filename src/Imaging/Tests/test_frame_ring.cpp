@@ -0,0 +1,177 @@
+/** This file contains the test functions to test classes and functions defined in
+frame_ring.h */
+#include "../Imaging/frame_ring.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+/** Writes frames of values of their index until the ring refuses one. */
+void ProduceFrames(Imaging::FrameRing<int> &ring, int nFrames)
+{
+	for (int N = 0; N != nFrames; ++N)
+	{
+		Imaging::FrameRing<int>::WriteSlot slot = ring.Claim();
+		if (slot)
+		{
+			Imaging::ImageFrame<int> &frame = slot.GetFrame();
+			std::fill(frame.GetPointer(0, 0), frame.GetPointer(0, 0) + frame.data.size(),
+				static_cast<int>(slot.GetIndex()));
+			slot.Commit();
+		}
+	}
+}
+
+/** Acquires the frames left in the ring and gets their indices. */
+std::vector<int> ConsumeFrames(Imaging::FrameRing<int> &ring)
+{
+	std::vector<int> indices;
+	for (auto view = ring.TryAcquire(); view; view = ring.TryAcquire())
+		indices.push_back(view.GetFrame().data.front());
+	return indices;
+}
+
+void TestFrameRingPolicies(void)
+{
+	using namespace Imaging;
+
+	// Frames come out in order, and a full ring refuses TryClaim().
+	FrameRing<int> ring(4, Size2D<::size_t>(5, 3), 2);
+	ProduceFrames(ring, 4);
+	if (ring.TryClaim() || ConsumeFrames(ring) != std::vector<int>({0, 1, 2, 3}) ||
+		ring.TryAcquire())
+		throw std::logic_error("FrameRing::Claim(BLOCK)");
+
+	FrameRing<int> newest(4, Size2D<::size_t>(5, 3), 2, RingPolicy::DROP_NEWEST);
+	ProduceFrames(newest, 6);
+	if (ConsumeFrames(newest) != std::vector<int>({0, 1, 2, 3}) ||
+		newest.GetCounters().nDroppedNewest != 2)
+		throw std::logic_error("FrameRing::Claim(DROP_NEWEST)");
+
+	FrameRing<int> oldest(4, Size2D<::size_t>(5, 3), 2, RingPolicy::DROP_OLDEST);
+	ProduceFrames(oldest, 6);
+	RingCounters counters = oldest.GetCounters();
+	if (ConsumeFrames(oldest) != std::vector<int>({2, 3, 4, 5}) ||
+		counters.nDroppedOldest != 2 || counters.nCommitted != 6)
+		throw std::logic_error("FrameRing::Claim(DROP_OLDEST)");
+
+	// A frame being read is not dropped; the producer waits for it instead.
+	ProduceFrames(oldest, 3);
+	FrameRing<int>::ReadView held = oldest.TryAcquire();
+	ProduceFrames(oldest, 1);
+	std::thread reader([&held]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		held.Release();
+	});
+	ProduceFrames(oldest, 2);
+	reader.join();
+	if (ConsumeFrames(oldest) != std::vector<int>({8, 9, 10, 11}) ||
+		oldest.GetCounters().nDroppedOldest != 3)
+		throw std::logic_error("FrameRing::Claim(DROP_OLDEST)");
+
+	// A ring of a single slot refuses a claim until its committed frame is released.
+	FrameRing<int> single(1, Size2D<::size_t>(5, 3), 2);
+	FrameRing<int>::WriteSlot claimed = single.TryClaim();
+	if (!claimed)
+		throw std::logic_error("FrameRing::TryClaim()");
+	claimed.Commit();
+	if (single.TryClaim())
+		throw std::logic_error("FrameRing::TryClaim()");
+	FrameRing<int>::ReadView only = single.TryAcquire();
+	if (!only || only.GetIndex() != 0 || single.TryAcquire() || single.TryClaim())
+		throw std::logic_error("FrameRing::TryAcquire()");
+	only.Release();
+	ProduceFrames(single, 1);
+	if (ConsumeFrames(single) != std::vector<int>({1}))
+		throw std::logic_error("FrameRing::Claim()");
+
+	FrameRing<int> singleOldest(1, Size2D<::size_t>(5, 3), 2, RingPolicy::DROP_OLDEST);
+	ProduceFrames(singleOldest, 3);
+	if (ConsumeFrames(singleOldest) != std::vector<int>({2}) ||
+		singleOldest.GetCounters().nDroppedOldest != 2)
+		throw std::logic_error("FrameRing::Claim(DROP_OLDEST)");
+
+	// An abandoned slot is skipped, and a slot frame can be reset in place.
+	{
+		FrameRing<int>::WriteSlot slot = ring.Claim();
+		slot.GetFrame().Reset(Size2D<::size_t>(3, 5), 2);
+	}
+	ProduceFrames(ring, 1);
+	FrameRing<int>::ReadView view = ring.Acquire();
+	if (view.GetIndex() != 5 || view.GetFrame().data.front() != 5 ||
+		ring.GetCounters().nAbandoned != 1)
+		throw std::logic_error("FrameRing::Acquire()");
+	view.Release();
+
+	// Closing wakes up a waiting consumer after the committed frames.
+	ProduceFrames(ring, 1);
+	std::thread closer([&ring]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		ring.Close();
+	});
+	bool first = static_cast<bool>(ring.Acquire()), second = static_cast<bool>(ring.Acquire());
+	closer.join();
+	if (!first || second || ring.Claim() || view)
+		throw std::logic_error("FrameRing::Close()");
+
+	std::cout << "Policies of a frame ring were successful." << std::endl;
+}
+
+void TestFrameRingThreads(void)
+{
+	using namespace Imaging;
+
+	// Every frame is received once and never torn, by several producers and consumers.
+	const int nProducers = 3, nConsumers = 3, nFrames = 3000;
+	FrameRing<int> ring(8, Size2D<::size_t>(16, 16), 1);
+	std::vector<std::thread> producers, consumers;
+	std::vector<std::vector<int>> received(nConsumers);
+	std::atomic<int> nTorn(0);
+	for (int P = 0; P != nProducers; ++P)
+		producers.emplace_back([&ring]() { ProduceFrames(ring, nFrames); });
+	for (int C = 0; C != nConsumers; ++C)
+		consumers.emplace_back([&, C]()
+		{
+			for (;;)
+			{
+				FrameRing<int>::ReadView view = ring.Acquire();
+				if (!view)
+					break;
+				const std::vector<int> &data = view.GetFrame().data;
+				if (std::count(data.cbegin(), data.cend(), data.front()) !=
+					static_cast<::ptrdiff_t>(data.size()))
+					++nTorn;
+				received[C].push_back(data.front());
+			}
+		});
+	for (auto it = producers.begin(); it != producers.end(); ++it)
+		it->join();
+	ring.Close();
+	for (auto it = consumers.begin(); it != consumers.end(); ++it)
+		it->join();
+
+	std::vector<int> all;
+	for (auto it = received.cbegin(); it != received.cend(); ++it)
+		all.insert(all.end(), it->cbegin(), it->cend());
+	std::sort(all.begin(), all.end());
+	for (int I = 0; I != nProducers * nFrames; ++I)
+		if (static_cast<int>(all.size()) != nProducers * nFrames || all[I] != I)
+			throw std::logic_error("FrameRing::Acquire()");
+	if (nTorn != 0 || ring.GetCounters().nAcquired != nProducers * nFrames)
+		throw std::logic_error("FrameRing::Acquire()");
+
+	std::cout << "Multiple producers and consumers of a frame ring were successful." <<
+		std::endl;
+}
+
+void TestFrameRings(void)
+{
+	std::cout << std::endl << "Test for frame_ring.h has started." << std::endl;
+	TestFrameRingPolicies();
+	TestFrameRingThreads();
+	std::cout << "Test for frame_ring.h has been completed." << std::endl;
+}
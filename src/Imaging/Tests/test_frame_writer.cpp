@@ -0,0 +1,135 @@
+/** This file contains the test functions to test classes and functions defined in
+frame_writer.h */
+#include "../Imaging/frame_writer.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+
+Imaging::ImageFrame<unsigned short> MakeWriterFrame(::size_t width, ::size_t height,
+	::size_t depth, ::size_t index)
+{
+	Imaging::ImageFrame<unsigned short> img(width, height, depth);
+	for (::size_t Y = 0; Y != height; ++Y)
+		for (::size_t X = 0; X != width; ++X)
+			for (::size_t C = 0; C != depth; ++C)
+				*img.GetPointer(X, Y, C) = static_cast<unsigned short>(index * 1000 + Y * 37 +
+				X * 3 + C);
+	return img;
+}
+
+void TestFrameWriterFormat(Imaging::RawImageFormat format, Imaging::ByteOrder order,
+	bool directIo)
+{
+	using namespace Imaging;
+
+	const std::string path = "test_frame_writer.raw";
+	const ::size_t width = 100, height = 60, depth = 3, nFrames = 7;
+	FrameWriterOptions options;
+	options.format = format;
+	options.order = order;
+	options.queueDepth = 2;
+	options.chunkBytes = 10000;		// lines split across chunks
+	options.syncInterval = 3;
+	options.directIo = directIo;
+	{
+		FrameWriter<unsigned short> writer(path, Size2D<::size_t>(width, height), depth,
+			options);
+		for (::size_t N = 0; N != nFrames; ++N)
+			writer.Write(MakeWriterFrame(width, height, depth, N));
+		if (writer.GetFrameCount() != nFrames)
+			throw std::logic_error("FrameWriter::GetFrameCount()");
+		try
+		{
+			writer.Write(ImageFrame<unsigned short>(width, height, 1));
+			throw std::logic_error("FrameWriter::Write()");
+		}
+		catch (const std::invalid_argument &ex)
+		{
+			std::cout << ex.what() << std::endl;
+		}
+		writer.Close();
+	}
+
+	RawSequenceHeader header;
+	header.Read(path);
+	if (header.size != Size2D<::size_t>(width, height) || header.depth != depth ||
+		header.dataType != 12 || header.format != format || header.nFrames != nFrames)
+		throw std::logic_error("RawSequenceHeader::Read()");
+	{
+		FrameReader<unsigned short> reader(path, header.size, header.depth,
+			header.GetReaderOptions());
+		if (reader.GetFrameCount() != nFrames)
+			throw std::logic_error("FrameWriter::Close()");
+		for (::size_t N = 0; reader.HasNext(); ++N)
+			if (reader.Next().get()->data != MakeWriterFrame(width, height, depth, N).data)
+				throw std::logic_error("FrameWriter::Write()");
+	}
+	std::remove(path.c_str());
+}
+
+/** The file of frames which do not fill the last chunk is cut back to the header and the
+frames, also after the padding of direct I/O, so the frame count survives a round trip. */
+void TestFrameWriterSize(bool directIo)
+{
+	using namespace Imaging;
+
+	const std::string path = "test_frame_writer.raw";
+	const ::size_t width = 10, height = 10, nFrames = 10;
+	FrameWriterOptions options;
+	options.directIo = directIo;
+	{
+		FrameWriter<unsigned char> writer(path, Size2D<::size_t>(width, height), 1, options);
+		for (::size_t N = 0; N != nFrames; ++N)
+			writer.Write(ImageFrame<unsigned char>(width, height, 1));
+		writer.Close();
+	}
+
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	const unsigned long long nBytes = static_cast<unsigned long long>(file.tellg());
+	file.close();
+	if (nBytes != RawSequenceHeader::GetSize() + nFrames * width * height)
+		throw std::logic_error("FrameWriter::Close()");
+	RawSequenceHeader header;
+	header.Read(path);
+	{
+		FrameReader<unsigned char> reader(path, header.size, header.depth,
+			header.GetReaderOptions());
+		if (header.nFrames != nFrames || reader.GetFrameCount() != nFrames)
+			throw std::logic_error("FrameWriter::Close()");
+	}
+	std::remove(path.c_str());
+}
+
+void TestFrameWriterFormats(void)
+{
+	using namespace Imaging;
+
+	TestFrameWriterFormat(RawImageFormat::BIP, ByteOrder::NATIVE, false);
+	TestFrameWriterFormat(RawImageFormat::BSQ, ByteOrder::BIG, false);
+	TestFrameWriterFormat(RawImageFormat::BIL, ByteOrder::LITTLE, true);
+	TestFrameWriterFormat(RawImageFormat::BSQ, ByteOrder::BIG, true);
+	TestFrameWriterSize(false);
+	TestFrameWriterSize(true);
+
+	try
+	{
+		RawSequenceHeader header;
+		header.Parse("ENVI\nsamples = 10\n");
+		throw std::logic_error("RawSequenceHeader::Parse()");
+	}
+	catch (const std::runtime_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	std::cout << "Writing raw sequences was successful." << std::endl;
+}
+
+void TestFrameWriters(void)
+{
+	std::cout << std::endl << "Test for frame_writer.h has started." << std::endl;
+	TestFrameWriterFormats();
+	std::cout << "Test for frame_writer.h has been completed." << std::endl;
+}
@@ -7,8 +7,6 @@ image.h */
 #include <iostream>
 #include <sstream>
 
-#include "opencv2/opencv.hpp"
-
 void TestDummyBytes(void)
 {
 	// {int x 3 channel x 4 pixel} x 2 lines -> 48 bytes/line x 2 lines = 96 bytes
@@ -39,11 +37,140 @@ void TestDummyBytes(void)
 	delete [] raw_1;
 }
 
+/** Packs samples into lines of given bytes per line as a reference of Copy(Packing). */
+std::vector<unsigned char> Pack(const std::vector<unsigned short> &src, ::size_t width,
+	::size_t height, ::size_t bytesPerLine, Imaging::Packing packing)
+{
+	using namespace Imaging;
+
+	std::vector<unsigned char> dst(bytesPerLine * height, 0);
+	for (::size_t Y = 0; Y != height; ++Y)
+	{
+		unsigned char *line = dst.data() + bytesPerLine * Y;
+		for (::size_t X = 0; X != width; ++X)
+		{
+			unsigned v = src[width * Y + X];
+			if (packing == Packing::MONO10P || packing == Packing::MONO12P)
+			{
+				// Write bit by bit from the least significant bit.
+				::size_t bits = packing == Packing::MONO10P ? 10 : 12;
+				for (::size_t B = 0; B != bits; ++B)
+					if (v >> B & 1)
+						line[(bits * X + B) / 8] |= 1 << ((bits * X + B) % 8);
+			}
+			else
+			{
+				::size_t lsb = packing == Packing::MONO10_PACKED ? 2 : 4;
+				unsigned char *group = line + 3 * (X / 2);
+				group[X % 2 == 0 ? 0 : 2] = static_cast<unsigned char>(v >> lsb);
+				group[1] |= (v & ((1 << lsb) - 1)) << (X % 2 == 0 ? 0 : 4);
+			}
+		}
+	}
+	return dst;
+}
+
+void TestPackedBytes(void)
+{
+	using namespace Imaging;
+
+	const Packing packings[4] = {Packing::MONO10P, Packing::MONO12P, Packing::MONO10_PACKED,
+		Packing::MONO12_PACKED};
+	// Lines long enough for the vectorized kernels of every SIMD level.
+	const ::size_t widths[5] = {16, 7, 5, 1, 203};
+	const SimdLevel best = GetKernelLevel();
+	for (auto level : {SimdLevel::BASELINE, SimdLevel::SSE41, SimdLevel::AVX2,
+		SimdLevel::AVX512})
+	{
+		if (!IsKernelLevelAvailable(level))
+			continue;
+		SetKernelLevel(level);
+		for (int P = 0; P != 4; ++P)
+			for (int W = 0; W != 5; ++W)
+			{
+				const ::size_t width = widths[W], height = 3;
+				unsigned mask = P == 1 || P == 3 ? 0x0FFF : 0x03FF;
+				std::vector<unsigned short> src(width * height), dst;
+				for (::size_t I = 0; I != src.size(); ++I)
+					src[I] = static_cast<unsigned short>((I * 2654435761u >> 7) & mask);
+
+				// Lines without and with padding bytes.
+				::size_t nBytes = GetPackedBytesPerLine(width, packings[P]);
+				for (::size_t bytesPerLine = nBytes; bytesPerLine <= nBytes + 3;
+					bytesPerLine += 3)
+				{
+					std::vector<unsigned char> raw = Pack(src, width, height, bytesPerLine,
+						packings[P]);
+					Copy(raw.data(), width, height, bytesPerLine, packings[P], dst);
+					if (dst != src)
+						throw std::logic_error("Copy(Packing)");
+				}
+			}
+	}
+	SetKernelLevel(best);
+
+	std::vector<unsigned short> dst;
+	try
+	{
+		std::vector<unsigned char> raw(10);
+		Copy(raw.data(), 7, 1, 10, Packing::MONO12P, dst);
+		throw std::logic_error("Copy(Packing)");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	std::cout << "Unpacking of packed samples was successful." << std::endl;
+}
+
+/** Checks the conversions from data of the other byte order in BIP, BSQ and BIL. */
+void TestByteOrderConversion(void)
+{
+	using namespace Imaging;
+
+	// BSQ data of 3 bands x 5 x 4 pixels, and its BIL and BIP arrangement.
+	const ::size_t width = 5, height = 4, nBands = 3;
+	std::vector<unsigned short> bsq(width * height * nBands), bil(bsq.size()),
+		bip(bsq.size());
+	for (::size_t B = 0; B != nBands; ++B)
+		for (::size_t Y = 0; Y != height; ++Y)
+			for (::size_t X = 0; X != width; ++X)
+			{
+				unsigned short v = static_cast<unsigned short>(1000 * B + 100 * Y + X);
+				bsq[width * height * B + width * Y + X] = v;
+				bil[width * nBands * Y + width * B + X] = v;
+				bip[nBands * width * Y + nBands * X + B] = v;
+			}
+
+	const ByteOrder other = GetNativeByteOrder() == ByteOrder::LITTLE ? ByteOrder::BIG :
+		ByteOrder::LITTLE;
+	const RawImageFormat formats[3] = {RawImageFormat::BIP, RawImageFormat::BSQ,
+		RawImageFormat::BIL};
+	const std::vector<unsigned short> *sources[3] = {&bip, &bsq, &bil};
+	for (int F = 0; F != 3; ++F)
+	{
+		ImageFrame<unsigned short> img1, img2;
+		img1.CopyFrom(sources[F]->data(), Size2D<::size_t>(width, height), nBands,
+			formats[F]);
+		std::vector<unsigned short> swapped = *sources[F];
+		SwapBytes(swapped.data(), swapped.size());
+		img2.CopyFrom(swapped.data(), Size2D<::size_t>(width, height), nBands, formats[F],
+			other);
+		if (img1.data != bip || img2.data != bip)
+			throw std::logic_error("CopyFrom(RawImageFormat, ByteOrder)");
+	}
+
+	std::cout << "Conversion of swapped byte order was successful." << std::endl;
+}
+
 void TestConvert(void)
 {
 	using namespace Imaging;
 
 	TestDummyBytes();
+	TestPackedBytes();
+	TestByteOrderConversion();
 
 	std::vector<unsigned int> imgBsq1(24), imgBip1(24), imgBip2(24);
 	for (unsigned int I = 0; I != imgBsq1.size(); ++I)
@@ -0,0 +1,428 @@
+/** This file contains the test functions to test classes and functions defined in
+image_codec.h */
+#include "../Imaging/image_codec.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <numeric>
+
+/** Wraps bytes into a zlib stream of stored (uncompressed) deflate blocks. */
+std::vector<unsigned char> StoreZlib(const std::vector<unsigned char> &data)
+{
+	std::vector<unsigned char> dst = {0x78, 0x01};
+	for (::size_t I = 0; I == 0 || I < data.size(); I += 1000)
+	{
+		::size_t n = std::min<::size_t>(1000, data.size() - I);
+		dst.push_back(I + n == data.size() ? 1 : 0);
+		unsigned char header[4] = {static_cast<unsigned char>(n), static_cast<unsigned char>(n >> 8),
+			static_cast<unsigned char>(~n), static_cast<unsigned char>(~n >> 8)};
+		dst.insert(dst.end(), header, header + 4);
+		dst.insert(dst.end(), data.begin() + I, data.begin() + I + n);
+	}
+	dst.insert(dst.end(), 4, 0);	// Adler-32 is not verified
+	return dst;
+}
+
+void WriteBytes(const std::string &path, const std::vector<unsigned char> &bytes)
+{
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+void PutBigEndian(std::vector<unsigned char> &dst, unsigned value, ::size_t nBytes)
+{
+	for (::size_t I = 0; I != nBytes; ++I)
+		dst.push_back(static_cast<unsigned char>(value >> (8 * (nBytes - 1 - I))));
+}
+
+/** Writes a PNG file of given chunks; CRCs are left zero. */
+void WritePng(const std::string &path, unsigned width, unsigned height, int bitDepth,
+	int colorType, bool interlaced, const std::vector<unsigned char> &palette,
+	const std::vector<unsigned char> &alpha, const std::vector<unsigned char> &filtered)
+{
+	std::vector<unsigned char> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	auto Chunk = [&](const char *type, const std::vector<unsigned char> &data)
+	{
+		PutBigEndian(png, static_cast<unsigned>(data.size()), 4);
+		png.insert(png.end(), type, type + 4);
+		png.insert(png.end(), data.begin(), data.end());
+		png.insert(png.end(), 4, 0);
+	};
+	std::vector<unsigned char> header;
+	PutBigEndian(header, width, 4);
+	PutBigEndian(header, height, 4);
+	header.push_back(static_cast<unsigned char>(bitDepth));
+	header.push_back(static_cast<unsigned char>(colorType));
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(interlaced ? 1 : 0);
+	Chunk("IHDR", header);
+	if (!palette.empty())
+		Chunk("PLTE", palette);
+	if (!alpha.empty())
+		Chunk("tRNS", alpha);
+
+	// Image data split into two chunks.
+	std::vector<unsigned char> data = StoreZlib(filtered);
+	Chunk("IDAT", std::vector<unsigned char>(data.begin(), data.begin() + data.size() / 2));
+	Chunk("IDAT", std::vector<unsigned char>(data.begin() + data.size() / 2, data.end()));
+	Chunk("IEND", std::vector<unsigned char>());
+	WriteBytes(path, png);
+}
+
+void TestPng(void)
+{
+	using namespace Imaging;
+
+	// Lenna.png uses all filter types; the reference is from an independent decoder.
+	ImageFrame<unsigned char> lenna;
+	ReadImage("Lenna.png", lenna);
+	if (lenna.size != Size2D<::size_t>(512, 512) || lenna.depth != 3 ||
+		std::accumulate(lenna.data.cbegin(), lenna.data.cend(), 0ull) != 100842898 ||
+		*lenna.GetPointer(0, 0, 0) != 226 || *lenna.GetPointer(200, 100, 1) != 117 ||
+		*lenna.GetPointer(511, 511, 2) != 81)
+		throw std::logic_error("ReadImage(PNG)");
+
+	// Interlaced RGB; each pass is a sequence of rows with filter type 0.
+	const std::string path = "test_image_codec.png";
+	const unsigned width = 13, height = 11;
+	auto GetValue = [](unsigned x, unsigned y, unsigned c)
+	{
+		return static_cast<unsigned char>(x * 17 + y * 5 + c * 80);
+	};
+	const unsigned passes[7][4] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8},
+		{2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+	std::vector<unsigned char> filtered;
+	for (int P = 0; P != 7; ++P)
+		for (unsigned Y = passes[P][1]; Y < height; Y += passes[P][3])
+		{
+			if (passes[P][0] >= width)
+				continue;
+			filtered.push_back(0);
+			for (unsigned X = passes[P][0]; X < width; X += passes[P][2])
+				for (unsigned C = 0; C != 3; ++C)
+					filtered.push_back(GetValue(X, Y, C));
+		}
+	WritePng(path, width, height, 8, 2, true, {}, {}, filtered);
+	ImageFrame<unsigned char> img;
+	ReadImage(path, img);
+	for (unsigned Y = 0; Y != height; ++Y)
+		for (unsigned X = 0; X != width; ++X)
+			for (unsigned C = 0; C != 3; ++C)
+				if (*img.GetPointer(X, Y, C) != GetValue(X, Y, C))
+					throw std::logic_error("ReadImage(interlaced PNG)");
+
+	// 2-bit palette with transparency expands to RGBA.
+	std::vector<unsigned char> palette = {255, 0, 0, 0, 255, 0, 0, 0, 255, 9, 9, 9};
+	filtered = {0, 0x1B, 0xE0, 0, 0xE4, 0x40};		// indices 0123 23 and 3210 10
+	WritePng(path, 6, 2, 2, 3, false, palette, {128, 64}, filtered);
+	ReadImage(path, img);
+	if (img.depth != 4 || *img.GetPointer(0, 0, 0) != 255 || *img.GetPointer(0, 0, 3) != 128 ||
+		*img.GetPointer(1, 0, 3) != 64 || *img.GetPointer(4, 0, 2) != 9 ||
+		*img.GetPointer(5, 0, 2) != 255 || *img.GetPointer(5, 0, 3) != 255 ||
+		*img.GetPointer(0, 1, 2) != 9 || *img.GetPointer(3, 1, 0) != 255)
+		throw std::logic_error("ReadImage(palette PNG)");
+
+	// 16-bit gray is decoded in the native byte order, and converted into float.
+	filtered = {0, 0x12, 0x34, 0xAB, 0xCD};
+	WritePng(path, 2, 1, 16, 0, false, {}, {}, filtered);
+	ImageFrame<unsigned short> img16;
+	ImageFrame<float> imgF;
+	ReadImage(path, img16);
+	ReadImage(path, imgF);
+	if (img16.data != std::vector<unsigned short>({0x1234, 0xABCD}) ||
+		imgF.data != std::vector<float>({4660.0f, 43981.0f}))
+		throw std::logic_error("ReadImage(16-bit PNG)");
+
+	// Truncated image data.
+	filtered.pop_back();
+	WritePng(path, 2, 1, 16, 0, false, {}, {}, filtered);
+	try
+	{
+		ReadImage(path, img16);
+		throw std::logic_error("ReadImage(PNG)");
+	}
+	catch (const std::runtime_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	std::remove(path.c_str());
+
+	std::cout << "Decoding PNG files was successful." << std::endl;
+}
+
+void TestPnm(void)
+{
+	using namespace Imaging;
+
+	const std::string path = "test_image_codec.pnm";
+	ImageFrame<unsigned char> img;
+	ImageFrame<unsigned short> img16;
+
+	std::string text = "P3\n# comment\n3 1\n255\n1 2 3  4 5 6\n7 8 9\n";
+	WriteBytes(path, std::vector<unsigned char>(text.begin(), text.end()));
+	ReadImage(path, img);
+	if (img.depth != 3 || img.data != std::vector<unsigned char>({1, 2, 3, 4, 5, 6, 7, 8, 9}))
+		throw std::logic_error("ReadImage(P3)");
+
+	text = "P1 5 2 10110\n0 1 0 0 1\n";
+	WriteBytes(path, std::vector<unsigned char>(text.begin(), text.end()));
+	ReadImage(path, img);
+	if (img.data != std::vector<unsigned char>({0, 255, 0, 0, 255, 255, 0, 255, 255, 0}))
+		throw std::logic_error("ReadImage(P1)");
+
+	std::vector<unsigned char> bytes = {'P', '4', ' ', '1', '0', ' ', '2', '\n', 0xA5, 0x40,
+		0xFF, 0xC0};
+	WriteBytes(path, bytes);
+	ReadImage(path, img);
+	if (img.data != std::vector<unsigned char>({0, 255, 0, 255, 255, 0, 255, 0, 255, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0}))
+		throw std::logic_error("ReadImage(P4)");
+
+	bytes = {'P', '5', '\n', '2', ' ', '2', '\n', '6', '5', '5', '3', '5', '\n', 0x01, 0x02,
+		0x03, 0x04, 0xFF, 0xFE, 0x00, 0x10};
+	WriteBytes(path, bytes);
+	ReadImage(path, img16);
+	if (img16.data != std::vector<unsigned short>({0x0102, 0x0304, 0xFFFE, 0x0010}))
+		throw std::logic_error("ReadImage(P5)");
+
+	// Rows are decoded on demand.
+	std::unique_ptr<ImageDecoder> decoder = OpenImageDecoder(path);
+	unsigned short row[2];
+	decoder->ReadRow(row);
+	decoder->ReadRow(row);
+	if (row[0] != 0xFFFE || decoder->GetNextRow() != 2)
+		throw std::logic_error("ImageDecoder::ReadRow()");
+	try
+	{
+		decoder->ReadRow(row);
+		throw std::logic_error("ImageDecoder::ReadRow()");
+	}
+	catch (const std::out_of_range &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	text = "XY 1 1\n";
+	WriteBytes(path, std::vector<unsigned char>(text.begin(), text.end()));
+	try
+	{
+		ReadImage(path, img);
+		throw std::logic_error("ReadImage()");
+	}
+	catch (const std::runtime_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	std::remove(path.c_str());
+
+	std::cout << "Decoding PNM files was successful." << std::endl;
+}
+
+/** Builds a TIFF file of pages in given byte order; each page is given as the tags and
+the bytes of its strips. */
+class TiffBuilder
+{
+public:
+	TiffBuilder(bool bigEndian) : bigEndian_(bigEndian)
+	{
+		const char order = bigEndian ? 'M' : 'I';
+		this->bytes_ = {static_cast<unsigned char>(order), static_cast<unsigned char>(order)};
+		this->Put(42, 2);
+		this->Put(0, 4);
+	}
+
+	void Put(unsigned value, ::size_t nBytes)
+	{
+		for (::size_t I = 0; I != nBytes; ++I)
+			this->bytes_.push_back(static_cast<unsigned char>(value >> (8 *
+			(this->bigEndian_ ? nBytes - 1 - I : I))));
+	}
+
+	void Set(::size_t position, unsigned value)
+	{
+		for (::size_t I = 0; I != 4; ++I)
+			this->bytes_[position + I] = static_cast<unsigned char>(value >> (8 *
+			(this->bigEndian_ ? 3 - I : I)));
+	}
+
+	/** Tags are (tag, values) with LONG values; strip offsets (273) and byte counts (279)
+	are added from the strips. */
+	void AddPage(std::vector<std::pair<unsigned, std::vector<unsigned>>> tags,
+		const std::vector<std::vector<unsigned char>> &strips)
+	{
+		std::vector<unsigned> offsets, counts;
+		for (auto it = strips.cbegin(); it != strips.cend(); ++it)
+		{
+			offsets.push_back(static_cast<unsigned>(this->bytes_.size()));
+			counts.push_back(static_cast<unsigned>(it->size()));
+			this->bytes_.insert(this->bytes_.end(), it->begin(), it->end());
+		}
+		tags.push_back(std::make_pair(273u, offsets));
+		tags.push_back(std::make_pair(279u, counts));
+		std::sort(tags.begin(), tags.end());
+
+		// Values longer than 4 bytes.
+		std::vector<unsigned> positions;
+		for (auto it = tags.cbegin(); it != tags.cend(); ++it)
+		{
+			positions.push_back(static_cast<unsigned>(this->bytes_.size()));
+			if (it->second.size() > 1)
+				for (auto v = it->second.cbegin(); v != it->second.cend(); ++v)
+					this->Put(*v, 4);
+		}
+
+		if (this->bytes_.size() % 2 != 0)
+			this->bytes_.push_back(0);
+		this->Set(this->nextPosition_, static_cast<unsigned>(this->bytes_.size()));
+		this->Put(static_cast<unsigned>(tags.size()), 2);
+		for (::size_t I = 0; I != tags.size(); ++I)
+		{
+			this->Put(tags[I].first, 2);
+			this->Put(4, 2);
+			this->Put(static_cast<unsigned>(tags[I].second.size()), 4);
+			this->Put(tags[I].second.size() > 1 ? positions[I] : tags[I].second[0], 4);
+		}
+		this->nextPosition_ = this->bytes_.size();
+		this->Put(0, 4);
+	}
+
+	const std::vector<unsigned char> &GetBytes(void) const
+	{
+		return this->bytes_;
+	}
+
+protected:
+	bool bigEndian_;
+	std::vector<unsigned char> bytes_;
+	::size_t nextPosition_ = 4;
+};
+
+void TestTiff(void)
+{
+	using namespace Imaging;
+
+	const std::string path = "test_image_codec.tif";
+	const unsigned width = 7, height = 5;
+	auto GetValue = [](unsigned page, unsigned x, unsigned y, unsigned c)
+	{
+		return static_cast<unsigned short>(page * 20000 + y * 1000 + x * 10 + c);
+	};
+
+	// Files of both byte orders with 2 pages each.
+	// Page 0: 8-bit RGB, chunky, uncompressed, 2 rows per strip
+	// Page 1: 16-bit RGB, planar, deflate with the horizontal predictor, 1 strip per plane
+	for (int B = 0; B != 2; ++B)
+	{
+		const bool bigEndian = B == 1;
+		TiffBuilder tiff(bigEndian);
+		std::vector<std::vector<unsigned char>> strips;
+		for (unsigned Y = 0; Y < height; Y += 2)
+		{
+			std::vector<unsigned char> strip;
+			for (unsigned R = Y; R != std::min(Y + 2, height); ++R)
+				for (unsigned X = 0; X != width; ++X)
+					for (unsigned C = 0; C != 3; ++C)
+						strip.push_back(static_cast<unsigned char>(GetValue(0, X, R, C)));
+			strips.push_back(strip);
+		}
+		tiff.AddPage({{256, {width}}, {257, {height}}, {258, {8, 8, 8}}, {262, {2}},
+			{277, {3}}, {278, {2}}}, strips);
+
+		strips.clear();
+		for (unsigned C = 0; C != 3; ++C)
+		{
+			std::vector<unsigned char> plane;
+			for (unsigned Y = 0; Y != height; ++Y)
+				for (unsigned X = 0; X != width; ++X)
+				{
+					unsigned short v = static_cast<unsigned short>(GetValue(1, X, Y, C) -
+						(X == 0 ? 0 : GetValue(1, X - 1, Y, C)));
+					unsigned char hi = static_cast<unsigned char>(v >> 8);
+					unsigned char lo = static_cast<unsigned char>(v & 0xFF);
+					plane.push_back(bigEndian ? hi : lo);
+					plane.push_back(bigEndian ? lo : hi);
+				}
+			strips.push_back(StoreZlib(plane));
+		}
+		tiff.AddPage({{256, {width}}, {257, {height}}, {258, {16, 16, 16}}, {259, {8}},
+			{262, {2}}, {277, {3}}, {284, {2}}, {317, {2}}}, strips);
+		WriteBytes(path, tiff.GetBytes());
+
+		std::vector<ImageFrame<unsigned short>> pages;
+		ReadImagePages(path, pages);
+		if (pages.size() != 2)
+			throw std::logic_error("ReadImagePages(TIFF)");
+		for (unsigned P = 0; P != 2; ++P)
+			for (unsigned Y = 0; Y != height; ++Y)
+				for (unsigned X = 0; X != width; ++X)
+					for (unsigned C = 0; C != 3; ++C)
+					{
+						unsigned short expected = GetValue(P, X, Y, C);
+						if (P == 0)
+							expected = static_cast<unsigned char>(expected);
+						if (*pages[P].GetPointer(X, Y, C) != expected)
+							throw std::logic_error("ReadImagePages(TIFF)");
+					}
+
+		ImageFrame<unsigned short> img;
+		ReadImage(path, img, 1);
+		if (img.data != pages[1].data)
+			throw std::logic_error("ReadImage(TIFF)");
+	}
+
+	try
+	{
+		ImageFrame<unsigned char> img;
+		ReadImage(path, img, 2);
+		throw std::logic_error("ReadImage(TIFF)");
+	}
+	catch (const std::out_of_range &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	std::remove(path.c_str());
+
+	std::cout << "Decoding TIFF files was successful." << std::endl;
+}
+
+void TestReadImages(void)
+{
+	using namespace Imaging;
+
+	std::vector<std::string> paths(8, "Lenna.png");
+	std::vector<ImageFrame<unsigned char>> images;
+	ImageFrame<unsigned char> lenna;
+	ReadImage("Lenna.png", lenna);
+	ReadImages(paths, images);
+	for (auto it = images.cbegin(); it != images.cend(); ++it)
+		if (it->data != lenna.data)
+			throw std::logic_error("ReadImages()");
+
+	paths[5] = "missing.png";
+	try
+	{
+		ReadImages(paths, images);
+		throw std::logic_error("ReadImages()");
+	}
+	catch (const std::runtime_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	std::cout << "Decoding multiple files was successful." << std::endl;
+}
+
+void TestImageCodecs(void)
+{
+	std::cout << std::endl << "Test for image_codec.h has started." << std::endl;
+	Imaging::SetThreadCount(4);		// force the parallel path on any machine
+	TestPng();
+	TestPnm();
+	TestTiff();
+	TestReadImages();
+	Imaging::SetThreadCount(0);
+	std::cout << "Test for image_codec.h has been completed." << std::endl;
+}
@@ -0,0 +1,124 @@
+/** This file contains the test functions to test classes and functions defined in
+image_expression.h */
+#include "../Imaging/image_expression.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <random>
+
+template <typename T>
+Imaging::ImageFrame<T> MakeRandomFrame(::size_t width, ::size_t height, ::size_t depth,
+	int minValue, int maxValue, unsigned seed)
+{
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<int> dist(minValue, maxValue);
+	Imaging::ImageFrame<T> img(width, height, depth);
+	for (::size_t I = 0; I != img.data.size(); ++I)
+		*(img.GetPointer(0, 0) + I) = static_cast<T>(dist(gen));
+	return img;
+}
+
+void TestExpressionArithmetic(void)
+{
+	using namespace Imaging;
+
+	ImageFrame<unsigned short> a = MakeRandomFrame<unsigned short>(37, 23, 3, 0, 4095, 1),
+		b = MakeRandomFrame<unsigned short>(37, 23, 3, 0, 4095, 2);
+	const float gain = 1.5f, offset = 100.0f;
+
+	// unsigned short - unsigned short is int, so negative differences are kept.
+	ImageFrame<float> dst;
+	dst = (a - b) * gain + offset;
+	for (::size_t I = 0; I != dst.data.size(); ++I)
+		if (dst.data[I] != (static_cast<int>(a.data[I]) - b.data[I]) * gain + offset)
+			throw std::logic_error("ImageFrame::operator=(FrameExpression)");
+	if (dst.size != a.size || dst.depth != 3)
+		throw std::logic_error("ImageFrame::operator=(FrameExpression)");
+
+	// Casts, functions and scalars on the left.
+	ImageFrame<unsigned char> dst8;
+	dst8 = SaturateCast<unsigned char>(Abs(a - b) / 16.0 - 0.25);
+	ImageFrame<double> ratio;
+	ratio = 1.0 / (Cast<double>(Max(a, b)) + 1);
+	ImageFrame<short> clipped;
+	clipped = -Min(a, 1000);
+	for (::size_t I = 0; I != a.data.size(); ++I)
+	{
+		int diff = std::abs(static_cast<int>(a.data[I]) - b.data[I]);
+		double scaled = diff / 16.0 - 0.25;
+		unsigned char expected = scaled <= 0.0 ? 0 :
+			(scaled >= 255.0 ? 255 : static_cast<unsigned char>(scaled + 0.5));
+		if (dst8.data[I] != expected ||
+			ratio.data[I] != 1.0 / (std::max(a.data[I], b.data[I]) + 1.0) ||
+			clipped.data[I] != -std::min(static_cast<int>(a.data[I]), 1000))
+			throw std::logic_error("ImageFrame::operator=(FrameExpression)");
+	}
+
+	// Saturation of integers, and NaN.
+	ImageFrame<int> wide(4, 1, 1);
+	int values[4] = {-5, 100, 300, 70000};
+	std::copy(values, values + 4, wide.GetPointer(0, 0));
+	ImageFrame<unsigned char> narrow;
+	narrow = SaturateCast<unsigned char>(wide);
+	ImageFrame<float> nan(1, 1, 1);
+	*nan.GetPointer(0, 0) = std::numeric_limits<float>::quiet_NaN();
+	ImageFrame<unsigned short> nan16;
+	nan16 = SaturateCast<unsigned short>(nan);
+	if (narrow.data != std::vector<unsigned char>({0, 100, 255, 255}) || nan16.data[0] != 0)
+		throw std::logic_error("SaturateCast()");
+
+	// The destination may be an operand.
+	ImageFrame<unsigned short> acc(a);
+	acc = acc + b;
+	for (::size_t I = 0; I != a.data.size(); ++I)
+		if (acc.data[I] != static_cast<unsigned short>(a.data[I] + b.data[I]))
+			throw std::logic_error("ImageFrame::operator=(FrameExpression)");
+
+	// Evaluation into a region of a larger frame.
+	ImageFrame<int> canvas(50, 40, 3);
+	std::fill(canvas.GetPointer(0, 0), canvas.GetPointer(0, 0) + canvas.data.size(), -1);
+	Evaluate(a - b, canvas, Region<::size_t, ::size_t>(Point2D<::size_t>(5, 10),
+		Size2D<::size_t>(37, 23)));
+	if (*canvas.GetPointer(4, 10, 0) != -1 || *canvas.GetPointer(5, 9, 2) != -1 ||
+		*canvas.GetPointer(41, 32, 1) != static_cast<int>(*a.GetPointer(36, 22, 1)) -
+		*b.GetPointer(36, 22, 1) || *canvas.GetPointer(42, 32, 1) != -1)
+		throw std::logic_error("Evaluate(Region)");
+
+	// An empty region writes nothing, even at the origin where its last corner would wrap.
+	ImageFrame<unsigned short> empty(0, 0, 3);
+	Evaluate(empty + empty, canvas, Region<::size_t, ::size_t>(0, 0, 0, 0));
+	if (*canvas.GetPointer(0, 0, 0) != -1)
+		throw std::logic_error("Evaluate(Region)");
+
+	ImageFrame<unsigned short> other(23, 37, 3);
+	try
+	{
+		dst = a + other;
+		throw std::logic_error("operator+(ImageFrame, ImageFrame)");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	try
+	{
+		Evaluate(a - b, canvas, Region<::size_t, ::size_t>(Point2D<::size_t>(20, 20),
+			Size2D<::size_t>(37, 23)));
+		throw std::logic_error("Evaluate(Region)");
+	}
+	catch (const std::out_of_range &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	std::cout << "Arithmetic of frame expressions was successful." << std::endl;
+}
+
+void TestImageExpressions(void)
+{
+	std::cout << std::endl << "Test for image_expression.h has started." << std::endl;
+	Imaging::SetThreadCount(4);		// force the parallel path on any machine
+	TestExpressionArithmetic();
+	Imaging::SetThreadCount(0);
+	std::cout << "Test for image_expression.h has been completed." << std::endl;
+}
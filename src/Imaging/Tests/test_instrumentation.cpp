@@ -0,0 +1,177 @@
+/** This file contains the test functions to test classes and functions defined in
+instrumentation.h and trace.h */
+#include "../Utilities/instrumentation.h"
+#include "../Utilities/trace.h"
+#include "../Imaging/image.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/** Gets the totals of an operation, which must be registered. */
+Imaging::OperationStats GetOperationStats(const std::string &name)
+{
+	for (const auto &s : Imaging::Instrumentation::GetStats())
+		if (s.name == name)
+			return s;
+	throw std::logic_error("Instrumentation::GetStats()");
+}
+
+void TestInstrumentationRegistry(void)
+{
+	using namespace Imaging;
+
+	const ::size_t id = Instrumentation::Register("Test::Operation");
+	if (Instrumentation::Register("Test::Operation") != id ||
+		Instrumentation::Register("Test::Other") == id)
+		throw std::logic_error("Instrumentation::Register()");
+
+	// Counters of threads are summed, including those of threads which have ended.
+	Instrumentation::Reset();
+	Instrumentation::Record(id, 1000, 10, 1);
+	std::vector<std::thread> threads;
+	for (int I = 0; I != 4; ++I)
+		threads.push_back(std::thread([id]
+		{
+			for (int J = 0; J != 100; ++J)
+				Instrumentation::Record(id, 2000, 10, 1);
+		}));
+	for (auto &t : threads)
+		t.join();
+	OperationStats s = GetOperationStats("Test::Operation");
+	if (s.calls != 401 || s.bytes != 4010 || s.pixels != 401 ||
+		s.seconds < 801e-6 - 1e-12 || s.seconds > 801e-6 + 1e-12 ||
+		s.maxSeconds < 2e-6 - 1e-12 || s.maxSeconds > 2e-6 + 1e-12)
+		throw std::logic_error("Instrumentation::GetStats()");
+
+	// Totals and maximums start from zero after Reset().
+	Instrumentation::Reset();
+	s = GetOperationStats("Test::Operation");
+	if (s.calls != 0 || s.bytes != 0 || s.seconds != 0.0 || s.maxSeconds != 0.0)
+		throw std::logic_error("Instrumentation::Reset()");
+	Instrumentation::Record(id, 500, 0, 0);
+	s = GetOperationStats("Test::Operation");
+	if (s.calls != 1 || s.maxSeconds < 500e-9 - 1e-12 || s.maxSeconds > 500e-9 + 1e-12)
+		throw std::logic_error("Instrumentation::Reset()");
+
+	{
+		ScopedTimer timer(id, 100, 5);
+	}
+	s = GetOperationStats("Test::Operation");
+	if (s.calls != 2 || s.bytes != 100 || s.pixels != 5)
+		throw std::logic_error("ScopedTimer");
+
+	const std::string json = Instrumentation::ToJson();
+	if (json.find("{\"name\": \"Test::Operation\", \"calls\": 2,") == std::string::npos)
+		throw std::logic_error("Instrumentation::ToJson()");
+	const std::string text = Instrumentation::ToPrometheus();
+	if (text.find("# TYPE imaging_operation_calls_total counter\n") == std::string::npos ||
+		text.find("imaging_operation_calls_total{operation=\"Test::Operation\"} 2\n") ==
+		std::string::npos ||
+		text.find("imaging_operation_bytes_total{operation=\"Test::Operation\"} 100\n") ==
+		std::string::npos)
+		throw std::logic_error("Instrumentation::ToPrometheus()");
+}
+
+/** Primitives are counted only if instrumentation is compiled in. */
+void TestInstrumentedPrimitives(void)
+{
+	using namespace Imaging;
+
+	std::vector<unsigned short> src(3 * 64 * 48), dst;
+	Instrumentation::Reset();
+	BsqToBip(src.data(), 3, 64 * 48, dst);
+	BsqToBip(src.data(), 3, 64 * 48, dst);
+#if defined(IMAGING_INSTRUMENTATION)
+	const OperationStats s = GetOperationStats("BsqToBip");
+	if (s.calls != 2 || s.bytes != 2 * 2 * src.size() * sizeof(unsigned short) ||
+		s.pixels != 2 * 64 * 48)
+		throw std::logic_error("IMAGING_SCOPED_TIMER()");
+	std::cout << Instrumentation::ToPrometheus();
+#else
+	for (const auto &s : Instrumentation::GetStats())
+		if (s.name == "BsqToBip")
+			throw std::logic_error("IMAGING_SCOPED_TIMER()");
+#endif
+}
+
+/** Counts the occurrences of a string in another. */
+::size_t CountOf(const std::string &text, const std::string &key)
+{
+	::size_t n = 0;
+	for (auto pos = text.find(key); pos != std::string::npos; pos = text.find(key, pos + 1))
+		++n;
+	return n;
+}
+
+void TestTracer(void)
+{
+	using namespace Imaging;
+
+	const ::size_t id = Instrumentation::Register("Test::Traced");
+
+	// Nothing is recorded before Start().
+	{
+		ScopedTimer timer(id);
+	}
+	Tracer::Start(8);
+	if (!Tracer::IsEnabled() ||
+		CountOf(Tracer::ToJson(), "\"name\": \"Test::Traced\"") != 0)
+		throw std::logic_error("Tracer::Start()");
+
+	// Each thread has its own timeline, and events beyond the capacity are dropped.
+	for (int I = 0; I != 3; ++I)
+	{
+		ScopedTimer timer(id);
+	}
+	std::thread worker([id]
+	{
+		Tracer::SetThreadName("Worker \"1\"");
+		for (int I = 0; I != 10; ++I)
+		{
+			ScopedTimer timer(id);
+		}
+	});
+	worker.join();
+	Tracer::Stop();
+	{
+		ScopedTimer timer(id);
+	}
+
+	const std::string json = Tracer::ToJson();
+	if (CountOf(json, "\"name\": \"Test::Traced\", \"cat\": \"imaging\", "
+		"\"ph\": \"X\"") != 11 ||
+		CountOf(json, "\"args\": {\"name\": \"Worker \\\"1\\\"\"}") != 1 ||
+		Tracer::GetDroppedCount() != 2 ||
+		json.find("\"dropped_events\": \"2\"") == std::string::npos)
+		throw std::logic_error("Tracer::ToJson()");
+
+	const std::string path = "trace_test.json";
+	Tracer::Write(path);
+	std::ifstream in(path);
+	std::ostringstream text;
+	text << in.rdbuf();
+	in.close();
+	std::remove(path.c_str());
+	if (text.str() != json)
+		throw std::logic_error("Tracer::Write()");
+
+	// Events of an earlier run are discarded.
+	Tracer::Start();
+	Tracer::Stop();
+	if (CountOf(Tracer::ToJson(), "\"ph\": \"X\"") != 0 || Tracer::GetDroppedCount() != 0)
+		throw std::logic_error("Tracer::Start()");
+}
+
+void TestInstrumentation(void)
+{
+	std::cout << std::endl << "Test for instrumentation.h has started." << std::endl;
+	TestInstrumentationRegistry();
+	TestInstrumentedPrimitives();
+	TestTracer();
+	std::cout << "Test for instrumentation.h has been completed." << std::endl;
+}
@@ -0,0 +1,107 @@
+/** This file contains the test functions to test classes and functions defined in
+integral_image.h */
+#include "../Imaging/integral_image.h"
+#include "../Utilities/parallel.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <random>
+#include <algorithm>
+
+template <typename T>
+void TestIntegralImage(::size_t width, ::size_t height, ::size_t depth)
+{
+	using namespace Imaging;
+	typedef typename ImageFrame<T>::SizeType SizeType;
+
+	// Fill the image with random samples.
+	std::mt19937 gen(1);
+	std::uniform_int_distribution<int> sample(0, 200);
+	std::vector<T> src(width * height * depth);
+	for (auto it = src.begin(); it != src.end(); ++it)
+		*it = static_cast<T>(sample(gen) - (std::is_signed<T>::value ? 100 : 0));
+	ImageFrame<T> img(std::move(src), Size2D<SizeType>(width, height), depth);
+
+	IntegralImage<T> integral(img);
+	if (integral.GetSize() != img.size)
+		throw std::logic_error("IntegralImage<T>::GetSize()");
+
+	// Compare against brute force sums over several regions.
+	std::vector<Region<SizeType, SizeType>> rois;
+	rois.push_back(Region<SizeType, SizeType>(0, 0, width, height));
+	rois.push_back(Region<SizeType, SizeType>(1, 2, width / 2, height / 3));
+	rois.push_back(Region<SizeType, SizeType>(width - 1, height - 1, 1, 1));
+	for (auto it = rois.cbegin(); it != rois.cend(); ++it)
+		for (SizeType C = 0; C != depth; ++C)
+		{
+			double sum = 0.0, sumSq = 0.0;
+			for (SizeType Y = it->origin.y; Y != it->origin.y + it->size.height; ++Y)
+				for (SizeType X = it->origin.x; X != it->origin.x + it->size.width; ++X)
+				{
+					double v = static_cast<double>(*img.GetPointer(X, Y, C));
+					sum += v;
+					sumSq += v * v;
+				}
+			double n = static_cast<double>(it->GetArea());
+			double var = sumSq / n - (sum / n) * (sum / n);
+			if (static_cast<double>(integral.Sum(*it, C)) != sum)
+				throw std::logic_error("IntegralImage<T>::Sum()");
+			if (static_cast<double>(integral.SumOfSquares(*it, C)) != sumSq)
+				throw std::logic_error("IntegralImage<T>::SumOfSquares()");
+			if (std::abs(integral.Mean(*it, C) - sum / n) > 1e-9 ||
+				std::abs(integral.Variance(*it, C) - var) > 1e-6 * (1.0 + var))
+				throw std::logic_error("IntegralImage<T>::Mean() or Variance()");
+		}
+
+	try
+	{
+		integral.Sum(Region<SizeType, SizeType>(1, 0, width, height));
+		throw std::logic_error("IntegralImage<T>::Sum()");
+	}
+	catch (const std::out_of_range &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	std::cout << "Integral image of " << typeid(T).name() << " " << width << " x " <<
+		height << " x " << depth << " was successful." << std::endl;
+}
+
+void TestIntegralImageOverflow(void)
+{
+	using namespace Imaging;
+
+	static_assert(std::is_same<IntegralImage<unsigned char>::SumType, unsigned int>::value,
+		"8-bit samples are summed in 32-bit by default.");
+
+	// 4200 x 4200 x 255 exceeds the range of unsigned int, and not that of a 64-bit sum.
+	ImageFrame<unsigned char> img(4200, 4200);
+	std::fill(img.GetPointer(0, 0), img.GetPointer(0, 0) + img.data.size(), 255);
+	try
+	{
+		IntegralImage<unsigned char> integral(img, false);
+		throw std::logic_error("IntegralImage<T>::Build()");
+	}
+	catch (const std::overflow_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	IntegralImage<unsigned char, unsigned long long> integral(img, false);
+	if (integral.Sum(Region<::size_t, ::size_t>(0, 0, 4200, 4200)) != 4200ull * 4200 * 255 ||
+		integral.Mean(Region<::size_t, ::size_t>(100, 200, 3000, 4000)) != 255.0)
+		throw std::logic_error("IntegralImage<T>::Build()");
+}
+
+void TestIntegralImages(void)
+{
+	std::cout << std::endl << "Test for integral_image.h has started." << std::endl;
+	TestIntegralImage<unsigned char>(640, 480, 3);
+	Imaging::SetThreadCount(4);		// force the parallel path on any machine
+	TestIntegralImage<unsigned char>(640, 480, 3);
+	Imaging::SetThreadCount(0);
+	TestIntegralImage<unsigned short>(333, 257, 1);
+	TestIntegralImage<short>(100, 70, 2);
+	TestIntegralImage<float>(257, 129, 4);
+	TestIntegralImageOverflow();
+	std::cout << "Test for integral_image.h has been completed." << std::endl;
+}
@@ -0,0 +1,291 @@
+/** This file contains the test functions to test classes and functions defined in
+kernels.h */
+#include "../Imaging/kernels.h"
+#include "../Imaging/image.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/** Compares the bytes of two arrays, since swapped floating point values may be NaN. */
+template <typename T>
+bool IsSame(const std::vector<T> &a, const std::vector<T> &b)
+{
+	return a.size() == b.size() && (a.empty() ||
+		std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+/** Compares the kernels of the current level with a plain transposition for elements of
+type T, for every number of bands up to 9 and odd numbers of samples. */
+template <typename T>
+void TestKernelsOf(void)
+{
+	using namespace Imaging;
+
+	const int index = GetKernelIndex<T>();
+	for (::size_t nBands = 1; nBands != 10; ++nBands)
+		for (::size_t nSamples : {0, 1, 7, 131})
+			for (bool swap : {false, true})
+			{
+				std::vector<T> src(nBands * nSamples), dst(src.size()), ref(src.size());
+				for (::size_t I = 0; I != src.size(); ++I)
+					src[I] = static_cast<T>(0x0102030405060708ull * (I + 1));
+				for (::size_t B = 0; B != nBands; ++B)
+					for (::size_t I = 0; I != nSamples; ++I)
+					{
+						T value = src[nSamples * B + I];
+						ref[nBands * I + B] = swap ? SwapBytes(value) : value;
+					}
+
+				GetKernels().transposeToBip[index](src.data(), nBands, nSamples, dst.data(),
+					swap);
+				if (!IsSame(dst, ref))
+					throw std::logic_error("KernelTable::transposeToBip");
+			}
+
+	std::vector<T> src(257), dst(src.size()), ref(src.size());
+	for (::size_t I = 0; I != src.size(); ++I)
+	{
+		src[I] = static_cast<T>(0x0102030405060708ull * (I + 1));
+		ref[I] = SwapBytes(src[I]);
+	}
+	GetKernels().copySwapped[index](src.data(), src.size(), dst.data());
+	if (!IsSame(dst, ref))
+		throw std::logic_error("KernelTable::copySwapped");
+
+	// In place.
+	GetKernels().copySwapped[index](dst.data(), dst.size(), dst.data());
+	if (!IsSame(dst, src))
+		throw std::logic_error("KernelTable::copySwapped");
+}
+
+/** Compares the pixel kernels of the current level with plain copies for pixels of 1 to 8
+bytes, for partial tiles and lines walked bottom up. */
+void TestPixelKernels(void)
+{
+	using namespace Imaging;
+
+	const ::size_t w = 19, h = 13;
+	for (::size_t N = 1; N != 9; ++N)
+	{
+		std::vector<unsigned char> src(w * h * N), dst(src.size()), ref(src.size());
+		for (::size_t I = 0; I != src.size(); ++I)
+			src[I] = static_cast<unsigned char>(I * 13 + 5);
+
+		// Transposition of the lines bottom up is a rotation by 90 degrees.
+		for (::size_t Y = 0; Y != h; ++Y)
+			for (::size_t X = 0; X != w; ++X)
+				for (::size_t B = 0; B != N; ++B)
+					ref[(h * X + Y) * N + B] = src[(w * (h - 1 - Y) + X) * N + B];
+		const ::ptrdiff_t stride = static_cast<::ptrdiff_t>(w * N);
+		GetKernels().transposePixels[N - 1](src.data() + stride * (h - 1), -stride, w, h,
+			dst.data(), static_cast<::ptrdiff_t>(h * N));
+		if (dst != ref)
+			throw std::logic_error("KernelTable::transposePixels");
+
+		// In place.
+		for (::size_t I = 0; I != w * h; ++I)
+			for (::size_t B = 0; B != N; ++B)
+				ref[I * N + B] = src[(w * h - 1 - I) * N + B];
+		dst = src;
+		GetKernels().reversePixels[N - 1](dst.data(), w * h, dst.data());
+		if (dst != ref)
+			throw std::logic_error("KernelTable::reversePixels");
+	}
+}
+
+/** Compares the fused blur and decimation of 5 lines with the weighted sums of the
+reflected pixels, for ranges of pixels with and without the ends of the lines. Floating
+point samples are kept small, so their sums are exact. */
+template <typename T>
+void TestReduceKernels(void)
+{
+	using namespace Imaging;
+
+	const unsigned weights[] = {1, 4, 6, 4, 1};
+	for (::size_t w : {1, 2, 3, 7, 40})
+		for (::size_t d = 1; d != 6; ++d)
+		{
+			std::vector<T> src(5 * w * d);
+			for (::size_t I = 0; I != src.size(); ++I)
+				src[I] = static_cast<T>((I * 2654435761u >> 7) &
+					(std::is_floating_point<T>::value ? 1023 : ~0u));
+			const void *lines[5];
+			for (::size_t I = 0; I != 5; ++I)
+				lines[I] = src.data() + w * d * I;
+			const ::size_t wDst = (w + 1) / 2;
+			for (::size_t first : {::size_t(0), wDst / 2})
+			{
+				std::vector<T> dst((wDst - first) * d);
+				std::vector<typename std::conditional<std::is_floating_point<T>::value, T,
+					unsigned>::type> buffer((2 * (wDst - first) + 4) * d);
+				GetKernels().reduceLines[GetKernelIndex<T>()](lines, w, d, first, wDst,
+					dst.data(), buffer.data());
+				for (::size_t X = first; X != wDst; ++X)
+					for (::size_t C = 0; C != d; ++C)
+					{
+						unsigned long long sum = 0;
+						for (int J = 0; J != 5; ++J)
+						{
+							// Reflected without repeating the edge pixel.
+							::ptrdiff_t x = 2 * static_cast<::ptrdiff_t>(X) + J - 2;
+							const ::ptrdiff_t n = static_cast<::ptrdiff_t>(w);
+							while (n > 1 && (x < 0 || x >= n))
+								x = x < 0 ? -x : 2 * (n - 1) - x;
+							x = n > 1 ? x : 0;
+							for (::size_t I = 0; I != 5; ++I)
+								sum += weights[I] * weights[J] *
+									static_cast<unsigned long long>(
+									src[(w * I + static_cast<::size_t>(x)) * d + C]);
+						}
+						const T expected = std::is_floating_point<T>::value ?
+							static_cast<T>(sum / 256.0) : static_cast<T>((sum + 128) >> 8);
+						if (dst[(X - first) * d + C] != expected)
+							throw std::logic_error("KernelTable::reduceLines");
+					}
+			}
+		}
+}
+
+/** Compares the minimums and maximums of two arrays with std::min() and std::max(), also
+in place. */
+template <typename T>
+void TestMinMaxKernels(void)
+{
+	using namespace Imaging;
+
+	const ::size_t n = 77;
+	std::vector<T> a(n), b(n), dst(n), ref(n);
+	for (::size_t I = 0; I != n; ++I)
+	{
+		a[I] = static_cast<T>(I * 2654435761u >> 5);
+		b[I] = static_cast<T>(I * 40503u + 7);
+	}
+	for (::size_t I = 0; I != n; ++I)
+		ref[I] = std::min(a[I], b[I]);
+	GetKernels().minSamples[GetKernelIndex<T>()](a.data(), b.data(), n, dst.data());
+	if (dst != ref)
+		throw std::logic_error("KernelTable::minSamples");
+	for (::size_t I = 0; I != n; ++I)
+		ref[I] = std::max(a[I], b[I]);
+	GetKernels().maxSamples[GetKernelIndex<T>()](a.data(), b.data(), n, a.data());
+	if (a != ref)
+		throw std::logic_error("KernelTable::maxSamples");
+}
+
+/** Compares gray and YUV conversions of pixels of 3 and 4 elements in both orders with
+their formulas, also YUV in place. */
+void TestColorKernels(void)
+{
+	using namespace Imaging;
+
+	const ::size_t n = 77;
+	const YuvCoefficients k = {66, 129, 25, -38, -74, 112, 112, -94, -18, 16, 298, 409, 100,
+		208, 516};
+	auto saturate = [](int v)
+	{
+		return static_cast<unsigned char>(v < 0 ? 0 : (v > 255 ? 255 : v));
+	};
+	for (::size_t d = 3; d != 5; ++d)
+		for (::size_t posR = 0; posR <= 2; posR += 2)
+		{
+			std::vector<unsigned char> src(d * n), gray(n), yuv(3 * n), color(3 * n);
+			std::vector<unsigned short> src16(d * n), gray16(n);
+			for (::size_t I = 0; I != src.size(); ++I)
+			{
+				src[I] = static_cast<unsigned char>(I * 2654435761u >> 9);
+				src16[I] = static_cast<unsigned short>(I * 2654435761u >> 3);
+			}
+			GetKernels().colorToGray[0](src.data(), d, n, posR, gray.data());
+			GetKernels().colorToGray[1](src16.data(), d, n, posR, gray16.data());
+			GetKernels().colorToYuv(src.data(), d, n, posR, k, yuv.data());
+			GetKernels().yuvToColor(yuv.data(), n, posR, k, color.data());
+			for (::size_t P = 0; P != n; ++P)
+			{
+				const unsigned char *p = src.data() + d * P;
+				const int r = p[posR], g = p[1], b = p[2 - posR];
+				const int r16 = src16[d * P + posR], g16 = src16[d * P + 1],
+					b16 = src16[d * P + 2 - posR];
+				if (gray[P] != (77 * r + 150 * g + 29 * b + 128) >> 8 ||
+					gray16[P] != (77 * r16 + 150 * g16 + 29 * b16 + 128) >> 8)
+					throw std::logic_error("KernelTable::colorToGray");
+				const int y = (66 * r + 129 * g + 25 * b + 128) >> 8;
+				const int cb = (-38 * r - 74 * g + 112 * b + 128) >> 8;
+				const int cr = (112 * r - 94 * g - 18 * b + 128) >> 8;
+				if (yuv[3 * P] != saturate(16 + y) || yuv[3 * P + 1] != saturate(128 + cb) ||
+					yuv[3 * P + 2] != saturate(128 + cr))
+					throw std::logic_error("KernelTable::colorToYuv");
+				const int c = 298 * (yuv[3 * P] - 16) + 128, e = yuv[3 * P + 2] - 128;
+				const int u = yuv[3 * P + 1] - 128;
+				if (color[3 * P + posR] != saturate((c + 409 * e) >> 8) ||
+					color[3 * P + 1] != saturate((c - 100 * u - 208 * e) >> 8) ||
+					color[3 * P + 2 - posR] != saturate((c + 516 * u) >> 8))
+					throw std::logic_error("KernelTable::yuvToColor");
+			}
+			if (d == 3)
+			{
+				GetKernels().colorToYuv(src.data(), d, n, posR, k, src.data());
+				if (src != yuv)
+					throw std::logic_error("KernelTable::colorToYuv");
+			}
+		}
+}
+
+void TestKernelLevels(void)
+{
+	using namespace Imaging;
+
+	const SimdLevel best = GetKernelLevel();
+	if (!IsKernelLevelAvailable(best) || !IsKernelLevelAvailable(SimdLevel::BASELINE) ||
+		static_cast<int>(best) > static_cast<int>(GetCpuSimdLevel()))
+		throw std::logic_error("GetKernelLevel()");
+	std::cout << "CPU: " << GetSimdLevelName(GetCpuSimdLevel()) << ", kernels: " <<
+		GetSimdLevelName(best) << std::endl;
+
+	const SimdLevel levels[] = {SimdLevel::BASELINE, SimdLevel::SSE41, SimdLevel::AVX2,
+		SimdLevel::AVX512};
+	for (auto level : levels)
+	{
+		if (!IsKernelLevelAvailable(level))
+		{
+			// Unavailable levels are refused, and the current level is kept.
+			try
+			{
+				SetKernelLevel(level);
+			}
+			catch (const std::invalid_argument &)
+			{
+				continue;
+			}
+			throw std::logic_error("SetKernelLevel()");
+		}
+
+		SetKernelLevel(level);
+		if (GetKernelLevel() != level)
+			throw std::logic_error("SetKernelLevel()");
+		TestKernelsOf<unsigned char>();
+		TestKernelsOf<unsigned short>();
+		TestKernelsOf<float>();
+		TestKernelsOf<double>();
+		TestKernelsOf<long long>();
+		TestPixelKernels();
+		TestReduceKernels<unsigned char>();
+		TestReduceKernels<unsigned short>();
+		TestReduceKernels<float>();
+		TestMinMaxKernels<unsigned char>();
+		TestMinMaxKernels<unsigned short>();
+		TestMinMaxKernels<float>();
+		TestColorKernels();
+	}
+	SetKernelLevel(best);
+}
+
+void TestKernels(void)
+{
+	std::cout << std::endl << "Test for kernels.h has started." << std::endl;
+	TestKernelLevels();
+	std::cout << "Test for kernels.h has been completed." << std::endl;
+}
@@ -0,0 +1,115 @@
+/** This file contains the test functions to test classes and functions defined in
+lookup_table.h */
+#include "../Imaging/lookup_table.h"
+#include "../Utilities/parallel.h"
+
+#include <stdexcept>
+#include <iostream>
+
+template <typename T>
+Imaging::ImageFrame<T> MakeRamp(::size_t width, ::size_t height, ::size_t depth)
+{
+	std::vector<T> src(width * height * depth);
+	for (::size_t I = 0; I != src.size(); ++I)
+		src[I] = static_cast<T>(I * 7);
+	return Imaging::ImageFrame<T>(std::move(src),
+		Imaging::Size2D<::size_t>(width, height), depth);
+}
+
+void TestSharedLookupTable(void)
+{
+	using namespace Imaging;
+
+	ImageFrame<unsigned char> img = MakeRamp<unsigned char>(64, 48, 3), dst;
+	LookupTable<unsigned char, unsigned char> lut(1);
+	SetThreshold<unsigned char>(127, lut);
+	Apply(img, lut, dst);
+	for (::size_t I = 0; I != img.data.size(); ++I)
+		if (dst.data[I] != (img.data[I] > 127 ? 255 : 0))
+			throw std::logic_error("Apply(SetThreshold)");
+
+	// Gamma of 1 is the identity, applied in place.
+	ImageFrame<unsigned char> img2 = img;
+	SetGamma(1.0, lut);
+	Apply(img2, lut);
+	if (img2.data != img.data)
+		throw std::logic_error("Apply(SetGamma)");
+
+	// 16-bit to float with contrast stretch.
+	ImageFrame<unsigned short> img3 = MakeRamp<unsigned short>(100, 10, 1);
+	ImageFrame<float> dst3;
+	LookupTable<unsigned short, float> lut3(1);
+	SetContrastStretch<unsigned short, float>(1000, 3000, lut3);
+	Apply(img3, lut3, dst3);
+	for (::size_t I = 0; I != img3.data.size(); ++I)
+	{
+		double expected = std::min(1.0, std::max(0.0, (img3.data[I] - 1000.0) / 2000.0));
+		if (std::abs(dst3.data[I] - expected) > 1e-6)
+			throw std::logic_error("Apply(SetContrastStretch)");
+	}
+
+	std::cout << "Shared lookup tables were successful." << std::endl;
+}
+
+void TestPerChannelLookupTable(void)
+{
+	using namespace Imaging;
+
+	// Per-channel tables of signed 16-bit samples.
+	ImageFrame<short> img = MakeRamp<short>(32, 32, 2);
+	LookupTable<short, int> lut(2, [](short v, ::size_t c)
+	{
+		return c == 0 ? static_cast<int>(v) : -static_cast<int>(v);
+	});
+	ImageFrame<int> dst;
+	Apply(img, lut, dst);
+	for (::size_t I = 0; I != img.data.size(); ++I)
+		if (dst.data[I] != (I % 2 == 0 ? img.data[I] : -img.data[I]))
+			throw std::logic_error("Apply(per-channel)");
+
+	// Color map from a single channel into 3 channels.
+	ImageFrame<unsigned char> mono = MakeRamp<unsigned char>(16, 16, 1), color;
+	LookupTable<unsigned char, unsigned char> colorMap(3, [](unsigned char v, ::size_t c)
+	{
+		return static_cast<unsigned char>(c == 1 ? 255 - v : v);
+	});
+	Apply(mono, colorMap, color);
+	if (color.depth != 3 || *color.GetPointer(1, 0, 1) != 255 - *mono.GetPointer(1, 0))
+		throw std::logic_error("Apply(color map)");
+
+	try
+	{
+		Apply(mono, colorMap);
+		throw std::logic_error("Apply(color map)");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	// A table of mismatched channels leaves the destination untouched.
+	const ImageFrame<int> previous = dst;
+	try
+	{
+		Apply(ImageFrame<short>(4, 4, 3), lut, dst);
+		throw std::logic_error("Apply(per-channel)");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	if (dst.size != previous.size || dst.depth != previous.depth || dst.data != previous.data)
+		throw std::logic_error("Apply(per-channel)");
+
+	std::cout << "Per-channel lookup tables were successful." << std::endl;
+}
+
+void TestLookupTables(void)
+{
+	std::cout << std::endl << "Test for lookup_table.h has started." << std::endl;
+	TestSharedLookupTable();
+	Imaging::SetThreadCount(4);		// force the parallel path on any machine
+	TestPerChannelLookupTable();
+	Imaging::SetThreadCount(0);
+	std::cout << "Test for lookup_table.h has been completed." << std::endl;
+}
@@ -0,0 +1,95 @@
+/** This file contains the test functions to test classes and functions defined in
+memory_tracker.h */
+#include "../Utilities/memory_tracker.h"
+#include "../Utilities/instrumentation.h"
+#include "../Imaging/image.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <vector>
+
+// Keeps allocated blocks from being optimized out.
+volatile unsigned char memoryTrackerSink;
+
+/** Checks the counters of the program around the lifetime of a frame. */
+void TestMemoryTrackerCounters(void)
+{
+	using namespace Imaging;
+
+	if (!MemoryTracker::IsInstalled())
+		throw std::logic_error("MemoryTracker::IsInstalled()");
+
+	const unsigned long long live = MemoryTracker::GetLiveBytes();
+	const unsigned long long count = MemoryTracker::GetAllocationCount();
+	MemoryTracker::ResetPeak();
+	{
+		ImageFrame<unsigned short> img(100, 100, 3);
+		*img.GetPointer(99, 99, 2) = 7;
+		memoryTrackerSink = static_cast<unsigned char>(*img.GetPointer(99, 99, 2));
+		if (MemoryTracker::GetLiveBytes() < live + 60000 ||
+			MemoryTracker::GetAllocationCount() < count + 1)
+			throw std::logic_error("MemoryTracker::Allocate()");
+	}
+	if (MemoryTracker::GetLiveBytes() != live || MemoryTracker::GetPeakBytes() < live + 60000)
+		throw std::logic_error("MemoryTracker::Free()");
+
+	// A conversion into a destination of the right size allocates nothing.
+	std::vector<unsigned short> src(3 * 64 * 48), dst(src.size());
+	const unsigned long long before = MemoryTracker::GetAllocationCount();
+	BsqToBip(src.data(), 3, 64 * 48, dst);
+	BilToBip(src.data(), 3, 64, 48, dst);
+	if (MemoryTracker::GetAllocationCount() != before)
+		throw std::logic_error("BsqToBip()");
+}
+
+/** Allocations are charged to every open scope, and the peak of a scope is measured from
+the bytes held when it was opened. */
+void TestAllocationScopes(void)
+{
+	using namespace Imaging;
+
+	const ::size_t outer = Instrumentation::Register("Test::Outer");
+	const ::size_t inner = Instrumentation::Register("Test::Inner");
+	std::vector<unsigned char> held(500);
+	MemoryTracker::ResetOperations();
+	{
+		AllocationScope scopeOuter(outer);
+		std::vector<unsigned char> a(1000);
+		memoryTrackerSink = a[999];
+		{
+			AllocationScope scopeInner(inner);
+			std::vector<unsigned char> b(3000);
+			memoryTrackerSink = b[2999];
+		}
+		std::vector<unsigned char> c(2000);
+		memoryTrackerSink = c[1999];
+	}
+	memoryTrackerSink = held[0];
+
+	const AllocationTotals o = MemoryTracker::GetOperation(outer);
+	const AllocationTotals i = MemoryTracker::GetOperation(inner);
+	if (o.allocations != 3 || o.bytes != 6000 || o.peakBytes != 4000 ||
+		i.allocations != 1 || i.bytes != 3000 || i.peakBytes != 3000)
+		throw std::logic_error("AllocationScope");
+
+#if defined(IMAGING_INSTRUMENTATION)
+	// A copy of an ROI into a new frame allocates the frame once, and nothing after.
+	ImageFrame<unsigned char> imgSrc(64, 48, 3), imgDst;
+	const Region<::size_t, ::size_t> roi(8, 8, 32, 16);
+	Instrumentation::Reset();
+	imgSrc.CopyTo(roi, imgDst);
+	imgSrc.CopyTo(roi, imgDst);
+	for (const auto &s : Instrumentation::GetStats())
+		if (s.name == "ImageFrame::CopyTo" && (s.calls != 2 || s.allocations.allocations != 1 ||
+			s.allocations.bytes != 32 * 16 * 3 || s.allocations.peakBytes != 32 * 16 * 3))
+			throw std::logic_error("ImageFrame::CopyTo()");
+#endif
+}
+
+void TestMemoryTracker(void)
+{
+	std::cout << std::endl << "Test for memory_tracker.h has started." << std::endl;
+	TestMemoryTrackerCounters();
+	TestAllocationScopes();
+	std::cout << "Test for memory_tracker.h has been completed." << std::endl;
+}
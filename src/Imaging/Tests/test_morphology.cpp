@@ -0,0 +1,183 @@
+/** This file contains the test functions to test functions defined in morphology.h */
+#include "../Imaging/morphology.h"
+#include "tests.h"
+
+#include <limits>
+#include <stdexcept>
+#include <iostream>
+#include <string>
+
+/** Erodes or dilates every sample by the minimum or the maximum over the pixels of an
+element inside the image; the element is reflected for dilation. */
+template <typename T>
+Imaging::ImageFrame<T> GetMorphologyReference(const Imaging::ImageFrame<T> &img,
+	const Imaging::ImageFrame<unsigned char> &element, bool dilate)
+{
+	const ::ptrdiff_t w = static_cast<::ptrdiff_t>(img.size.width);
+	const ::ptrdiff_t h = static_cast<::ptrdiff_t>(img.size.height);
+	const ::ptrdiff_t ax = static_cast<::ptrdiff_t>(element.size.width / 2);
+	const ::ptrdiff_t ay = static_cast<::ptrdiff_t>(element.size.height / 2);
+	Imaging::ImageFrame<T> imgDst(img.size, img.depth);
+	for (::ptrdiff_t Y = 0; Y != h; ++Y)
+		for (::ptrdiff_t X = 0; X != w; ++X)
+			for (::size_t C = 0; C != img.depth; ++C)
+			{
+				T value = dilate ? std::numeric_limits<T>::lowest() :
+					std::numeric_limits<T>::max();
+				const ::ptrdiff_t wElement = static_cast<::ptrdiff_t>(element.size.width);
+				const ::ptrdiff_t hElement = static_cast<::ptrdiff_t>(element.size.height);
+				for (::ptrdiff_t J = 0; J != hElement; ++J)
+					for (::ptrdiff_t I = 0; I != wElement; ++I)
+					{
+						const ::ptrdiff_t x = dilate ? X - (I - ax) : X + (I - ax);
+						const ::ptrdiff_t y = dilate ? Y - (J - ay) : Y + (J - ay);
+						if (*element.GetPointer(I, J) == 0 || x < 0 || x >= w || y < 0 ||
+							y >= h)
+							continue;
+						const T v = *img.GetPointer(x, y, C);
+						value = dilate ? std::max(value, v) : std::min(value, v);
+					}
+				*imgDst.GetPointer(X, Y, C) = value;
+			}
+	return imgDst;
+}
+
+Imaging::ImageFrame<unsigned char> GetElement(::size_t width, ::size_t height,
+	const std::vector<unsigned char> &pixels = std::vector<unsigned char>())
+{
+	return Imaging::ImageFrame<unsigned char>(pixels.empty() ?
+		std::vector<unsigned char>(width * height, 1) : pixels,
+		Imaging::Size2D<::size_t>(width, height), 1);
+}
+
+/** Compares every operation by rectangles, including even sizes, runs filtered by van
+Herk and Gil-Werman, and rectangles larger than the image, and by other elements with
+the reference. Opening, closing and filtering in place reuse a buffer across sizes. */
+template <typename T>
+void TestMorphologies(::size_t depth, bool binary)
+{
+	using namespace Imaging;
+
+	const std::string name = "Morphology<" + std::to_string(sizeof(T)) + ">";
+	const Size2D<::size_t> sizes[] = {Size2D<::size_t>(1, 1), Size2D<::size_t>(37, 23),
+		Size2D<::size_t>(131, 70)};
+	const Size2D<::size_t> rectangles[] = {Size2D<::size_t>(1, 1), Size2D<::size_t>(3, 3),
+		Size2D<::size_t>(2, 4), Size2D<::size_t>(8, 1), Size2D<::size_t>(1, 9),
+		Size2D<::size_t>(9, 8), Size2D<::size_t>(21, 17), Size2D<::size_t>(150, 3),
+		Size2D<::size_t>(3, 90)};
+	const ImageFrame<unsigned char> elements[] = {
+		GetElement(3, 3, {0, 1, 0, 1, 1, 1, 0, 1, 0}),
+		GetElement(2, 3, {1, 0, 1, 0, 1, 1}),
+		GetElement(5, 5, {0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1, 1, 1, 0, 0, 0,
+		1, 0, 0})};
+	MorphologyBuffer<T> buffer;
+	for (const auto &sz : sizes)
+	{
+		ImageFrame<T> img = GetHashedImage<T>(sz.width, sz.height, depth, 11,
+			binary ? 5 : 1000);
+		for (::size_t I = 0; binary && I != img.data.size(); ++I)
+			*(img.GetPointer(0, 0) + I) = static_cast<T>(img.data[I] != 0 ? 255 : 0);
+		for (const auto &rect : rectangles)
+		{
+			const ImageFrame<unsigned char> element = GetElement(rect.width, rect.height);
+			const ImageFrame<T> eroded = GetMorphologyReference(img, element, false);
+			const ImageFrame<T> dilated = GetMorphologyReference(img, element, true);
+			ImageFrame<T> imgDst;
+			Erode(img, rect, imgDst);
+			if (imgDst.data != eroded.data)
+				throw std::logic_error(name + " Erode()");
+			Dilate(img, rect, imgDst);
+			if (imgDst.data != dilated.data)
+				throw std::logic_error(name + " Dilate()");
+			Open(img, rect, imgDst, buffer);
+			if (imgDst.data != GetMorphologyReference(eroded, element, true).data)
+				throw std::logic_error(name + " Open()");
+			Close(img, rect, imgDst, buffer);
+			if (imgDst.data != GetMorphologyReference(dilated, element, false).data)
+				throw std::logic_error(name + " Close()");
+
+			// In place.
+			imgDst = img;
+			Erode(imgDst, rect, imgDst, buffer);
+			if (imgDst.data != eroded.data)
+				throw std::logic_error(name + " Erode() in place");
+		}
+
+		for (const auto &element : elements)
+		{
+			const ImageFrame<T> eroded = GetMorphologyReference(img, element, false);
+			const ImageFrame<T> dilated = GetMorphologyReference(img, element, true);
+			ImageFrame<T> imgDst;
+			Erode(img, element, imgDst);
+			if (imgDst.data != eroded.data)
+				throw std::logic_error(name + " Erode() by an element");
+			Dilate(img, element, imgDst);
+			if (imgDst.data != dilated.data)
+				throw std::logic_error(name + " Dilate() by an element");
+
+			// Opening never brightens and closing never darkens, also without symmetry.
+			ImageFrame<T> imgOpen, imgClose;
+			Open(img, element, imgOpen, buffer);
+			Close(img, element, imgClose);
+			for (::size_t I = 0; I != img.data.size(); ++I)
+				if (imgOpen.data[I] > img.data[I] || imgClose.data[I] < img.data[I])
+					throw std::logic_error(name + " Open() and Close() by an element");
+			if (imgOpen.data != GetMorphologyReference(eroded, element, true).data)
+				throw std::logic_error(name + " Open() by an element");
+
+			imgDst = img;
+			Dilate(imgDst, element, imgDst);
+			if (imgDst.data != dilated.data)
+				throw std::logic_error(name + " Dilate() in place by an element");
+		}
+	}
+}
+
+void TestMorphologyExceptions(void)
+{
+	using namespace Imaging;
+
+	const ImageFrame<unsigned char> img(10, 12, 1);
+	ImageFrame<unsigned char> imgDst;
+	try
+	{
+		Erode(img, Size2D<::size_t>(0, 3), imgDst);
+		throw std::logic_error("Erode()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	try
+	{
+		Dilate(img, GetElement(3, 3, std::vector<unsigned char>(9, 0)), imgDst);
+		throw std::logic_error("Dilate()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	// Empty images are kept empty.
+	const ImageFrame<unsigned char> imgEmpty;
+	Close(imgEmpty, Size2D<::size_t>(3, 3), imgDst);
+	if (!imgDst.data.empty())
+		throw std::logic_error("Close()");
+}
+
+void TestMorphologies(void)
+{
+	std::cout << std::endl << "Test for morphology.h has started." << std::endl;
+	Imaging::SetThreadCount(4);		// force the bands of each thread on any machine
+	TestMorphologies<unsigned char>(1, true);
+	TestMorphologies<unsigned char>(1, false);
+	TestMorphologies<unsigned char>(3, false);
+	TestMorphologies<unsigned short>(1, false);
+	TestMorphologies<short>(1, false);
+	TestMorphologies<float>(2, false);
+	TestMorphologies<double>(1, true);
+	Imaging::SetThreadCount(0);
+	TestMorphologyExceptions();
+	std::cout << "Test for morphology.h has been completed." << std::endl;
+}
@@ -0,0 +1,205 @@
+/** This file contains the test functions to test functions defined in orientation.h */
+#include "../Imaging/orientation.h"
+#include "tests.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <string>
+
+/** Source position (x, y) of every destination pixel of each operation. */
+enum class Orientation {ROTATE90, ROTATE180, ROTATE270, FLIP_HORIZONTAL, FLIP_VERTICAL,
+	TRANSPOSE};
+
+std::string GetOrientationName(Orientation orientation)
+{
+	return "Orient(" + std::to_string(static_cast<int>(orientation)) + ")";
+}
+
+template <typename T>
+void Orient(Orientation orientation, const Imaging::ImageFrame<T> &imgSrc,
+	Imaging::ImageFrame<T> &imgDst)
+{
+	using namespace Imaging;
+	switch (orientation)
+	{
+	case Orientation::ROTATE90:
+		return Rotate90(imgSrc, imgDst);
+	case Orientation::ROTATE180:
+		return Rotate180(imgSrc, imgDst);
+	case Orientation::ROTATE270:
+		return Rotate270(imgSrc, imgDst);
+	case Orientation::FLIP_HORIZONTAL:
+		return FlipHorizontal(imgSrc, imgDst);
+	case Orientation::FLIP_VERTICAL:
+		return FlipVertical(imgSrc, imgDst);
+	default:
+		return Transpose(imgSrc, imgDst);
+	}
+}
+
+template <typename T>
+void Orient(Orientation orientation, Imaging::ImageFrame<T> &img)
+{
+	using namespace Imaging;
+	switch (orientation)
+	{
+	case Orientation::ROTATE90:
+		return Rotate90(img);
+	case Orientation::ROTATE180:
+		return Rotate180(img);
+	case Orientation::ROTATE270:
+		return Rotate270(img);
+	case Orientation::FLIP_HORIZONTAL:
+		return FlipHorizontal(img);
+	case Orientation::FLIP_VERTICAL:
+		return FlipVertical(img);
+	default:
+		return Transpose(img);
+	}
+}
+
+/** Checks every sample of an oriented image against its source pixel. */
+template <typename T>
+bool IsOriented(Orientation orientation, const Imaging::ImageFrame<T> &imgSrc,
+	const Imaging::ImageFrame<T> &imgDst)
+{
+	const ::size_t w = imgSrc.size.width, h = imgSrc.size.height;
+	const bool swapped = orientation == Orientation::ROTATE90 ||
+		orientation == Orientation::ROTATE270 || orientation == Orientation::TRANSPOSE;
+	if (imgDst.depth != imgSrc.depth || imgDst.size.width != (swapped ? h : w) ||
+		imgDst.size.height != (swapped ? w : h))
+		return false;
+	for (::size_t Y = 0; Y != imgDst.size.height; ++Y)
+		for (::size_t X = 0; X != imgDst.size.width; ++X)
+		{
+			::size_t x = X, y = Y;
+			switch (orientation)
+			{
+			case Orientation::ROTATE90:
+				x = Y;
+				y = h - 1 - X;
+				break;
+			case Orientation::ROTATE180:
+				x = w - 1 - X;
+				y = h - 1 - Y;
+				break;
+			case Orientation::ROTATE270:
+				x = w - 1 - Y;
+				y = X;
+				break;
+			case Orientation::FLIP_HORIZONTAL:
+				x = w - 1 - X;
+				break;
+			case Orientation::FLIP_VERTICAL:
+				y = h - 1 - Y;
+				break;
+			default:
+				x = Y;
+				y = X;
+			}
+			for (::size_t C = 0; C != imgSrc.depth; ++C)
+				if (*imgDst.GetPointer(X, Y, C) != *imgSrc.GetPointer(x, y, C))
+					return false;
+		}
+	return true;
+}
+
+/** Compares every operation with the source position of every pixel, for sizes with and
+without partial tiles of the kernels and of the parallel tiles. */
+template <typename T>
+void TestOrientations(::size_t depth)
+{
+	using namespace Imaging;
+
+	const Orientation orientations[] = {Orientation::ROTATE90, Orientation::ROTATE180,
+		Orientation::ROTATE270, Orientation::FLIP_HORIZONTAL, Orientation::FLIP_VERTICAL,
+		Orientation::TRANSPOSE};
+	const Size2D<::size_t> sizes[] = {Size2D<::size_t>(1, 1), Size2D<::size_t>(8, 16),
+		Size2D<::size_t>(131, 70), Size2D<::size_t>(64, 129)};
+	for (auto orientation : orientations)
+	{
+		const std::string name = GetOrientationName(orientation);
+		for (const auto &sz : sizes)
+		{
+			const ImageFrame<T> imgSrc = GetHashedImage<T>(sz.width, sz.height, depth, 7);
+			ImageFrame<T> imgDst;
+			Orient(orientation, imgSrc, imgDst);
+			if (!IsOriented(orientation, imgSrc, imgDst))
+				throw std::logic_error(name);
+		}
+
+		// In place, including odd sizes of partial tiles on the diagonal.
+		for (::size_t n : {1, 7, 64, 150})
+		{
+			const ImageFrame<T> imgSrc = GetHashedImage<T>(n, n, depth, 7);
+			ImageFrame<T> img(imgSrc);
+			Orient(orientation, img);
+			if (!IsOriented(orientation, imgSrc, img))
+				throw std::logic_error(name + " in place");
+			img = imgSrc;
+			Orient(orientation, img, img);
+			if (!IsOriented(orientation, imgSrc, img))
+				throw std::logic_error(name + " of the same image");
+		}
+	}
+
+	// Flips and 180 degrees are in place for any shape.
+	const ImageFrame<T> imgSrc = GetHashedImage<T>(131, 70, depth, 7);
+	for (auto orientation : {Orientation::ROTATE180, Orientation::FLIP_HORIZONTAL,
+		Orientation::FLIP_VERTICAL})
+	{
+		ImageFrame<T> img(imgSrc);
+		Orient(orientation, img);
+		if (!IsOriented(orientation, imgSrc, img))
+			throw std::logic_error(GetOrientationName(orientation) + " in place");
+	}
+}
+
+void TestOrientationExceptions(void)
+{
+	using namespace Imaging;
+
+	ImageFrame<unsigned char> img(10, 12, 3), imgEmpty;
+	try
+	{
+		Transpose(img);
+		throw std::logic_error("Transpose()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	try
+	{
+		Rotate90(img, img);
+		throw std::logic_error("Rotate90()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	// Empty images are kept empty.
+	ImageFrame<unsigned char> imgDst;
+	Rotate90(imgEmpty, imgDst);
+	FlipHorizontal(imgEmpty);
+	if (!imgDst.data.empty() || !imgEmpty.data.empty())
+		throw std::logic_error("Rotate90()");
+}
+
+void TestOrientations(void)
+{
+	std::cout << std::endl << "Test for orientation.h has started." << std::endl;
+	TestOrientations<unsigned char>(1);
+	TestOrientations<unsigned char>(3);
+	TestOrientations<unsigned char>(4);
+	TestOrientations<unsigned short>(1);
+	TestOrientations<unsigned short>(3);
+	TestOrientations<unsigned short>(4);
+	TestOrientations<float>(3);
+	TestOrientations<double>(2);
+	TestOrientations<double>(3);
+	TestOrientationExceptions();
+	std::cout << "Test for orientation.h has been completed." << std::endl;
+}
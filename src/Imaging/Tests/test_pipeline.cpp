@@ -0,0 +1,200 @@
+/** This file contains the test functions to test classes and functions defined in
+pipeline.h */
+#include "../Imaging/pipeline.h"
+#include "../Imaging/color_conversion.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <thread>
+
+/** Fills a color frame of an index with values of the index and the position. */
+bool FillPipelineFrame(unsigned long long index, Imaging::ImageFrame<unsigned char> &frame)
+{
+	if (index >= 40)
+		return false;
+	for (::size_t Y = 0; Y != frame.size.height; ++Y)
+		for (::size_t X = 0; X != frame.size.width; ++X)
+			for (::size_t C = 0; C != 3; ++C)
+				*frame.GetPointer(X, Y, C) = static_cast<unsigned char>(index + X + Y);
+	return true;
+}
+
+void TestPipelineStages(void)
+{
+	using namespace Imaging;
+
+	// ingest -> convert (3 threads) -> filter in place (2 threads) -> ordered sink.
+	Pipeline pipeline(2);
+	auto ingest = pipeline.AddSource<unsigned char>("ingest", Size2D<::size_t>(32, 24), 3,
+		FillPipelineFrame, 2);
+	auto convert = pipeline.AddStage<unsigned char, float>("convert", ingest,
+		[](const ImageFrame<unsigned char> &src, ImageFrame<float> &dst)
+	{
+		ImageFrame<unsigned char> gray;
+		ColorToGray(src, gray);
+		dst.Reset(gray.size, 1);
+		for (::size_t I = 0; I != gray.data.size(); ++I)
+			*(dst.GetPointer(0, 0) + I) = 0.5f * gray.data[I];
+	}, 3);
+	auto filter = pipeline.AddInPlaceStage<float>("filter", convert, [](ImageFrame<float> &img)
+	{
+		for (::size_t I = 0; I != img.data.size(); ++I)
+			*(img.GetPointer(0, 0) + I) += 1.0f;
+	}, 2);
+	std::vector<unsigned long long> indices;
+	bool valid = true;
+	pipeline.AddSink<float>("write", filter,
+		[&](unsigned long long index, const ImageFrame<float> &img)
+	{
+		indices.push_back(index);
+		valid = valid && img.depth == 1 && img.size == Size2D<::size_t>(32, 24) &&
+			*img.GetPointer(5, 7) == 0.5f * (index + 12) + 1.0f;
+	});
+	pipeline.Run();
+
+	std::vector<StageStats> stats = pipeline.GetStats();
+	if (!valid || indices.size() != 40 || stats.size() != 4)
+		throw std::logic_error("Pipeline::Run()");
+	for (unsigned long long I = 0; I != 40; ++I)
+		if (indices[I] != I)
+			throw std::logic_error("Pipeline::AddSink()");
+	for (auto it = stats.cbegin(); it != stats.cend(); ++it)
+		if (it->nFrames != 40)
+			throw std::logic_error("Pipeline::GetStats()");
+	if (stats[2].nInPlace != 40 || stats[1].parallelism != 3)
+		throw std::logic_error("Pipeline::AddInPlaceStage()");
+
+	// An in-place stage sharing its input works on a copy.
+	Pipeline branches;
+	auto source = branches.AddSource<unsigned char>("ingest", Size2D<::size_t>(8, 8), 3,
+		FillPipelineFrame);
+	auto inverted = branches.AddInPlaceStage<unsigned char>("invert", source,
+		[](ImageFrame<unsigned char> &img)
+	{
+		for (::size_t I = 0; I != img.data.size(); ++I)
+			*(img.GetPointer(0, 0) + I) = static_cast<unsigned char>(255 - img.data[I]);
+	});
+	unsigned long long sumOriginal = 0, sumInverted = 0;
+	branches.AddSink<unsigned char>("original", source,
+		[&](unsigned long long, const ImageFrame<unsigned char> &img)
+	{
+		sumOriginal += *img.GetPointer(1, 2, 0);
+	});
+	branches.AddSink<unsigned char>("inverted", inverted,
+		[&](unsigned long long, const ImageFrame<unsigned char> &img)
+	{
+		sumInverted += *img.GetPointer(1, 2, 0);
+	}, 2, false);
+	branches.Run();
+	if (sumOriginal != 40 * 3 + 780 || sumInverted != 40 * 252 - 780 ||
+		branches.GetStats()[1].nInPlace != 0)
+		throw std::logic_error("Pipeline::AddInPlaceStage()");
+
+	std::cout << "Stages of a pipeline were successful." << std::endl;
+}
+
+void TestPipelineEndOfStream(void)
+{
+	using namespace Imaging;
+
+	// Workers of a source still fill every index before the end of the stream, when
+	// another worker has already run out of frames at a later index.
+	for (int N = 0; N != 200; ++N)
+	{
+		Pipeline pipeline(2);
+		auto ingest = pipeline.AddSource<unsigned char>("ingest", Size2D<::size_t>(4, 4), 1,
+			[](unsigned long long index, ImageFrame<unsigned char> &frame)
+		{
+			*frame.GetPointer(0, 0) = static_cast<unsigned char>(index);
+			if (index < 20)
+				std::this_thread::yield();
+			return index < 20;
+		}, 8);
+		std::vector<unsigned long long> indices;
+		bool valid = true;
+		pipeline.AddSink<unsigned char>("write", ingest,
+			[&](unsigned long long index, const ImageFrame<unsigned char> &img)
+		{
+			indices.push_back(index);
+			valid = valid && *img.GetPointer(0, 0) == index;
+		});
+		pipeline.Run();
+		if (!valid || indices.size() != 20)
+			throw std::logic_error("Pipeline::AddSource()");
+		for (unsigned long long I = 0; I != 20; ++I)
+			if (indices[I] != I)
+				throw std::logic_error("Pipeline::AddSource()");
+	}
+
+	std::cout << "End of the stream of a pipeline was successful." << std::endl;
+}
+
+void TestPipelineErrors(void)
+{
+	using namespace Imaging;
+
+	// An exception stops every stage and is rethrown by Run().
+	Pipeline pipeline(1);
+	auto ingest = pipeline.AddSource<unsigned char>("ingest", Size2D<::size_t>(4, 4), 3,
+		FillPipelineFrame);
+	auto failing = pipeline.AddInPlaceStage<unsigned char>("fail", ingest,
+		[](ImageFrame<unsigned char> &img)
+	{
+		if (*img.GetPointer(0, 0) == 7)
+			throw std::runtime_error("Stage failed at frame 7.");
+	}, 2);
+	pipeline.AddSink<unsigned char>("write", failing,
+		[](unsigned long long, const ImageFrame<unsigned char> &) {});
+	try
+	{
+		pipeline.Run();
+		throw std::logic_error("Pipeline::Run()");
+	}
+	catch (const std::runtime_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	try
+	{
+		pipeline.Run();
+		throw std::invalid_argument("Pipeline::Run()");
+	}
+	catch (const std::logic_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	Pipeline other;
+	try
+	{
+		other.AddSink<unsigned char>("write", ingest,
+			[](unsigned long long, const ImageFrame<unsigned char> &) {});
+		throw std::logic_error("Pipeline::AddSink()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+	try
+	{
+		other.AddSource<unsigned char>("ingest", Size2D<::size_t>(4, 4), 3, FillPipelineFrame,
+			0);
+		throw std::logic_error("Pipeline::AddSource()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	std::cout << "Errors of a pipeline were successful." << std::endl;
+}
+
+void TestPipelines(void)
+{
+	std::cout << std::endl << "Test for pipeline.h has started." << std::endl;
+	TestPipelineStages();
+	TestPipelineEndOfStream();
+	TestPipelineErrors();
+	std::cout << "Test for pipeline.h has been completed." << std::endl;
+}
@@ -0,0 +1,244 @@
+/** This file contains the test functions to test classes defined in pyramid.h */
+#include "../Imaging/pyramid.h"
+#include "tests.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+/** Index of a pixel reflected without repeating the edge pixel. */
+::size_t ReflectPyramidIndex(::ptrdiff_t i, ::size_t n)
+{
+	const ::ptrdiff_t m = static_cast<::ptrdiff_t>(n);
+	while (m > 1 && (i < 0 || i >= m))
+		i = i < 0 ? -i : 2 * (m - 1) - i;
+	return m > 1 ? static_cast<::size_t>(i) : 0;
+}
+
+/** Rounds a sum of weights of 2^shift to the nearest for integral samples. */
+template <typename T>
+double NormalizeReference(double sum, int shift)
+{
+	const double value = sum / std::ldexp(1.0, shift);
+	return std::is_integral<T>::value ? std::floor(value + 0.5) : value;
+}
+
+bool IsClose(double a, double b, bool exact)
+{
+	return exact ? a == b : std::abs(a - b) <= 1e-4 * (1.0 + std::abs(b));
+}
+
+/** Compares every level with the weighted sums of the reflected pixels of the previous
+level, and every Laplacian level with the difference from the upsampled next level. */
+template <typename T>
+bool IsPyramid(const Imaging::Pyramid<T> &pyramid, const Imaging::ImageFrame<T> &imgSrc)
+{
+	const double k[] = {1, 4, 6, 4, 1};
+	const bool exact = std::is_integral<T>::value;
+	const ::size_t d = imgSrc.depth;
+	if (pyramid.GetLevel(0).data != imgSrc.data || pyramid.GetLevel(0).size != imgSrc.size)
+		return false;
+	for (::size_t L = 0; L + 1 < pyramid.GetLevelCount(); ++L)
+	{
+		const auto &fine = pyramid.GetLevel(L), &coarse = pyramid.GetLevel(L + 1);
+		const ::size_t w = fine.size.width, h = fine.size.height;
+		if (coarse.size.width != (w + 1) / 2 || coarse.size.height != (h + 1) / 2 ||
+			coarse.depth != d)
+			return false;
+		for (::size_t Y = 0; Y != coarse.size.height; ++Y)
+			for (::size_t X = 0; X != coarse.size.width; ++X)
+				for (::size_t C = 0; C != d; ++C)
+				{
+					double sum = 0.0;
+					for (int J = 0; J != 5; ++J)
+						for (int I = 0; I != 5; ++I)
+						{
+							const ::ptrdiff_t x = 2 * static_cast<::ptrdiff_t>(X) + I - 2;
+							const ::ptrdiff_t y = 2 * static_cast<::ptrdiff_t>(Y) + J - 2;
+							sum += k[J] * k[I] * *fine.GetPointer(ReflectPyramidIndex(x, w),
+								ReflectPyramidIndex(y, h), C);
+						}
+					if (!IsClose(*coarse.GetPointer(X, Y, C), NormalizeReference<T>(sum, 8),
+						exact))
+						return false;
+				}
+
+		if (!pyramid.HasLaplacian())
+			continue;
+		const auto &lap = pyramid.GetLaplacian(L);
+		if (lap.size != fine.size || lap.depth != d)
+			return false;
+		for (::size_t Y = 0; Y != h; ++Y)
+			for (::size_t X = 0; X != w; ++X)
+				for (::size_t C = 0; C != d; ++C)
+				{
+					// The zeros inserted between the pixels of the next level have no
+					// weight.
+					double sum = 0.0;
+					for (::ptrdiff_t j = static_cast<::ptrdiff_t>(Y / 2) - 1;
+						j <= static_cast<::ptrdiff_t>(Y / 2) + 1; ++j)
+						for (::ptrdiff_t i = static_cast<::ptrdiff_t>(X / 2) - 1;
+							i <= static_cast<::ptrdiff_t>(X / 2) + 1; ++i)
+						{
+							const ::ptrdiff_t u = static_cast<::ptrdiff_t>(X) - 2 * i + 2;
+							const ::ptrdiff_t v = static_cast<::ptrdiff_t>(Y) - 2 * j + 2;
+							if (u >= 0 && u < 5 && v >= 0 && v < 5)
+								sum += k[u] * k[v] * *coarse.GetPointer(
+								ReflectPyramidIndex(i, coarse.size.width),
+								ReflectPyramidIndex(j, coarse.size.height), C);
+						}
+					const double ref = *fine.GetPointer(X, Y, C) -
+						NormalizeReference<T>(sum, 6);
+					if (!IsClose(static_cast<double>(*lap.GetPointer(X, Y, C)), ref, exact))
+						return false;
+				}
+	}
+	return true;
+}
+
+/** Builds pyramids of frames with odd and even sizes down to 1 x 1, of ROIs, and updates
+them incrementally. */
+template <typename T>
+void TestPyramids(::size_t depth)
+{
+	using namespace Imaging;
+
+	const std::string name = "Pyramid<" + std::to_string(sizeof(T)) + ">";
+
+	// Floating point samples are kept small, so the sums of 256 samples are exact.
+	const ::size_t modulus = std::is_floating_point<T>::value ? 1024 : 0;
+	const Size2D<::size_t> sizes[] = {Size2D<::size_t>(1, 1), Size2D<::size_t>(2, 3),
+		Size2D<::size_t>(5, 7), Size2D<::size_t>(64, 33), Size2D<::size_t>(131, 70)};
+	for (const auto &sz : sizes)
+	{
+		const ImageFrame<T> img = GetHashedImage<T>(sz.width, sz.height, depth, 9, modulus,
+			1);
+		Pyramid<T> pyramid(sz, depth, 6, true);
+		pyramid.Build(img);
+		if (pyramid.GetLevelCount() != 6 || !IsPyramid(pyramid, img))
+			throw std::logic_error(name + "::Build()");
+	}
+
+	// An ROI resets the levels to its dimension.
+	const ImageFrame<T> img = GetHashedImage<T>(131, 70, depth, 9, modulus, 1);
+	const Region<::size_t, ::size_t> roi(17, 9, 100, 51);
+	ImageFrame<T> imgRoi;
+	img.CopyTo(roi, imgRoi);
+	Pyramid<T> pyramid(img.size, depth, 4, true);
+	pyramid.Build(img, roi);
+	if (!IsPyramid(pyramid, imgRoi))
+		throw std::logic_error(name + "::Build() of an ROI");
+
+	// The levels are rebuilt from the changed regions of another frame, including the
+	// edges, and the frames of the levels are kept.
+	const ImageFrame<T> *level = &pyramid.GetLevel(3);
+	const Region<::size_t, ::size_t> regions[] = {Region<::size_t, ::size_t>(40, 20, 9, 5),
+		Region<::size_t, ::size_t>(0, 0, 1, 1), Region<::size_t, ::size_t>(99, 50, 1, 1),
+		Region<::size_t, ::size_t>(0, 30, 100, 3),
+		Region<::size_t, ::size_t>(71, 0, 29, 51)};
+	ImageFrame<T> imgNext = img;
+	for (const auto &changed : regions)
+	{
+		const ImageFrame<T> imgOther = GetHashedImage<T>(131, 70, depth, 9, modulus,
+			static_cast<unsigned>(changed.origin.x * 7 + changed.origin.y + 3));
+		imgNext.CopyFrom(imgOther, changed + roi.origin, changed.origin + roi.origin);
+		pyramid.Update(imgNext, roi, changed);
+		imgNext.CopyTo(roi, imgRoi);
+		if (!IsPyramid(pyramid, imgRoi) || &pyramid.GetLevel(3) != level)
+			throw std::logic_error(name + "::Update()");
+	}
+
+	// Without Laplacian levels.
+	Pyramid<T> gaussian(img.size, depth, 3);
+	gaussian.Build(img);
+	gaussian.Update(img, Region<::size_t, ::size_t>(3, 4, 5, 6));
+	if (gaussian.HasLaplacian() || !IsPyramid(gaussian, img))
+		throw std::logic_error(name + " without Laplacian levels");
+}
+
+void TestPyramidExceptions(void)
+{
+	using namespace Imaging;
+
+	const ImageFrame<unsigned char> img(10, 12, 3);
+	Pyramid<unsigned char> pyramid(img.size, 3, 2), empty;
+	try
+	{
+		Pyramid<unsigned char> none(img.size, 3, 0);
+		throw std::logic_error("Pyramid()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	try
+	{
+		empty.Build(img);
+		throw std::runtime_error("Pyramid::Build()");
+	}
+	catch (const std::logic_error &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	try
+	{
+		pyramid.Build(img);
+		pyramid.GetLaplacian(0);
+		throw std::runtime_error("Pyramid::GetLaplacian()");
+	}
+	catch (const std::logic_error &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	try
+	{
+		pyramid.GetLevel(2);
+		throw std::logic_error("Pyramid::GetLevel()");
+	}
+	catch (const std::out_of_range &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	try
+	{
+		pyramid.Update(ImageFrame<unsigned char>(10, 11, 3),
+			Region<::size_t, ::size_t>(0, 0, 1, 1));
+		throw std::logic_error("Pyramid::Update()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	try
+	{
+		pyramid.Update(img, Region<::size_t, ::size_t>(5, 5, 6, 1));
+		throw std::logic_error("Pyramid::Update()");
+	}
+	catch (const std::out_of_range &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+}
+
+void TestPyramids(void)
+{
+	std::cout << std::endl << "Test for pyramid.h has started." << std::endl;
+	TestPyramids<unsigned char>(1);
+	TestPyramids<unsigned char>(3);
+	TestPyramids<unsigned char>(5);
+	TestPyramids<unsigned short>(1);
+	TestPyramids<unsigned short>(4);
+	TestPyramids<short>(2);
+	TestPyramids<int>(1);
+	TestPyramids<float>(3);
+	TestPyramids<double>(1);
+	TestPyramidExceptions();
+	std::cout << "Test for pyramid.h has been completed." << std::endl;
+}
@@ -0,0 +1,128 @@
+/** This file contains the test functions to test classes and functions defined in
+statistics.h */
+#include "../Imaging/statistics.h"
+#include "../Utilities/parallel.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <random>
+
+/** Compares the results of a histogram with brute force statistics over an ROI. */
+template <typename T>
+void CheckHistogram(const Imaging::Histogram<T> &hist, const Imaging::ImageFrame<T> &img,
+	const Imaging::Region<::size_t, ::size_t> &roi)
+{
+	for (::size_t C = 0; C != img.depth; ++C)
+	{
+		std::vector<double> values;
+		for (::size_t Y = roi.origin.y; Y != roi.origin.y + roi.size.height; ++Y)
+			for (::size_t X = roi.origin.x; X != roi.origin.x + roi.size.width; ++X)
+				values.push_back(static_cast<double>(*img.GetPointer(X, Y, C)));
+		std::sort(values.begin(), values.end());
+		double sum = 0.0, sumSq = 0.0;
+		for (auto it = values.cbegin(); it != values.cend(); ++it)
+		{
+			sum += *it;
+			sumSq += *it * *it;
+		}
+		double n = static_cast<double>(values.size()), mean = sum / n;
+		double stddev = std::sqrt(sumSq / n - mean * mean);
+
+		if (hist.GetTotal(C) != values.size())
+			throw std::logic_error("Histogram<T>::GetTotal()");
+		if (hist.GetMin(C) != values.front() || hist.GetMax(C) != values.back())
+			throw std::logic_error("Histogram<T>::GetMin() or GetMax()");
+		if (std::abs(hist.GetMean(C) - mean) > 1e-6 ||
+			std::abs(hist.GetStdDev(C) - stddev) > 1e-6)
+			throw std::logic_error("Histogram<T>::GetMean() or GetStdDev()");
+		if (hist.GetPercentile(0.0, C) != values.front() ||
+			hist.GetPercentile(100.0, C) != values.back())
+			throw std::logic_error("Histogram<T>::GetPercentile()");
+	}
+}
+
+template <typename T>
+void TestDirectHistogram(::size_t width, ::size_t height, ::size_t depth)
+{
+	using namespace Imaging;
+
+	std::mt19937 gen(1);
+	std::normal_distribution<double> sample(60.0, 15.0);
+	std::vector<T> src(width * height * depth);
+	for (auto it = src.begin(); it != src.end(); ++it)
+		*it = static_cast<T>(std::max(0.0, std::min(120.0, sample(gen))));
+	ImageFrame<T> img(std::move(src), Size2D<::size_t>(width, height), depth);
+
+	Histogram<T> hist;
+	hist.Compute(img);
+	CheckHistogram(hist, img, Region<::size_t, ::size_t>(0, 0, width, height));
+
+	Region<::size_t, ::size_t> roi(3, 5, width / 2, height / 3);
+	hist.Compute(img, roi);
+	CheckHistogram(hist, img, roi);
+
+	// Median of a normal distribution is close to the mean.
+	if (std::abs(hist.GetPercentile(50.0) - 60.0) > 2.0)
+		throw std::logic_error("Histogram<T>::GetPercentile()");
+
+	std::cout << "Histogram of " << typeid(T).name() << " " << width << " x " << height <<
+		" x " << depth << " was successful." << std::endl;
+}
+
+void TestUniformHistogram(void)
+{
+	using namespace Imaging;
+
+	// 0.0, 0.1, ..., 9.9 in 10 bins of [0, 10).
+	std::vector<float> src(100);
+	for (::size_t I = 0; I != src.size(); ++I)
+		src[I] = static_cast<float>(I) / 10.0f;
+	src[0] = std::numeric_limits<float>::quiet_NaN();
+	ImageFrame<float> img(src, Size2D<::size_t>(10, 10), 1);
+
+	Histogram<float> hist(0.0, 10.0, 10);
+	hist.Compute(img);
+	if (hist.GetTotal() != 99 || hist.GetCount(0) != 9 || hist.GetCount(9) != 10)
+		throw std::logic_error("Histogram<T>::Compute()");
+	if (std::abs(hist.GetMin() - 0.1) > 1e-6 || std::abs(hist.GetMax() - 9.9) > 1e-6)
+		throw std::logic_error("Histogram<T>::GetMin() or GetMax()");
+	if (std::abs(hist.GetPercentile(50.0) - 5.05) > 0.1)
+		throw std::logic_error("Histogram<T>::GetPercentile()");
+
+	// The extremes of each channel of an ROI, with the elements of lines kept apart.
+	ImageFrame<unsigned short> noise(37, 11, 3);
+	for (::size_t I = 0; I != noise.data.size(); ++I)
+		*(noise.GetPointer(0, 0) + I) = static_cast<unsigned short>(I * 2654435761u >> 17);
+	const Region<::size_t, ::size_t> roi(2, 1, 30, 9);
+	Histogram<unsigned short> noiseHist(0.0, 65536.0, 16);
+	noiseHist.Compute(noise, roi);
+	for (::size_t C = 0; C != 3; ++C)
+	{
+		double low = 65536.0, high = -1.0;
+		for (::size_t Y = 1; Y != 10; ++Y)
+			for (::size_t X = 2; X != 32; ++X)
+			{
+				low = std::min(low, static_cast<double>(*noise.GetPointer(X, Y, C)));
+				high = std::max(high, static_cast<double>(*noise.GetPointer(X, Y, C)));
+			}
+		if (noiseHist.GetMin(C) != low || noiseHist.GetMax(C) != high)
+			throw std::logic_error("Histogram<T>::GetMin() or GetMax()");
+	}
+
+	std::cout << "Histogram of uniform bins was successful." << std::endl;
+}
+
+void TestStatistics(void)
+{
+	std::cout << std::endl << "Test for statistics.h has started." << std::endl;
+	TestDirectHistogram<unsigned char>(640, 480, 1);
+	TestDirectHistogram<unsigned char>(320, 240, 3);
+	TestDirectHistogram<unsigned short>(333, 257, 2);
+	TestDirectHistogram<signed char>(100, 100, 1);
+	Imaging::SetThreadCount(4);		// force the parallel path on any machine
+	TestDirectHistogram<unsigned char>(640, 480, 3);
+	Imaging::SetThreadCount(0);
+	TestUniformHistogram();
+	std::cout << "Test for statistics.h has been completed." << std::endl;
+}
@@ -1,9 +1,13 @@
 /** This file contains the test functions to test classes and functions defined utilities.h */
 //#include "../Utilities/safecast.h"
 #include "../Utilities/containers.h"
+#include "../Utilities/parallel.h"
+#include "../Utilities/byte_order.h"
+#include "../Utilities/compression.h"
 
 #include <stdexcept>
 #include <iostream>
+#include <random>
 
 template <typename T, typename U>
 void TestSafeCast(const T src, U &dst)
@@ -242,11 +246,132 @@ void TestStdArray(void)
 		<< std::endl;
 }
 
+void TestParallelFor(void)
+{
+	std::cout << "Test for parallel loops started." << std::endl;
+
+	// Every item must be visited exactly once by any number of threads.
+	std::vector<int> visits(1000, 0);
+	for (unsigned int nThreads = 1; nThreads != 9; ++nThreads)
+	{
+		Imaging::SetThreadCount(nThreads);
+		Imaging::ParallelFor(0, visits.size(), 10, [&visits](::size_t first, ::size_t last)
+		{
+			for (::size_t I = first; I != last; ++I)
+				++visits[I];
+		});
+	}
+	Imaging::SetThreadCount(0);
+	if (std::count(visits.cbegin(), visits.cend(), 8) !=
+		static_cast<::ptrdiff_t>(visits.size()))
+		throw std::logic_error("ParallelFor()");
+
+	// An exception from a worker thread is rethrown at the calling thread.
+	try
+	{
+		Imaging::ParallelFor(0, 1000, 1, [](::size_t first, ::size_t)
+		{
+			if (first == 0)
+				throw std::runtime_error("Exception from a worker thread.");
+		});
+		throw std::logic_error("ParallelFor()");
+	}
+	catch (const std::runtime_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	std::cout << "Test for parallel loops has been completed." << std::endl;
+}
+
+void TestByteOrder(void)
+{
+	using namespace Imaging;
+
+	std::cout << "Test for byte order started." << std::endl;
+
+	if (SwapBytes(static_cast<unsigned short>(0x1234)) != 0x3412 ||
+		SwapBytes(0x12345678u) != 0x78563412u ||
+		SwapBytes(0x0102030405060708ull) != 0x0807060504030201ull ||
+		SwapBytes(static_cast<short>(-2)) != static_cast<short>(0xFEFF))
+		throw std::logic_error("SwapBytes()");
+
+	// Floating point values are restored after swapping twice.
+	std::vector<double> values = {1.5, -3.25e100, 0.0};
+	std::vector<double> swapped = values;
+	SwapBytes(swapped.data(), swapped.size());
+	if (swapped == values)
+		throw std::logic_error("SwapBytes()");
+	SwapBytes(swapped.data(), swapped.size());
+	if (swapped != values)
+		throw std::logic_error("SwapBytes()");
+
+	if (NeedsSwap(ByteOrder::NATIVE) || NeedsSwap(GetNativeByteOrder()) ||
+		!NeedsSwap(GetNativeByteOrder() == ByteOrder::LITTLE ? ByteOrder::BIG :
+		ByteOrder::LITTLE))
+		throw std::logic_error("NeedsSwap()");
+
+	std::cout << "Test for byte order completed." << std::endl;
+}
+
+void TestCompression(void)
+{
+	using namespace Imaging;
+
+	std::cout << "Test for compression started." << std::endl;
+
+	// Runs, repeated patterns with overlapping matches, noise, and sizes around the limits
+	// of the format.
+	std::mt19937 gen(7);
+	const ::size_t sizes[6] = {0, 5, 12, 13, 1000, 300000};
+	for (int S = 0; S != 6; ++S)
+		for (int K = 0; K != 3; ++K)
+		{
+			std::vector<unsigned char> src(sizes[S]), compressed, dst(sizes[S]);
+			for (::size_t I = 0; I != src.size(); ++I)
+				src[I] = static_cast<unsigned char>(K == 0 ? 7 : (K == 1 ? (I / 3) % 11 : gen()));
+			Lz4Compress(src.data(), src.size(), compressed);
+			if (compressed.size() > GetLz4Bound(src.size()) ||
+				(K != 2 && src.size() > 1000 && compressed.size() * 20 > src.size()))
+				throw std::logic_error("Lz4Compress()");
+			Lz4Decompress(compressed.data(), compressed.size(), dst.data(), dst.size());
+			if (dst != src)
+				throw std::logic_error("Lz4Decompress()");
+		}
+
+	std::vector<unsigned char> src(1000, 1), compressed, dst(999);
+	Lz4Compress(src.data(), src.size(), compressed);
+	try
+	{
+		Lz4Decompress(compressed.data(), compressed.size(), dst.data(), dst.size());
+		throw std::logic_error("Lz4Decompress()");
+	}
+	catch (const std::runtime_error &ex)
+	{
+		std::cout << ex.what() << std::endl;
+	}
+
+	std::vector<unsigned short> values = {0x0102, 0x0304, 0x0506}, restored(3);
+	std::vector<unsigned char> shuffled(6);
+	ShuffleBytes(values.data(), 3, 2, shuffled.data());
+	if (GetNativeByteOrder() == ByteOrder::LITTLE &&
+		shuffled != std::vector<unsigned char>({2, 4, 6, 1, 3, 5}))
+		throw std::logic_error("ShuffleBytes()");
+	UnshuffleBytes(shuffled.data(), 3, 2, restored.data());
+	if (restored != values)
+		throw std::logic_error("UnshuffleBytes()");
+
+	std::cout << "Test for compression completed." << std::endl;
+}
+
 void TestUtilities(void)
 {
 	std::cout << std::endl << "Test for Utilities has started." << std::endl;
 	TestsSafeCast();
 	TestSafeArithmetic();
 	TestStdArray();
+	TestParallelFor();
+	TestByteOrder();
+	TestCompression();
 	std::cout << "Test for Utilities has been completed." << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,250 @@
+/** This file contains the test functions to test classes and functions defined in warp.h */
+#include "../Imaging/warp.h"
+#include "tests.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <iostream>
+#include <limits>
+
+/** The identity transform keeps every pixel with every interpolation, and a rotation by 90
+degrees moves every pixel to a known pixel. */
+template <typename T>
+void TestWarpExact(::size_t depth)
+{
+	using namespace Imaging;
+
+	const ::size_t w = 37, h = 23;
+	const ImageFrame<T> imgSrc = GetHashedImage<T>(w, h, depth, 7, 251);
+	ImageFrame<T> imgDst;
+	const Interpolation interps[] = {Interpolation::NEAREST, Interpolation::LINEAR,
+		Interpolation::AREA, Interpolation::CUBIC, Interpolation::LANCZO};
+	const std::array<double, 6> identity = {{1, 0, 0, 0, 1, 0}};
+	for (auto interp : interps)
+	{
+		WarpAffine(imgSrc, identity, imgSrc.size, imgDst, interp);
+		for (::size_t I = 0; I != imgSrc.data.size(); ++I)
+			if (std::abs(static_cast<double>(imgDst.data[I]) - imgSrc.data[I]) > 1e-4)
+				throw std::logic_error("WarpAffine(identity)");
+	}
+
+	// (x, y) -> (h - 1 - y, x)
+	const std::array<double, 6> rotation = {{0, -1, static_cast<double>(h - 1), 1, 0, 0}};
+	for (auto interp : interps)
+	{
+		WarpAffine(imgSrc, rotation, Size2D<::size_t>(h, w), imgDst, interp);
+		if (imgDst.size != Size2D<::size_t>(h, w) || imgDst.depth != depth)
+			throw std::logic_error("WarpAffine(rotation)");
+		for (::size_t Y = 0; Y != w; ++Y)
+			for (::size_t X = 0; X != h; ++X)
+				for (::size_t C = 0; C != depth; ++C)
+					if (std::abs(static_cast<double>(*imgDst.GetPointer(X, Y, C)) -
+						*imgSrc.GetPointer(Y, h - 1 - X, C)) > 1e-4)
+						throw std::logic_error("WarpAffine(rotation)");
+	}
+}
+
+/** A translation by fractions of a pixel is the bilinear interpolation of 4 pixels, and
+pixels sampled outside of the source get the border. */
+template <typename T>
+void TestWarpTranslation(double tolerance)
+{
+	using namespace Imaging;
+
+	const ::size_t w = 150, h = 70, d = 3;
+	const ImageFrame<T> imgSrc = GetHashedImage<T>(w, h, d, 7, 251);
+	ImageFrame<T> imgDst;
+	const T border = static_cast<T>(9);
+	const double dx = 2.5, dy = -1.25;
+	WarpAffine(imgSrc, std::array<double, 6>{{1, 0, dx, 0, 1, dy}}, imgSrc.size, imgDst,
+		Interpolation::LINEAR, border);
+	for (::size_t Y = 0; Y != h; ++Y)
+		for (::size_t X = 0; X != w; ++X)
+			for (::size_t C = 0; C != d; ++C)
+			{
+				const double x = X - dx, y = Y - dy;
+				const long long x0 = static_cast<long long>(std::floor(x));
+				const long long y0 = static_cast<long long>(std::floor(y));
+				const double fx = x - x0, fy = y - y0;
+				auto get = [&](long long x, long long y)
+				{
+					return x >= 0 && y >= 0 && x < static_cast<long long>(w) &&
+						y < static_cast<long long>(h) ? static_cast<double>(
+						*imgSrc.GetPointer(x, y, C)) : static_cast<double>(border);
+				};
+				const double top = get(x0, y0) * (1 - fx) + get(x0 + 1, y0) * fx;
+				const double bottom = get(x0, y0 + 1) * (1 - fx) + get(x0 + 1, y0 + 1) * fx;
+				const double v = top * (1 - fy) + bottom * fy;
+				if (std::abs(*imgDst.GetPointer(X, Y, C) - v) > tolerance)
+					throw std::logic_error("WarpAffine(translation)");
+			}
+}
+
+/** A perspective transform whose last row is (0, 0, 1) is an affine transform, and a
+table of a transform gives the same pixels as the warp into the ROI of the table. */
+template <typename T>
+void TestWarpPerspective(::size_t depth)
+{
+	using namespace Imaging;
+
+	const ::size_t w = 200, h = 150;
+	const ImageFrame<T> imgSrc = GetHashedImage<T>(w, h, depth, 7, 251);
+	const std::array<double, 6> affine = {{0.9, -0.3, 40.5, 0.25, 1.1, -12.0}};
+	const std::array<double, 9> perspective = {{affine[0], affine[1], affine[2], affine[3],
+		affine[4], affine[5], 0, 0, 1}};
+	const Size2D<::size_t> szDst(220, 180);
+	ImageFrame<T> imgAffine, imgPerspective;
+	WarpAffine(imgSrc, affine, szDst, imgAffine, Interpolation::CUBIC);
+	WarpPerspective(imgSrc, perspective, szDst, imgPerspective, Interpolation::CUBIC);
+	if (imgAffine.data != imgPerspective.data)
+		throw std::logic_error("WarpPerspective()");
+
+	// Only the ROI is written; the other pixels are kept.
+	const std::array<double, 9> tilt = {{1.0, 0.1, 3.0, -0.05, 0.95, 7.0, 2e-4, -1e-4,
+		1.0}};
+	const Region<::size_t, ::size_t> roi(30, 20, 150, 90);
+	const std::vector<T> filled(szDst.width * szDst.height * depth, static_cast<T>(7));
+	ImageFrame<T> imgWarp(filled, szDst, depth), imgRemap(filled, szDst, depth);
+	WarpPerspective(imgSrc, tilt, szDst, roi, imgWarp);
+	RemapTable table(szDst, roi);
+	table.SetPerspective(tilt);
+	Remap(imgSrc, table, imgRemap);
+	if (imgWarp.data != imgRemap.data ||
+		*imgRemap.GetPointer(0, 0, 0) != static_cast<T>(7) ||
+		*imgRemap.GetPointer(szDst.width - 1, szDst.height - 1, depth - 1) !=
+		static_cast<T>(7))
+		throw std::logic_error("Remap()");
+}
+
+/** A table of a lens undistortion is filled once and reused for every frame. */
+void TestRemapTable(void)
+{
+	using namespace Imaging;
+
+	const Size2D<::size_t> sz(160, 120);
+	const double cx = 80.0, cy = 60.0, k1 = 2e-6;
+	auto undistort = [=](::size_t x, ::size_t y)
+	{
+		const double dx = x - cx, dy = y - cy, r = 1.0 + k1 * (dx * dx + dy * dy);
+		return Point2D<double>(cx + dx * r, cy + dy * r);
+	};
+	RemapTable table(sz);
+	table.Fill(undistort);
+	if (table.GetSize() != sz ||
+		table.GetRegion() != Region<::size_t, ::size_t>(0, 0, 160, 120))
+		throw std::logic_error("RemapTable::GetSize() or GetRegion()");
+	for (::size_t Y = 0; Y < sz.height; Y += 7)
+		for (::size_t X = 0; X < sz.width; X += 5)
+		{
+			const Point2D<double> expected = undistort(X, Y), p = table.GetPosition(X, Y);
+			if (std::abs(p.x - expected.x) > 0.5 / 256 ||
+				std::abs(p.y - expected.y) > 0.5 / 256)
+				throw std::logic_error("RemapTable::Fill()");
+		}
+
+	// Every frame gets the same pixels as a warp of the frame, and the destination is not
+	// reallocated.
+	for (int I = 0; I != 3; ++I)
+	{
+		const ImageFrame<unsigned char> imgSrc =
+			GetHashedImage<unsigned char>(160, 120, 3, 7, 251);
+		ImageFrame<unsigned char> imgDst;
+		Remap(imgSrc, table, imgDst);
+		const unsigned char *p = imgDst.data.data();
+		Remap(imgSrc, table, imgDst);
+		if (imgDst.data.data() != p || imgDst.size != sz || imgDst.depth != 3 ||
+			*imgDst.GetPointer(80, 60, 1) != *imgSrc.GetPointer(80, 60, 1))
+			throw std::logic_error("Remap()");
+	}
+
+	// Positions far outside, including NaN, are border.
+	table.Fill([](::size_t, ::size_t)
+	{
+		return Point2D<double>(std::numeric_limits<double>::quiet_NaN(), 1e30);
+	});
+	const ImageFrame<float> imgSrc = GetHashedImage<float>(160, 120, 1, 7, 251);
+	ImageFrame<float> imgDst;
+	Remap(imgSrc, table, imgDst, Interpolation::LANCZO, -1.0f);
+	for (auto v : imgDst.data)
+		if (v != -1.0f)
+			throw std::logic_error("Remap(border)");
+}
+
+void TestWarpExceptions(void)
+{
+	using namespace Imaging;
+
+	try
+	{
+		GetInverseAffine(std::array<double, 6>{{1, 2, 0, 2, 4, 0}});
+		throw std::logic_error("GetInverseAffine()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	try
+	{
+		GetInversePerspective(std::array<double, 9>{{1, 0, 0, 0, 1, 0, 1, 0, 0}});
+		throw std::logic_error("GetInversePerspective()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	const std::array<double, 9> m = {{2, 1, 3, -1, 4, 5, 0.01, 0.02, 1}};
+	const std::array<double, 9> a = GetInversePerspective(m);
+	for (int R = 0; R != 3; ++R)
+		for (int C = 0; C != 3; ++C)
+		{
+			double v = 0.0;
+			for (int K = 0; K != 3; ++K)
+				v += m[3 * R + K] * a[3 * K + C];
+			if (std::abs(v - (R == C ? 1.0 : 0.0)) > 1e-12)
+				throw std::logic_error("GetInversePerspective()");
+		}
+
+	try
+	{
+		RemapTable table(Size2D<::size_t>(10, 10), Region<::size_t, ::size_t>(5, 5, 6, 5));
+		throw std::logic_error("RemapTable::RemapTable()");
+	}
+	catch (const std::out_of_range &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+
+	ImageFrame<unsigned char> img(8, 8, 1);
+	try
+	{
+		WarpAffine(img, std::array<double, 6>{{1, 0, 0, 0, 1, 0}}, img.size, img);
+		throw std::logic_error("WarpAffine()");
+	}
+	catch (const std::invalid_argument &ex)
+	{
+		std::cout << "Expected exception: " << ex.what() << std::endl;
+	}
+}
+
+void TestWarps(void)
+{
+	std::cout << std::endl << "Test for warp.h has started." << std::endl;
+	TestWarpExact<unsigned char>(1);
+	TestWarpExact<unsigned char>(3);
+	TestWarpExact<unsigned short>(4);
+	TestWarpExact<float>(2);
+	TestWarpExact<double>(1);
+	TestWarpTranslation<unsigned char>(0.5);
+	TestWarpTranslation<unsigned short>(0.5);
+	TestWarpTranslation<short>(0.5);
+	TestWarpTranslation<float>(1e-3);
+	TestWarpTranslation<double>(1e-9);
+	TestWarpPerspective<unsigned char>(3);
+	TestWarpPerspective<unsigned short>(1);
+	TestWarpPerspective<float>(4);
+	TestRemapTable();
+	TestWarpExceptions();
+	std::cout << "Test for warp.h has been completed." << std::endl;
+}
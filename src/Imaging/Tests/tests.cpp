@@ -5,6 +5,11 @@
 #include <stdexcept>
 #include <iostream>
 
+#include "../Utilities/memory_tracker.h"
+
+// Counts allocations for TestMemoryTracker().
+IMAGING_DEFINE_ALLOCATION_HOOKS()
+
 int main(void)
 {
 	try
@@ -13,14 +18,40 @@ int main(void)
 		TestCoordinates();
 		TestConvert();
 		TestImageFrames();
+#if !defined(IMAGING_NO_OPENCV)
 		TestImageProcessing();
+#endif
+		TestDetection();
+		TestIntegralImages();
+		TestStatistics();
+		TestLookupTables();
+		TestColorConversions();
+		TestDemosaic();
+		TestFrameReaders();
+		TestFrameWriters();
+		TestImageCodecs();
+		TestChunkedCubes();
+		TestFrameCompression();
+		TestFrameRings();
+		TestPipelines();
+		TestImageExpressions();
+		TestKernels();
+		TestInstrumentation();
+		TestMemoryTracker();
+		TestWarps();
+		TestOrientations();
+		TestPyramids();
+		TestMorphologies();
 	}
 	catch (const std::exception &ex)
 	{
 		std::cout << ex.what() << std::endl;
+		return 1;
 	}
 	catch (...)
 	{
 		std::cout << "Unknown exception" << std::endl;
+		return 1;
 	}
+	return 0;
 }
\ No newline at end of file
@@ -1,5 +1,49 @@
+#if !defined(TESTS_H)
+#define TESTS_H
+
+#include "../Imaging/image.h"
+
 void TestUtilities(void);
 void TestCoordinates(void);
 void TestConvert(void);
 void TestImageFrames(void);
 void TestImageProcessing(void);
+void TestDetection(void);
+void TestIntegralImages(void);
+void TestStatistics(void);
+void TestLookupTables(void);
+void TestColorConversions(void);
+void TestDemosaic(void);
+void TestFrameReaders(void);
+void TestFrameWriters(void);
+void TestImageCodecs(void);
+void TestChunkedCubes(void);
+void TestFrameCompression(void);
+void TestFrameRings(void);
+void TestPipelines(void);
+void TestImageExpressions(void);
+void TestKernels(void);
+void TestInstrumentation(void);
+void TestMemoryTracker(void);
+void TestWarps(void);
+void TestOrientations(void);
+void TestPyramids(void);
+void TestMorphologies(void);
+
+/** Gets an image of samples hashed from their indices, i.e., (I * 2654435761 + seed) >>
+shift, which are reduced modulo a modulus if it is not 0. */
+template <typename T>
+Imaging::ImageFrame<T> GetHashedImage(::size_t width, ::size_t height, ::size_t depth,
+	unsigned int shift, ::size_t modulus = 0, unsigned int seed = 0)
+{
+	std::vector<T> samples(width * height * depth);
+	for (::size_t I = 0; I != samples.size(); ++I)
+	{
+		const ::size_t value = (I * 2654435761u + seed) >> shift;
+		samples[I] = static_cast<T>(modulus != 0 ? value % modulus : value);
+	}
+	return Imaging::ImageFrame<T>(std::move(samples),
+		Imaging::Size2D<::size_t>(width, height), depth);
+}
+
+#endif
@@ -0,0 +1,40 @@
+#if !defined(BYTE_ORDER_H)
+#define BYTE_ORDER_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Global functions for the byte order of data samples.
+
+#include <cstring>
+#include <type_traits>
+
+namespace Imaging
+{
+	/** Presents the byte order of multi-byte data samples.
+
+	NATIVE: the byte order of this machine, i.e., no conversion
+	LITTLE: least significant byte first, e.g., x86, ARM
+	BIG: most significant byte first, e.g., network byte order, ENVI files with
+	"byte order = 1", FITS
+	*/
+	enum class ByteOrder {NATIVE, LITTLE, BIG};
+
+	/** Gets the byte order of this machine as LITTLE or BIG. */
+	inline ByteOrder GetNativeByteOrder(void);
+
+	/** Checks if samples stored in given byte order must be swapped on this machine. */
+	inline bool NeedsSwap(ByteOrder order);
+
+	/** Reverses the bytes of a value.
+
+	Any arithmetic type is supported including floating point types, whose bytes are
+	swapped through an unsigned integer of the same size. */
+	template <typename T>
+	T SwapBytes(T value);
+
+	/** Reverses the bytes of each element of an array in place. */
+	template <typename T>
+	void SwapBytes(T *data, ::size_t nElem);
+}
+
+#include "byte_order_inl.h"
+
+#endif
@@ -0,0 +1,70 @@
+#if !defined(BYTE_ORDER_INL_H)
+#define BYTE_ORDER_INL_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Global functions for the byte order of data samples.
+
+namespace Imaging
+{
+	ByteOrder GetNativeByteOrder(void)
+	{
+		const unsigned short one = 1;
+		unsigned char first;
+		std::memcpy(&first, &one, 1);
+		return first == 1 ? ByteOrder::LITTLE : ByteOrder::BIG;
+	}
+
+	bool NeedsSwap(ByteOrder order)
+	{
+		return order != ByteOrder::NATIVE && order != GetNativeByteOrder();
+	}
+
+	/** Shifts and masks of fixed widths are recognized by compilers as a single byte swap
+	instruction, and vectorized when applied over arrays. */
+	inline unsigned char SwapUnsigned(unsigned char value)
+	{
+		return value;
+	}
+
+	inline unsigned short SwapUnsigned(unsigned short value)
+	{
+		return static_cast<unsigned short>(value << 8 | value >> 8);
+	}
+
+	inline unsigned int SwapUnsigned(unsigned int value)
+	{
+		return value << 24 | (value & 0xFF00u) << 8 | (value >> 8 & 0xFF00u) | value >> 24;
+	}
+
+	inline unsigned long long SwapUnsigned(unsigned long long value)
+	{
+		return static_cast<unsigned long long>(
+			SwapUnsigned(static_cast<unsigned int>(value))) << 32 |
+			SwapUnsigned(static_cast<unsigned int>(value >> 32));
+	}
+
+	template <typename T>
+	T SwapBytes(T value)
+	{
+		static_assert(std::is_arithmetic<T>::value, "Only arithmetic types are supported.");
+		static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+			"Only 1, 2, 4 and 8-byte types are supported.");
+		typedef typename std::conditional<sizeof(T) == 1, unsigned char,
+			typename std::conditional<sizeof(T) == 2, unsigned short,
+			typename std::conditional<sizeof(T) == 4, unsigned int,
+			unsigned long long>::type>::type>::type UnsignedType;
+		UnsignedType bits;
+		std::memcpy(&bits, &value, sizeof(T));
+		bits = SwapUnsigned(bits);
+		std::memcpy(&value, &bits, sizeof(T));
+		return value;
+	}
+
+	template <typename T>
+	void SwapBytes(T *data, ::size_t nElem)
+	{
+		for (::size_t I = 0; I != nElem; ++I)
+			data[I] = SwapBytes(data[I]);
+	}
+}
+
+#endif
@@ -0,0 +1,42 @@
+#if !defined(COMPRESSION_H)
+#define COMPRESSION_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Global functions for lossless compression of blocks of memory.
+
+#include <cstddef>
+#include <vector>
+
+namespace Imaging
+{
+	/** Gets the maximum number of bytes of a compressed block of given bytes. */
+	inline ::size_t GetLz4Bound(::size_t nBytes);
+
+	/** Compresses a block into the LZ4 block format.
+
+	Matches are searched greedily through a hash table of 4-byte sequences, which trades
+	some ratio for a speed close to a memory copy. Incompressible data grows by at most
+	1/255. The block has no header, so the number of source bytes must be kept by the
+	caller for decompression.
+	@param [out] dst	resized to the number of compressed bytes */
+	inline void Lz4Compress(const void *src, ::size_t nBytes, std::vector<unsigned char> &dst);
+
+	/** Decompresses an LZ4 block of known decompressed size.
+
+	@exception std::runtime_error	if the block is invalid or its decompressed size is not
+	nDst */
+	inline void Lz4Decompress(const void *src, ::size_t nSrc, void *dst, ::size_t nDst);
+
+	/** Groups the bytes of elements by their significance, i.e., the first bytes of all
+	elements, then the second bytes, and so on.
+
+	Neighboring samples of images mostly differ in the low bytes, so the high bytes form
+	long runs which compress much better than interleaved bytes. */
+	inline void ShuffleBytes(const void *src, ::size_t nElem, ::size_t elemBytes, void *dst);
+
+	/** Restores the bytes grouped by ShuffleBytes(). */
+	inline void UnshuffleBytes(const void *src, ::size_t nElem, ::size_t elemBytes, void *dst);
+}
+
+#include "compression_inl.h"
+
+#endif
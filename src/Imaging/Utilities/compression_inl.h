@@ -0,0 +1,172 @@
+#if !defined(COMPRESSION_INL_H)
+#define COMPRESSION_INL_H
+
+#include <cstring>
+#include <stdexcept>
+
+namespace Imaging
+{
+	inline ::size_t GetLz4Bound(::size_t nBytes)
+	{
+		return nBytes + nBytes / 255 + 16;
+	}
+
+	/** Reads 4 bytes at any alignment. */
+	inline unsigned ReadUnaligned32(const unsigned char *src)
+	{
+		unsigned value;
+		std::memcpy(&value, src, 4);
+		return value;
+	}
+
+	/** Appends a length of 15 or more as the extra bytes of LZ4. */
+	inline unsigned char *PutLz4Length(unsigned char *dst, ::size_t length)
+	{
+		for (; length >= 255; length -= 255)
+			*dst++ = 255;
+		*dst++ = static_cast<unsigned char>(length);
+		return dst;
+	}
+
+	/** A sequence is a token of the literal and match lengths, the literals, and the offset
+	of the match. The last 5 bytes are always literals and no match starts in the last 12
+	bytes, as required by the format. The search steps faster through data without
+	matches. */
+	inline void Lz4Compress(const void *src, ::size_t nBytes, std::vector<unsigned char> &dst)
+	{
+		const unsigned hashBits = 14;
+		const ::size_t minMatch = 4, lastLiterals = 5, matchLimit = 12;
+		const unsigned char *s = static_cast<const unsigned char *>(src);
+		dst.resize(GetLz4Bound(nBytes));
+		unsigned char *out = dst.data();
+
+		auto PutSequence = [&](::size_t anchor, ::size_t nLiterals, ::size_t offset,
+			::size_t matchLength)
+		{
+			unsigned char *token = out++;
+			*token = static_cast<unsigned char>(std::min<::size_t>(nLiterals, 15) << 4);
+			if (nLiterals >= 15)
+				out = PutLz4Length(out, nLiterals - 15);
+			if (nLiterals != 0)
+				std::memcpy(out, s + anchor, nLiterals);
+			out += nLiterals;
+			if (matchLength == 0)
+				return;		// last literals
+			*out++ = static_cast<unsigned char>(offset);
+			*out++ = static_cast<unsigned char>(offset >> 8);
+			::size_t extra = matchLength - minMatch;
+			*token = static_cast<unsigned char>(*token | std::min<::size_t>(extra, 15));
+			if (extra >= 15)
+				out = PutLz4Length(out, extra - 15);
+		};
+
+		::size_t anchor = 0;
+		if (nBytes > matchLimit)
+		{
+			std::vector<unsigned> table(1 << hashBits, 0);
+			const ::size_t limit = nBytes - matchLimit, matchEnd = nBytes - lastLiterals;
+			for (::size_t pos = 1; pos < limit;)
+			{
+				unsigned sequence = ReadUnaligned32(s + pos);
+				unsigned hash = (sequence * 2654435761u) >> (32 - hashBits);
+				::size_t ref = table[hash];
+				table[hash] = static_cast<unsigned>(pos);
+				if (ref >= pos || pos - ref > 65535 || ReadUnaligned32(s + ref) != sequence)
+				{
+					pos += 1 + ((pos - anchor) >> 6);
+					continue;
+				}
+
+				::size_t length = minMatch;
+				while (pos + length < matchEnd && s[ref + length] == s[pos + length])
+					++length;
+				while (pos > anchor && ref > 0 && s[pos - 1] == s[ref - 1])
+				{
+					--pos;
+					--ref;
+					++length;
+				}
+				PutSequence(anchor, pos - anchor, pos - ref, length);
+				pos += length;
+				anchor = pos;
+			}
+		}
+		PutSequence(anchor, nBytes - anchor, 0, 0);
+		dst.resize(out - dst.data());
+	}
+
+	inline void Lz4Decompress(const void *src, ::size_t nSrc, void *dst, ::size_t nDst)
+	{
+		const unsigned char *in = static_cast<const unsigned char *>(src), *end = in + nSrc;
+		unsigned char *out = static_cast<unsigned char *>(dst), *begin = out;
+		unsigned char *outEnd = out + nDst;
+		auto Fail = []()
+		{
+			throw std::runtime_error("The compressed block is invalid.");
+		};
+		auto GetLength = [&](::size_t length) -> ::size_t
+		{
+			if (length == 15)
+				for (unsigned char b = 255; b == 255; length += b)
+				{
+					if (in == end)
+						Fail();
+					b = *in++;
+				}
+			return length;
+		};
+
+		while (in != end)
+		{
+			unsigned token = *in++;
+			::size_t nLiterals = GetLength(token >> 4);
+			if (nLiterals > static_cast<::size_t>(end - in) ||
+				nLiterals > static_cast<::size_t>(outEnd - out))
+				Fail();
+			if (nLiterals != 0)
+				std::memcpy(out, in, nLiterals);
+			in += nLiterals;
+			out += nLiterals;
+			if (in == end)
+				break;		// last literals
+
+			if (end - in < 2)
+				Fail();
+			::size_t offset = in[0] | (in[1] << 8);
+			in += 2;
+			::size_t length = GetLength(token & 0x0F) + 4;
+			if (offset == 0 || offset > static_cast<::size_t>(out - begin) ||
+				length > static_cast<::size_t>(outEnd - out))
+				Fail();
+			const unsigned char *match = out - offset;
+			if (offset >= length)
+				std::memcpy(out, match, length);
+			else
+				for (::size_t I = 0; I != length; ++I)		// overlapping run
+					out[I] = match[I];
+			out += length;
+		}
+		if (out != outEnd)
+			Fail();
+	}
+
+	inline void ShuffleBytes(const void *src, ::size_t nElem, ::size_t elemBytes, void *dst)
+	{
+		const unsigned char *s = static_cast<const unsigned char *>(src);
+		unsigned char *d = static_cast<unsigned char *>(dst);
+		for (::size_t B = 0; B != elemBytes; ++B)
+			for (::size_t I = 0; I != nElem; ++I)
+				d[nElem * B + I] = s[elemBytes * I + B];
+	}
+
+	inline void UnshuffleBytes(const void *src, ::size_t nElem, ::size_t elemBytes, void *dst)
+	{
+		const unsigned char *s = static_cast<const unsigned char *>(src);
+		unsigned char *d = static_cast<unsigned char *>(dst);
+		for (::size_t B = 0; B != elemBytes; ++B)
+			for (::size_t I = 0; I != nElem; ++I)
+				d[elemBytes * I + B] = s[nElem * B + I];
+	}
+}
+
+#endif
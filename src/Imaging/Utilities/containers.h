@@ -4,6 +4,7 @@
 // Global functions and operators for std::array<T, N>, std::vector<T> classes.
 
 #include <array>
+#include <cmath>
 #include <algorithm>
 #include <vector>
 
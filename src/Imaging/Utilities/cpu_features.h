@@ -0,0 +1,28 @@
+#if !defined(CPU_FEATURES_H)
+#define CPU_FEATURES_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Global functions for the SIMD instruction sets of this machine.
+
+namespace Imaging
+{
+	/** Presents a level of SIMD instruction sets, each of which includes the lower levels.
+
+	BASELINE: what the compiler targets by default, e.g., SSE2 on x86-64
+	SSE41: SSE4.1
+	AVX2: AVX2 and FMA
+	AVX512: AVX-512 F, BW and VL
+	*/
+	enum class SimdLevel {BASELINE, SSE41, AVX2, AVX512};
+
+	/** Gets the highest SIMD level supported by this CPU and the operating system.
+
+	The result is BASELINE on processors other than x86. */
+	inline SimdLevel GetCpuSimdLevel(void);
+
+	/** Gets the name of a SIMD level, e.g., "avx2". */
+	inline const char *GetSimdLevelName(SimdLevel level);
+}
+
+#include "cpu_features_inl.h"
+
+#endif
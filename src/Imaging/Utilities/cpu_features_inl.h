@@ -0,0 +1,73 @@
+#if !defined(CPU_FEATURES_INL_H)
+#define CPU_FEATURES_INL_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Global functions for the SIMD instruction sets of this machine.
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace Imaging
+{
+	/** AVX registers must also be saved by the operating system, which is told by XGETBV;
+	GCC and Clang check it in __builtin_cpu_supports(). */
+	SimdLevel GetCpuSimdLevel(void)
+	{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		int info[4];
+		__cpuid(info, 0);
+		const int nIds = info[0];
+		__cpuid(info, 1);
+		const bool sse41 = (info[2] & 1 << 19) != 0, fma = (info[2] & 1 << 12) != 0;
+		const bool osxsave = (info[2] & 1 << 27) != 0, avx = (info[2] & 1 << 28) != 0;
+		const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+		bool avx2 = false, avx512 = false;
+		if (nIds >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			const unsigned int ebx = static_cast<unsigned int>(info[1]);
+			avx2 = (ebx & 1u << 5) != 0;
+			avx512 = (ebx & 1u << 16) != 0 && (ebx & 1u << 30) != 0 && (ebx & 1u << 31) != 0;
+		}
+		if (avx512 && avx2 && fma && (xcr0 & 0xE6) == 0xE6)
+			return SimdLevel::AVX512;
+		else if (avx && avx2 && fma && (xcr0 & 0x6) == 0x6)
+			return SimdLevel::AVX2;
+		else if (sse41)
+			return SimdLevel::SSE41;
+		else
+			return SimdLevel::BASELINE;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+			__builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx2") &&
+			__builtin_cpu_supports("fma"))
+			return SimdLevel::AVX512;
+		else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+			return SimdLevel::AVX2;
+		else if (__builtin_cpu_supports("sse4.1"))
+			return SimdLevel::SSE41;
+		else
+			return SimdLevel::BASELINE;
+#else
+		return SimdLevel::BASELINE;
+#endif
+	}
+
+	const char *GetSimdLevelName(SimdLevel level)
+	{
+		switch (level)
+		{
+		case SimdLevel::SSE41:
+			return "sse4.1";
+		case SimdLevel::AVX2:
+			return "avx2";
+		case SimdLevel::AVX512:
+			return "avx512";
+		default:
+			return "baseline";
+		}
+	}
+}
+
+#endif
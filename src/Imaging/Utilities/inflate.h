@@ -0,0 +1,109 @@
+#if !defined(INFLATE_H)
+#define INFLATE_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace Imaging
+{
+	/** Canonical Huffman code of deflate streams with a lookup table for short codes. */
+	class HuffmanTable
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		static const unsigned maxBits = 15;
+		static const unsigned fastBits = 10;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Builds the code from the code length of each symbol; 0 for unused symbols.
+
+		@exception std::runtime_error	if the lengths over-subscribe the code */
+		void Build(const unsigned char *lengths, unsigned nSymbols);
+
+		//////////////////////////////////////////////////
+		// Data.
+
+		/** Symbol and length of the codes up to fastBits, indexed by the next fastBits of the
+		stream; (symbol << 4) | length, or 0 for longer codes. */
+		std::vector<unsigned short> fast;
+		unsigned short count[maxBits + 1];
+		std::vector<unsigned short> symbols;
+	};
+
+	/** Decompresses a deflate (RFC 1951) or zlib (RFC 1950) stream incrementally.
+
+	Compressed bytes are pulled from a source function whenever the bits run out, and
+	decompressed bytes are produced as many as requested by each Read(), so neither the
+	whole compressed nor the whole decompressed data has to be in memory. Only the last 32
+	KiB of the output are kept for back references.
+	The Adler-32 checksum of zlib streams is not verified. */
+	class Inflater
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+
+		/** Fills a buffer of given size with compressed bytes and returns the number of
+		bytes filled; 0 at the end of the input. */
+		typedef std::function<::size_t(unsigned char *, ::size_t)> Source;
+
+		//////////////////////////////////////////////////
+		// Default constructors.
+		Inflater(void);
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Starts a new stream.
+
+		@exception std::runtime_error	if zlib is true and the zlib header is invalid */
+		void Reset(Source source, bool zlib = true);
+
+		/** Starts a new stream from memory. */
+		void Reset(const void *src, ::size_t nBytes, bool zlib = true);
+
+		/** Decompresses up to given number of bytes.
+
+		@return	the number of bytes decompressed, which is less than nBytes only at the end
+		of the stream
+		@exception std::runtime_error	if the stream is invalid or truncated */
+		::size_t Read(void *dst, ::size_t nBytes);
+
+		/** Checks if the end of the last block has been reached. */
+		bool IsFinished(void) const;
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void Refill(void);
+		unsigned GetBits(unsigned nBits);
+		unsigned Decode(const HuffmanTable &table);
+		void BeginBlock(void);
+		void ReadDynamicTables(void);
+
+		//////////////////////////////////////////////////
+		// Data.
+		Source source_;
+		std::vector<unsigned char> input_;
+		::size_t inputPos_, inputSize_;
+		unsigned long long bits_;
+		unsigned nBits_;
+		bool inputEnded_;
+
+		std::vector<unsigned char> window_;
+		::size_t windowPos_;
+
+		// State between calls to Read().
+		bool inBlock_, lastBlock_, finished_, stored_;
+		::size_t nStored_, copyLength_, copyDistance_;
+		HuffmanTable literals_, distances_;
+	};
+}
+
+#include "inflate_inl.h"
+
+#endif
@@ -0,0 +1,331 @@
+#if !defined(INFLATE_INL_H)
+#define INFLATE_INL_H
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// HuffmanTable class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+
+	/** Codes are assigned in the canonical order of RFC 1951, and the codes up to fastBits
+	are entered into the lookup table bit-reversed, because deflate packs them from the
+	most significant bit into the least significant bits of the stream. */
+	inline void HuffmanTable::Build(const unsigned char *lengths, unsigned nSymbols)
+	{
+		std::fill(this->count, this->count + maxBits + 1, 0);
+		for (unsigned S = 0; S != nSymbols; ++S)
+			++this->count[lengths[S]];
+		this->count[0] = 0;
+
+		int left = 1;
+		for (unsigned L = 1; L <= maxBits; ++L)
+		{
+			left = 2 * left - this->count[L];
+			if (left < 0)
+				throw std::runtime_error("The Huffman code of the compressed stream is invalid.");
+		}
+
+		unsigned offsets[maxBits + 2] = {}, next[maxBits + 1] = {};
+		for (unsigned L = 1; L <= maxBits; ++L)
+		{
+			offsets[L + 1] = offsets[L] + this->count[L];
+			next[L] = (next[L - 1] + this->count[L - 1]) << 1;
+		}
+		this->symbols.assign(nSymbols, 0);
+		this->fast.assign(1 << fastBits, 0);
+		for (unsigned S = 0; S != nSymbols; ++S)
+		{
+			unsigned length = lengths[S];
+			if (length == 0)
+				continue;
+			this->symbols[offsets[length]++] = static_cast<unsigned short>(S);
+			unsigned code = next[length]++;
+			if (length > fastBits)
+				continue;
+			unsigned reversed = 0;
+			for (unsigned B = 0; B != length; ++B)
+				reversed |= ((code >> B) & 1) << (length - 1 - B);
+			for (unsigned I = reversed; I < (1u << fastBits); I += 1 << length)
+				this->fast[I] = static_cast<unsigned short>((S << 4) | length);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Inflater class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Default constructors.
+	inline Inflater::Inflater(void) : input_(16384), inputPos_(0), inputSize_(0), bits_(0),
+		nBits_(0), inputEnded_(true), window_(32768), windowPos_(0), inBlock_(false),
+		lastBlock_(false), finished_(true), stored_(false), nStored_(0), copyLength_(0),
+		copyDistance_(0) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline bool Inflater::IsFinished(void) const
+	{
+		return this->finished_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	inline void Inflater::Reset(Source source, bool zlib)
+	{
+		this->source_ = std::move(source);
+		this->inputPos_ = this->inputSize_ = 0;
+		this->bits_ = 0;
+		this->nBits_ = 0;
+		this->inputEnded_ = false;
+		this->windowPos_ = 0;
+		this->inBlock_ = this->lastBlock_ = this->finished_ = this->stored_ = false;
+		this->nStored_ = this->copyLength_ = this->copyDistance_ = 0;
+		if (zlib)
+		{
+			unsigned cmf = this->GetBits(8), flg = this->GetBits(8);
+			if ((cmf & 0x0F) != 8 || (cmf * 256 + flg) % 31 != 0 || (flg & 0x20) != 0)
+				throw std::runtime_error("The zlib header of the compressed stream is invalid.");
+		}
+	}
+
+	inline void Inflater::Reset(const void *src, ::size_t nBytes, bool zlib)
+	{
+		const unsigned char *it_src = static_cast<const unsigned char *>(src);
+		this->Reset([it_src, nBytes](unsigned char *dst, ::size_t n) mutable -> ::size_t
+		{
+			n = std::min(n, nBytes);
+			std::copy(it_src, it_src + n, dst);
+			it_src += n;
+			nBytes -= n;
+			return n;
+		}, zlib);
+	}
+
+	/** Back references are copied byte by byte because the source may overlap the bytes
+	being copied, e.g., a run of a single byte has distance 1. */
+	inline ::size_t Inflater::Read(void *dst, ::size_t nBytes)
+	{
+		static const unsigned short lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15,
+			17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+		static const unsigned char lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1,
+			2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+		static const unsigned short distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33,
+			49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+			8193, 12289, 16385, 24577};
+		static const unsigned char distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4,
+			5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+		unsigned char *it_dst = static_cast<unsigned char *>(dst);
+		unsigned char *window = this->window_.data();
+		const ::size_t mask = this->window_.size() - 1;
+		::size_t done = 0;
+		while (done != nBytes)
+		{
+			if (this->copyLength_ != 0)
+			{
+				::size_t n = std::min(this->copyLength_, nBytes - done);
+				for (::size_t I = 0; I != n; ++I, ++this->windowPos_)
+				{
+					unsigned char value = window[(this->windowPos_ - this->copyDistance_) & mask];
+					it_dst[done++] = window[this->windowPos_ & mask] = value;
+				}
+				this->copyLength_ -= n;
+			}
+			else if (!this->inBlock_)
+			{
+				if (this->lastBlock_ || this->finished_)
+				{
+					this->finished_ = true;
+					break;
+				}
+				this->BeginBlock();
+			}
+			else if (this->stored_)
+			{
+				if (this->nStored_ == 0)
+				{
+					this->inBlock_ = false;
+					continue;
+				}
+				unsigned char value = static_cast<unsigned char>(this->GetBits(8));
+				it_dst[done++] = window[this->windowPos_++ & mask] = value;
+				--this->nStored_;
+			}
+			else
+			{
+				unsigned symbol = this->Decode(this->literals_);
+				if (symbol < 256)
+					it_dst[done++] = window[this->windowPos_++ & mask] =
+					static_cast<unsigned char>(symbol);
+				else if (symbol == 256)
+					this->inBlock_ = false;
+				else
+				{
+					symbol -= 257;
+					if (symbol >= 29)
+						throw std::runtime_error("The compressed stream has an invalid length.");
+					::size_t length = lengthBase[symbol] + this->GetBits(lengthExtra[symbol]);
+					unsigned code = this->Decode(this->distances_);
+					if (code >= 30)
+						throw std::runtime_error("The compressed stream has an invalid distance.");
+					::size_t distance = distanceBase[code] + this->GetBits(distanceExtra[code]);
+					if (distance > this->windowPos_)
+						throw std::runtime_error("The compressed stream has an invalid distance.");
+					this->copyLength_ = length;
+					this->copyDistance_ = distance;
+				}
+			}
+		}
+		return done;
+	}
+
+	inline void Inflater::Refill(void)
+	{
+		while (this->nBits_ <= 56)
+		{
+			if (this->inputPos_ == this->inputSize_)
+			{
+				if (this->inputEnded_)
+					return;
+				this->inputSize_ = this->source_(this->input_.data(), this->input_.size());
+				this->inputPos_ = 0;
+				if (this->inputSize_ == 0)
+				{
+					this->inputEnded_ = true;
+					return;
+				}
+			}
+			this->bits_ |= static_cast<unsigned long long>(this->input_[this->inputPos_++]) <<
+				this->nBits_;
+			this->nBits_ += 8;
+		}
+	}
+
+	inline unsigned Inflater::GetBits(unsigned nBits)
+	{
+		if (this->nBits_ < nBits)
+		{
+			this->Refill();
+			if (this->nBits_ < nBits)
+				throw std::runtime_error("The compressed stream is truncated.");
+		}
+		unsigned value = static_cast<unsigned>(this->bits_ & ((1ull << nBits) - 1));
+		this->bits_ >>= nBits;
+		this->nBits_ -= nBits;
+		return value;
+	}
+
+	/** Codes longer than the lookup table are decoded bit by bit in the canonical order. */
+	inline unsigned Inflater::Decode(const HuffmanTable &table)
+	{
+		if (this->nBits_ < HuffmanTable::maxBits)
+			this->Refill();
+		unsigned entry = table.fast[this->bits_ & ((1 << HuffmanTable::fastBits) - 1)];
+		if (entry != 0)
+		{
+			unsigned length = entry & 0x0F;
+			if (length > this->nBits_)
+				throw std::runtime_error("The compressed stream is truncated.");
+			this->bits_ >>= length;
+			this->nBits_ -= length;
+			return entry >> 4;
+		}
+
+		int code = 0, first = 0, index = 0;
+		for (unsigned L = 1; L <= HuffmanTable::maxBits; ++L)
+		{
+			code |= static_cast<int>(this->GetBits(1));
+			int count = table.count[L];
+			if (code - first < count)
+				return table.symbols[index + code - first];
+			index += count;
+			first = (first + count) << 1;
+			code <<= 1;
+		}
+		throw std::runtime_error("The compressed stream has an invalid Huffman code.");
+	}
+
+	inline void Inflater::BeginBlock(void)
+	{
+		this->lastBlock_ = this->GetBits(1) != 0;
+		unsigned type = this->GetBits(2);
+		this->stored_ = type == 0;
+		if (type == 0)
+		{
+			this->GetBits(this->nBits_ % 8);
+			unsigned length = this->GetBits(16), complement = this->GetBits(16);
+			if ((length ^ 0xFFFF) != complement)
+				throw std::runtime_error("The stored block of the compressed stream is invalid.");
+			this->nStored_ = length;
+		}
+		else if (type == 1)
+		{
+			unsigned char lengths[288];
+			std::fill(lengths, lengths + 144, 8);
+			std::fill(lengths + 144, lengths + 256, 9);
+			std::fill(lengths + 256, lengths + 280, 7);
+			std::fill(lengths + 280, lengths + 288, 8);
+			this->literals_.Build(lengths, 288);
+			std::fill(lengths, lengths + 30, 5);
+			this->distances_.Build(lengths, 30);
+		}
+		else if (type == 2)
+			this->ReadDynamicTables();
+		else
+			throw std::runtime_error("The compressed stream has an invalid block type.");
+		this->inBlock_ = true;
+	}
+
+	inline void Inflater::ReadDynamicTables(void)
+	{
+		static const unsigned char order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12,
+			3, 13, 2, 14, 1, 15};
+		unsigned nLiterals = this->GetBits(5) + 257, nDistances = this->GetBits(5) + 1;
+		unsigned nCodeLengths = this->GetBits(4) + 4;
+		if (nLiterals > 286 || nDistances > 30)
+			throw std::runtime_error("The compressed stream has invalid code lengths.");
+
+		unsigned char lengths[286 + 30] = {};
+		for (unsigned I = 0; I != nCodeLengths; ++I)
+			lengths[order[I]] = static_cast<unsigned char>(this->GetBits(3));
+		HuffmanTable codeLengths;
+		codeLengths.Build(lengths, 19);
+
+		std::fill(lengths, lengths + 19, 0);
+		for (unsigned I = 0; I < nLiterals + nDistances;)
+		{
+			unsigned symbol = this->Decode(codeLengths), repeat = 0;
+			unsigned char value = 0;
+			if (symbol < 16)
+			{
+				lengths[I++] = static_cast<unsigned char>(symbol);
+				continue;
+			}
+			else if (symbol == 16)
+			{
+				if (I == 0)
+					throw std::runtime_error("The compressed stream has invalid code lengths.");
+				value = lengths[I - 1];
+				repeat = 3 + this->GetBits(2);
+			}
+			else if (symbol == 17)
+				repeat = 3 + this->GetBits(3);
+			else
+				repeat = 11 + this->GetBits(7);
+			if (I + repeat > nLiterals + nDistances)
+				throw std::runtime_error("The compressed stream has invalid code lengths.");
+			std::fill(lengths + I, lengths + I + repeat, value);
+			I += repeat;
+		}
+		if (lengths[256] == 0)
+			throw std::runtime_error("The compressed stream has no end of block code.");
+		this->literals_.Build(lengths, nLiterals);
+		this->distances_.Build(lengths + nLiterals, nDistances);
+	}
+}
+
+#endif
@@ -0,0 +1,162 @@
+#if !defined(INSTRUMENTATION_H)
+#define INSTRUMENTATION_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Timers and counters of operations, accumulated per thread into a global registry.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "memory_tracker.h"
+
+namespace Imaging
+{
+	/** Totals of an operation over every thread. */
+	class OperationStats
+	{
+	public:
+		OperationStats(void);
+
+		std::string name;
+		unsigned long long calls, bytes, pixels;
+		double seconds, maxSeconds;
+
+		/** Allocations during the calls, counted if MemoryTracker is installed. */
+		AllocationTotals allocations;
+	};
+
+	/** Global registry of operations, each of which counts calls, time, bytes and pixels.
+
+	Each thread adds to its own counters without locking or contention, so recording does
+	not slow down other threads; the counters of all threads are summed only when they are
+	read. The counters of a thread are kept after the thread ends.
+	Primitives are instrumented by IMAGING_SCOPED_TIMER(), which is compiled out unless
+	IMAGING_INSTRUMENTATION is defined, while this class is always available. */
+	class Instrumentation
+	{
+	public:
+		/** Maximum number of operations. */
+		static const ::size_t maxOperations = MemoryTracker::maxOperations;
+
+		/** Gets the id of an operation, registering the name at the first call.
+
+		@exception std::length_error if maxOperations names have already been registered */
+		static inline ::size_t Register(const std::string &name);
+
+		/** Adds a call of an operation to the counters of this thread. */
+		static inline void Record(::size_t id, unsigned long long nanoseconds,
+			unsigned long long bytes, unsigned long long pixels);
+
+		/** Gets the totals of every operation since the start or the last Reset(), in the
+		order of registration. */
+		static inline std::vector<OperationStats> GetStats(void);
+
+		/** Starts all totals from zero. Calls being recorded by other threads at the moment
+		may be counted on either side. */
+		static inline void Reset(void);
+
+		/** Gets the totals as a JSON object {"operations": [{"name": ..., ...}, ...]}. */
+		static inline std::string ToJson(void);
+
+		/** Gets the totals in the text format of Prometheus, as metrics named
+		<prefix>_operation_calls_total etc. with a label of the operation. */
+		static inline std::string ToPrometheus(const std::string &prefix = "imaging");
+
+	protected:
+		class Counter
+		{
+		public:
+			Counter(void);
+
+			std::atomic<unsigned long long> calls, nanoseconds, maxNanoseconds, bytes, pixels;
+		};
+
+		/** Counters of a thread, written by only the thread. */
+		class ThreadCounters
+		{
+		public:
+			ThreadCounters(void);
+
+			Counter counters[maxOperations];
+			std::atomic<unsigned long long> epoch;
+		};
+
+		/** Plain totals, which are sums of counters. */
+		class Totals
+		{
+		public:
+			Totals(void);
+
+			void Add(const Counter &c, bool withMax);
+
+			unsigned long long calls, nanoseconds, maxNanoseconds, bytes, pixels;
+		};
+
+		/** Removes the counters of a thread from the registry when the thread ends. */
+		class ThreadHolder
+		{
+		public:
+			ThreadHolder(void);
+			~ThreadHolder(void);
+
+			std::shared_ptr<ThreadCounters> counters;
+		};
+
+		class Registry
+		{
+		public:
+			std::mutex lock;
+			std::vector<std::string> names;
+			std::vector<std::shared_ptr<ThreadCounters>> threads;
+			std::vector<Totals> ended, baseline;
+			std::atomic<unsigned long long> epoch;
+		};
+
+		static inline Registry &GetRegistry(void);
+		static inline ThreadCounters &GetThreadCounters(void);
+	};
+
+	/** Times its scope, and records it as a call of an operation when destroyed, also on
+	the timeline of Tracer while it is recording. Allocations in the scope are charged to
+	the operation. */
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer(::size_t id, unsigned long long bytes = 0, unsigned long long pixels = 0);
+		ScopedTimer(const ScopedTimer &src) = delete;
+		ScopedTimer &operator=(const ScopedTimer &src) = delete;
+		~ScopedTimer(void);
+
+	protected:
+		::size_t id_;
+		unsigned long long bytes_, pixels_;
+		AllocationScope scope_;
+		std::chrono::steady_clock::time_point start_;
+	};
+}
+
+#define IMAGING_CONCAT_(a, b) a##b
+#define IMAGING_CONCAT(a, b) IMAGING_CONCAT_(a, b)
+
+/** Records the rest of the enclosing scope as a call of the operation of given name, which
+processes given bytes and pixels.
+
+The name is registered once per call site. The macro expands to nothing, and its arguments
+are not evaluated, unless IMAGING_INSTRUMENTATION is defined. */
+#if defined(IMAGING_INSTRUMENTATION)
+#define IMAGING_SCOPED_TIMER(name, bytes, pixels) \
+	static const ::size_t IMAGING_CONCAT(imagingOperation_, __LINE__) = \
+		Imaging::Instrumentation::Register(name); \
+	Imaging::ScopedTimer IMAGING_CONCAT(imagingTimer_, __LINE__)( \
+		IMAGING_CONCAT(imagingOperation_, __LINE__), (bytes), (pixels))
+#else
+#define IMAGING_SCOPED_TIMER(name, bytes, pixels)
+#endif
+
+#include "trace.h"
+#include "instrumentation_inl.h"
+
+#endif
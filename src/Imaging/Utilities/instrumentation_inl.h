@@ -0,0 +1,274 @@
+#if !defined(INSTRUMENTATION_INL_H)
+#define INSTRUMENTATION_INL_H
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// OperationStats class
+
+	inline OperationStats::OperationStats(void) : calls(0), bytes(0), pixels(0), seconds(0.0),
+		maxSeconds(0.0) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Instrumentation class
+
+	inline Instrumentation::Counter::Counter(void) : calls(0), nanoseconds(0),
+		maxNanoseconds(0), bytes(0), pixels(0) {}
+
+	inline Instrumentation::ThreadCounters::ThreadCounters(void) : epoch(0) {}
+
+	inline Instrumentation::Totals::Totals(void) : calls(0), nanoseconds(0),
+		maxNanoseconds(0), bytes(0), pixels(0) {}
+
+	inline void Instrumentation::Totals::Add(const Counter &c, bool withMax)
+	{
+		this->calls += c.calls.load(std::memory_order_relaxed);
+		this->nanoseconds += c.nanoseconds.load(std::memory_order_relaxed);
+		this->bytes += c.bytes.load(std::memory_order_relaxed);
+		this->pixels += c.pixels.load(std::memory_order_relaxed);
+		if (withMax)
+			this->maxNanoseconds = std::max(this->maxNanoseconds,
+				c.maxNanoseconds.load(std::memory_order_relaxed));
+	}
+
+	/** The registry is never destroyed, so threads ending after main() can still retire
+	their counters. */
+	inline Instrumentation::Registry &Instrumentation::GetRegistry(void)
+	{
+		static Registry *registry = []
+		{
+			Registry *r = new Registry;
+			r->ended.resize(maxOperations);
+			r->baseline.resize(maxOperations);
+			r->epoch = 0;
+			return r;
+		}();
+		return *registry;
+	}
+
+	inline Instrumentation::ThreadHolder::ThreadHolder(void) :
+		counters(std::make_shared<ThreadCounters>())
+	{
+		Registry &registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.lock);
+		this->counters->epoch = registry.epoch.load();
+		registry.threads.push_back(this->counters);
+	}
+
+	inline Instrumentation::ThreadHolder::~ThreadHolder(void)
+	{
+		Registry &registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.lock);
+		const bool withMax = this->counters->epoch.load() == registry.epoch.load();
+		for (::size_t I = 0; I != maxOperations; ++I)
+			registry.ended[I].Add(this->counters->counters[I], withMax);
+		registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(),
+			this->counters));
+	}
+
+	inline Instrumentation::ThreadCounters &Instrumentation::GetThreadCounters(void)
+	{
+		static thread_local ThreadHolder holder;
+		return *holder.counters;
+	}
+
+	inline ::size_t Instrumentation::Register(const std::string &name)
+	{
+		Registry &registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.lock);
+		auto it = std::find(registry.names.cbegin(), registry.names.cend(), name);
+		if (it != registry.names.cend())
+			return it - registry.names.cbegin();
+		if (registry.names.size() == maxOperations)
+			throw std::length_error("Too many operations are registered.");
+		registry.names.push_back(name);
+		return registry.names.size() - 1;
+	}
+
+	/** Only this thread writes its counters, so a relaxed load and store replaces an atomic
+	read-modify-write. Maximums of an earlier epoch are cleared by the thread itself at its
+	first call after Reset(). */
+	inline void Instrumentation::Record(::size_t id, unsigned long long nanoseconds,
+		unsigned long long bytes, unsigned long long pixels)
+	{
+		ThreadCounters &t = GetThreadCounters();
+		const unsigned long long epoch = GetRegistry().epoch.load(std::memory_order_relaxed);
+		if (t.epoch.load(std::memory_order_relaxed) != epoch)
+		{
+			for (::size_t I = 0; I != maxOperations; ++I)
+				t.counters[I].maxNanoseconds.store(0, std::memory_order_relaxed);
+			t.epoch.store(epoch, std::memory_order_release);
+		}
+
+		Counter &c = t.counters[id];
+		auto Add = [](std::atomic<unsigned long long> &a, unsigned long long value)
+		{
+			a.store(a.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		};
+		Add(c.calls, 1);
+		Add(c.nanoseconds, nanoseconds);
+		Add(c.bytes, bytes);
+		Add(c.pixels, pixels);
+		if (nanoseconds > c.maxNanoseconds.load(std::memory_order_relaxed))
+			c.maxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+	}
+
+	inline std::vector<OperationStats> Instrumentation::GetStats(void)
+	{
+		Registry &registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.lock);
+		const unsigned long long epoch = registry.epoch.load();
+		std::vector<OperationStats> stats(registry.names.size());
+		for (::size_t I = 0; I != stats.size(); ++I)
+		{
+			Totals sum = registry.ended[I];
+			for (const auto &t : registry.threads)
+				sum.Add(t->counters[I], t->epoch.load(std::memory_order_acquire) == epoch);
+
+			const Totals &base = registry.baseline[I];
+			OperationStats &s = stats[I];
+			s.name = registry.names[I];
+			s.calls = sum.calls - base.calls;
+			s.bytes = sum.bytes - base.bytes;
+			s.pixels = sum.pixels - base.pixels;
+			s.seconds = (sum.nanoseconds - base.nanoseconds) * 1e-9;
+			s.maxSeconds = sum.maxNanoseconds * 1e-9;
+			s.allocations = MemoryTracker::GetOperation(I);
+		}
+		return stats;
+	}
+
+	/** Counters are never cleared by other threads than their owners, so the current sums
+	are kept as a baseline to be subtracted. */
+	inline void Instrumentation::Reset(void)
+	{
+		Registry &registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.lock);
+		for (::size_t I = 0; I != maxOperations; ++I)
+		{
+			registry.ended[I].maxNanoseconds = 0;
+			Totals sum = registry.ended[I];
+			for (const auto &t : registry.threads)
+				sum.Add(t->counters[I], false);
+			registry.baseline[I] = sum;
+		}
+		++registry.epoch;
+		MemoryTracker::ResetOperations();
+	}
+
+	inline std::string Instrumentation::ToJson(void)
+	{
+		auto Escape = [](const std::string &src)
+		{
+			std::string dst;
+			for (auto c : src)
+			{
+				if (c == '"' || c == '\\')
+					dst.push_back('\\');
+				dst.push_back(c);
+			}
+			return dst;
+		};
+
+		const std::vector<OperationStats> stats = GetStats();
+		std::ostringstream out;
+		out << std::setprecision(10) << "{\"operations\": [";
+		for (::size_t I = 0; I != stats.size(); ++I)
+		{
+			const OperationStats &s = stats[I];
+			out << (I == 0 ? "" : ", ") << "{\"name\": \"" << Escape(s.name) << "\", " <<
+				"\"calls\": " << s.calls << ", \"seconds\": " << s.seconds << ", " <<
+				"\"max_seconds\": " << s.maxSeconds << ", \"bytes\": " << s.bytes << ", " <<
+				"\"pixels\": " << s.pixels << ", \"bytes_per_second\": " <<
+				(s.seconds > 0.0 ? s.bytes / s.seconds : 0.0) << ", \"allocations\": " <<
+				s.allocations.allocations << ", \"allocated_bytes\": " <<
+				s.allocations.bytes << ", \"peak_allocated_bytes\": " <<
+				s.allocations.peakBytes << "}";
+		}
+		out << "]}";
+		return out.str();
+	}
+
+	inline std::string Instrumentation::ToPrometheus(const std::string &prefix)
+	{
+		auto Escape = [](const std::string &src)
+		{
+			std::string dst;
+			for (auto c : src)
+			{
+				if (c == '\n')
+					dst += "\\n";
+				else
+				{
+					if (c == '"' || c == '\\')
+						dst.push_back('\\');
+					dst.push_back(c);
+				}
+			}
+			return dst;
+		};
+
+		const std::vector<OperationStats> stats = GetStats();
+		std::ostringstream out;
+		out << std::setprecision(10);
+		auto Write = [&](const std::string &suffix, const char *type, const char *help,
+			double (*value)(const OperationStats &))
+		{
+			const std::string metric = prefix + "_operation_" + suffix;
+			out << "# HELP " << metric << " " << help << "\n# TYPE " << metric << " " << type <<
+				"\n";
+			for (const auto &s : stats)
+				out << metric << "{operation=\"" << Escape(s.name) << "\"} " << value(s) << "\n";
+		};
+		Write("calls_total", "counter", "Number of calls of an operation.",
+			[](const OperationStats &s) { return static_cast<double>(s.calls); });
+		Write("seconds_total", "counter", "Time spent in an operation.",
+			[](const OperationStats &s) { return s.seconds; });
+		Write("max_seconds", "gauge", "Longest call of an operation.",
+			[](const OperationStats &s) { return s.maxSeconds; });
+		Write("bytes_total", "counter", "Bytes read and written by an operation.",
+			[](const OperationStats &s) { return static_cast<double>(s.bytes); });
+		Write("pixels_total", "counter", "Pixels processed by an operation.",
+			[](const OperationStats &s) { return static_cast<double>(s.pixels); });
+		Write("allocations_total", "counter", "Heap allocations during an operation.",
+			[](const OperationStats &s)
+			{
+				return static_cast<double>(s.allocations.allocations);
+			});
+		Write("allocated_bytes_total", "counter", "Bytes allocated during an operation.",
+			[](const OperationStats &s)
+			{
+				return static_cast<double>(s.allocations.bytes);
+			});
+		Write("peak_allocated_bytes", "gauge", "Most bytes held by a call of an operation.",
+			[](const OperationStats &s)
+			{
+				return static_cast<double>(s.allocations.peakBytes);
+			});
+		return out.str();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// ScopedTimer class
+
+	inline ScopedTimer::ScopedTimer(::size_t id, unsigned long long bytes,
+		unsigned long long pixels) : id_(id), bytes_(bytes), pixels_(pixels), scope_(id),
+		start_(std::chrono::steady_clock::now()) {}
+
+	inline ScopedTimer::~ScopedTimer(void)
+	{
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - this->start_).count();
+		Instrumentation::Record(this->id_, static_cast<unsigned long long>(ns), this->bytes_,
+			this->pixels_);
+		if (Tracer::IsEnabled())
+			Tracer::Record(this->id_, this->start_, static_cast<unsigned long long>(ns));
+	}
+}
+
+#endif
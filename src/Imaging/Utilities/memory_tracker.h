@@ -0,0 +1,154 @@
+#if !defined(MEMORY_TRACKER_H)
+#define MEMORY_TRACKER_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Counters of heap allocations of a program, and of the operations making them.
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace Imaging
+{
+	/** Allocations made during the calls of an operation. */
+	class AllocationTotals
+	{
+	public:
+		AllocationTotals(void);
+
+		unsigned long long allocations, bytes, peakBytes;
+	};
+
+	/** Counts live bytes, peak bytes and allocations of every operator new of a program.
+
+	A program opts in by IMAGING_DEFINE_ALLOCATION_HOOKS(), which replaces the global
+	operator new and delete by Allocate() and Free(). Allocations are also added to every
+	AllocationScope open on the allocating thread, so the temporary frames of an operation,
+	e.g., the copy of the ROI in Resize(), are charged to it. ScopedTimer opens a scope for
+	its operation, whose totals are reported by Instrumentation. */
+	class MemoryTracker
+	{
+	public:
+		/** Maximum number of operations, which is that of Instrumentation. */
+		static const ::size_t maxOperations = 256;
+
+		/** Allocates given bytes by malloc() and counts them; returns nullptr on failure. */
+		static inline void *Allocate(::size_t bytes);
+
+		/** Frees a block of Allocate(); p may be nullptr. */
+		static inline void Free(void *p);
+
+		/** Tells whether the hooks are defined, i.e., whether anything has been counted. */
+		static inline bool IsInstalled(void);
+
+		/** Gets the bytes allocated and not freed yet. */
+		static inline unsigned long long GetLiveBytes(void);
+
+		/** Gets the maximum of GetLiveBytes() since the start or the last ResetPeak(). */
+		static inline unsigned long long GetPeakBytes(void);
+
+		/** Starts the peak from the current live bytes. */
+		static inline void ResetPeak(void);
+
+		/** Gets the number and bytes of all allocations since the start. */
+		static inline unsigned long long GetAllocationCount(void);
+		static inline unsigned long long GetAllocatedBytes(void);
+
+		/** Gets the allocations of an operation. peakBytes is the maximum of the bytes held
+		by a call on its thread, above those held when it was called. */
+		static inline AllocationTotals GetOperation(::size_t id);
+
+		/** Starts the totals of every operation from zero. */
+		static inline void ResetOperations(void);
+
+	protected:
+		friend class AllocationScope;
+
+		/** Counters of the program, which are constant-initialized so that the hooks can be
+		called before main(). */
+		class Counters
+		{
+		public:
+			std::atomic<long long> live, peak;
+			std::atomic<unsigned long long> allocations, bytes;
+			std::atomic<unsigned long long> opAllocations[maxOperations],
+				opBytes[maxOperations], opPeak[maxOperations];
+			std::atomic<bool> installed;
+		};
+
+		static inline Counters &GetCounters(void);
+
+		/** Net bytes allocated by this thread. */
+		static inline long long &GetThreadBytes(void);
+
+		static inline void Add(long long bytes);
+	};
+
+	/** Charges the allocations of the calling thread to an operation while it lives.
+
+	Scopes nest; an allocation is charged to every open scope of the thread. */
+	class AllocationScope
+	{
+	public:
+		explicit AllocationScope(::size_t id);
+		AllocationScope(const AllocationScope &src) = delete;
+		AllocationScope &operator=(const AllocationScope &src) = delete;
+		~AllocationScope(void);
+
+	protected:
+		friend class MemoryTracker;
+
+		static inline AllocationScope *&GetCurrent(void);
+
+		::size_t id_;
+		long long entry_, max_;
+		AllocationScope *parent_;
+	};
+}
+
+/** Replaces the global operator new and delete by MemoryTracker::Allocate() and Free().
+
+Placed at global scope of exactly one source file of a program. */
+#if defined(__cpp_sized_deallocation)
+#define IMAGING_DEFINE_SIZED_DELETE_HOOKS() \
+	void operator delete(void *p, std::size_t) noexcept { Imaging::MemoryTracker::Free(p); } \
+	void operator delete[](void *p, std::size_t) noexcept { Imaging::MemoryTracker::Free(p); }
+#else
+#define IMAGING_DEFINE_SIZED_DELETE_HOOKS()
+#endif
+
+#define IMAGING_DEFINE_ALLOCATION_HOOKS() \
+	void *operator new(std::size_t n) \
+	{ \
+		if (void *p = Imaging::MemoryTracker::Allocate(n)) \
+			return p; \
+		throw std::bad_alloc(); \
+	} \
+	void *operator new[](std::size_t n) \
+	{ \
+		if (void *p = Imaging::MemoryTracker::Allocate(n)) \
+			return p; \
+		throw std::bad_alloc(); \
+	} \
+	void *operator new(std::size_t n, const std::nothrow_t &) noexcept \
+	{ \
+		return Imaging::MemoryTracker::Allocate(n); \
+	} \
+	void *operator new[](std::size_t n, const std::nothrow_t &) noexcept \
+	{ \
+		return Imaging::MemoryTracker::Allocate(n); \
+	} \
+	void operator delete(void *p) noexcept { Imaging::MemoryTracker::Free(p); } \
+	void operator delete[](void *p) noexcept { Imaging::MemoryTracker::Free(p); } \
+	void operator delete(void *p, const std::nothrow_t &) noexcept \
+	{ \
+		Imaging::MemoryTracker::Free(p); \
+	} \
+	void operator delete[](void *p, const std::nothrow_t &) noexcept \
+	{ \
+		Imaging::MemoryTracker::Free(p); \
+	} \
+	IMAGING_DEFINE_SIZED_DELETE_HOOKS()
+
+#include "memory_tracker_inl.h"
+
+#endif
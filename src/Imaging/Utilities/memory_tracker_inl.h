@@ -0,0 +1,159 @@
+#if !defined(MEMORY_TRACKER_INL_H)
+#define MEMORY_TRACKER_INL_H
+
+#include <cstdlib>
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// AllocationTotals class
+
+	inline AllocationTotals::AllocationTotals(void) : allocations(0), bytes(0), peakBytes(0) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// MemoryTracker class
+
+	inline MemoryTracker::Counters &MemoryTracker::GetCounters(void)
+	{
+		static Counters counters;
+		return counters;
+	}
+
+	inline long long &MemoryTracker::GetThreadBytes(void)
+	{
+		static thread_local long long bytes = 0;
+		return bytes;
+	}
+
+	/** Every counter is updated with relaxed atomics; their values are only statistics. */
+	inline void MemoryTracker::Add(long long bytes)
+	{
+		Counters &c = GetCounters();
+		const long long live = c.live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		long long &net = GetThreadBytes();
+		net += bytes;
+		if (bytes < 0)
+			return;
+
+		c.allocations.fetch_add(1, std::memory_order_relaxed);
+		c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+		long long peak = c.peak.load(std::memory_order_relaxed);
+		while (live > peak && !c.peak.compare_exchange_weak(peak, live,
+			std::memory_order_relaxed)) {}
+		for (AllocationScope *s = AllocationScope::GetCurrent(); s != nullptr; s = s->parent_)
+		{
+			c.opAllocations[s->id_].fetch_add(1, std::memory_order_relaxed);
+			c.opBytes[s->id_].fetch_add(bytes, std::memory_order_relaxed);
+			if (net > s->max_)
+				s->max_ = net;
+		}
+	}
+
+	/** The size of a block is kept in a header aligned for any type before the block. */
+	inline void *MemoryTracker::Allocate(::size_t bytes)
+	{
+		const ::size_t header = alignof(std::max_align_t) > sizeof(::size_t) ?
+			alignof(std::max_align_t) : sizeof(::size_t);
+		void *p = std::malloc(header + (bytes == 0 ? 1 : bytes));
+		if (p == nullptr)
+			return nullptr;
+		*static_cast<::size_t *>(p) = bytes;
+		GetCounters().installed.store(true, std::memory_order_relaxed);
+		Add(static_cast<long long>(bytes));
+		return static_cast<char *>(p) + header;
+	}
+
+	inline void MemoryTracker::Free(void *p)
+	{
+		if (p == nullptr)
+			return;
+		const ::size_t header = alignof(std::max_align_t) > sizeof(::size_t) ?
+			alignof(std::max_align_t) : sizeof(::size_t);
+		void *block = static_cast<char *>(p) - header;
+		Add(-static_cast<long long>(*static_cast<::size_t *>(block)));
+		std::free(block);
+	}
+
+	inline bool MemoryTracker::IsInstalled(void)
+	{
+		return GetCounters().installed.load(std::memory_order_relaxed);
+	}
+
+	inline unsigned long long MemoryTracker::GetLiveBytes(void)
+	{
+		const long long live = GetCounters().live.load(std::memory_order_relaxed);
+		return live > 0 ? static_cast<unsigned long long>(live) : 0;
+	}
+
+	inline unsigned long long MemoryTracker::GetPeakBytes(void)
+	{
+		const long long peak = GetCounters().peak.load(std::memory_order_relaxed);
+		return peak > 0 ? static_cast<unsigned long long>(peak) : 0;
+	}
+
+	inline void MemoryTracker::ResetPeak(void)
+	{
+		Counters &c = GetCounters();
+		c.peak.store(c.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	inline unsigned long long MemoryTracker::GetAllocationCount(void)
+	{
+		return GetCounters().allocations.load(std::memory_order_relaxed);
+	}
+
+	inline unsigned long long MemoryTracker::GetAllocatedBytes(void)
+	{
+		return GetCounters().bytes.load(std::memory_order_relaxed);
+	}
+
+	inline AllocationTotals MemoryTracker::GetOperation(::size_t id)
+	{
+		Counters &c = GetCounters();
+		AllocationTotals totals;
+		totals.allocations = c.opAllocations[id].load(std::memory_order_relaxed);
+		totals.bytes = c.opBytes[id].load(std::memory_order_relaxed);
+		totals.peakBytes = c.opPeak[id].load(std::memory_order_relaxed);
+		return totals;
+	}
+
+	inline void MemoryTracker::ResetOperations(void)
+	{
+		Counters &c = GetCounters();
+		for (::size_t I = 0; I != maxOperations; ++I)
+		{
+			c.opAllocations[I].store(0, std::memory_order_relaxed);
+			c.opBytes[I].store(0, std::memory_order_relaxed);
+			c.opPeak[I].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// AllocationScope class
+
+	inline AllocationScope *&AllocationScope::GetCurrent(void)
+	{
+		static thread_local AllocationScope *current = nullptr;
+		return current;
+	}
+
+	inline AllocationScope::AllocationScope(::size_t id) : id_(id),
+		entry_(MemoryTracker::GetThreadBytes()), max_(entry_), parent_(GetCurrent())
+	{
+		GetCurrent() = this;
+	}
+
+	inline AllocationScope::~AllocationScope(void)
+	{
+		GetCurrent() = this->parent_;
+		std::atomic<unsigned long long> &peak =
+			MemoryTracker::GetCounters().opPeak[this->id_];
+		const unsigned long long bytes = static_cast<unsigned long long>(this->max_ -
+			this->entry_);
+		unsigned long long old = peak.load(std::memory_order_relaxed);
+		while (bytes > old && !peak.compare_exchange_weak(old, bytes,
+			std::memory_order_relaxed)) {}
+	}
+}
+
+#endif
@@ -0,0 +1,42 @@
+#if !defined(PARALLEL_H)
+#define PARALLEL_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Global functions for data-parallel loops.
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace Imaging
+{
+	/** Gets the number of threads used by ParallelFor().
+
+	The default is the number of hardware threads, i.e.,
+	std::thread::hardware_concurrency(), or 1 if it is unknown. */
+	inline unsigned int GetThreadCount(void);
+
+	/** Sets the number of threads used by ParallelFor().
+
+	@param [in] n	number of threads; 0 restores the default */
+	inline void SetThreadCount(unsigned int n);
+
+	/** Splits [first, last) into contiguous ranges and runs func(begin, end) on each range
+	by a separate thread.
+
+	The calling thread processes the last range, and the function returns after all ranges
+	are completed. If the range is smaller than two grains, or only one thread is available,
+	func(first, last) is called on the calling thread without creating any thread.
+	The other threads are started on every call and joined before it returns, which
+	allocates their states, so a loop is allocation-free only on one thread.
+	@param [in] grain	minimum number of items per range
+	@exception any exception thrown by func; the first one is rethrown after all threads
+	have been joined. */
+	template <typename F>
+	void ParallelFor(::size_t first, ::size_t last, ::size_t grain, F func);
+}
+
+#include "parallel_inl.h"
+
+#endif
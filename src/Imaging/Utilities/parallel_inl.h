@@ -0,0 +1,79 @@
+#if !defined(PARALLEL_INL_H)
+#define PARALLEL_INL_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Global functions for data-parallel loops.
+
+namespace Imaging
+{
+	/** The number of threads is kept in a function-local static object, so this header
+	does not need a translation unit. */
+	inline std::atomic<unsigned int> &GetThreadCountSetting(void)
+	{
+		static std::atomic<unsigned int> count(0);
+		return count;
+	}
+
+	inline unsigned int GetThreadCount(void)
+	{
+		unsigned int n = GetThreadCountSetting().load();
+		if (n == 0)
+			n = std::thread::hardware_concurrency();
+		return n == 0 ? 1 : n;
+	}
+
+	inline void SetThreadCount(unsigned int n)
+	{
+		GetThreadCountSetting().store(n);
+	}
+
+	template <typename F>
+	void ParallelFor(::size_t first, ::size_t last, ::size_t grain, F func)
+	{
+		if (last <= first)
+			return;
+		::size_t count = last - first;
+		if (grain == 0)
+			grain = 1;
+		::size_t nRanges = std::min(static_cast<::size_t>(GetThreadCount()),
+			count / grain);
+		if (nRanges <= 1)
+		{
+			func(first, last);
+			return;
+		}
+
+		// Distribute the remainder one by one to the leading ranges.
+		::size_t length = count / nRanges, remainder = count % nRanges;
+		std::vector<std::thread> threads;
+		std::vector<std::exception_ptr> errors(nRanges);
+		threads.reserve(nRanges - 1);
+		::size_t begin = first;
+		for (::size_t R = 0; R != nRanges; ++R)
+		{
+			::size_t end = begin + length + (R < remainder ? 1 : 0);
+			auto task = [&func, &errors, R, begin, end]()
+			{
+				try
+				{
+					func(begin, end);
+				}
+				catch (...)
+				{
+					errors[R] = std::current_exception();
+				}
+			};
+			if (R + 1 == nRanges)
+				task();
+			else
+				threads.push_back(std::thread(task));
+			begin = end;
+		}
+		for (auto it = threads.begin(); it != threads.end(); ++it)
+			it->join();
+		for (auto it = errors.cbegin(); it != errors.cend(); ++it)
+			if (*it)
+				std::rethrow_exception(*it);
+	}
+}
+
+#endif
@@ -0,0 +1,131 @@
+#if !defined(RAW_FILE_H)
+#define RAW_FILE_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Unbuffered file access by positions for raw image data.
+
+#include <string>
+#include <vector>
+
+namespace Imaging
+{
+	/** Block of memory whose beginning is aligned to given number of bytes.
+
+	Unbuffered (direct) I/O requires the memory, the file position and the number of bytes
+	to be aligned to the block size of the device. */
+	class AlignedBuffer
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Default constructors.
+		AlignedBuffer(void);
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		AlignedBuffer(::size_t nBytes, ::size_t alignment);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		char *GetPointer(void);
+		const char *GetPointer(void) const;
+		::size_t GetSize(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Changes the size, keeping the memory if it is already large enough. */
+		void Resize(::size_t nBytes);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Data.
+		std::vector<char> data_;
+		::size_t alignment_, offset_, size_;
+	};
+
+	/** File opened for reading or writing at given positions.
+
+	Each access is a single system call (pread/pwrite on POSIX, ReadFile/WriteFile on
+	Windows) at an explicit position, so multiple threads can access the same file without
+	sharing a file pointer.
+	With direct I/O, the page cache is bypassed (O_DIRECT on Linux, F_NOCACHE on macOS,
+	FILE_FLAG_NO_BUFFERING on Windows). Positions, sizes and memory of every access must
+	then be multiples of GetDirectAlignment(). If the file system does not support direct
+	I/O, the file is opened buffered and IsDirect() returns false. */
+	class RawFile
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Types and constants.
+		enum class Mode {READ, WRITE};
+
+		//////////////////////////////////////////////////
+		// Default constructors.
+		RawFile(void);
+
+		RawFile(const RawFile &src) = delete;
+		RawFile &operator=(const RawFile &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Custom constructors.
+		RawFile(const std::string &path, Mode mode, bool direct = false);
+
+		//////////////////////////////////////////////////
+		// Destructors.
+		~RawFile(void);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+		bool IsOpen(void) const;
+		bool IsDirect(void) const;
+
+		/** Gets the alignment required by direct I/O, which is safe for common devices. */
+		static ::size_t GetDirectAlignment(void);
+
+		/** Gets the current size of the file in bytes. */
+		unsigned long long GetSize(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Opens a file. WRITE creates a new file or truncates an existing file.
+
+		@exception std::runtime_error	if the file cannot be opened */
+		void Open(const std::string &path, Mode mode, bool direct = false);
+		void Close(void);
+
+		/** Reads up to given bytes at a position, and returns the number of bytes read,
+		which is less than requested only at the end of the file. */
+		::size_t ReadAt(unsigned long long position, void *dst, ::size_t nBytes) const;
+
+		/** Writes given bytes at a position.
+
+		@exception std::runtime_error	if not all bytes are written, e.g., the disk is full */
+		void WriteAt(unsigned long long position, const void *src, ::size_t nBytes);
+
+		/** Changes the size of the file, e.g., to cut off the padding of the last aligned
+		block written by direct I/O. */
+		void Truncate(unsigned long long size);
+
+		/** Flushes the data written so far to the device (fsync). */
+		void Sync(void);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void CheckOpen(void) const;
+
+		//////////////////////////////////////////////////
+		// Data.
+#if defined(WIN32)
+		void *handle_;
+#else
+		int handle_;
+#endif
+		bool direct_;
+		std::string path_;
+	};
+}
+
+#include "raw_file_inl.h"
+
+#endif
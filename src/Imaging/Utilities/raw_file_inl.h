@@ -0,0 +1,296 @@
+#if !defined(RAW_FILE_INL_H)
+#define RAW_FILE_INL_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Unbuffered file access by positions for raw image data.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// AlignedBuffer class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Default constructors.
+	inline AlignedBuffer::AlignedBuffer(void) : alignment_(1), offset_(0), size_(0) {}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	inline AlignedBuffer::AlignedBuffer(::size_t nBytes, ::size_t alignment) :
+		alignment_(alignment == 0 ? 1 : alignment), offset_(0), size_(0)
+	{
+		this->Resize(nBytes);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline char *AlignedBuffer::GetPointer(void)
+	{
+		return this->data_.data() + this->offset_;
+	}
+
+	inline const char *AlignedBuffer::GetPointer(void) const
+	{
+		return this->data_.data() + this->offset_;
+	}
+
+	inline ::size_t AlignedBuffer::GetSize(void) const
+	{
+		return this->size_;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+
+	/** The vector is over-allocated by the alignment, and the beginning is moved forward to
+	the next aligned address. */
+	inline void AlignedBuffer::Resize(::size_t nBytes)
+	{
+		if (nBytes + this->alignment_ > this->data_.size())
+		{
+			this->data_.resize(nBytes + this->alignment_);
+			::size_t address = reinterpret_cast<::size_t>(this->data_.data());
+			this->offset_ = (this->alignment_ - address % this->alignment_) % this->alignment_;
+		}
+		this->size_ = nBytes;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// RawFile class
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Default constructors.
+#if defined(WIN32)
+	inline RawFile::RawFile(void) : handle_(INVALID_HANDLE_VALUE), direct_(false) {}
+#else
+	inline RawFile::RawFile(void) : handle_(-1), direct_(false) {}
+#endif
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	inline RawFile::RawFile(const std::string &path, Mode mode, bool direct) : RawFile()
+	{
+		this->Open(path, mode, direct);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Destructors.
+	inline RawFile::~RawFile(void)
+	{
+		this->Close();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline bool RawFile::IsOpen(void) const
+	{
+#if defined(WIN32)
+		return this->handle_ != INVALID_HANDLE_VALUE;
+#else
+		return this->handle_ != -1;
+#endif
+	}
+
+	inline bool RawFile::IsDirect(void) const
+	{
+		return this->direct_;
+	}
+
+	inline ::size_t RawFile::GetDirectAlignment(void)
+	{
+		return 4096;
+	}
+
+	inline unsigned long long RawFile::GetSize(void) const
+	{
+		this->CheckOpen();
+#if defined(WIN32)
+		LARGE_INTEGER size;
+		if (!::GetFileSizeEx(this->handle_, &size))
+			throw std::runtime_error("Failed to get the size of " + this->path_);
+		return static_cast<unsigned long long>(size.QuadPart);
+#else
+		struct stat info;
+		if (::fstat(this->handle_, &info) != 0)
+			throw std::runtime_error("Failed to get the size of " + this->path_);
+		return static_cast<unsigned long long>(info.st_size);
+#endif
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+	inline void RawFile::CheckOpen(void) const
+	{
+		if (!this->IsOpen())
+			throw std::logic_error("The file is not open.");
+	}
+
+	/** If direct I/O is rejected by the file system (EINVAL), e.g., tmpfs, the file is
+	opened again without it. */
+	inline void RawFile::Open(const std::string &path, Mode mode, bool direct)
+	{
+		this->Close();
+		this->path_ = path;
+		this->direct_ = direct;
+#if defined(WIN32)
+		DWORD access = mode == Mode::READ ? GENERIC_READ : GENERIC_WRITE;
+		DWORD creation = mode == Mode::READ ? OPEN_EXISTING : CREATE_ALWAYS;
+		DWORD flags = FILE_ATTRIBUTE_NORMAL | (direct ? FILE_FLAG_NO_BUFFERING : 0);
+		this->handle_ = ::CreateFileA(path.c_str(), access, FILE_SHARE_READ, NULL, creation,
+			flags, NULL);
+		if (this->handle_ == INVALID_HANDLE_VALUE)
+			throw std::runtime_error("Failed to open " + path);
+#else
+		int flags = mode == Mode::READ ? O_RDONLY : (O_WRONLY | O_CREAT | O_TRUNC);
+#if defined(O_DIRECT)
+		if (direct)
+		{
+			this->handle_ = ::open(path.c_str(), flags | O_DIRECT, 0644);
+			if (this->handle_ == -1 && errno == EINVAL)
+				this->direct_ = false;
+		}
+		if (!this->direct_)
+			this->handle_ = ::open(path.c_str(), flags, 0644);
+#else
+		this->handle_ = ::open(path.c_str(), flags, 0644);
+#if defined(F_NOCACHE)
+		if (this->handle_ != -1 && direct)
+			::fcntl(this->handle_, F_NOCACHE, 1);
+#else
+		this->direct_ = false;
+#endif
+#endif
+		if (this->handle_ == -1)
+		{
+			std::ostringstream errMsg;
+			errMsg << "Failed to open " << path << ": " << std::strerror(errno);
+			throw std::runtime_error(errMsg.str());
+		}
+#endif
+	}
+
+	inline void RawFile::Close(void)
+	{
+		if (!this->IsOpen())
+			return;
+#if defined(WIN32)
+		::CloseHandle(this->handle_);
+		this->handle_ = INVALID_HANDLE_VALUE;
+#else
+		::close(this->handle_);
+		this->handle_ = -1;
+#endif
+	}
+
+	inline ::size_t RawFile::ReadAt(unsigned long long position, void *dst,
+		::size_t nBytes) const
+	{
+		this->CheckOpen();
+		char *it_dst = static_cast<char *>(dst);
+		::size_t done = 0;
+		while (done != nBytes)
+		{
+#if defined(WIN32)
+			OVERLAPPED overlapped = {};
+			unsigned long long offset = position + done;
+			overlapped.Offset = static_cast<DWORD>(offset);
+			overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+			DWORD count = static_cast<DWORD>(std::min<::size_t>(nBytes - done, 1 << 30));
+			DWORD nRead = 0;
+			if (!::ReadFile(this->handle_, it_dst + done, count, &nRead, &overlapped) &&
+				::GetLastError() != ERROR_HANDLE_EOF)
+				throw std::runtime_error("Failed to read " + this->path_);
+#else
+			::ssize_t nRead = ::pread(this->handle_, it_dst + done, nBytes - done,
+				static_cast<::off_t>(position + done));
+			if (nRead < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				std::ostringstream errMsg;
+				errMsg << "Failed to read " << this->path_ << ": " << std::strerror(errno);
+				throw std::runtime_error(errMsg.str());
+			}
+#endif
+			if (nRead == 0)
+				break;		// end of file
+			done += static_cast<::size_t>(nRead);
+		}
+		return done;
+	}
+
+	inline void RawFile::WriteAt(unsigned long long position, const void *src,
+		::size_t nBytes)
+	{
+		this->CheckOpen();
+		const char *it_src = static_cast<const char *>(src);
+		::size_t done = 0;
+		while (done != nBytes)
+		{
+#if defined(WIN32)
+			OVERLAPPED overlapped = {};
+			unsigned long long offset = position + done;
+			overlapped.Offset = static_cast<DWORD>(offset);
+			overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+			DWORD count = static_cast<DWORD>(std::min<::size_t>(nBytes - done, 1 << 30));
+			DWORD nWritten = 0;
+			if (!::WriteFile(this->handle_, it_src + done, count, &nWritten, &overlapped) ||
+				nWritten == 0)
+				throw std::runtime_error("Failed to write " + this->path_);
+#else
+			::ssize_t nWritten = ::pwrite(this->handle_, it_src + done, nBytes - done,
+				static_cast<::off_t>(position + done));
+			if (nWritten < 0 && errno == EINTR)
+				continue;
+			if (nWritten <= 0)
+			{
+				std::ostringstream errMsg;
+				errMsg << "Failed to write " << this->path_ << ": " << std::strerror(errno);
+				throw std::runtime_error(errMsg.str());
+			}
+#endif
+			done += static_cast<::size_t>(nWritten);
+		}
+	}
+
+	inline void RawFile::Truncate(unsigned long long size)
+	{
+		this->CheckOpen();
+#if defined(WIN32)
+		LARGE_INTEGER position;
+		position.QuadPart = static_cast<LONGLONG>(size);
+		if (!::SetFilePointerEx(this->handle_, position, NULL, FILE_BEGIN) ||
+			!::SetEndOfFile(this->handle_))
+			throw std::runtime_error("Failed to resize " + this->path_);
+#else
+		if (::ftruncate(this->handle_, static_cast<::off_t>(size)) != 0)
+			throw std::runtime_error("Failed to resize " + this->path_);
+#endif
+	}
+
+	inline void RawFile::Sync(void)
+	{
+		this->CheckOpen();
+#if defined(WIN32)
+		if (!::FlushFileBuffers(this->handle_))
+#else
+		if (::fsync(this->handle_) != 0)
+#endif
+			throw std::runtime_error("Failed to flush " + this->path_);
+	}
+}
+
+#endif
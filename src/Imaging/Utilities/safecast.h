@@ -4,7 +4,9 @@
 // Global functions and operators for safe casting and conversion.
 
 //#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <stdexcept>
 #include <type_traits>
 
 namespace Imaging
@@ -121,6 +123,20 @@ namespace Imaging
 	typename std::enable_if<std::is_floating_point<U>::value && std::is_integral<T>::value,
 		T>::type RoundAs(U src);
 
+	/** Converts a floating point value into either an integral type or a floating point
+	type.
+
+	This function is used when the destination type is a template parameter which could be
+	any arithmetic type. An integral destination is rounded off by RoundAs() with overflow
+	checking, and a floating point destination is simply casted. */
+	template <typename T, typename U>
+	typename std::enable_if<std::is_floating_point<U>::value && std::is_integral<T>::value,
+		T>::type RoundOrCast(U src);
+
+	template <typename T, typename U>
+	typename std::enable_if<std::is_floating_point<U>::value &&
+		std::is_floating_point<T>::value, T>::type RoundOrCast(U src);
+
 	/** Negates signed integral value while checking the source value value.
 
 	The minimum value of signed integral values is one step further than the maximum value.
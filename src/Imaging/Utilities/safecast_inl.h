@@ -99,6 +99,20 @@ namespace Imaging
 #endif
 	}
 
+	template <typename T, typename U>
+	typename std::enable_if<std::is_floating_point<U>::value && std::is_integral<T>::value,
+		T>::type RoundOrCast(U src)
+	{
+		return RoundAs<T>(src);
+	}
+
+	template <typename T, typename U>
+	typename std::enable_if<std::is_floating_point<U>::value &&
+		std::is_floating_point<T>::value, T>::type RoundOrCast(U src)
+	{
+		return static_cast<T>(src);
+	}
+
 	template <typename T>
 	typename std::enable_if<std::is_arithmetic<T>::value, T>::type
 		SafeAdd(T a, T b)
@@ -0,0 +1,72 @@
+#if !defined(THREAD_POOL_H)
+#define THREAD_POOL_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Pool of worker threads for asynchronous tasks.
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Imaging
+{
+	/** Fixed number of worker threads which run submitted tasks in the order of submission.
+
+	Unlike ParallelFor(), the threads live as long as the pool, so it is used for
+	long-running or repeated background work such as file I/O.
+	The destructor runs every task already submitted, then joins the threads. */
+	class ThreadPool
+	{
+	public:
+		//////////////////////////////////////////////////
+		// Custom constructors.
+
+		/** Starts given number of threads; 0 means GetThreadCount(). */
+		explicit ThreadPool(unsigned int nThreads = 0);
+
+		ThreadPool(const ThreadPool &src) = delete;
+		ThreadPool &operator=(const ThreadPool &src) = delete;
+
+		//////////////////////////////////////////////////
+		// Destructors.
+		~ThreadPool(void);
+
+		//////////////////////////////////////////////////
+		// Accessors.
+
+		/** Gets the number of threads. */
+		unsigned int GetSize(void) const;
+
+		//////////////////////////////////////////////////
+		// Methods.
+
+		/** Queues func() and returns a future of its result.
+
+		An exception thrown by func() is stored in the future. */
+		template <typename F>
+		std::future<typename std::result_of<F()>::type> Submit(F func);
+
+	protected:
+		//////////////////////////////////////////////////
+		// Methods.
+		void Run(void);
+
+		//////////////////////////////////////////////////
+		// Data.
+		std::mutex lock_;
+		std::condition_variable ready_;
+		std::deque<std::function<void(void)>> tasks_;
+		bool stop_;
+		std::vector<std::thread> threads_;
+	};
+}
+
+#include "thread_pool_inl.h"
+
+#endif
@@ -0,0 +1,79 @@
+#if !defined(THREAD_POOL_INL_H)
+#define THREAD_POOL_INL_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Pool of worker threads for asynchronous tasks.
+
+#include "parallel.h"
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Custom constructors.
+	inline ThreadPool::ThreadPool(unsigned int nThreads) : stop_(false)
+	{
+		if (nThreads == 0)
+			nThreads = GetThreadCount();
+		this->threads_.reserve(nThreads);
+		for (unsigned int I = 0; I != nThreads; ++I)
+			this->threads_.push_back(std::thread(&ThreadPool::Run, this));
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Destructors.
+	inline ThreadPool::~ThreadPool(void)
+	{
+		{
+			std::lock_guard<std::mutex> guard(this->lock_);
+			this->stop_ = true;
+		}
+		this->ready_.notify_all();
+		for (auto it = this->threads_.begin(); it != this->threads_.end(); ++it)
+			it->join();
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Accessors.
+	inline unsigned int ThreadPool::GetSize(void) const
+	{
+		return static_cast<unsigned int>(this->threads_.size());
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Methods.
+
+	/** std::function<T> requires a copyable object, so the packaged task is shared. */
+	template <typename F>
+	std::future<typename std::result_of<F()>::type> ThreadPool::Submit(F func)
+	{
+		typedef typename std::result_of<F()>::type ResultType;
+		auto task = std::make_shared<std::packaged_task<ResultType(void)>>(std::move(func));
+		std::future<ResultType> result = task->get_future();
+		{
+			std::lock_guard<std::mutex> guard(this->lock_);
+			if (this->stop_)
+				throw std::logic_error("The thread pool has been stopped.");
+			this->tasks_.push_back([task]() { (*task)(); });
+		}
+		this->ready_.notify_one();
+		return result;
+	}
+
+	inline void ThreadPool::Run(void)
+	{
+		for (;;)
+		{
+			std::function<void(void)> task;
+			{
+				std::unique_lock<std::mutex> guard(this->lock_);
+				this->ready_.wait(guard, [this]() { return this->stop_ || !this->tasks_.empty(); });
+				if (this->tasks_.empty())
+					return;		// stopped and drained
+				task = std::move(this->tasks_.front());
+				this->tasks_.pop_front();
+			}
+			task();
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,109 @@
+#if !defined(TRACE_H)
+#define TRACE_H
+////////////////////////////////////////////////////////////////////////////////////////
+// Timeline of operations on each thread in the Chrome trace event format.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Imaging
+{
+	/** Recorder of the calls of operations of Instrumentation on a timeline of each thread,
+	which is written as Chrome trace event JSON to be loaded into chrome://tracing or
+	Perfetto.
+
+	Each call is recorded by the thread making it into its own buffer of events, without
+	locking; when the buffer is full, later events are dropped and counted. A call is
+	recorded as a complete event, i.e., its beginning and its duration.
+	Calls are recorded by ScopedTimer, so primitives are traced only if
+	IMAGING_INSTRUMENTATION is defined. Nothing is recorded until Start() is called. */
+	class Tracer
+	{
+	public:
+		/** Starts recording, discarding events recorded before.
+
+		@param [in] eventsPerThread	capacity of the buffer of each thread */
+		static inline void Start(::size_t eventsPerThread = 65536);
+
+		/** Stops recording. Recorded events are kept until the next Start(). */
+		static inline void Stop(void);
+
+		static inline bool IsEnabled(void);
+
+		/** Names the calling thread on the timeline, e.g., after the stage it runs. */
+		static inline void SetThreadName(const std::string &name);
+
+		/** Adds a call of an operation of Instrumentation to the buffer of this thread. */
+		static inline void Record(::size_t id, std::chrono::steady_clock::time_point start,
+			unsigned long long nanoseconds);
+
+		/** Gets the number of events dropped since Start() because buffers were full. */
+		static inline unsigned long long GetDroppedCount(void);
+
+		/** Gets the recorded events as a Chrome trace event JSON object. */
+		static inline std::string ToJson(void);
+
+		/** Writes ToJson() to a file.
+
+		@exception std::runtime_error if the file cannot be opened */
+		static inline void Write(const std::string &path);
+
+	protected:
+		class Event
+		{
+		public:
+			::size_t id;
+			long long start, duration;
+		};
+
+		/** Events of a thread. The owner writes events and then publishes the count, so
+		readers see only complete events. */
+		class ThreadTrace
+		{
+		public:
+			ThreadTrace(unsigned int tid);
+
+			std::unique_ptr<Event[]> events;
+			::size_t capacity;
+			std::atomic<::size_t> count;
+			std::atomic<unsigned long long> dropped, generation;
+			std::atomic<bool> ended;
+			unsigned int tid;
+			std::string name;
+		};
+
+		/** Marks the events of a thread as ended when the thread ends. */
+		class ThreadHolder
+		{
+		public:
+			ThreadHolder(void);
+			~ThreadHolder(void);
+
+			std::shared_ptr<ThreadTrace> trace;
+		};
+
+		class State
+		{
+		public:
+			std::mutex lock;
+			std::vector<std::shared_ptr<ThreadTrace>> threads;
+			std::atomic<bool> enabled;
+			std::atomic<unsigned long long> generation;
+			std::atomic<::size_t> capacity;
+			std::atomic<long long> origin;
+			unsigned int nextTid;
+		};
+
+		static inline State &GetState(void);
+		static inline ThreadTrace &GetThreadTrace(void);
+	};
+}
+
+#include "instrumentation.h"
+#include "trace_inl.h"
+
+#endif
@@ -0,0 +1,207 @@
+#if !defined(TRACE_INL_H)
+#define TRACE_INL_H
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace Imaging
+{
+	////////////////////////////////////////////////////////////////////////////////////////
+	// Tracer class
+
+	inline Tracer::ThreadTrace::ThreadTrace(unsigned int tid) : capacity(0), count(0),
+		dropped(0), generation(0), ended(false), tid(tid) {}
+
+	/** The state is never destroyed, so threads ending after main() can still mark their
+	events. */
+	inline Tracer::State &Tracer::GetState(void)
+	{
+		static State *state = []
+		{
+			State *s = new State;
+			s->enabled = false;
+			s->generation = 0;
+			s->capacity = 0;
+			s->origin = 0;
+			s->nextTid = 1;
+			return s;
+		}();
+		return *state;
+	}
+
+	inline Tracer::ThreadHolder::ThreadHolder(void)
+	{
+		State &state = GetState();
+		std::lock_guard<std::mutex> lock(state.lock);
+		this->trace = std::make_shared<ThreadTrace>(state.nextTid++);
+		state.threads.push_back(this->trace);
+	}
+
+	/** Events of the thread are kept to be written, unless there is none. */
+	inline Tracer::ThreadHolder::~ThreadHolder(void)
+	{
+		State &state = GetState();
+		std::lock_guard<std::mutex> lock(state.lock);
+		this->trace->ended = true;
+		if (this->trace->generation != state.generation || this->trace->count == 0)
+			state.threads.erase(std::find(state.threads.begin(), state.threads.end(),
+				this->trace));
+	}
+
+	inline Tracer::ThreadTrace &Tracer::GetThreadTrace(void)
+	{
+		static thread_local ThreadHolder holder;
+		return *holder.trace;
+	}
+
+	/** Buffers of ended threads are released here, since their events are no longer
+	written. */
+	inline void Tracer::Start(::size_t eventsPerThread)
+	{
+		if (eventsPerThread == 0)
+			throw std::invalid_argument("The capacity of a trace must be greater than 0.");
+
+		State &state = GetState();
+		std::lock_guard<std::mutex> lock(state.lock);
+		state.threads.erase(std::remove_if(state.threads.begin(), state.threads.end(),
+			[](const std::shared_ptr<ThreadTrace> &t) { return t->ended.load(); }),
+			state.threads.end());
+		state.capacity = eventsPerThread;
+		state.origin = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+		++state.generation;
+		state.enabled = true;
+	}
+
+	inline void Tracer::Stop(void)
+	{
+		GetState().enabled = false;
+	}
+
+	inline bool Tracer::IsEnabled(void)
+	{
+		return GetState().enabled.load(std::memory_order_relaxed);
+	}
+
+	inline void Tracer::SetThreadName(const std::string &name)
+	{
+		ThreadTrace &t = GetThreadTrace();
+		State &state = GetState();
+		std::lock_guard<std::mutex> lock(state.lock);
+		t.name = name;
+	}
+
+	/** A thread starts a new buffer at its first event after Start(). Readers use only
+	buffers of the current generation, so the buffer is not replaced while being read. */
+	inline void Tracer::Record(::size_t id, std::chrono::steady_clock::time_point start,
+		unsigned long long nanoseconds)
+	{
+		State &state = GetState();
+		ThreadTrace &t = GetThreadTrace();
+		const unsigned long long generation = state.generation.load(std::memory_order_relaxed);
+		if (t.generation.load(std::memory_order_relaxed) != generation)
+		{
+			const ::size_t capacity = state.capacity.load(std::memory_order_relaxed);
+			if (t.capacity != capacity)
+			{
+				t.events.reset(new Event[capacity]);
+				t.capacity = capacity;
+			}
+			t.count.store(0, std::memory_order_relaxed);
+			t.dropped.store(0, std::memory_order_relaxed);
+			t.generation.store(generation, std::memory_order_release);
+		}
+
+		const ::size_t n = t.count.load(std::memory_order_relaxed);
+		if (n == t.capacity)
+		{
+			t.dropped.store(t.dropped.load(std::memory_order_relaxed) + 1,
+				std::memory_order_relaxed);
+			return;
+		}
+		Event &e = t.events[n];
+		e.id = id;
+		e.start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			start.time_since_epoch()).count() - state.origin.load(std::memory_order_relaxed);
+		e.duration = static_cast<long long>(nanoseconds);
+		t.count.store(n + 1, std::memory_order_release);
+	}
+
+	inline unsigned long long Tracer::GetDroppedCount(void)
+	{
+		State &state = GetState();
+		std::lock_guard<std::mutex> lock(state.lock);
+		unsigned long long dropped = 0;
+		for (const auto &t : state.threads)
+			if (t->generation.load(std::memory_order_acquire) == state.generation)
+				dropped += t->dropped.load(std::memory_order_relaxed);
+		return dropped;
+	}
+
+	/** Times are in microseconds from Start(), and every thread is in a single process. */
+	inline std::string Tracer::ToJson(void)
+	{
+		auto Escape = [](const std::string &src)
+		{
+			std::string dst;
+			for (auto c : src)
+			{
+				if (c == '"' || c == '\\')
+					dst.push_back('\\');
+				dst.push_back(c);
+			}
+			return dst;
+		};
+
+		std::vector<std::string> names;
+		for (const auto &s : Instrumentation::GetStats())
+			names.push_back(Escape(s.name));
+
+		State &state = GetState();
+		std::lock_guard<std::mutex> lock(state.lock);
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(3) << "{\"traceEvents\": [";
+		const char *separator = "\n";
+		unsigned long long dropped = 0;
+		for (const auto &t : state.threads)
+		{
+			if (t->generation.load(std::memory_order_acquire) != state.generation)
+				continue;
+			if (!t->name.empty())
+			{
+				out << separator << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, " <<
+					"\"tid\": " << t->tid << ", \"args\": {\"name\": \"" << Escape(t->name) <<
+					"\"}}";
+				separator = ",\n";
+			}
+			const ::size_t n = t->count.load(std::memory_order_acquire);
+			for (::size_t I = 0; I != n; ++I)
+			{
+				const Event &e = t->events[I];
+				out << separator << "{\"name\": \"" <<
+					(e.id < names.size() ? names[e.id] : std::string("?")) <<
+					"\", \"cat\": \"imaging\", \"ph\": \"X\", \"ts\": " << e.start * 1e-3 <<
+					", \"dur\": " << e.duration * 1e-3 << ", \"pid\": 1, \"tid\": " << t->tid <<
+					"}";
+				separator = ",\n";
+			}
+			dropped += t->dropped.load(std::memory_order_relaxed);
+		}
+		out << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped_events\": \"" <<
+			dropped << "\"}}\n";
+		return out.str();
+	}
+
+	inline void Tracer::Write(const std::string &path)
+	{
+		std::ofstream out(path);
+		if (!out)
+			throw std::runtime_error("Failed to open " + path + ".");
+		out << ToJson();
+	}
+}
+
+#endif